@@ -11,8 +11,10 @@ INCLUDES
 #include "app/editor/ed_ui_open_file_dialog.h"
 #include "app/editor/ed_ui_properties.h"
 #include "ecs/ecs.h"
+#include "ecs/systems/collision_system.h"
 #include "ecs/systems/player_system.h"
 #include "ecs/systems/render_system.h"
+#include "ecs/systems/transform_system.h"
 #include "engine/kk_camera.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
@@ -22,10 +24,6 @@ INCLUDES
 #include "thirdparty/rxi_map/src/map.h"
 #include "utl/utl.h"
 
-// TODO ?
-#include "gpu/vlk/vlk.h"
-#include "gpu/vlk/models/vlk_static_model.h"
-
 #include "autogen/ed.static.h"
 
 /*=========================================================
@@ -120,6 +118,8 @@ void ed__run_frame(app_t* app)
 
 	if (ed->world_is_open)
 	{
+		collision_system__run(&ed->world.collision, &ed->world.ecs);
+		transform_system__run(&ed->world.ecs, 1.0f);
 		geo__render(&ed->world.geo, &ed->window.gpu_window, frame);
 		run_render_system(ed, &ed->window.gpu_window, frame);
 	}
@@ -217,18 +217,16 @@ static void run_render_system(_ed_t* ed, gpu_window_t* window, gpu_frame_t* fram
 	ecs_t* ecs = &ed->world.ecs;
 	ecs_static_model_t* sm;
 	ecs_transform_t* transform;
+	ecs_query_t* query;
 	uint32_t i;
 
-	for (i = 0; i < ecs->next_free_id; ++i)
-	{
-		sm = &ecs->static_model_comp[i];
-		transform = &ecs->transform_comp[i];
+	/* Find entities with static model and transform */
+	query = ecs__query(ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM), 0);
 
-		/* Find entities with static model and transform */
-		if (!sm->base.is_used || !transform->base.is_used)
-		{
-			continue;
-		}
+	for (i = 0; i < ecs_query__get_count(query); ++i)
+	{
+		sm = ecs_static_model__get(ecs, ecs_query__get_entity(query, i));
+		transform = ecs_transform__get(ecs, sm->base.entity);
 
 		/* Make sure model is loaded */
 		if (!sm->model)
@@ -238,13 +236,6 @@ static void run_render_system(_ed_t* ed, gpu_window_t* window, gpu_frame_t* fram
 
 		/* Render the model */
 		gpu_static_model__render(sm->model, g_gpu, window, frame, sm->material, transform);
-
-		/* Convert entity id into an RGBA color */
-		kk_vec4_t color;
-		utl_unpack_rgba_float(i, color);
-
-		/* Render picker buffer */
-		vlk_static_model__render_to_picker_buffer(sm->model, g_gpu, window, frame, color, transform);
 	}
 }
 
@@ -315,10 +306,15 @@ static void window_on_mouse_button
 {
 	_ed_t* ed = (_ed_t*)platform_window__get_user_data(window);
 
-	if (!ed->camera_is_moving && action == KEY_ACTION_RELEASE && button == MOUSE_BUTTON_LEFT)
+	if (ed->world_is_open && !ed->camera_is_moving && action == KEY_ACTION_RELEASE && button == MOUSE_BUTTON_LEFT)
 	{
-		gpu_frame_t* frame = &window->gpu_window.frames[window->gpu_window.frame_idx];
-		ed->selected_entity = vlk_window__get_picker_id(&window->gpu_window, frame, window->mouse_x, window->mouse_y);
+		/* Select what is under the mouse with a raycast */
+		kk_ray_t ray;
+		collision_system_hit_t hit;
+
+		kk_camera__get_ray(&ed->camera, window->mouse_x, window->mouse_y, (float)window->gpu_window.width, (float)window->gpu_window.height, &ray);
+		kk_world__raycast(&ed->world, &ray, &hit);
+		ed->selected_entity = hit.entity;
 	}
 }
 
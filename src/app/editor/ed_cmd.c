@@ -58,8 +58,22 @@ void _ed_cmd__set_component_property(void* context, _ed_undo_cmd_val_t* old_val,
 		*(kk_vec3_t*)prop.value = new_val->vec3_val;
 		break;
 
+	case ECS_COMPONENT_PROP_TYPE_VEC4:
+		*(kk_vec4_t*)prop.value = new_val->vec4_val;
+		break;
+
+	case ECS_COMPONENT_PROP_TYPE_ENTITY:
+		*(entity_id_t*)prop.value = new_val->uint32_val;
+		break;
+
 	default:
 		kk_log__error("Unknown component property type.");
-		break;
+		return;
+	}
+
+	/* Let the component know the value changed */
+	if (ctx->component->property_changed)
+	{
+		ctx->component->property_changed(ctx->ecs, ctx->entity, ctx->property_idx);
 	}
 }
\ No newline at end of file
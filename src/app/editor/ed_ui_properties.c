@@ -81,7 +81,12 @@ void _ed_ui_properties__think(_ed_ui_properties_t* prop)
 				continue;
 			}
 
-			// TODO : Check if selected entity has this component
+			/* Skip components the selected entity does not have */
+			if (!comp->has(ecs, ed->selected_entity))
+			{
+				continue;
+			}
+
 			igColumns(1, NULL, FALSE);
 			igText(comp->name);
 			//igCollapsingHeader(comp->name, 0);
@@ -136,6 +141,12 @@ void _ed_ui_properties__think(_ed_ui_properties_t* prop)
 						cmd->property_idx = prop_idx;
 
 						_ed_undo__create_float(&ed->undo_buffer, cmd, old_val, *(float*)prop_info.value, _ed_cmd__set_component_property);
+
+						/* Let the component know the value changed */
+						if (comp->property_changed)
+						{
+							comp->property_changed(ecs, ed->selected_entity, prop_idx);
+						}
 					}
 				}
 				break;
@@ -160,6 +171,12 @@ void _ed_ui_properties__think(_ed_ui_properties_t* prop)
 						cmd->property_idx = prop_idx;
 
 						_ed_undo__create_vec3(&ed->undo_buffer, cmd, old_val, *(kk_vec3_t*)prop_info.value, _ed_cmd__set_component_property);
+
+						/* Let the component know the value changed */
+						if (comp->property_changed)
+						{
+							comp->property_changed(ecs, ed->selected_entity, prop_idx);
+						}
 					}
 				}
 				break;
@@ -176,6 +193,40 @@ void _ed_ui_properties__think(_ed_ui_properties_t* prop)
 						{
 							kk_log__fatal("Failed to allocate memory.");
 							break;
+
+				case ECS_COMPONENT_PROP_TYPE_ENTITY:
+				{
+					entity_id_t old_val = *(entity_id_t*)prop_info.value;
+					int val = (int)old_val;
+
+					/* Entity ids are edited as signed ints so -1 means no entity */
+					if (igInputInt(prop_info.name, &val, 1, 10, ImGuiInputTextFlags_EnterReturnsTrue))
+					{
+						*(entity_id_t*)prop_info.value = (entity_id_t)val;
+
+						/* Memory is freed by the undo buffer */
+						_ed_cmd__set_component_property_cmd_t* cmd = malloc(sizeof(_ed_cmd__set_component_property_cmd_t));
+						if (!cmd)
+						{
+							kk_log__fatal("Failed to allocate memory.");
+							break;
+						}
+
+						cmd->component = comp;
+						cmd->ecs = &ed->world.ecs;
+						cmd->entity = ed->selected_entity;
+						cmd->property_idx = prop_idx;
+
+						_ed_undo__create_uint32(&ed->undo_buffer, cmd, old_val, *(entity_id_t*)prop_info.value, _ed_cmd__set_component_property);
+
+						/* Let the component know the value changed */
+						if (comp->property_changed)
+						{
+							comp->property_changed(ecs, ed->selected_entity, prop_idx);
+						}
+					}
+				}
+				break;
 						}
 
 						cmd->component = comp;
@@ -184,6 +235,12 @@ void _ed_ui_properties__think(_ed_ui_properties_t* prop)
 						cmd->property_idx = prop_idx;
 
 						_ed_undo__create_vec4(&ed->undo_buffer, cmd, old_val, *(kk_vec4_t*)prop_info.value, _ed_cmd__set_component_property);
+
+						/* Let the component know the value changed */
+						if (comp->property_changed)
+						{
+							comp->property_changed(ecs, ed->selected_entity, prop_idx);
+						}
 					}
 				}
 				break;
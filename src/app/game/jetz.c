@@ -6,14 +6,17 @@ INCLUDES
 #include "global.h"
 #include "app/app.h"
 #include "app/game/jetz.h"
+#include "ecs/ecs_scheduler.h"
+#include "ecs/systems/collision_system.h"
 #include "ecs/systems/physics_system.h"
 #include "ecs/systems/player_system.h"
 #include "ecs/systems/render_system.h"
+#include "ecs/systems/transform_system.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
 #include "platform/platform.h"
 
-//#include "autogen/jetz.static.h"
+#include "autogen/jetz.static.h"
 
 /*=========================================================
 VARIABLES
@@ -39,7 +42,13 @@ void jetz__construct(app_t* app)
 	kk_camera__construct(&j->camera);
 	j->camera.pos.y = 1.0f;
 
+	render_system__construct(&j->render_system);
 	kk_world__construct(&j->world, "worlds/world.lua");
+
+	jetz__set_tick_rate(app, JETZ_DEFAULT_TICK_RATE);
+
+	ecs_scheduler__construct(&j->scheduler);
+	add_systems(j);
 }
 
 //## public
@@ -49,6 +58,10 @@ void jetz__destruct(app_t* app)
 
 	gpu__wait_idle(g_gpu);
 
+	ecs_scheduler__dump(&j->scheduler);
+	ecs_scheduler__destruct(&j->scheduler);
+
+	render_system__destruct(&j->render_system);
 	kk_camera__destruct(&j->camera);
 	platform_window__destruct(&j->window, g_platform, g_gpu);
 
@@ -82,13 +95,127 @@ void jetz__run_frame(app_t* app)
 	/* Get frame time delta */
 	j->frame_delta_time = g_platform->get_delta_time(g_platform);
 
-	player_system__run(&j->world.ecs, &j->camera, j->frame_delta_time);
-	physics_system__run(&j->world.ecs, j->frame_delta_time);
+	/* Work out how many fixed ticks fit in the time so far. The remainder carries over and blends rendering. */
+	j->tick_accumulator += j->frame_delta_time;
+	j->num_ticks = (uint32_t)(j->tick_accumulator / j->tick_time);
+	if (j->num_ticks > JETZ_MAX_TICKS_PER_FRAME)
+	{
+		j->num_ticks = JETZ_MAX_TICKS_PER_FRAME;
+		j->tick_accumulator = j->tick_time * JETZ_MAX_TICKS_PER_FRAME;
+	}
+
+	j->tick_accumulator -= j->tick_time * j->num_ticks;
+	j->tick_alpha = min(j->tick_accumulator / j->tick_time, 1.0f);
+
+	ecs_scheduler__run(&j->scheduler, &j->world.ecs);
+
+	/* Log the schedule once every system has been timed */
+	if (j->scheduler.num_runs == 1)
+	{
+		ecs_scheduler__dump(&j->scheduler);
+	}
+}
+
+//## public
+/**
+Sets how many times per second the simulation is stepped. Rendering runs
+at the platform's frame rate and blends between ticks.
+*/
+void jetz__set_tick_rate(app_t* app, uint32_t ticks_per_second)
+{
+	_jetz_t* j = _jetz__from_base(app);
+
+	j->tick_time = 1.0f / (float)max(ticks_per_second, 1);
+	j->tick_accumulator = 0.0f;
+}
+
+//## public
+boolean jetz__should_exit(app_t* app)
+{
+	_jetz_t* j = _jetz__from_base(app);
+	return (j->should_exit);
+}
 
+//## public
+_jetz_t* _jetz__from_base(app_t* app)
+{
+	return (_jetz_t*)app->intf->context;
+}
 
-	////// update camera
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
 
+//## static
+/**
+Adds the game systems to the scheduler.
+*/
+static void add_systems(_jetz_t* j)
+{
+	uint32_t camera;
+	uint32_t collision;
+	uint32_t physics;
+	uint32_t render;
+
+	ecs_scheduler__add(&j->scheduler, "player", run_player_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PLAYER) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS),
+		0);
+
+	physics = ecs_scheduler__add(&j->scheduler, "physics", run_physics_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		0);
+
+	/* Writes transforms only to push dirty flags down the hierarchy */
+	collision = ecs_scheduler__add(&j->scheduler, "collision", run_collision_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		0);
+
+	ecs_scheduler__add(&j->scheduler, "transform", run_transform_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		0);
+
+	camera = ecs_scheduler__add(&j->scheduler, "camera", run_camera_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PLAYER) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		0,
+		0);
+
+	render = ecs_scheduler__add(&j->scheduler, "render", run_render_system, j,
+		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM),
+		0,
+		ECS_SYSTEM_FLAG_MAIN_THREAD);
+
+	/* The camera and collision world aren't components, so order them explicitly */
+	ecs_scheduler__add_dependency(&j->scheduler, collision, physics);
+	ecs_scheduler__add_dependency(&j->scheduler, render, camera);
+}
+
+//## static
+/**
+Moves the camera behind the player.
+*/
+static void run_camera_system(ecs_t* ecs, void* context)
+{
+	_jetz_t* j = (_jetz_t*)context;
+	kk_vec3_t player_pos;
+	kk_vec4_t player_rot;
 	kk_vec3_t temp;
+	kk_vec3_t dir;
+	kk_vec3_t up;
+
+	/* Find the player */
+	ecs_query_t* player_query = ecs__query(ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PLAYER) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM), 0);
+	ecs_transform_t* player_transform = ecs_transform__get(ecs, ecs_query__get_single(player_query));
+	if (!player_transform)
+	{
+		kk_log__fatal("Player does not have a transform.");
+	}
+
+	/* Follow the rendered pose, not the latest tick */
+	ecs_transform__get_blended(player_transform, j->tick_alpha, &player_pos, &player_rot);
 
 	/* Set distance behind the player */
 	kk_vec3_t cam_dist;
@@ -97,10 +224,10 @@ void jetz__run_frame(app_t* app)
 	cam_dist.z = 5.0f;
 
 	/* Rotate based on player orientation to get directly behind */
-	kk_math_quat_rotatev(&j->world.ecs.transform_comp[0].rot, &cam_dist, &cam_dist);
+	kk_math_quat_rotatev(&player_rot, &cam_dist, &cam_dist);
 
 	/* player pos - cam dist */
-	kk_math_vec3_sub(&j->world.ecs.transform_comp[0].pos, &cam_dist, &temp);
+	kk_math_vec3_sub(&player_pos, &cam_dist, &temp);
 
 	/* Move the camera up slightly */
 	cam_dist.x = 0.0f;
@@ -108,14 +235,14 @@ void jetz__run_frame(app_t* app)
 	cam_dist.z = 0.0f;
 	kk_math_vec3_add(&temp, &cam_dist, &temp);
 	
-	j->camera.pos = temp;
-
 	/* Get the camera direction vector - this points from the camera to the player */
-	kk_math_vec3_sub(&j->world.ecs.transform_comp[0].pos, &temp, &j->camera.dir);
+	kk_math_vec3_sub(&player_pos, &temp, &dir);
+
+	up.x = 0.0f;
+	up.y = 1.0f;
+	up.z = 0.0f;
 
-	j->camera.up.x = 0.0f;
-	j->camera.up.y = 1.0f;
-	j->camera.up.z = 0.0f;
+	kk_camera__set_pose(&j->camera, &temp, &dir, &up);
 
 	/* 
 	
@@ -128,23 +255,49 @@ void jetz__run_frame(app_t* app)
 
 	*/
 
-	/////
+}
 
+//## static
+/**
+Updates the broadphase. Reads the dirty flags, so it must run before the
+transform system clears them.
+*/
+static void run_collision_system(ecs_t* ecs, void* context)
+{
+	_jetz_t* j = (_jetz_t*)context;
+	collision_system__run(&j->world.collision, ecs);
+}
 
-	gpu_frame_t* frame = gpu_window__begin_frame(&j->window.gpu_window, &j->camera, j->frame_delta_time);
-	render_system__run(&j->world.ecs, &j->window.gpu_window, frame);
-	gpu_window__end_frame(&j->window.gpu_window, frame);
+//## static
+static void run_physics_system(ecs_t* ecs, void* context)
+{
+	_jetz_t* j = (_jetz_t*)context;
+	physics_system__run(ecs, &j->world.bodies, &j->world.collision, j->tick_time, j->num_ticks);
 }
 
-//## public
-boolean jetz__should_exit(app_t* app)
+//## static
+static void run_player_system(ecs_t* ecs, void* context)
 {
-	_jetz_t* j = _jetz__from_base(app);
-	return (j->should_exit);
+	_jetz_t* j = (_jetz_t*)context;
+	player_system__run(ecs, &j->camera, j->frame_delta_time);
 }
 
-//## public
-_jetz_t* _jetz__from_base(app_t* app)
+//## static
+/**
+Records the frame. Runs on the main thread since it uses the GPU.
+*/
+static void run_render_system(ecs_t* ecs, void* context)
 {
-	return (_jetz_t*)app->intf->context;
+	_jetz_t* j = (_jetz_t*)context;
+
+	gpu_frame_t* frame = gpu_window__begin_frame(&j->window.gpu_window, &j->camera, j->frame_delta_time);
+	render_system__run(&j->render_system, ecs, &j->camera, &j->window.gpu_window, frame);
+	gpu_window__end_frame(&j->window.gpu_window, frame);
+}
+
+//## static
+static void run_transform_system(ecs_t* ecs, void* context)
+{
+	_jetz_t* j = (_jetz_t*)context;
+	transform_system__run(ecs, j->tick_alpha);
 }
@@ -12,6 +12,8 @@ DECLARATIONS
 INCLUDES
 =========================================================*/
 
+#include "ecs/ecs_scheduler.h"
+#include "ecs/systems/render_system.h"
 #include "engine/kk_camera.h"
 #include "engine/kk_world.h"
 #include "platform/platform_window.h"
@@ -20,6 +22,9 @@ INCLUDES
 CONSTANTS
 =========================================================*/
 
+#define JETZ_DEFAULT_TICK_RATE		(60)	/* Simulation ticks per second. */
+#define JETZ_MAX_TICKS_PER_FRAME	(4)		/* Frame time past this many ticks is dropped so a slow frame can't snowball. */
+
 /*=========================================================
 TYPES
 =========================================================*/
@@ -33,6 +38,8 @@ struct _jetz_s
 	Create/destroy
 	*/
 	kk_camera_t			camera;
+	render_system_t		render_system;
+	ecs_scheduler_t		scheduler;
 	platform_window_t	window;
 	kk_world_t			world;
 
@@ -40,6 +47,10 @@ struct _jetz_s
 	Other
 	*/
 	float				frame_delta_time;	/* Time between current frame and last frame (in seconds) */
+	float				tick_time;			/* Length of a simulation tick (in seconds) */
+	float				tick_accumulator;	/* Frame time not simulated yet (in seconds) */
+	float				tick_alpha;			/* Blend between the last two ticks used for rendering */
+	uint32_t			num_ticks;			/* Number of ticks to simulate this frame */
 	boolean				should_exit;		/* Should the app exit? */
 };
 
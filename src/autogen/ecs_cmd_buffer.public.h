@@ -0,0 +1,90 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty command buffer.
+
+@param buf The buffer to construct.
+*/
+void ecs_cmd_buffer__construct(ecs_cmd_buffer_t* buf)
+;
+
+/**
+Destructs a command buffer. Commands that were not applied are discarded.
+
+@param buf The buffer to destruct.
+*/
+void ecs_cmd_buffer__destruct(ecs_cmd_buffer_t* buf)
+;
+
+/**
+Records adding a component. Returns the component data to fill in, which is
+copied to the real component when the buffer is applied. The data is zeroed
+except for transforms, which start with identity rotation, unit scale and no
+parent. The pointer is only valid until the next command is recorded.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+@param type The component type.
+@return The component data.
+*/
+void* ecs_cmd_buffer__add(ecs_cmd_buffer_t* buf, entity_id_t ent, ecs_component_type_t type)
+;
+
+/**
+Applies the commands from a set of buffers and empties them. Spawns are
+resolved first, then adds and removes are applied one component type at a
+time across all buffers, then entities are destroyed. Commands for the same
+component type keep the order they were recorded in within a buffer.
+
+@param bufs The buffers.
+@param num_bufs The number of buffers.
+@param ecs The ECS context.
+*/
+void ecs_cmd_buffer__apply(ecs_cmd_buffer_t* bufs, uint32_t num_bufs, ecs_t* ecs)
+;
+
+/**
+Discards all recorded commands. Allocations are kept for reuse.
+
+@param buf The buffer.
+*/
+void ecs_cmd_buffer__clear(ecs_cmd_buffer_t* buf)
+;
+
+/**
+Records destroying an entity and all of its components.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+*/
+void ecs_cmd_buffer__destroy(ecs_cmd_buffer_t* buf, entity_id_t ent)
+;
+
+/**
+Checks if a buffer has anything to apply.
+*/
+boolean ecs_cmd_buffer__is_empty(ecs_cmd_buffer_t* buf)
+;
+
+/**
+Records removing a component.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+@param type The component type.
+*/
+void ecs_cmd_buffer__remove(ecs_cmd_buffer_t* buf, entity_id_t ent, ecs_component_type_t type)
+;
+
+/**
+Records spawning an entity. The returned pending id can be used with the
+other commands in this buffer. It is replaced by a real id when the buffer
+is applied.
+
+@param buf The buffer.
+@return The pending id.
+*/
+entity_id_t ecs_cmd_buffer__spawn(ecs_cmd_buffer_t* buf)
+;
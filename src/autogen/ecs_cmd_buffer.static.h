@@ -0,0 +1,26 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Applies an add or remove command.
+*/
+static void apply_component_cmd(ecs_cmd_buffer_t* buf, ecs_t* ecs, ecs_cmd_t* cmd)
+;
+
+/**
+Converts a pending id to the entity id it was given when applied. Other ids
+are returned unchanged.
+*/
+static entity_id_t resolve(ecs_cmd_buffer_t* buf, entity_id_t ent)
+;
+
+/**
+Counting sort of the command indices into one bucket per component type
+followed by a bucket of destroys. Keeps recorded order within a bucket.
+*/
+static void sort_commands(ecs_cmd_buffer_t* buf)
+;
+
+static uint32_t get_bucket(ecs_cmd_t* cmd)
+;
@@ -2,7 +2,10 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-void ecs_physics__add(ecs_t* ecs, entity_id_t ent)
+ecs_physics_t* ecs_physics__add(ecs_t* ecs, entity_id_t ent)
+;
+
+ecs_physics_t* ecs_physics__get(ecs_t* ecs, entity_id_t ent)
 ;
 
 boolean ecs_physics__get_property
@@ -14,8 +17,31 @@ boolean ecs_physics__get_property
 	)
 ;
 
+boolean ecs_physics__has(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_physics__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 ;
 
+void ecs_physics__remove(ecs_t* ecs, entity_id_t ent)
+;
+
+/**
+Wakes the body after a property is edited.
+*/
+void ecs_physics__property_changed(ecs_t* ecs, entity_id_t ent, uint32_t property_idx)
+;
+
 void ecs_physics__register(ecs_t* ecs)
 ;
+
+/**
+Wakes a sleeping body so the physics system simulates it again. Writing a
+sleeping body's momentum or transform wakes it on the next step, this wakes
+it right away.
+
+@param ecs The ECS context.
+@param ent The entity.
+*/
+void ecs_physics__wake(ecs_t* ecs, entity_id_t ent)
+;
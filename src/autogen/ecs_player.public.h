@@ -2,7 +2,10 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-void ecs_player__add(ecs_t* ecs, entity_id_t ent)
+ecs_player_t* ecs_player__add(ecs_t* ecs, entity_id_t ent)
+;
+
+ecs_player_t* ecs_player__get(ecs_t* ecs, entity_id_t ent)
 ;
 
 boolean ecs_player__get_property
@@ -14,8 +17,14 @@ boolean ecs_player__get_property
 	)
 ;
 
+boolean ecs_player__has(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_player__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 ;
 
+void ecs_player__remove(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_player__register(ecs_t* ecs)
 ;
@@ -0,0 +1,37 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty pool. No chunks are allocated until the pool is grown.
+
+@param pool The pool to construct.
+@param elem_size The size of an element.
+@param fill Byte value that new chunks are filled with.
+*/
+void ecs_pool__construct(ecs_pool_t* pool, size_t elem_size, uint8_t fill)
+;
+
+/**
+Destructs a pool and frees all chunks.
+
+@param pool The pool to destruct.
+*/
+void ecs_pool__destruct(ecs_pool_t* pool)
+;
+
+/**
+Gets the number of bytes allocated by the pool.
+*/
+size_t ecs_pool__get_memory_usage(ecs_pool_t* pool)
+;
+
+/**
+Grows the pool so it can hold at least the specified number of elements.
+Existing chunks are not moved.
+
+@param pool The pool.
+@param count The number of elements required.
+*/
+void ecs_pool__reserve(ecs_pool_t* pool, uint32_t count)
+;
@@ -0,0 +1,59 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs a query. The match list starts empty.
+
+@param query The query to construct.
+@param required Component bits an entity must have.
+@param excluded Component bits an entity must not have.
+*/
+void ecs_query__construct(ecs_query_t* query, ecs_component_mask_t required, ecs_component_mask_t excluded)
+;
+
+/**
+Destructs a query.
+
+@param query The query to destruct.
+*/
+void ecs_query__destruct(ecs_query_t* query)
+;
+
+/**
+Gets the number of matching entities.
+*/
+uint32_t ecs_query__get_count(ecs_query_t* query)
+;
+
+/**
+Gets a matching entity by index. Index must be less than the match count.
+*/
+entity_id_t ecs_query__get_entity(ecs_query_t* query, uint32_t idx)
+;
+
+/**
+Gets the first matching entity. Used for queries that are expected to
+match a single entity, such as the player.
+
+@return The entity id, or ECS_INVALID_ID if nothing matches.
+*/
+entity_id_t ecs_query__get_single(ecs_query_t* query)
+;
+
+/**
+Checks if a signature matches the query. An empty signature never matches
+since the entity has no components.
+*/
+boolean ecs_query__is_match(ecs_query_t* query, ecs_component_mask_t mask)
+;
+
+/**
+Adds or removes an entity from the match list based on its signature.
+
+@param query The query.
+@param ent The entity id.
+@param mask The entity's current signature.
+*/
+void ecs_query__update(ecs_query_t* query, entity_id_t ent, ecs_component_mask_t mask)
+;
@@ -0,0 +1,65 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty scheduler.
+
+@param sched The scheduler to construct.
+*/
+void ecs_scheduler__construct(ecs_scheduler_t* sched)
+;
+
+/**
+Destructs a scheduler.
+
+@param sched The scheduler to destruct.
+*/
+void ecs_scheduler__destruct(ecs_scheduler_t* sched)
+;
+
+/**
+Adds a system. Systems that conflict run in the order they were added.
+
+@param sched The scheduler.
+@param name Name used in the schedule dump. Must outlive the scheduler.
+@param func The system function.
+@param context User context passed to func.
+@param reads Component types the system reads.
+@param writes Component types the system writes.
+@param flags ECS_SYSTEM_FLAG_* bits.
+@return The index of the system.
+*/
+uint32_t ecs_scheduler__add(ecs_scheduler_t* sched, const char* name, ecs_system_func func, void* context, ecs_component_mask_t reads, ecs_component_mask_t writes, uint32_t flags)
+;
+
+/**
+Makes a system wait for an earlier system even if they share no component
+types. Use for state outside the ECS, like a camera.
+
+@param sched The scheduler.
+@param system Index of the system that waits.
+@param depends_on Index of the system to wait for. Must have been added before system.
+*/
+void ecs_scheduler__add_dependency(ecs_scheduler_t* sched, uint32_t system, uint32_t depends_on)
+;
+
+/**
+Logs the schedule and the timings from the last run.
+
+@param sched The scheduler.
+*/
+void ecs_scheduler__dump(ecs_scheduler_t* sched)
+;
+
+/**
+Runs every system. Stages run in order. Systems in a stage run concurrently
+on the job system, except for main thread systems which the calling thread
+runs itself. The schedule is rebuilt each run. Commands recorded in the ECS
+command buffers are applied after the last stage.
+
+@param sched The scheduler.
+@param ecs The ECS context passed to the systems.
+*/
+void ecs_scheduler__run(ecs_scheduler_t* sched, ecs_t* ecs)
+;
@@ -0,0 +1,27 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Works out the dependencies and stage of each system.
+*/
+static void build_schedule(ecs_scheduler_t* sched)
+;
+
+/**
+Gets the time in seconds, or 0 if the platform has no timer.
+*/
+static double get_time()
+;
+
+/**
+Runs a system and records how long it took.
+*/
+static void run_system(ecs_scheduler_t* sched, uint32_t idx)
+;
+
+/**
+Job that runs the system at index start.
+*/
+static void run_system_job(void* data, uint32_t start, uint32_t end)
+;
@@ -0,0 +1,68 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty sparse set. Storage is allocated as components are added.
+
+@param set The set to construct.
+@param elem_size The size of a component. Components must begin with an ecs_component_t.
+*/
+void ecs_sparse_set__construct(ecs_sparse_set_t* set, size_t elem_size)
+;
+
+/**
+Destructs a sparse set.
+
+@param set The set to destruct.
+*/
+void ecs_sparse_set__destruct(ecs_sparse_set_t* set)
+;
+
+/**
+Adds a component for an entity. The component is zeroed. If the entity
+already has the component, the existing component is zeroed and returned.
+
+@param set The set.
+@param ent The entity id.
+@return The component, or NULL if the entity id is invalid.
+*/
+void* ecs_sparse_set__add(ecs_sparse_set_t* set, entity_id_t ent)
+;
+
+/**
+Gets the component for an entity.
+
+@param set The set.
+@param ent The entity id.
+@return The component, or NULL if the entity does not have one.
+*/
+void* ecs_sparse_set__get(ecs_sparse_set_t* set, entity_id_t ent)
+;
+
+/**
+Gets the number of bytes allocated by the set.
+*/
+size_t ecs_sparse_set__get_memory_usage(ecs_sparse_set_t* set)
+;
+
+/**
+Checks if an entity has a component in the set.
+
+@param set The set.
+@param ent The entity id.
+@return TRUE if the entity has the component.
+*/
+boolean ecs_sparse_set__has(ecs_sparse_set_t* set, entity_id_t ent)
+;
+
+/**
+Removes the component for an entity. The last component in the dense array
+is moved into the freed slot to keep the array packed, so pointers to that
+component are invalidated.
+
+@param set The set.
+@param ent The entity id.
+*/
+void ecs_sparse_set__remove(ecs_sparse_set_t* set, entity_id_t ent)
+;
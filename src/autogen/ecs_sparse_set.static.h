@@ -0,0 +1,10 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Gets the dense slot for an entity, or ECS_INVALID_ID if the entity does not
+have a component. Entity ids past the end of the sparse index have none.
+*/
+static uint32_t get_slot(ecs_sparse_set_t* set, entity_id_t ent)
+;
@@ -2,7 +2,10 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-void ecs_static_model__add(ecs_t* ecs, entity_id_t ent)
+ecs_static_model_t* ecs_static_model__add(ecs_t* ecs, entity_id_t ent)
+;
+
+ecs_static_model_t* ecs_static_model__get(ecs_t* ecs, entity_id_t ent)
 ;
 
 boolean ecs_static_model__get_property
@@ -14,8 +17,14 @@ boolean ecs_static_model__get_property
 	)
 ;
 
+boolean ecs_static_model__has(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_static_model__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 ;
 
+void ecs_static_model__remove(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_static_model__register(ecs_t* ecs)
 ;
@@ -2,7 +2,23 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-void ecs_transform__add(ecs_t* ecs, entity_id_t ent)
+ecs_transform_t* ecs_transform__add(ecs_t* ecs, entity_id_t ent)
+;
+
+/**
+Gets the local position and rotation blended between the previous and
+current simulation tick. Transforms that are not interpolated return pos
+and rot unchanged.
+
+@param comp The transform.
+@param alpha Blend factor. 0 is the previous tick, 1 is the current tick.
+@param out__pos The blended position.
+@param out__rot The blended rotation.
+*/
+void ecs_transform__get_blended(ecs_transform_t* comp, float alpha, kk_vec3_t* out__pos, kk_vec4_t* out__rot)
+;
+
+ecs_transform_t* ecs_transform__get(ecs_t* ecs, entity_id_t ent)
 ;
 
 boolean ecs_transform__get_property
@@ -14,8 +30,117 @@ boolean ecs_transform__get_property
 	)
 ;
 
+boolean ecs_transform__has(ecs_t* ecs, entity_id_t ent)
+;
+
 void ecs_transform__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 ;
 
+/**
+Queues a transform to have its cached matrix rebuilt by the next transform
+system pass. Must be called after writing pos, rot or scale.
+*/
+void ecs_transform__set_dirty(ecs_t* ecs, ecs_transform_t* comp)
+;
+
+/**
+Sets the parent of a transform. The transform's pos, rot and scale become
+relative to the parent.
+
+@param ecs The ECS context.
+@param ent The child entity.
+@param parent The parent entity, or ECS_INVALID_ID to detach.
+@return FALSE if the parent does not have a transform or would create a cycle.
+*/
+boolean ecs_transform__set_parent(ecs_t* ecs, entity_id_t ent, entity_id_t parent)
+;
+
+/**
+Builds the matrix that takes the transform's local space to its parent's
+space. Equivalent to translate * scale * rotate.
+
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+@param out__m The local matrix.
+*/
+void ecs_transform__get_local_matrix(ecs_transform_t* comp, float alpha, kk_mat4_t* out__m)
+;
+
+/**
+Builds the matrix that takes the transform's parent space to world space by
+composing the local pose of every ancestor. Unlike the cached world matrices
+this does not depend on the last transform pass, so it can be used before
+the pass runs.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated ancestors.
+@param out__m The parent's world matrix. Not written if the transform has no parent.
+@return FALSE if the transform has no parent.
+*/
+boolean ecs_transform__get_parent_matrix(ecs_t* ecs, ecs_transform_t* comp, float alpha, kk_mat4_t* out__m)
+;
+
+/**
+Gets the world space bounds of a box and sphere in the transform's local
+space. Works from the pose directly, so no matrix is built unless the
+transform has a parent. Ancestors are posed at the same alpha, not taken
+from their cached world matrices, which may be a frame old and blended.
+
+Each world axis of the box spans the absolute rotated and scaled half
+extents. The sphere's radius grows by the largest scale.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+@param box The local box. May be NULL if out__box is.
+@param sphere The local sphere. May be NULL if out__sphere is.
+@param out__box The world box. May be NULL.
+@param out__sphere The world sphere. May be NULL.
+*/
+void ecs_transform__get_world_bounds
+	(
+	ecs_t*					ecs,
+	ecs_transform_t*		comp,
+	float					alpha,
+	kk_aabb_t*				box,
+	kk_sphere_t*			sphere,
+	kk_aabb_t*				out__box,
+	kk_sphere_t*			out__sphere
+	)
+;
+
+/**
+Builds the matrix that takes the transform's local space to world space at
+the current tick. Unlike the cached matrix this is never blended, and
+ancestors are posed at the current tick too, so it matches the pose the
+simulation sees.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param out__m The world matrix.
+*/
+void ecs_transform__get_world_matrix(ecs_t* ecs, ecs_transform_t* comp, kk_mat4_t* out__m)
+;
+
+/**
+Rebuilds the cached matrix. Equivalent to parent * translate * scale * rotate.
+
+@param comp The transform to update.
+@param parent The parent transform, which must already be up to date. NULL if none.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+*/
+void ecs_transform__update_matrix(ecs_transform_t* comp, ecs_transform_t* parent, float alpha)
+;
+
+void ecs_transform__remove(ecs_t* ecs, entity_id_t ent)
+;
+
+/**
+Marks a property as modified so the cached matrix is rebuilt.
+*/
+void ecs_transform__property_changed(ecs_t* ecs, entity_id_t ent, uint32_t property_idx)
+;
+
 void ecs_transform__register(ecs_t* ecs)
 ;
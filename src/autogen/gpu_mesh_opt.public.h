@@ -0,0 +1,79 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Optimizes a welded mesh in place for the vertex cache, overdraw and vertex
+fetch. Vertices are reordered, so nothing more can be added to the weld
+afterwards.
+
+@param weld The welded mesh.
+@param position_offset Byte offset of the three float position in the vertex type.
+@param stats Cache misses before and after are added to these stats.
+*/
+void gpu_mesh_opt__optimize(gpu_vertex_weld_t* weld, uint32_t position_offset, gpu_mesh_opt_stats_t* stats)
+;
+
+/**
+Counts post-transform cache misses when drawing a triangle list through a
+FIFO cache.
+
+@param indices The index list.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices referenced.
+@param cache_size The number of cache entries.
+@return The number of misses.
+*/
+uint32_t gpu_mesh_opt__count_misses(const uint32_t* indices, uint32_t num_indices, uint32_t num_vertices, uint32_t cache_size)
+;
+
+/**
+Gets the average cache miss ratio: misses per triangle. 3 is the worst, 0.5
+is the best possible for a large regular grid.
+
+@param stats The stats.
+@param after TRUE for the optimized meshes, FALSE for the input.
+@return The ACMR, or 0 if there are no triangles.
+*/
+float gpu_mesh_opt__get_acmr(const gpu_mesh_opt_stats_t* stats, boolean after)
+;
+
+/**
+Reorders triangles for the post-transform vertex cache. The triangle with the
+best score among those using cached vertices is emitted next. Vertices score
+higher the more recently they were used and the fewer triangles they have
+left, so the order finishes off regions instead of leaving stragglers.
+
+@param indices The index list to reorder in place.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices referenced.
+*/
+void gpu_mesh_opt__optimize_vertex_cache(uint32_t* indices, uint32_t num_indices, uint32_t num_vertices)
+;
+
+/**
+Reorders clusters of cache-ordered triangles so outward facing clusters are
+drawn first. Triangles within a cluster keep their order. Call after
+gpu_mesh_opt__optimize_vertex_cache.
+
+@param indices The index list to reorder in place.
+@param num_indices The number of indices.
+@param positions The first vertex position, three floats.
+@param stride Bytes between vertex positions.
+@param num_vertices The number of vertices referenced.
+*/
+void gpu_mesh_opt__optimize_overdraw(uint32_t* indices, uint32_t num_indices, const uint8_t* positions, uint32_t stride, uint32_t num_vertices)
+;
+
+/**
+Reorders vertices into the order the index list first uses them and remaps
+the indices to match. Vertices that are never used are moved to the end.
+
+@param vertices The vertex data to reorder in place.
+@param vertex_size The size of one vertex in bytes.
+@param indices The index list to remap in place.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices.
+*/
+void gpu_mesh_opt__optimize_vertex_fetch(uint8_t* vertices, uint32_t vertex_size, uint32_t* indices, uint32_t num_indices, uint32_t num_vertices)
+;
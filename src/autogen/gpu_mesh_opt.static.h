@@ -0,0 +1,25 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Sorts clusters by descending key. Ties keep the cache order.
+*/
+static int compare_clusters(const void* a, const void* b)
+;
+
+/**
+Gets a triangle's centroid and its normal scaled by twice its area.
+*/
+static void get_triangle(const uint32_t* tri, const uint8_t* positions, uint32_t stride, kk_vec3_t* out__center, kk_vec3_t* out__normal)
+;
+
+static boolean is_in_list(const uint32_t* list, uint32_t count, uint32_t value)
+;
+
+/**
+Scores a vertex from its LRU cache position (-1 if not cached) and the
+number of triangles still to be emitted that use it.
+*/
+static float vertex_score(int32_t cache_pos, uint32_t live)
+;
@@ -0,0 +1,69 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty render queue.
+
+@param q The queue to construct.
+*/
+void gpu_render_queue__construct(gpu_render_queue_t* q)
+;
+
+/**
+Destructs a render queue.
+
+@param q The queue to destruct.
+*/
+void gpu_render_queue__destruct(gpu_render_queue_t* q)
+;
+
+/**
+Removes every draw. Memory is kept for the next frame.
+
+@param q The queue.
+*/
+void gpu_render_queue__clear(gpu_render_queue_t* q)
+;
+
+/**
+Packs a draw's state into a sort key. Each field is masked to its width, so
+ids past the limit only group less well.
+
+@param pipeline The pipeline.
+@param model_id The model's id, which selects the material set.
+@param mesh The mesh index in the model.
+@param depth View depth, 0 at the near plane and 1 at the far plane. Clamped.
+@return The key.
+*/
+uint64_t gpu_render_queue__make_key(gpu_render_pipeline_t pipeline, uint32_t model_id, uint32_t mesh, float depth)
+;
+
+/**
+Adds a draw. The packet is copied.
+
+@param q The queue.
+@param draw The draw, with its key set.
+*/
+void gpu_render_queue__push(gpu_render_queue_t* q, gpu_render_draw_t* draw)
+;
+
+/**
+Sorts the draws by key into the sorted array. Draws with equal keys keep the
+order they were pushed in.
+
+@param q The queue.
+*/
+void gpu_render_queue__sort(gpu_render_queue_t* q)
+;
+
+/**
+Sorts the draws and records them with one call into the backend.
+
+@param q The queue.
+@param gpu The GPU context.
+@param window The window to render to.
+@param frame The frame being recorded.
+*/
+void gpu_render_queue__submit(gpu_render_queue_t* q, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame)
+;
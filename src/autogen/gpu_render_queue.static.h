@@ -0,0 +1,19 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Sorts keys[0] and order[0] with a least significant digit radix sort. The
+histograms for every digit are built in one pass, and a digit that is the
+same for every key is skipped, so unused key bits cost nothing.
+
+@return The index of the key/order arrays that hold the result.
+*/
+static uint32_t radix_sort(gpu_render_queue_t* q, uint32_t n)
+;
+
+/**
+Makes sure the sort arrays can hold a number of draws.
+*/
+static void reserve(gpu_render_queue_t* q, uint32_t n)
+;
@@ -2,6 +2,28 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
+/**
+Builds the triangle tree from the faces, which are triangulated on load.
+*/
+static void build_bvh(tinyobj_attrib_t* attrib, kk_bvh_t* out__bvh)
+;
+
+/**
+Computes the bounds of a set of vertices, either the first count vertices or
+those referenced by count face indices. The sphere is centered on the box
+and reaches the farthest vertex, which is tighter than the box's corners.
+No vertices gets empty bounds at the origin.
+*/
+static void compute_bounds
+	(
+	tinyobj_attrib_t*				attrib,
+	const tinyobj_vertex_index_t*	faces,
+	unsigned int					count,
+	kk_aabb_t*						out__box,
+	kk_sphere_t*					out__sphere
+	)
+;
+
 static void file_reader
 	(
 	const char*		filename,
@@ -11,3 +33,10 @@ static void file_reader
 	size_t*			len
 	)
 ;
+
+/**
+Gets a vertex position, the i-th vertex or the one referenced by the i-th
+face index.
+*/
+static float* get_vertex(tinyobj_attrib_t* attrib, const tinyobj_vertex_index_t* faces, unsigned int i)
+;
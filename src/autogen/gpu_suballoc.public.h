@@ -0,0 +1,64 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an allocator with the whole range free.
+
+@param a The allocator to construct.
+@param size The size of the range.
+*/
+void gpu_suballoc__construct(gpu_suballoc_t* a, uint64_t size)
+;
+
+/**
+Destructs an allocator. Live allocations are simply forgotten.
+
+@param a The allocator to destruct.
+*/
+void gpu_suballoc__destruct(gpu_suballoc_t* a)
+;
+
+/**
+Allocates a range. The alignment does not have to be a power of two, so
+vertex data can be aligned to its stride.
+
+@param a The allocator.
+@param size The size to allocate. Must not be 0.
+@param alignment The offset is a multiple of this.
+@param out__offset Receives the offset of the allocation.
+@return TRUE if the range was allocated, FALSE if no free range fits.
+*/
+boolean gpu_suballoc__alloc(gpu_suballoc_t* a, uint64_t size, uint64_t alignment, uint64_t* out__offset)
+;
+
+/**
+Frees a range returned by gpu_suballoc__alloc.
+
+@param a The allocator.
+@param offset The offset of the allocation.
+@param size The size it was allocated with.
+*/
+void gpu_suballoc__free(gpu_suballoc_t* a, uint64_t offset, uint64_t size)
+;
+
+/**
+Gets external fragmentation: how much of the free space is unusable by an
+allocation as large as all of it. 0 when the free space is one range, near
+1 when it is scattered in small pieces.
+
+@param a The allocator.
+@return The fragmentation from 0 to 1.
+*/
+float gpu_suballoc__get_fragmentation(const gpu_suballoc_t* a)
+;
+
+/**
+Gets the size of the largest free range, which is the largest allocation
+that can succeed without alignment padding.
+
+@param a The allocator.
+@return The size in bytes.
+*/
+uint64_t gpu_suballoc__get_largest_free(const gpu_suballoc_t* a)
+;
@@ -0,0 +1,15 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Inserts a free range at an index of the sorted list.
+*/
+static void insert_block(gpu_suballoc_t* a, uint32_t idx, gpu_suballoc_block_t block)
+;
+
+/**
+Removes the free range at an index of the sorted list.
+*/
+static void remove_block(gpu_suballoc_t* a, uint32_t idx)
+;
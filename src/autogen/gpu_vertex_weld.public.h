@@ -0,0 +1,53 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs a vertex weld with room for a fixed number of corners. The hash
+table is sized for the worst case of every corner being unique, so adding
+never reallocates.
+
+@param w The weld to construct.
+@param vertex_size The size of one vertex in bytes.
+@param max_corners The most corners that will be added.
+*/
+void gpu_vertex_weld__construct(gpu_vertex_weld_t* w, uint32_t vertex_size, uint32_t max_corners)
+;
+
+/**
+Destructs a vertex weld.
+
+@param w The weld to destruct.
+*/
+void gpu_vertex_weld__destruct(gpu_vertex_weld_t* w)
+;
+
+/**
+Adds a face corner. If an identical vertex was added before its index is
+reused, otherwise the vertex is appended.
+
+@param w The weld.
+@param vertex The corner's vertex data, vertex_size bytes.
+@return The vertex index of the corner.
+*/
+uint32_t gpu_vertex_weld__add(gpu_vertex_weld_t* w, const void* vertex)
+;
+
+/**
+Gets the size of one index in bytes: 2 when every vertex can be addressed
+with 16 bits, 4 otherwise.
+
+@param w The weld.
+@return The index size in bytes.
+*/
+uint32_t gpu_vertex_weld__get_index_size(const gpu_vertex_weld_t* w)
+;
+
+/**
+Copies the indices packed at the size from gpu_vertex_weld__get_index_size.
+
+@param w The weld.
+@param dest Receives num_indices indices.
+*/
+void gpu_vertex_weld__copy_indices(const gpu_vertex_weld_t* w, void* dest)
+;
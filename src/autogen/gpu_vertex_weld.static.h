@@ -2,8 +2,8 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-static void create_picker_render_pass(_vlk_dev_t* dev)
-;
-
-static void destroy_picker_render_pass(_vlk_dev_t* dev)
+/**
+FNV-1a hash of the vertex bytes.
+*/
+static uint32_t hash_vertex(const void* vertex, uint32_t size)
 ;
@@ -14,6 +14,13 @@ void jetz__init_app_intf(app_intf_t* intf)
 void jetz__run_frame(app_t* app)
 ;
 
+/**
+Sets how many times per second the simulation is stepped. Rendering runs
+at the platform's frame rate and blends between ticks.
+*/
+void jetz__set_tick_rate(app_t* app, uint32_t ticks_per_second)
+;
+
 boolean jetz__should_exit(app_t* app)
 ;
 
@@ -0,0 +1,37 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Adds the game systems to the scheduler.
+*/
+static void add_systems(_jetz_t* j)
+;
+
+/**
+Moves the camera behind the player.
+*/
+static void run_camera_system(ecs_t* ecs, void* context)
+;
+
+/**
+Updates the broadphase. Reads the dirty flags, so it must run before the
+transform system clears them.
+*/
+static void run_collision_system(ecs_t* ecs, void* context)
+;
+
+static void run_physics_system(ecs_t* ecs, void* context)
+;
+
+static void run_player_system(ecs_t* ecs, void* context)
+;
+
+/**
+Records the frame. Runs on the main thread since it uses the GPU.
+*/
+static void run_render_system(ecs_t* ecs, void* context)
+;
+
+static void run_transform_system(ecs_t* ecs, void* context)
+;
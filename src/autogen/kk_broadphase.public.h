@@ -0,0 +1,108 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty broadphase.
+
+@param bp The broadphase to construct.
+*/
+void kk_broadphase__construct(kk_broadphase_t* bp)
+;
+
+/**
+Destructs a broadphase.
+
+@param bp The broadphase to destruct.
+*/
+void kk_broadphase__destruct(kk_broadphase_t* bp)
+;
+
+/**
+Adds a proxy.
+
+@param bp The broadphase.
+@param box The proxy's bounds.
+@param user_data Value reported in pairs, usually an entity id.
+@param is_static Static proxies are never queried for pairs, so two static proxies never pair.
+@return The proxy.
+*/
+uint32_t kk_broadphase__add(kk_broadphase_t* bp, kk_aabb_t* box, uint32_t user_data, boolean is_static)
+;
+
+/**
+Gets the height of the tree. A leaf has height 0.
+*/
+int32_t kk_broadphase__get_height(kk_broadphase_t* bp)
+;
+
+uint32_t kk_broadphase__get_user_data(kk_broadphase_t* bp, uint32_t proxy)
+;
+
+boolean kk_broadphase__is_static(kk_broadphase_t* bp, uint32_t proxy)
+;
+
+/**
+Updates a proxy's bounds. The tree is only changed if the new box is not
+inside the proxy's fat box.
+
+@param bp The broadphase.
+@param proxy The proxy.
+@param box The new bounds.
+@return TRUE if the proxy was reinserted.
+*/
+boolean kk_broadphase__move(kk_broadphase_t* bp, uint32_t proxy, kk_aabb_t* box)
+;
+
+/**
+Calls a function for each proxy whose fat box overlaps a box.
+
+@param bp The broadphase.
+@param box The box to test.
+@param func Called for each overlapping proxy. Return FALSE to stop.
+@param data User data passed to func.
+*/
+void kk_broadphase__query(kk_broadphase_t* bp, kk_aabb_t* box, kk_broadphase_query_func func, void* data)
+;
+
+/**
+Calls a function for each proxy whose fat box a ray hits. The function can
+clip the ray, which skips the parts of the tree past the closest hit.
+
+@param bp The broadphase.
+@param ray The ray to test.
+@param func Called for each proxy the ray hits.
+@param data User data passed to func.
+*/
+void kk_broadphase__raycast(kk_broadphase_t* bp, kk_ray_t* ray, kk_broadphase_ray_func func, void* data)
+;
+
+/**
+Removes a proxy.
+
+@param bp The broadphase.
+@param proxy The proxy to remove.
+*/
+void kk_broadphase__remove(kk_broadphase_t* bp, uint32_t proxy)
+;
+
+/**
+Changes whether a proxy is queried for pairs. Sleeping bodies are made
+static so they stop pairing with each other but still pair with anything
+that moves into them.
+
+@param bp The broadphase.
+@param proxy The proxy.
+@param is_static Should the proxy be static.
+*/
+void kk_broadphase__set_static(kk_broadphase_t* bp, uint32_t proxy, boolean is_static)
+;
+
+/**
+Finds every pair of proxies with overlapping fat boxes where at least one
+proxy is dynamic. Pairs are sorted by user data.
+
+@param bp The broadphase.
+*/
+void kk_broadphase__update_pairs(kk_broadphase_t* bp)
+;
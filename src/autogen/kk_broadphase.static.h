@@ -0,0 +1,71 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Query callback that records a pair with the querying proxy.
+*/
+static boolean add_pair(void* data, uint32_t proxy)
+;
+
+/**
+Takes a node from the free list, growing the node array if needed.
+Invalidates node pointers.
+*/
+static uint32_t allocate_node(kk_broadphase_t* bp)
+;
+
+/**
+Rotates the subtree at node a if its children's heights differ by more than
+one. Returns the new root of the subtree.
+*/
+static uint32_t balance(kk_broadphase_t* bp, uint32_t ia)
+;
+
+static int compare_pairs(const void* a, const void* b)
+;
+
+static void fatten(kk_aabb_t* box, kk_aabb_t* out__fat)
+;
+
+static void free_node(kk_broadphase_t* bp, uint32_t idx)
+;
+
+/**
+Surface area of a box. Used as the cost of a node since it is proportional
+to the chance of a random ray or box hitting it.
+*/
+static float get_area(kk_aabb_t* box)
+;
+
+/**
+Inserts a leaf next to the sibling that adds the least area to the tree.
+*/
+static void insert_leaf(kk_broadphase_t* bp, uint32_t leaf)
+;
+
+/**
+Cost of descending into a child to insert a leaf.
+*/
+static float get_descend_cost(kk_broadphase_t* bp, uint32_t child, kk_aabb_t* leaf_box)
+;
+
+/**
+Walks from a node to the root, balancing and updating bounds and heights.
+*/
+static void refit(kk_broadphase_t* bp, uint32_t idx)
+;
+
+/**
+Detaches a leaf from the tree. Its parent is freed and the sibling takes the
+parent's place.
+*/
+static void remove_leaf(kk_broadphase_t* bp, uint32_t leaf)
+;
+
+/**
+Points a parent at a new child in place of an old one. A null parent means
+the new child becomes the root.
+*/
+static void replace_child(kk_broadphase_t* bp, uint32_t parent, uint32_t old_child, uint32_t new_child)
+;
@@ -0,0 +1,59 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Builds a tree over an indexed triangle mesh. The mesh is copied, so it can
+be freed afterwards.
+
+@param bvh The tree to construct.
+@param positions Vertex positions, three floats each.
+@param indices Vertex indices, three per triangle.
+@param num_triangles The number of triangles.
+*/
+void kk_bvh__construct(kk_bvh_t* bvh, const float* positions, const uint32_t* indices, uint32_t num_triangles)
+;
+
+/**
+Destructs a tree.
+
+@param bvh The tree to destruct.
+*/
+void kk_bvh__destruct(kk_bvh_t* bvh)
+;
+
+/**
+Checks if any triangle overlaps a box.
+
+@param bvh The tree.
+@param m Places the mesh in the space of the box.
+@param box The box.
+@return TRUE if a triangle overlaps the box.
+*/
+boolean kk_bvh__overlap_aabb(kk_bvh_t* bvh, kk_mat4_t* m, kk_aabb_t* box)
+;
+
+/**
+Checks if any triangle overlaps a sphere.
+
+@param bvh The tree.
+@param m Places the mesh in the space of the sphere.
+@param center The center of the sphere.
+@param radius The radius of the sphere.
+@return TRUE if a triangle overlaps the sphere.
+*/
+boolean kk_bvh__overlap_sphere(kk_bvh_t* bvh, kk_mat4_t* m, kk_vec3_t* center, float radius)
+;
+
+/**
+Finds the closest triangle a ray hits. Children are visited nearest first
+and anything past the closest hit so far is skipped. Triangles are hit from
+either side.
+
+@param bvh The tree.
+@param ray The ray, in the mesh's space.
+@param out__hit The closest hit.
+@return TRUE if the ray hit a triangle.
+*/
+boolean kk_bvh__raycast(kk_bvh_t* bvh, kk_ray_t* ray, kk_bvh_hit_t* out__hit)
+;
@@ -0,0 +1,54 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Builds the node for a range of references and everything below it. Splits
+on the axis and bin boundary with the lowest surface area cost, ordering the
+references so each child owns a contiguous range.
+*/
+static uint32_t build_node(kk_bvh_t* bvh, build_ref_t* refs, uint32_t begin, uint32_t end, uint32_t depth)
+;
+
+/**
+Finds the point on a triangle closest to a point.
+*/
+static void closest_point_on_triangle(kk_vec3_t* v, kk_vec3_t* p, kk_vec3_t* out__point)
+;
+
+/**
+Surface area of a box, the cost of visiting a node.
+*/
+static float get_area(kk_aabb_t* box)
+;
+
+/**
+Gets the bin a reference's centroid falls in along an axis.
+*/
+static uint32_t get_bin(build_ref_t* ref, uint32_t axis, float cmin, float extent)
+;
+
+/**
+Gets the unit normal of a triangle, facing against a direction.
+*/
+static void get_normal(kk_vec3_t* v, kk_vec3_t* dir, kk_vec3_t* out__normal)
+;
+
+/**
+Separating axis test between a triangle and a box. The axes are the box
+faces, the triangle's plane and the cross products of their edges.
+*/
+static boolean overlap_triangle_box(kk_vec3_t* v, kk_aabb_t* box)
+;
+
+/**
+Moller-Trumbore ray/triangle test. Hits either side.
+*/
+static boolean raycast_triangle(kk_bvh_triangle_t* tri, kk_ray_t* ray, float* out__t)
+;
+
+/**
+Transforms a triangle's vertices by a matrix.
+*/
+static void transform_triangle(kk_bvh_triangle_t* tri, kk_mat4_t* m, kk_vec3_t* out__v)
+;
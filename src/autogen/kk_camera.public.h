@@ -26,6 +26,20 @@ Gets a view matrix for the current camera state.
 //void kk_camera__get_view_matrix(kk_camera_t* cam, mat4_t* output)
 //;
 
+/**
+Gets the world space ray through a point on the screen, from the camera to
+the far plane. Used to pick what is under the mouse.
+
+@param cam The camera.
+@param x The x position in pixels, from the left.
+@param y The y position in pixels, from the top.
+@param width The width of the screen in pixels.
+@param height The height of the screen in pixels.
+@param out__ray The ray. Its direction is normalized.
+*/
+void kk_camera__get_ray(kk_camera_t* cam, float x, float y, float width, float height, kk_ray_t* out__ray)
+;
+
 /**
 Moves the camera forward or backward on the current view vector.
 */
@@ -44,3 +58,33 @@ void kk_camera__rot_x(kk_camera_t* cam, float delta_x)
 
 void kk_camera__rot_y(kk_camera_t* cam, float delta_y)
 ;
+
+/**
+Sets the aspect ratio of the view. Only marks the cache dirty if it changed.
+
+@param cam The camera.
+@param aspect Width over height.
+*/
+void kk_camera__set_aspect(kk_camera_t* cam, float aspect)
+;
+
+/**
+Places the camera and marks the cache dirty. Use this instead of writing the
+pose fields directly, otherwise kk_camera__update keeps the old matrices.
+
+@param cam The camera.
+@param pos The camera position.
+@param dir The view direction. Does not need to be normalized.
+@param up The up vector.
+*/
+void kk_camera__set_pose(kk_camera_t* cam, const kk_vec3_t* pos, const kk_vec3_t* dir, const kk_vec3_t* up)
+;
+
+/**
+Rebuilds the cached matrices and frustum if the camera changed since the
+last update.
+
+@param cam The camera.
+*/
+void kk_camera__update(kk_camera_t* cam)
+;
@@ -0,0 +1,71 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty set of contacts.
+
+@param contacts The contacts to construct.
+*/
+void kk_contacts__construct(kk_contacts_t* contacts)
+;
+
+/**
+Destructs a set of contacts.
+
+@param contacts The contacts to destruct.
+*/
+void kk_contacts__destruct(kk_contacts_t* contacts)
+;
+
+/**
+Applies contact impulses to the bodies. Accumulated impulses from the last
+step are applied first, then every point is solved in turn for
+KK_CONTACTS_ITERATIONS passes. Impulses change the bodies' momentum and
+angular momentum directly. Velocity and spin are then refreshed so the next
+integration step uses the result.
+
+@param contacts The contacts. Must be updated for the current step.
+@param bodies The bodies the contacts were synced with.
+@param delta_time The step length in seconds.
+*/
+void kk_contacts__solve(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, float delta_time)
+;
+
+/**
+Matches manifolds to the broadphase pairs. Manifolds for pairs that still
+exist keep their points, new pairs get an empty manifold and the rest are
+freed. Pairs without a body on either side are skipped. Call once per frame
+after gathering the bodies.
+
+@param contacts The contacts.
+@param ecs The ECS context the pairs refer to.
+@param bodies The bodies gathered for this frame.
+@param broadphase The broadphase with up to date pairs.
+*/
+void kk_contacts__sync(kk_contacts_t* contacts, ecs_t* ecs, kk_physics_bodies_t* bodies, kk_broadphase_t* broadphase)
+;
+
+/**
+Updates every manifold for the bodies' current pose.
+
+@param contacts The contacts.
+@param bodies The bodies the contacts were synced with.
+*/
+void kk_contacts__update(kk_contacts_t* contacts, kk_physics_bodies_t* bodies)
+;
+
+/**
+Updates a range of manifolds for the bodies' current pose. Points that
+separated or slid apart are dropped, then the shapes are tested and the
+new point is merged into the manifold. A new point close to an existing one
+replaces it and keeps its accumulated impulses. Ranges that do not overlap
+may be updated concurrently.
+
+@param contacts The contacts.
+@param bodies The bodies the contacts were synced with.
+@param start The first manifold to update.
+@param end One past the last manifold to update.
+*/
+void kk_contacts__update_range(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, uint32_t start, uint32_t end)
+;
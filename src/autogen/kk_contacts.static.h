@@ -0,0 +1,158 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Merges a new contact into a manifold.
+*/
+static void add_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, kk_narrowphase_contact_t* contact)
+;
+
+/**
+Gets a free manifold slot, growing the point arrays if needed.
+*/
+static uint32_t alloc_slot(kk_contacts_t* contacts)
+;
+
+/**
+Applies an impulse to a body at an offset from its center.
+*/
+static void apply_impulse(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* r, kk_vec3_t* impulse)
+;
+
+/**
+Maps each gathered body's entity id to its index.
+*/
+static void build_body_map(kk_contacts_t* contacts, kk_physics_bodies_t* bodies)
+;
+
+/**
+Builds a body's shape matrix from its current pose. Matches
+ecs_transform__get_local_matrix.
+*/
+static void build_body_matrix(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* scale, kk_mat4_t* out__m)
+;
+
+/**
+Orders a manifold against a broadphase pair.
+*/
+static int compare_key(kk_contact_manifold_t* m, kk_broadphase_pair_t* pair)
+;
+
+/**
+Copies the persistent state of one point to another.
+*/
+static void copy_point(kk_contacts_t* contacts, uint32_t dst, uint32_t src)
+;
+
+/**
+Gets the body index of an entity.
+*/
+static uint32_t get_body(kk_contacts_t* contacts, entity_id_t ent)
+;
+
+/**
+Gets the center of mass of a body. Static sides use the origin.
+*/
+static void get_center(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* out__center)
+;
+
+/**
+Gets the effective mass of a pair of bodies along a direction at a contact.
+*/
+static float get_effective_mass(kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, kk_vec3_t* r_a, kk_vec3_t* r_b, kk_vec3_t* dir)
+;
+
+/**
+Reads a vector from a set of component arrays.
+*/
+static void get_point(float** arrays, uint32_t idx, kk_vec3_t* out__v)
+;
+
+/**
+Gets the velocity of a point on a body.
+*/
+static void get_point_velocity(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* r, kk_vec3_t* out__vel)
+;
+
+/**
+Picks the point to replace in a full manifold. Keeps the deepest point and
+maximizes the area of the remaining four.
+*/
+static uint32_t get_replace_index(kk_contacts_t* contacts, kk_contact_manifold_t* m, kk_vec3_t* new_point, float new_depth)
+;
+
+/**
+Builds an orthonormal tangent basis for a normal.
+*/
+static void get_tangents(kk_vec3_t* n, kk_vec3_t* out__t1, kk_vec3_t* out__t2)
+;
+
+/**
+Grows the point arrays to hold more manifold slots. Existing points are kept.
+*/
+static void grow(kk_contacts_t* contacts, uint32_t num_slots)
+;
+
+/**
+Computes the per-step state of a point and applies its accumulated impulses.
+*/
+static void prepare_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, uint32_t idx, float inv_dt)
+;
+
+/**
+Drops points that have separated or slid apart and updates the depth of
+the rest.
+*/
+static void refresh_points(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m)
+;
+
+/**
+Rotates a vector by a body's orientation, or its inverse.
+*/
+static void rotate(kk_physics_bodies_t* bodies, uint32_t body, float sign, kk_vec3_t* v, kk_vec3_t* out__v)
+;
+
+/**
+Writes a vector to a set of component arrays.
+*/
+static void set_point(float** arrays, uint32_t idx, kk_vec3_t* v)
+;
+
+/**
+Fills in the bodies, shapes and static matrices of a manifold. Returns FALSE
+if the pair is no longer valid.
+*/
+static boolean setup_manifold(kk_contacts_t* contacts, ecs_t* ecs, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m)
+;
+
+/**
+Gets the shape of one side of a pair, and either its scale or its world
+matrix if it is static.
+*/
+static boolean setup_side(ecs_t* ecs, entity_id_t ent, uint32_t body, kk_shape_t** out__shape, kk_vec3_t* out__scale, kk_mat4_t* out__world)
+;
+
+/**
+Solves friction and then non-penetration for one point.
+*/
+static void solve_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, uint32_t idx)
+;
+
+/**
+Takes a world point into a body's frame. Static sides stay in world space.
+*/
+static void to_local(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* p, kk_vec3_t* out__p)
+;
+
+/**
+Takes a point in a body's frame to world space.
+*/
+static void to_world(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* p, kk_vec3_t* out__p)
+;
+
+/**
+Refreshes a body's velocity, angular velocity and spin from its momentum.
+*/
+static void update_velocity(kk_physics_bodies_t* bodies, uint32_t body)
+;
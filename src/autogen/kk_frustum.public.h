@@ -0,0 +1,52 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Culls a batch of spheres stored as separate arrays. Groups of
+KK_FRUSTUM_WIDTH spheres are tested with SIMD and any remainder one at a
+time. Gives the same results as kk_frustum__test_sphere.
+
+@param f The frustum.
+@param x The sphere centers' x components.
+@param y The sphere centers' y components.
+@param z The sphere centers' z components.
+@param r The sphere radii.
+@param count The number of spheres.
+@param out__visible Filled with the indices of the spheres that may be visible, in order. Must hold count indices.
+@return The number of spheres that may be visible.
+*/
+uint32_t kk_frustum__cull_spheres
+	(
+	kk_frustum_t*			f,
+	const float*			x,
+	const float*			y,
+	const float*			z,
+	const float*			r,
+	uint32_t				count,
+	uint32_t*				out__visible
+	)
+;
+
+/**
+Extracts the planes from a view projection matrix. The planes are in the
+space the matrix transforms from, so a view projection matrix gives world
+space planes. Clip depth is taken as -w to w, which also holds every point
+of a 0 to w projection.
+
+@param f The frustum to set.
+@param m The view projection matrix.
+*/
+void kk_frustum__from_matrix(kk_frustum_t* f, kk_mat4_t* m)
+;
+
+/**
+Tests whether a sphere may be inside the frustum. Spheres near a corner
+that are outside two planes but not fully outside either are kept.
+
+@param f The frustum.
+@param sphere The sphere, in the same space as the planes.
+@return TRUE if the sphere may be visible.
+*/
+boolean kk_frustum__test_sphere(kk_frustum_t* f, kk_sphere_t* sphere)
+;
@@ -0,0 +1,10 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Gets one column's term of a plane. Each plane is the matrix's last row plus
+or minus one of the others.
+*/
+static float get_plane_term(kk_vec4_t* col, int plane)
+;
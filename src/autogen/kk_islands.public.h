@@ -0,0 +1,47 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty set of islands.
+
+@param islands The islands to construct.
+*/
+void kk_islands__construct(kk_islands_t* islands)
+;
+
+/**
+Destructs a set of islands.
+
+@param islands The islands to destruct.
+*/
+void kk_islands__destruct(kk_islands_t* islands)
+;
+
+/**
+Puts islands to sleep once every body in them has been still for
+KK_ISLANDS_SLEEP_TICKS. Call after the bodies are integrated and scattered,
+with the islands from the same frame's wake. Sleeping bodies have their
+motion cleared and stop blending between ticks.
+
+@param islands The islands.
+@param bodies The bodies that were simulated.
+@param num_steps The number of steps the bodies were simulated for.
+*/
+void kk_islands__sleep(kk_islands_t* islands, kk_physics_bodies_t* bodies, uint32_t num_steps)
+;
+
+/**
+Builds the islands from the broadphase pairs and wakes every sleeping body
+in an island that has an awake body. Sleeping bodies don't pair with each
+other, so they are kept with the island they fell asleep in. A sleeping body
+is also woken when something writes to it, seen as a dirty transform or
+motion set since it went to sleep. Call before the bodies are gathered.
+
+@param islands The islands.
+@param ecs The ECS context.
+@param query The physics bodies. Must require physics and transform components.
+@param broadphase The broadphase with the pairs from the last collision update.
+*/
+void kk_islands__wake(kk_islands_t* islands, ecs_t* ecs, ecs_query_t* query, kk_broadphase_t* broadphase)
+;
@@ -0,0 +1,29 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Finds the root of an entity's island, halving the path on the way.
+*/
+static uint32_t find(kk_islands_t* islands, uint32_t ent)
+;
+
+/**
+Clears a body's motion and marks it asleep in an island. The previous pose
+is matched to the current one so the transform stops blending.
+*/
+static void put_to_sleep(ecs_physics_t* phys, ecs_transform_t* transform, uint32_t island)
+;
+
+/**
+Merges the islands of two entities.
+*/
+static void unite(kk_islands_t* islands, uint32_t a, uint32_t b)
+;
+
+/**
+Checks if anything wrote to a sleeping body. Sleep clears its motion and the
+transform isn't touched by physics while it sleeps.
+*/
+static boolean was_written(ecs_physics_t* phys, ecs_transform_t* transform)
+;
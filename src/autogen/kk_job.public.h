@@ -0,0 +1,76 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs a job system. The calling thread becomes worker 0 and must be the
+thread that later waits on jobs from outside of a job.
+
+@param sys The job system to construct.
+@param num_threads Number of workers including the calling thread. 0 uses one per core. Always 1 on the PSP.
+*/
+void kk_job__construct(kk_job_system_t* sys, uint32_t num_threads)
+;
+
+/**
+Destructs a job system. Waits for the worker threads to exit. Jobs still
+queued are discarded.
+
+@param sys The job system to destruct.
+*/
+void kk_job__destruct(kk_job_system_t* sys)
+;
+
+/**
+Gets the index of the calling thread's worker. 0 is the thread that
+constructed the job system. Only meaningful on threads of the job system.
+*/
+uint32_t kk_job__get_thread_index()
+;
+
+/**
+Runs func over [0, count) split into ranges of grain indices. The calling
+thread runs the first range itself and helps with the others until all of
+them are done. Ranges run concurrently, so func must only write to data owned
+by its range.
+
+@param sys The job system.
+@param count Number of indices.
+@param grain Indices per range. 0 picks a size that gives each thread a few ranges.
+@param func The function to run on each range.
+@param data User data passed to func.
+*/
+void kk_job__parallel_for(kk_job_system_t* sys, uint32_t count, uint32_t grain, kk_job_func func, void* data)
+;
+
+/**
+Submits a job. The job is copied, so it can be a local. On the PSP the job
+runs before this returns.
+
+@param sys The job system.
+@param job The job to run.
+*/
+void kk_job__run(kk_job_system_t* sys, const kk_job_t* job)
+;
+
+/**
+Submits a job that will not start until a counter reaches zero. The job's own
+counter is incremented immediately, so waiting on it also waits for the
+dependency.
+
+@param sys The job system.
+@param job The job to run.
+@param dependency The counter to wait for.
+*/
+void kk_job__run_after(kk_job_system_t* sys, const kk_job_t* job, kk_job_counter_t* dependency)
+;
+
+/**
+Waits until a counter reaches zero. The calling thread runs queued jobs while
+it waits.
+
+@param sys The job system.
+@param counter The counter to wait on.
+*/
+void kk_job__wait(kk_job_system_t* sys, kk_job_counter_t* counter)
+;
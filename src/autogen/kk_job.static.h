@@ -0,0 +1,56 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Takes the job from the bottom of a deque. Only the owning thread may pop.
+*/
+static boolean deque_pop(kk_job_deque_t* dq, kk_job_t* job)
+;
+
+/**
+Adds a job to the bottom of a deque. Only the owning thread may push.
+@return FALSE if the deque is full.
+*/
+static boolean deque_push(kk_job_deque_t* dq, const kk_job_t* job)
+;
+
+/**
+Takes the job from the top of another thread's deque.
+*/
+static boolean deque_steal(kk_job_deque_t* dq, kk_job_t* job)
+;
+
+/**
+Runs a job and signals its counter.
+*/
+static void execute(kk_job_system_t* sys, const kk_job_t* job)
+;
+
+/**
+Spins until the counter's continuation list is acquired.
+*/
+static void lock_counter(kk_job_counter_t* counter)
+;
+
+/**
+Runs one queued job, preferring the calling thread's own deque and stealing
+from the other threads if it is empty.
+@return TRUE if a job was run.
+*/
+static boolean run_one(kk_job_system_t* sys)
+;
+
+/**
+Queues a job on the calling thread's deque. Runs it inline if there is only
+one thread or the deque is full.
+*/
+static void submit(kk_job_system_t* sys, const kk_job_t* job)
+;
+
+/**
+Main loop of a worker thread. Runs jobs until the system stops, sleeping when
+there is nothing to do.
+*/
+static void worker_loop(kk_job_system_t* sys)
+;
@@ -0,0 +1,21 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Finds the deepest point of contact between two shapes. Pairs of spheres and
+sphere-box pairs are solved directly. Every other pair uses Minkowski Portal
+Refinement on the shapes' support functions, so each call finds a single
+point. Callers build up a full manifold over several steps.
+
+Sphere radii are scaled by the largest axis scale of their matrix.
+
+@param a The first shape.
+@param ma World matrix of the first shape.
+@param b The second shape.
+@param mb World matrix of the second shape.
+@param out__contact The contact. Only written if the shapes overlap.
+@return TRUE if the shapes overlap.
+*/
+boolean kk_narrowphase__collide(kk_shape_t* a, kk_mat4_t* ma, kk_shape_t* b, kk_mat4_t* mb, kk_narrowphase_contact_t* out__contact)
+;
@@ -0,0 +1,82 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Finds the point of a triangle closest to the origin.
+*/
+static void closest_to_origin(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* c, kk_vec3_t* out__point)
+;
+
+/**
+Box against sphere. The normal points from the box to the sphere.
+*/
+static boolean collide_box_sphere(posed_shape_t* box, posed_shape_t* sphere, kk_narrowphase_contact_t* out__contact)
+;
+
+/**
+Minkowski Portal Refinement. Finds a portal triangle on the boundary of
+A - B that the ray from an interior point to the origin passes through,
+refines it until it contains the origin, then pushes it out to the boundary
+for the penetration depth.
+*/
+static boolean collide_mpr(posed_shape_t* a, posed_shape_t* b, kk_narrowphase_contact_t* out__contact)
+;
+
+/**
+Sphere against sphere.
+*/
+static boolean collide_spheres(posed_shape_t* a, posed_shape_t* b, kk_narrowphase_contact_t* out__contact)
+;
+
+/**
+Replaces one portal point with a new support point so the portal stays on
+the ray from v0 to the origin.
+*/
+static void expand_portal(mpr_point_t* v0, mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, mpr_point_t* v4)
+;
+
+/**
+Finds where the origin maps onto A and B using its barycentric coordinates
+in the tetrahedron v0, v1, v2, v3. Returns the midpoint of the two.
+*/
+static void find_position(mpr_point_t* v0, mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, kk_vec3_t* dir, kk_vec3_t* out__pos)
+;
+
+/**
+Gets the largest scale along any of a matrix's axes.
+*/
+static float get_max_scale(kk_mat4_t* m)
+;
+
+/**
+Gets the outward normal of the portal triangle.
+*/
+static void get_portal_dir(mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, kk_vec3_t* out__dir)
+;
+
+/**
+Gets the support point of A - B in a direction.
+*/
+static void mpr_support(posed_shape_t* a, posed_shape_t* b, kk_vec3_t* dir, mpr_point_t* out__point)
+;
+
+/**
+Checks if a new support point is too close to the portal to refine further.
+*/
+static boolean reached_tolerance(mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, mpr_point_t* v4, kk_vec3_t* dir)
+;
+
+/**
+Gets the world space support point of a posed shape. The direction is taken
+into model space with the transpose of the matrix, which is exact for any
+affine matrix.
+*/
+static void support(posed_shape_t* p, kk_vec3_t* dir, kk_vec3_t* out__point)
+;
+
+/**
+Transforms a point by an affine matrix.
+*/
+static void transform_point(kk_mat4_t* m, kk_vec3_t* p, kk_vec3_t* out__point)
+;
@@ -0,0 +1,97 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs an empty set of bodies.
+
+@param bodies The bodies to construct.
+*/
+void kk_physics_bodies__construct(kk_physics_bodies_t* bodies)
+;
+
+/**
+Destructs a set of bodies.
+
+@param bodies The bodies to destruct.
+*/
+void kk_physics_bodies__destruct(kk_physics_bodies_t* bodies)
+;
+
+/**
+Copies body state from the components matched by a query into the arrays.
+The query must require both the physics and transform components. Sleeping
+bodies are skipped.
+
+@param bodies The bodies.
+@param ecs The ECS context.
+@param query The query to gather.
+*/
+void kk_physics_bodies__gather(kk_physics_bodies_t* bodies, ecs_t* ecs, ecs_query_t* query)
+;
+
+/**
+Integrates all bodies using the widest SIMD path available.
+
+@param bodies The bodies.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate(kk_physics_bodies_t* bodies, float delta_time)
+;
+
+/**
+Integrates a range of bodies. Groups of KK_PHYSICS_BODIES_WIDTH bodies are
+integrated with SIMD and any remainder with the scalar path. Ranges that do
+not overlap may be integrated concurrently.
+
+@param bodies The bodies.
+@param start The first body to integrate.
+@param end One past the last body to integrate.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate_range(kk_physics_bodies_t* bodies, uint32_t start, uint32_t end, float delta_time)
+;
+
+/**
+Integrates all bodies one at a time without SIMD. Produces the same results
+as kk_physics_bodies__integrate within floating point rounding.
+
+@param bodies The bodies.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate_scalar(kk_physics_bodies_t* bodies, float delta_time)
+;
+
+/**
+Ensures the arrays can hold the specified number of bodies. Existing body
+state is discarded if the arrays need to grow.
+
+@param bodies The bodies.
+@param count The number of bodies required.
+*/
+void kk_physics_bodies__reserve(kk_physics_bodies_t* bodies, uint32_t count)
+;
+
+/**
+Saves the current position and orientation of a range of bodies as the
+previous state. Call before the last step of a tick so rendering can blend
+from it. Ranges that do not overlap may be saved concurrently.
+
+@param bodies The bodies.
+@param start The first body to save.
+@param end One past the last body to save.
+*/
+void kk_physics_bodies__save_previous_range(kk_physics_bodies_t* bodies, uint32_t start, uint32_t end)
+;
+
+/**
+Copies integrated body state back to the source components and marks the
+transforms dirty. Momentum is copied too since contacts change it. The
+state from before the last step is copied to the transforms' previous pose
+for interpolation.
+
+@param bodies The bodies.
+@param ecs The ECS context the bodies were gathered from.
+*/
+void kk_physics_bodies__scatter(kk_physics_bodies_t* bodies, ecs_t* ecs)
+;
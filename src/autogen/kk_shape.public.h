@@ -0,0 +1,54 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Constructs a box shape.
+
+@param shape The shape to construct.
+@param center The center of the box.
+@param half_extents Half the size of the box on each axis.
+*/
+void kk_shape__construct_box(kk_shape_t* shape, kk_vec3_t* center, kk_vec3_t* half_extents)
+;
+
+/**
+Constructs a shape that encloses a set of points. Points on the corners of
+their bounds become a box, points about the same distance from their center
+become a sphere and anything else becomes a convex hull of the unique
+points. Point sets too large for a hull fall back to their box.
+
+@param shape The shape to construct.
+@param points Packed x, y, z positions.
+@param count The number of points.
+*/
+void kk_shape__construct_from_points(kk_shape_t* shape, const float* points, uint32_t count)
+;
+
+/**
+Constructs a sphere shape.
+
+@param shape The shape to construct.
+@param center The center of the sphere.
+@param radius The radius of the sphere.
+*/
+void kk_shape__construct_sphere(kk_shape_t* shape, kk_vec3_t* center, float radius)
+;
+
+/**
+Destructs a shape.
+
+@param shape The shape to destruct.
+*/
+void kk_shape__destruct(kk_shape_t* shape)
+;
+
+/**
+Finds the point of a shape furthest in a direction, in model space.
+
+@param shape The shape.
+@param dir The direction. Does not need to be normalized.
+@param out__point The support point.
+*/
+void kk_shape__support(kk_shape_t* shape, kk_vec3_t* dir, kk_vec3_t* out__point)
+;
@@ -0,0 +1,31 @@
+/*=========================================================
+This file is automatically generated. Do not edit manually.
+=========================================================*/
+
+/**
+Copies the unique points into the shape as a hull. Falls back to the box the
+shape was constructed as when there are too many.
+*/
+static void build_hull(kk_shape_t* shape, const float* points, uint32_t count)
+;
+
+/**
+Orders points by x, then y, then z.
+*/
+static int compare_points(const void* a, const void* b)
+;
+
+/**
+Checks if the points are exactly the corners of the bounds. Flat axes only
+have one side, so a quad needs four corners and a full box needs eight.
+*/
+static boolean is_box(const float* points, uint32_t count, kk_vec3_t* min_pt, kk_vec3_t* max_pt)
+;
+
+/**
+Checks if the points sit on a sphere around the center of their bounds. The
+bounds must be about a cube and every point about the same distance from
+the center.
+*/
+static boolean is_sphere(const float* points, uint32_t count, kk_vec3_t* center, kk_vec3_t* half, float* out__radius)
+;
@@ -20,3 +20,47 @@ void kk_world__destruct(kk_world_t* world)
 
 void kk_world__export_lua(kk_world_t* world, const char* filename)
 ;
+
+/**
+Finds the colliders whose triangles overlap a box.
+
+@param world The world.
+@param box The box, in world space.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void kk_world__overlap_aabb(kk_world_t* world, kk_aabb_t* box, utl_array_t(uint32_t)* out__entities)
+;
+
+/**
+Finds the colliders whose triangles overlap a sphere.
+
+@param world The world.
+@param center The center of the sphere, in world space.
+@param radius The radius of the sphere.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void kk_world__overlap_sphere(kk_world_t* world, kk_vec3_t* center, float radius, utl_array_t(uint32_t)* out__entities)
+;
+
+/**
+Finds the closest collider a ray hits. Colliders are tested against their
+model's triangles, as of the last collision system update.
+
+@param world The world.
+@param ray The ray, in world space.
+@param out__hit The closest hit. Its entity is ECS_INVALID_ID if there is none.
+@return TRUE if the ray hit a collider.
+*/
+boolean kk_world__raycast(kk_world_t* world, kk_ray_t* ray, collision_system_hit_t* out__hit)
+;
+
+/**
+Casts a batch of rays across the job system's threads.
+
+@param world The world.
+@param rays The rays, in world space.
+@param count The number of rays.
+@param out__hits The closest hit for each ray.
+*/
+void kk_world__raycast_batch(kk_world_t* world, kk_ray_t* rays, uint32_t count, collision_system_hit_t* out__hits)
+;
@@ -19,6 +19,10 @@ static void log_to_file(kk_log_t* log, const char* msg)
 static float platform_get_delta_time(platform_t* platform)
 ;
 
+/** Platform callback to get the current time in seconds. */
+static double platform_get_time(platform_t* platform)
+;
+
 /** Loads a file. */
 static boolean platform_load_file(const char* filename, boolean binary, long* out__size, void** out__buffer)
 ;
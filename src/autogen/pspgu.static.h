@@ -61,6 +61,17 @@ static void pspgu_static_model__destruct(gpu_static_model_t* model, gpu_t* gpu)
 static void pspgu_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, ecs_transform_t* transform)
 ;
 
+static void pspgu_static_model__render_batch(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count)
+;
+
+/**
+Gets the length of each mesh's run in a model's sorted draws when every
+mesh was queued for the same instances in the same order, which is the
+usual case. Otherwise returns count, so the draws are used in sorted order.
+*/
+static uint32_t get_instance_run_length(gpu_render_draw_t* draws, uint32_t count)
+;
+
 static void pspgu_texture__construct(gpu_texture_t* texture, gpu_t* gpu, void* img, int width, int height)
 ;
 
@@ -7,7 +7,8 @@ void _pspgu_static_mesh__construct
 	_pspgu_static_mesh_t*		mesh,
 	_pspgu_t*					ctx,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats
 	)
 ;
 
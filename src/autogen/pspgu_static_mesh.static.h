@@ -8,6 +8,7 @@ static void load_mesh
 	_pspgu_static_mesh_t*		mesh,
 	_pspgu_t*					ctx,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats
 	)
 ;
@@ -6,7 +6,8 @@ void _pspgu_static_model__construct
 	(
 	_pspgu_static_model_t*		model,
 	_pspgu_t*					ctx,
-	const tinyobj_t*			obj
+	const tinyobj_t*			obj,
+	gpu_mesh_opt_stats_t*		stats
 	)
 ;
 
@@ -3,7 +3,7 @@ This file is automatically generated. Do not edit manually.
 =========================================================*/
 
 /** Initializes the meshes in the model. */
-static void create_meshes(_pspgu_static_model_t* model, _pspgu_t* ctx, const tinyobj_t* obj)
+static void create_meshes(_pspgu_static_model_t* model, _pspgu_t* ctx, const tinyobj_t* obj, gpu_mesh_opt_stats_t* stats)
 ;
 
 /** Destroys the meshes in the model. */
@@ -3,29 +3,27 @@ This file is automatically generated. Do not edit manually.
 =========================================================*/
 
 /**
-Constructs a static mesh.
+Welds and optimizes the vertices of one shape. The caller packs the result
+into the model's geometry and destructs the weld.
 */
-void _vlk_static_mesh__construct
+void _vlk_static_mesh__build
 	(
-	_vlk_static_mesh_t*			mesh,
-	_vlk_dev_t*					device,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats,
+	gpu_vertex_weld_t*			out__weld
 	)
 ;
 
 /**
-Destructs a static mesh.
-*/
-void _vlk_static_mesh__destruct(_vlk_static_mesh_t* mesh)
-;
-
-/**
-Renders a static mesh. The appropriate pipeline must already be bound.
+Renders several instances of a static mesh in one draw. The appropriate
+pipeline, the model's geometry and any instance data must already be bound.
 */
-void _vlk_static_mesh__render
+void _vlk_static_mesh__render_instances
 	(
 	_vlk_static_mesh_t*			mesh,
-	VkCommandBuffer				cmd
+	_vlk_cmd_state_t*			state,
+	uint32_t					instance_count,
+	uint32_t					first_instance
 	)
 ;
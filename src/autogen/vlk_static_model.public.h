@@ -19,29 +19,26 @@ Destructs a static model.
 void vlk_static_model__destruct(gpu_static_model_t* base, gpu_t* gpu)
 ;
 
+_vlk_static_model_t* _vlk_static_model__from_base(gpu_static_model_t* base)
+;
+
 /**
-Renders the model to the picker buffer.
+Renders a static model. The appropriate pipeline must already be bound.
 */
-void vlk_static_model__render_to_picker_buffer
+void _vlk_static_model__render
 	(
-	gpu_static_model_t*		model, 
-	gpu_t*					gpu, 
-	gpu_window_t*			window, 
-	gpu_frame_t*			frame,
-	kk_vec4_t				color,
-	ecs_transform_t*		transform
+	_vlk_static_model_t*		model,
+	_vlk_cmd_state_t*			state
 	)
 ;
 
-_vlk_static_model_t* _vlk_static_model__from_base(gpu_static_model_t* base)
-;
-
 /**
-Renders a static model. The appropriate pipeline must already be bound.
+Binds the geometry arena holding the model's meshes. Every model in the same
+arena shares the binding.
 */
-void _vlk_static_model__render
+void _vlk_static_model__bind_buffers
 	(
 	_vlk_static_model_t*		model,
-	VkCommandBuffer				cmd
+	_vlk_cmd_state_t*			state
 	)
 ;
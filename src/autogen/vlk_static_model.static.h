@@ -5,6 +5,10 @@ This file is automatically generated. Do not edit manually.
 static void create_material_set(_vlk_static_model_t* model, _vlk_dev_t* device)
 ;
 
+/**
+Packs every shape into one range of vertices and one range of indices in a
+geometry arena, so the model needs no buffers of its own.
+*/
 static void create_meshes(_vlk_static_model_t* model, _vlk_dev_t* device, const tinyobj_t* obj)
 ;
 
@@ -2,9 +2,6 @@
 This file is automatically generated. Do not edit manually.
 =========================================================*/
 
-static void begin_picker_render_pass(_vlk_swapchain_t* swap, _vlk_frame_t* frame)
-;
-
 static void begin_primary_render_pass(_vlk_swapchain_t* swap, _vlk_frame_t* frame)
 ;
 
@@ -44,14 +41,6 @@ create_image_views
 static void create_image_views(_vlk_swapchain_t* swap)
 ;
 
-/**
-Creates images and image views for the picker buffers. Objects are rendered
-to the a picker buffer using a unique color. The buffer can then be sampled at a certain
-pixel to determine what object is drawn at that pixel. It allows "picking" objects on the screen.
-*/
-static void create_picker_buffers(_vlk_swapchain_t* swap)
-;
-
 /**
 create_semaphores
 */
@@ -94,12 +83,6 @@ destroy_image_views
 static void destroy_image_views(_vlk_swapchain_t* swap)
 ;
 
-/**
-Destroys the picker buffer images and image views.
-*/
-static void destroy_picker_buffers(_vlk_swapchain_t* swap)
-;
-
 /**
 destroy_semaphores
 */
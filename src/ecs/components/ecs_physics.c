@@ -32,11 +32,21 @@ FUNCTIONS
 =========================================================*/
 
 //## public
-void ecs_physics__add(ecs_t* ecs, entity_id_t ent)
+ecs_physics_t* ecs_physics__add(ecs_t* ecs, entity_id_t ent)
 {
-	ecs_physics_t* comp = &ecs->physics_comp[ent];
-	clear_struct(comp);
-	comp->base.is_used = TRUE;
+	ecs_physics_t* comp = (ecs_physics_t*)ecs_sparse_set__add(&ecs->physics_comp, ent);
+	if (comp)
+	{
+		ecs__set_component_bit(ecs, ent, ECS_COMPONENT_TYPE_PHYSICS);
+	}
+
+	return comp;
+}
+
+//## public
+ecs_physics_t* ecs_physics__get(ecs_t* ecs, entity_id_t ent)
+{
+	return (ecs_physics_t*)ecs_sparse_set__get(&ecs->physics_comp, ent);
 }
 
 //## public
@@ -48,9 +58,14 @@ boolean ecs_physics__get_property
 	ecs_component_prop_t*		out__property
 	)
 {
-	ecs_physics_t* comp = &ecs->physics_comp[ent];
+	ecs_physics_t* comp = ecs_physics__get(ecs, ent);
 	clear_struct(out__property);
 
+	if (!comp)
+	{
+		return FALSE;
+	}
+
 	switch (property_idx)
 	{
 	case ECS_PHYSICS_PROPERTY_MASS:
@@ -70,12 +85,17 @@ boolean ecs_physics__get_property
 	}
 }
 
+//## public
+boolean ecs_physics__has(ecs_t* ecs, entity_id_t ent)
+{
+	return ecs_sparse_set__has(&ecs->physics_comp, ent);
+}
+
 //## public
 void ecs_physics__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 {
 	/* Add component to the entity */
-	ecs_physics__add(ecs, ent);
-	ecs_physics_t* comp = &ecs->physics_comp[ent];
+	ecs_physics_t* comp = ecs_physics__add(ecs, ent);
 	
 	/* Loop through component members */
 	boolean loop = lua_script__start_loop(lua);
@@ -116,6 +136,27 @@ void ecs_physics__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 	}
 }
 
+//## public
+void ecs_physics__remove(ecs_t* ecs, entity_id_t ent)
+{
+	if (!ecs_sparse_set__has(&ecs->physics_comp, ent))
+	{
+		return;
+	}
+
+	ecs_sparse_set__remove(&ecs->physics_comp, ent);
+	ecs__clear_component_bit(ecs, ent, ECS_COMPONENT_TYPE_PHYSICS);
+}
+
+//## public
+/**
+Wakes the body after a property is edited.
+*/
+void ecs_physics__property_changed(ecs_t* ecs, entity_id_t ent, uint32_t property_idx)
+{
+	ecs_physics__wake(ecs, ent);
+}
+
 //## public
 void ecs_physics__register(ecs_t* ecs)
 {
@@ -124,8 +165,31 @@ void ecs_physics__register(ecs_t* ecs)
 	// TODO : Create a string copy utl function
 	strncpy_s(physics_intf.name, sizeof(physics_intf.name), ECS_PHYSICS_NAME, sizeof(physics_intf.name) - 1);
 	physics_intf.get_property = ecs_physics__get_property;
+	physics_intf.has = ecs_physics__has;
 	physics_intf.load = ecs_physics__load;
+	physics_intf.property_changed = ecs_physics__property_changed;
 
 	/* Register with ECS */
 	ecs__register_component_intf(ecs, &physics_intf);
 }
+
+//## public
+/**
+Wakes a sleeping body so the physics system simulates it again. Writing a
+sleeping body's momentum or transform wakes it on the next step, this wakes
+it right away.
+
+@param ecs The ECS context.
+@param ent The entity.
+*/
+void ecs_physics__wake(ecs_t* ecs, entity_id_t ent)
+{
+	ecs_physics_t* comp = ecs_physics__get(ecs, ent);
+	if (!comp)
+	{
+		return;
+	}
+
+	comp->sleeping = FALSE;
+	comp->still_ticks = 0;
+}
@@ -55,6 +55,10 @@ struct ecs_physics_s
 
 /* constant		*/	float				inertia;
 /* constant		*/	float				inverse_inertia;
+
+/* state		*/	uint32_t			still_ticks;		/* Consecutive ticks below the sleep thresholds. */
+/* state		*/	boolean				sleeping;			/* Skipped by the physics system until woken. */
+/* state		*/	entity_id_t			island;				/* Island the body fell asleep in. Only valid while sleeping. */
 };
 
 /*=========================================================
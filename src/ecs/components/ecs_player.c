@@ -30,11 +30,21 @@ FUNCTIONS
 =========================================================*/
 
 //## public
-void ecs_player__add(ecs_t* ecs, entity_id_t ent)
+ecs_player_t* ecs_player__add(ecs_t* ecs, entity_id_t ent)
 {
-	ecs_player_t* comp = &ecs->player_comp[ent];
-	clear_struct(comp);
-	comp->base.is_used = TRUE;
+	ecs_player_t* comp = (ecs_player_t*)ecs_sparse_set__add(&ecs->player_comp, ent);
+	if (comp)
+	{
+		ecs__set_component_bit(ecs, ent, ECS_COMPONENT_TYPE_PLAYER);
+	}
+
+	return comp;
+}
+
+//## public
+ecs_player_t* ecs_player__get(ecs_t* ecs, entity_id_t ent)
+{
+	return (ecs_player_t*)ecs_sparse_set__get(&ecs->player_comp, ent);
 }
 
 //## public
@@ -46,9 +56,14 @@ boolean ecs_player__get_property
 	ecs_component_prop_t*		out__property
 	)
 {
-	ecs_player_t* comp = &ecs->player_comp[ent];
+	ecs_player_t* comp = ecs_player__get(ecs, ent);
 	clear_struct(out__property);
 
+	if (!comp)
+	{
+		return FALSE;
+	}
+
 	switch (property_idx)
 	{
 	//case ECS_TRANSFORM_PROPERTY_POS:
@@ -62,6 +77,12 @@ boolean ecs_player__get_property
 	}
 }
 
+//## public
+boolean ecs_player__has(ecs_t* ecs, entity_id_t ent)
+{
+	return ecs_sparse_set__has(&ecs->player_comp, ent);
+}
+
 //## public
 void ecs_player__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 {
@@ -79,7 +100,6 @@ void ecs_player__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 
 	/* Add component to the entity */
 	ecs_player__add(ecs, ent);
-	ecs_player_t* comp = &ecs->player_comp[ent];
 	
 	/* Loop through component members */
 	boolean loop = lua_script__start_loop(lua);
@@ -104,6 +124,18 @@ void ecs_player__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 	}
 }
 
+//## public
+void ecs_player__remove(ecs_t* ecs, entity_id_t ent)
+{
+	if (!ecs_sparse_set__has(&ecs->player_comp, ent))
+	{
+		return;
+	}
+
+	ecs_sparse_set__remove(&ecs->player_comp, ent);
+	ecs__clear_component_bit(ecs, ent, ECS_COMPONENT_TYPE_PLAYER);
+}
+
 //## public
 void ecs_player__register(ecs_t* ecs)
 {
@@ -112,6 +144,7 @@ void ecs_player__register(ecs_t* ecs)
 	// TODO : Create a string copy utl function
 	strncpy_s(player_intf.name, sizeof(player_intf.name), ECS_PLAYER_NAME, sizeof(player_intf.name) - 1);
 	player_intf.get_property = ecs_player__get_property;
+	player_intf.has = ecs_player__has;
 	player_intf.load = ecs_player__load;
 
 	/* Register with ECS */
@@ -32,11 +32,21 @@ FUNCTIONS
 =========================================================*/
 
 //## public
-void ecs_static_model__add(ecs_t* ecs, entity_id_t ent)
+ecs_static_model_t* ecs_static_model__add(ecs_t* ecs, entity_id_t ent)
 {
-	ecs_static_model_t* comp = &ecs->static_model_comp[ent];
-	clear_struct(comp);
-	comp->base.is_used = TRUE;
+	ecs_static_model_t* comp = (ecs_static_model_t*)ecs_sparse_set__add(&ecs->static_model_comp, ent);
+	if (comp)
+	{
+		ecs__set_component_bit(ecs, ent, ECS_COMPONENT_TYPE_STATIC_MODEL);
+	}
+
+	return comp;
+}
+
+//## public
+ecs_static_model_t* ecs_static_model__get(ecs_t* ecs, entity_id_t ent)
+{
+	return (ecs_static_model_t*)ecs_sparse_set__get(&ecs->static_model_comp, ent);
 }
 
 //## public
@@ -48,9 +58,14 @@ boolean ecs_static_model__get_property
 	ecs_component_prop_t*		out__property
 	)
 {
-	ecs_static_model_t* comp = &ecs->static_model_comp[ent];
+	ecs_static_model_t* comp = ecs_static_model__get(ecs, ent);
 	clear_struct(out__property);
 
+	if (!comp)
+	{
+		return FALSE;
+	}
+
 	switch (property_idx)
 	{
 	case ECS_STATIC_MODEL_PROPERTY_MATERIAL:
@@ -74,12 +89,17 @@ boolean ecs_static_model__get_property
 	return TRUE;
 }
 
+//## public
+boolean ecs_static_model__has(ecs_t* ecs, entity_id_t ent)
+{
+	return ecs_sparse_set__has(&ecs->static_model_comp, ent);
+}
+
 //## public
 void ecs_static_model__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 {
 	/* Add component to the entity */
-	ecs_static_model__add(ecs, ent);
-	ecs_static_model_t* comp = &ecs->static_model_comp[ent];
+	ecs_static_model_t* comp = ecs_static_model__add(ecs, ent);
 	
 	/* Loop through component members */
 	boolean loop = lua_script__start_loop(lua);
@@ -119,6 +139,18 @@ void ecs_static_model__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 	}
 }
 
+//## public
+void ecs_static_model__remove(ecs_t* ecs, entity_id_t ent)
+{
+	if (!ecs_sparse_set__has(&ecs->static_model_comp, ent))
+	{
+		return;
+	}
+
+	ecs_sparse_set__remove(&ecs->static_model_comp, ent);
+	ecs__clear_component_bit(ecs, ent, ECS_COMPONENT_TYPE_STATIC_MODEL);
+}
+
 //## public
 void ecs_static_model__register(ecs_t* ecs)
 {
@@ -127,6 +159,7 @@ void ecs_static_model__register(ecs_t* ecs)
 	// TODO : Create a string copy utl function
 	strncpy_s(static_model_intf.name, sizeof(static_model_intf.name), ECS_STATIC_MODEL_NAME, sizeof(static_model_intf.name) - 1);
 	static_model_intf.get_property = ecs_static_model__get_property;
+	static_model_intf.has = ecs_static_model__has;
 	static_model_intf.load = ecs_static_model__load;
 
 	/* Register with ECS */
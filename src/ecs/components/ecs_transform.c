@@ -2,6 +2,7 @@
 INCLUDES
 =========================================================*/
 
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -12,6 +13,7 @@ INCLUDES
 #include "engine/kk_log.h"
 #include "lua/lua_script.h"
 #include "thirdparty/cimgui/imgui_jetz.h"
+#include "utl/utl_array.h"
 
 /*=========================================================
 CONSTANTS
@@ -21,6 +23,7 @@ const char* ECS_TRANSFORM_NAME = "transform";
 static const char* POS_NAME = "pos";
 static const char* ROT_NAME = "rot";
 static const char* SCALE_NAME = "scale";
+static const char* PARENT_NAME = "parent";
 
 /*=========================================================
 VARIABLES
@@ -33,11 +36,49 @@ FUNCTIONS
 =========================================================*/
 
 //## public
-void ecs_transform__add(ecs_t* ecs, entity_id_t ent)
+ecs_transform_t* ecs_transform__add(ecs_t* ecs, entity_id_t ent)
 {
-	ecs_transform_t* comp = &ecs->transform_comp[ent];
-	clear_struct(comp);
-	comp->base.is_used = TRUE;
+	ecs_transform_t* comp = (ecs_transform_t*)ecs_sparse_set__add(&ecs->transform_comp, ent);
+	if (comp)
+	{
+		ecs__set_component_bit(ecs, ent, ECS_COMPONENT_TYPE_TRANSFORM);
+		comp->parent = ECS_INVALID_ID;
+		ecs->transform_order_dirty = TRUE;
+		ecs->transform_ranges_valid = FALSE;
+		ecs_transform__set_dirty(ecs, comp);
+	}
+
+	return comp;
+}
+
+//## public
+/**
+Gets the local position and rotation blended between the previous and
+current simulation tick. Transforms that are not interpolated return pos
+and rot unchanged.
+
+@param comp The transform.
+@param alpha Blend factor. 0 is the previous tick, 1 is the current tick.
+@param out__pos The blended position.
+@param out__rot The blended rotation.
+*/
+void ecs_transform__get_blended(ecs_transform_t* comp, float alpha, kk_vec3_t* out__pos, kk_vec4_t* out__rot)
+{
+	if (!comp->interpolated)
+	{
+		*out__pos = comp->pos;
+		*out__rot = comp->rot;
+		return;
+	}
+
+	kk_math_vec3_lerp(&comp->prev_pos, &comp->pos, alpha, out__pos);
+	kk_math_quat_slerp(&comp->prev_rot, &comp->rot, alpha, out__rot);
+}
+
+//## public
+ecs_transform_t* ecs_transform__get(ecs_t* ecs, entity_id_t ent)
+{
+	return (ecs_transform_t*)ecs_sparse_set__get(&ecs->transform_comp, ent);
 }
 
 //## public
@@ -49,9 +90,14 @@ boolean ecs_transform__get_property
 	ecs_component_prop_t*		out__property
 	)
 {
-	ecs_transform_t* comp = &ecs->transform_comp[ent];
+	ecs_transform_t* comp = ecs_transform__get(ecs, ent);
 	clear_struct(out__property);
 
+	if (!comp)
+	{
+		return FALSE;
+	}
+
 	switch (property_idx)
 	{
 	case ECS_TRANSFORM_PROPERTY_POS:
@@ -72,17 +118,28 @@ boolean ecs_transform__get_property
 		out__property->name = SCALE_NAME;
 		return TRUE;
 
+	case ECS_TRANSFORM_PROPERTY_PARENT:
+		out__property->value = &comp->parent;
+		out__property->type = ECS_COMPONENT_PROP_TYPE_ENTITY;
+		out__property->name = PARENT_NAME;
+		return TRUE;
+
 	default:
 		return FALSE;
 	}
 }
 
+//## public
+boolean ecs_transform__has(ecs_t* ecs, entity_id_t ent)
+{
+	return ecs_sparse_set__has(&ecs->transform_comp, ent);
+}
+
 //## public
 void ecs_transform__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 {
 	/* Add component to the entity */
-	ecs_transform__add(ecs, ent);
-	ecs_transform_t* comp = &ecs->transform_comp[ent];
+	ecs_transform_t* comp = ecs_transform__add(ecs, ent);
 	
 	/* Default values */
 	comp->scale.x = comp->scale.y = comp->scale.z = 1.0f;
@@ -127,7 +184,410 @@ void ecs_transform__load(ecs_t* ecs, entity_id_t ent, lua_script_t* lua)
 				continue;
 			}
 		}
+
+		/* Parent entity id. The parent may be loaded after this entity so it is not validated here. */
+		if (!strncmp(key, PARENT_NAME, sizeof(key)))
+		{
+			int parent;
+			if (!lua_script__get_int(lua, &parent))
+			{
+				kk_log__error("Invalid parent.");
+				continue;
+			}
+
+			comp->parent = (entity_id_t)parent;
+		}
+	}
+}
+
+//## public
+/**
+Queues a transform to have its cached matrix rebuilt by the next transform
+system pass. Must be called after writing pos, rot or scale.
+*/
+void ecs_transform__set_dirty(ecs_t* ecs, ecs_transform_t* comp)
+{
+	if (comp->dirty)
+	{
+		return;
 	}
+
+	comp->dirty = TRUE;
+
+	/* The transform pass rebuilds the subtree of each dirty transform. A new order sweeps everything anyway. */
+	if (!ecs->transform_order_dirty)
+	{
+		utl_array_push(&ecs->transform_dirty_roots, comp->order_idx);
+	}
+}
+
+//## public
+/**
+Sets the parent of a transform. The transform's pos, rot and scale become
+relative to the parent.
+
+@param ecs The ECS context.
+@param ent The child entity.
+@param parent The parent entity, or ECS_INVALID_ID to detach.
+@return FALSE if the parent does not have a transform or would create a cycle.
+*/
+boolean ecs_transform__set_parent(ecs_t* ecs, entity_id_t ent, entity_id_t parent)
+{
+	ecs_transform_t* comp = ecs_transform__get(ecs, ent);
+	ecs_transform_t* ancestor;
+
+	if (!comp)
+	{
+		return FALSE;
+	}
+
+	if (parent != ECS_INVALID_ID)
+	{
+		/* Walk up from the new parent to make sure this entity is not an ancestor */
+		ancestor = ecs_transform__get(ecs, parent);
+		if (!ancestor)
+		{
+			kk_log__error("Transform parent does not have a transform.");
+			return FALSE;
+		}
+
+		while (ancestor)
+		{
+			if (ancestor == comp)
+			{
+				kk_log__error("Transform parent would create a cycle.");
+				return FALSE;
+			}
+
+			ancestor = (ancestor->parent != ECS_INVALID_ID) ? ecs_transform__get(ecs, ancestor->parent) : NULL;
+		}
+	}
+
+	comp->parent = parent;
+	ecs->transform_order_dirty = TRUE;
+	ecs->transform_ranges_valid = FALSE;
+	ecs_transform__set_dirty(ecs, comp);
+
+	return TRUE;
+}
+
+//## public
+/**
+Builds the matrix that takes the transform's local space to its parent's
+space. Equivalent to translate * scale * rotate.
+
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+@param out__m The local matrix.
+*/
+void ecs_transform__get_local_matrix(ecs_transform_t* comp, float alpha, kk_mat4_t* out__m)
+{
+	kk_mat4_t* m = out__m;
+	kk_vec3_t pos;
+	kk_vec4_t rot;
+
+	ecs_transform__get_blended(comp, alpha, &pos, &rot);
+
+	/* Rotation, with the scale applied to each row */
+	kk_math_quat_mat4(&rot, m);
+
+	m->x.x *= comp->scale.x;	m->y.x *= comp->scale.x;	m->z.x *= comp->scale.x;
+	m->x.y *= comp->scale.y;	m->y.y *= comp->scale.y;	m->z.y *= comp->scale.y;
+	m->x.z *= comp->scale.z;	m->y.z *= comp->scale.z;	m->z.z *= comp->scale.z;
+
+	/* Translation */
+	m->w.x = pos.x;
+	m->w.y = pos.y;
+	m->w.z = pos.z;
+	m->w.w = 1.0f;
+}
+
+//## public
+/**
+Builds the matrix that takes the transform's parent space to world space by
+composing the local pose of every ancestor. Unlike the cached world matrices
+this does not depend on the last transform pass, so it can be used before
+the pass runs.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated ancestors.
+@param out__m The parent's world matrix. Not written if the transform has no parent.
+@return FALSE if the transform has no parent.
+*/
+boolean ecs_transform__get_parent_matrix(ecs_t* ecs, ecs_transform_t* comp, float alpha, kk_mat4_t* out__m)
+{
+	ecs_transform_t* ancestor = (comp->parent != ECS_INVALID_ID) ? ecs_transform__get(ecs, comp->parent) : NULL;
+	kk_mat4_t local;
+	uint32_t depth = 0;
+
+	if (!ancestor)
+	{
+		return FALSE;
+	}
+
+	ecs_transform__get_local_matrix(ancestor, alpha, out__m);
+
+	/* Walk up, applying each ancestor's space on the left */
+	for (;;)
+	{
+		ancestor = (ancestor->parent != ECS_INVALID_ID) ? ecs_transform__get(ecs, ancestor->parent) : NULL;
+		if (!ancestor)
+		{
+			break;
+		}
+
+		if (++depth > ecs->transform_comp.count)
+		{
+			kk_log__error("Transform hierarchy contains a cycle.");
+			break;
+		}
+
+		ecs_transform__get_local_matrix(ancestor, alpha, &local);
+		kk_math_mat4_mul(&local, out__m, out__m);
+	}
+
+	return TRUE;
+}
+
+//## public
+/**
+Gets the world space bounds of a box and sphere in the transform's local
+space. Works from the pose directly, so no matrix is built unless the
+transform has a parent. Ancestors are posed at the same alpha, not taken
+from their cached world matrices, which may be a frame old and blended.
+
+Each world axis of the box spans the absolute rotated and scaled half
+extents. The sphere's radius grows by the largest scale.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+@param box The local box. May be NULL if out__box is.
+@param sphere The local sphere. May be NULL if out__sphere is.
+@param out__box The world box. May be NULL.
+@param out__sphere The world sphere. May be NULL.
+*/
+void ecs_transform__get_world_bounds
+	(
+	ecs_t*					ecs,
+	ecs_transform_t*		comp,
+	float					alpha,
+	kk_aabb_t*				box,
+	kk_sphere_t*			sphere,
+	kk_aabb_t*				out__box,
+	kk_sphere_t*			out__sphere
+	)
+{
+	float* scale = (float*)&comp->scale;
+	kk_mat4_t parent_m;
+	boolean has_parent;
+	float r[3][3];
+	float c[3];
+	float h[3];
+	float* wc;
+	float* wmin;
+	float* wmax;
+	kk_vec3_t pos;
+	kk_vec4_t q;
+	float mid;
+	float n;
+	float s;
+	float e;
+	int i;
+
+	ecs_transform__get_blended(comp, alpha, &pos, &q);
+	has_parent = ecs_transform__get_parent_matrix(ecs, comp, alpha, &parent_m);
+
+	/* Rotation rows, normalizing the quaternion on the way */
+	n = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+	s = (n > 0.0f) ? 2.0f / n : 0.0f;
+
+	r[0][0] = 1.0f - s * (q.y * q.y + q.z * q.z);
+	r[0][1] = s * (q.x * q.y - q.w * q.z);
+	r[0][2] = s * (q.x * q.z + q.w * q.y);
+	r[1][0] = s * (q.x * q.y + q.w * q.z);
+	r[1][1] = 1.0f - s * (q.x * q.x + q.z * q.z);
+	r[1][2] = s * (q.y * q.z - q.w * q.x);
+	r[2][0] = s * (q.x * q.z - q.w * q.y);
+	r[2][1] = s * (q.y * q.z + q.w * q.x);
+	r[2][2] = 1.0f - s * (q.x * q.x + q.y * q.y);
+
+	if (out__box)
+	{
+		wmin = (float*)&out__box->min;
+		wmax = (float*)&out__box->max;
+
+		c[0] = 0.5f * (box->min.x + box->max.x);
+		c[1] = 0.5f * (box->min.y + box->max.y);
+		c[2] = 0.5f * (box->min.z + box->max.z);
+		h[0] = 0.5f * (box->max.x - box->min.x);
+		h[1] = 0.5f * (box->max.y - box->min.y);
+		h[2] = 0.5f * (box->max.z - box->min.z);
+
+		for (i = 0; i < 3; ++i)
+		{
+			e = fabsf(scale[i]) * (fabsf(r[i][0]) * h[0] + fabsf(r[i][1]) * h[1] + fabsf(r[i][2]) * h[2]);
+			mid = ((float*)&pos)[i] + scale[i] * (r[i][0] * c[0] + r[i][1] * c[1] + r[i][2] * c[2]);
+			wmin[i] = mid - e;
+			wmax[i] = mid + e;
+		}
+
+		if (has_parent)
+		{
+			kk_math_aabb_transform(out__box, &parent_m, out__box);
+		}
+	}
+
+	if (out__sphere)
+	{
+		wc = (float*)&out__sphere->center;
+		c[0] = sphere->center.x;
+		c[1] = sphere->center.y;
+		c[2] = sphere->center.z;
+
+		for (i = 0; i < 3; ++i)
+		{
+			wc[i] = ((float*)&pos)[i] + scale[i] * (r[i][0] * c[0] + r[i][1] * c[1] + r[i][2] * c[2]);
+		}
+
+		out__sphere->radius = sphere->radius * max(fabsf(scale[0]), max(fabsf(scale[1]), fabsf(scale[2])));
+
+		if (has_parent)
+		{
+			kk_math_sphere_transform(out__sphere, &parent_m, out__sphere);
+		}
+	}
+}
+
+//## public
+/**
+Builds the matrix that takes the transform's local space to world space at
+the current tick. Unlike the cached matrix this is never blended, and
+ancestors are posed at the current tick too, so it matches the pose the
+simulation sees.
+
+@param ecs The ECS context.
+@param comp The transform.
+@param out__m The world matrix.
+*/
+void ecs_transform__get_world_matrix(ecs_t* ecs, ecs_transform_t* comp, kk_mat4_t* out__m)
+{
+	kk_mat4_t parent_m;
+	kk_mat4_t local;
+
+	if (!ecs_transform__get_parent_matrix(ecs, comp, 1.0f, &parent_m))
+	{
+		ecs_transform__get_local_matrix(comp, 1.0f, out__m);
+		return;
+	}
+
+	ecs_transform__get_local_matrix(comp, 1.0f, &local);
+	kk_math_mat4_mul(&parent_m, &local, out__m);
+}
+
+//## public
+/**
+Rebuilds the cached matrix. Equivalent to parent * translate * scale * rotate.
+
+@param comp The transform to update.
+@param parent The parent transform, which must already be up to date. NULL if none.
+@param alpha Blend factor between the previous and current tick for interpolated transforms.
+*/
+void ecs_transform__update_matrix(ecs_transform_t* comp, ecs_transform_t* parent, float alpha)
+{
+	kk_mat4_t local;
+
+	ecs_transform__get_local_matrix(comp, alpha, &local);
+
+	/* Into the parent's space */
+	if (parent)
+	{
+		kk_math_mat4_mul(&parent->world_matrix, &local, &comp->world_matrix);
+	}
+	else
+	{
+		comp->world_matrix = local;
+	}
+
+	comp->dirty = FALSE;
+}
+
+//## public
+void ecs_transform__remove(ecs_t* ecs, entity_id_t ent)
+{
+	ecs_transform_t* comp;
+	ecs_transform_t* child;
+	uint32_t i;
+	uint32_t end;
+
+	comp = ecs_transform__get(ecs, ent);
+	if (!comp)
+	{
+		return;
+	}
+
+	/* Detach children. Their local transform becomes their world transform. */
+	if (ecs->transform_ranges_valid)
+	{
+		/*
+		The children head the sub-ranges of this transform's depth-first range, so step over
+		their subtrees. Removals leave the ranges intact, so this holds while destroying many
+		entities in a row. A child removed earlier has no transform anymore.
+		*/
+		end = ecs->transform_subtree_end.data[comp->order_idx];
+		for (i = comp->order_idx + 1; i < end; i = ecs->transform_subtree_end.data[i])
+		{
+			child = ecs_transform__get(ecs, ecs->transform_order.data[i]);
+			if (child && child->parent == ent)
+			{
+				child->parent = ECS_INVALID_ID;
+				ecs_transform__set_dirty(ecs, child);
+			}
+		}
+	}
+	else
+	{
+		for (i = 0; i < ecs->transform_comp.count; ++i)
+		{
+			child = (ecs_transform_t*)ecs_sparse_set__get_at(&ecs->transform_comp, i);
+			if (child->parent == ent)
+			{
+				child->parent = ECS_INVALID_ID;
+				ecs_transform__set_dirty(ecs, child);
+			}
+		}
+	}
+
+	ecs_sparse_set__remove(&ecs->transform_comp, ent);
+	ecs__clear_component_bit(ecs, ent, ECS_COMPONENT_TYPE_TRANSFORM);
+	ecs->transform_order_dirty = TRUE;
+}
+
+//## public
+/**
+Marks a property as modified so the cached matrix is rebuilt.
+*/
+void ecs_transform__property_changed(ecs_t* ecs, entity_id_t ent, uint32_t property_idx)
+{
+	ecs_transform_t* comp = ecs_transform__get(ecs, ent);
+	if (!comp)
+	{
+		return;
+	}
+
+	/* Edited directly, so don't blend from an old tick */
+	comp->interpolated = FALSE;
+
+	/* Parent was written directly, validate it the same way as set_parent */
+	if (property_idx == ECS_TRANSFORM_PROPERTY_PARENT)
+	{
+		entity_id_t parent = comp->parent;
+		comp->parent = ECS_INVALID_ID;
+		ecs_transform__set_parent(ecs, ent, parent);
+	}
+
+	ecs_transform__set_dirty(ecs, comp);
 }
 
 //## public
@@ -138,7 +598,9 @@ void ecs_transform__register(ecs_t* ecs)
 	// TODO : Create a string copy utl function
 	strncpy_s(transform_intf.name, sizeof(transform_intf.name), ECS_TRANSFORM_NAME, sizeof(transform_intf.name) - 1);
 	transform_intf.get_property = ecs_transform__get_property;
+	transform_intf.has = ecs_transform__has;
 	transform_intf.load = ecs_transform__load;
+	transform_intf.property_changed = ecs_transform__property_changed;
 
 	/* Register with ECS */
 	ecs__register_component_intf(ecs, &transform_intf);
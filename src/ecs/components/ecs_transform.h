@@ -31,19 +31,38 @@ enum ecs_transform_properties_e
 	ECS_TRANSFORM_PROPERTY_POS,
 	ECS_TRANSFORM_PROPERTY_ROT,
 	ECS_TRANSFORM_PROPERTY_SCALE,
+	ECS_TRANSFORM_PROPERTY_PARENT,
 
 	ECS_TRANSFORM_PROPERTY__COUNT
 };
 
 /**
 A coordinate transformation that can be applied to an entity.
+
+Anything that writes pos, rot or scale must call ecs_transform__set_dirty so
+the cached matrix is rebuilt by the transform system.
+
+If the transform has a parent, pos, rot and scale are relative to the
+parent and the world matrix is the parent's world matrix times the local
+matrix. Children are updated whenever their parent is.
 */
 struct ecs_transform_s
 {
 	ecs_component_t			base;
 	kk_vec3_t				pos;
-	kk_vec4_t				rot;	/* quaternion */
+	kk_vec4_t				rot;			/* quaternion */
 	kk_vec3_t				scale;
+	entity_id_t				parent;			/* Parent entity, or ECS_INVALID_ID. Use ecs_transform__set_parent to change. */
+
+	kk_vec4_t				prev_rot;		/* Rotation at the previous simulation tick. */
+	kk_vec3_t				prev_pos;		/* Position at the previous simulation tick. */
+	boolean					interpolated;	/* Is world_matrix blended from prev_pos/prev_rot to pos/rot? */
+
+	kk_mat4_t				world_matrix;	/* Cached parent * translate * scale * rotate matrix, blended between ticks if interpolated. */
+	boolean					dirty;			/* Is world_matrix out of date? */
+	uint32_t				depth;			/* Number of ancestors. */
+	uint32_t				order_idx;		/* Index in the ECS transform order. Its subtree ends at transform_subtree_end[order_idx]. */
+	uint32_t				update_pass;	/* Transform pass that last rebuilt world_matrix. */
 };
 
 /*=========================================================
@@ -8,6 +8,7 @@ INCLUDES
 #include "ecs/components/ecs_physics.h"
 #include "ecs/components/ecs_static_model.h"
 #include "ecs/components/ecs_transform.h"
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
 #include "lua/lua_script.h"
 
@@ -15,14 +16,38 @@ INCLUDES
 VARIABLES
 =========================================================*/
 
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static void log_set_memory_usage(const char* name, ecs_sparse_set_t* set, size_t* total);
+static void update_queries(ecs_t* ecs, entity_id_t id);
+
 /*=========================================================
 CONSTRUCTORS
 =========================================================*/
 
 void ecs__construct(ecs_t* ecs)
 {
+	uint32_t i;
+
 	memset(ecs, 0, sizeof(*ecs));
-	utl_ringbuf_init(&ecs->recycled_ids_ringbuf, MAX_NUM_ENT);
+	utl_array_init(&ecs->recycled_ids);
+	utl_array_init(&ecs->transform_order);
+	utl_array_init(&ecs->transform_subtree_end);
+	utl_array_init(&ecs->transform_dirty_roots);
+	ecs_pool__construct(&ecs->signatures, sizeof(ecs_component_mask_t), 0);
+
+	/* Component storage. Grows as components are added. */
+	ecs_sparse_set__construct(&ecs->physics_comp, sizeof(ecs_physics_t));
+	ecs_sparse_set__construct(&ecs->player_comp, sizeof(ecs_player_t));
+	ecs_sparse_set__construct(&ecs->static_model_comp, sizeof(ecs_static_model_t));
+	ecs_sparse_set__construct(&ecs->transform_comp, sizeof(ecs_transform_t));
+
+	for (i = 0; i < cnt_of_array(ecs->cmd_buffers); ++i)
+	{
+		ecs_cmd_buffer__construct(&ecs->cmd_buffers[i]);
+	}
 
 	ecs_player__register(ecs);
 	ecs_physics__register(ecs);
@@ -32,6 +57,28 @@ void ecs__construct(ecs_t* ecs)
 
 void ecs__destruct(ecs_t* ecs)
 {
+	uint32_t i;
+
+	for (i = 0; i < ecs->num_queries; ++i)
+	{
+		ecs_query__destruct(&ecs->queries[i]);
+	}
+
+	for (i = 0; i < cnt_of_array(ecs->cmd_buffers); ++i)
+	{
+		ecs_cmd_buffer__destruct(&ecs->cmd_buffers[i]);
+	}
+
+	ecs_sparse_set__destruct(&ecs->transform_comp);
+	ecs_sparse_set__destruct(&ecs->static_model_comp);
+	ecs_sparse_set__destruct(&ecs->player_comp);
+	ecs_sparse_set__destruct(&ecs->physics_comp);
+
+	ecs_pool__destruct(&ecs->signatures);
+	utl_array_destroy(&ecs->recycled_ids);
+	utl_array_destroy(&ecs->transform_order);
+	utl_array_destroy(&ecs->transform_subtree_end);
+	utl_array_destroy(&ecs->transform_dirty_roots);
 }
 
 /*=========================================================
@@ -43,15 +90,14 @@ entity_id_t ecs__alloc_entity(ecs_t* ecs)
 	entity_id_t id = ECS_INVALID_ID;
 
 	/* Check recycled list */
-	if (!utl_ringbuf_is_empty(&ecs->recycled_ids_ringbuf))
+	if (ecs->recycled_ids.count > 0)
 	{
-		/* Use the first available recycled id */
-		uint32_t idx = utl_ringbuf_dequeue(&ecs->recycled_ids_ringbuf);
-		return ecs->recycled_ids[idx];
+		/* Use the most recently recycled id */
+		return ecs->recycled_ids.data[--ecs->recycled_ids.count];
 	}
 
-	/* Check if buffer full */
-	if (ecs->next_free_id == MAX_NUM_ENT)
+	/* Check if ids exhausted */
+	if (ecs->next_free_id == ECS_INVALID_ID)
 	{
 		return ECS_INVALID_ID;
 	}
@@ -62,8 +108,19 @@ entity_id_t ecs__alloc_entity(ecs_t* ecs)
 	return id;
 }
 
+void ecs__apply_commands(ecs_t* ecs)
+{
+	ecs_cmd_buffer__apply(ecs->cmd_buffers, cnt_of_array(ecs->cmd_buffers), ecs);
+}
+
 void ecs__free_entity(ecs_t* ecs, entity_id_t id)
 {
+	/* Remove components */
+	ecs_physics__remove(ecs, id);
+	ecs_player__remove(ecs, id);
+	ecs_static_model__remove(ecs, id);
+	ecs_transform__remove(ecs, id);
+
 	if (ecs->next_free_id - 1 == id)
 	{
 		/* This is the top most id, just decrease next free id */
@@ -72,8 +129,23 @@ void ecs__free_entity(ecs_t* ecs, entity_id_t id)
 	}
 
 	/* Add to recycled id list */
-	uint32_t idx = utl_ringbuf_enqueue(&ecs->recycled_ids_ringbuf);
-	ecs->recycled_ids[idx] = id;
+	utl_array_push(&ecs->recycled_ids, id);
+}
+
+ecs_component_mask_t ecs__get_signature(ecs_t* ecs, entity_id_t id)
+{
+	/* Entities past the end of the signature pool have no components */
+	if (id >= ecs_pool__get_capacity(&ecs->signatures))
+	{
+		return 0;
+	}
+
+	return *(ecs_component_mask_t*)ecs_pool__get(&ecs->signatures, id);
+}
+
+ecs_cmd_buffer_t* ecs__get_cmd_buffer(ecs_t* ecs)
+{
+	return &ecs->cmd_buffers[kk_job__get_thread_index()];
 }
 
 entity_id_t ecs__iterate(ecs_t* ecs, entity_id_t* id)
@@ -90,6 +162,31 @@ entity_id_t ecs__iterate(ecs_t* ecs, entity_id_t* id)
 	return *id <= ecs->next_free_id;
 }
 
+void ecs__log_memory_usage(ecs_t* ecs)
+{
+	size_t total = 0;
+	uint32_t i;
+
+	log_set_memory_usage(ECS_PHYSICS_NAME, &ecs->physics_comp, &total);
+	log_set_memory_usage(ECS_PLAYER_NAME, &ecs->player_comp, &total);
+	log_set_memory_usage(ECS_STATIC_MODEL_NAME, &ecs->static_model_comp, &total);
+	log_set_memory_usage(ECS_TRANSFORM_NAME, &ecs->transform_comp, &total);
+
+	for (i = 0; i < ecs->num_queries; ++i)
+	{
+		total += ecs_sparse_set__get_memory_usage(&ecs->queries[i].matches);
+	}
+
+	total += ecs_pool__get_memory_usage(&ecs->signatures);
+	total += sizeof(uint32_t) * ecs->recycled_ids.max;
+	total += sizeof(uint32_t) * ecs->transform_order.max;
+	total += sizeof(uint32_t) * ecs->transform_subtree_end.max;
+	total += sizeof(uint32_t) * ecs->transform_dirty_roots.max;
+
+	kk_log__dbg_fmt("ECS memory: %u entities, %u queries, %u bytes total.",
+		ecs->next_free_id, ecs->num_queries, (uint32_t)total);
+}
+
 void ecs__load_component(ecs_t* ecs, entity_id_t entity, const char* component_name, lua_script_t* lua)
 {
 	/* Find component */
@@ -122,6 +219,39 @@ void ecs__load_entity(ecs_t* ecs, entity_id_t entity, lua_script_t* lua)
 	}
 }
 
+ecs_query_t* ecs__query(ecs_t* ecs, ecs_component_mask_t required, ecs_component_mask_t excluded)
+{
+	ecs_query_t* query;
+	entity_id_t id;
+	uint32_t i;
+
+	/* Check for existing query */
+	for (i = 0; i < ecs->num_queries; ++i)
+	{
+		query = &ecs->queries[i];
+		if (query->required == required && query->excluded == excluded)
+		{
+			return query;
+		}
+	}
+
+	if (ecs->num_queries == MAX_NUM_QUERIES)
+	{
+		kk_log__fatal("Too many ECS queries.");
+	}
+
+	/* Create the query and match existing entities. After this the match list is updated incrementally. */
+	query = &ecs->queries[ecs->num_queries++];
+	ecs_query__construct(query, required, excluded);
+
+	for (id = 0; id < ecs->next_free_id; ++id)
+	{
+		ecs_query__update(query, id, ecs__get_signature(ecs, id));
+	}
+
+	return query;
+}
+
 void ecs__register_component_intf(ecs_t* ecs, comp_intf_t* comp_intf)
 {
 	/* Check if already registered */
@@ -138,4 +268,53 @@ void ecs__register_component_intf(ecs_t* ecs, comp_intf_t* comp_intf)
 		kk_log__error("Failed to register component in ECS.");
 		return;
 	}
+}
+
+void ecs__set_component_bit(ecs_t* ecs, entity_id_t id, ecs_component_type_t type)
+{
+	ecs_pool__reserve(&ecs->signatures, id + 1);
+	*(ecs_component_mask_t*)ecs_pool__get(&ecs->signatures, id) |= ECS_COMPONENT_BIT(type);
+	update_queries(ecs, id);
+}
+
+void ecs__clear_component_bit(ecs_t* ecs, entity_id_t id, ecs_component_type_t type)
+{
+	if (id >= ecs_pool__get_capacity(&ecs->signatures))
+	{
+		return;
+	}
+
+	*(ecs_component_mask_t*)ecs_pool__get(&ecs->signatures, id) &= ~ECS_COMPONENT_BIT(type);
+	update_queries(ecs, id);
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+/**
+Logs the memory used by a component set and adds it to the running total.
+*/
+static void log_set_memory_usage(const char* name, ecs_sparse_set_t* set, size_t* total)
+{
+	size_t bytes = ecs_sparse_set__get_memory_usage(set);
+
+	kk_log__dbg_fmt("ECS memory: %s: %u components, %u chunks, %u bytes.",
+		name, set->count, set->dense.num_chunks, (uint32_t)bytes);
+
+	*total += bytes;
+}
+
+/**
+Updates query match lists after an entity's signature changes.
+*/
+static void update_queries(ecs_t* ecs, entity_id_t id)
+{
+	ecs_component_mask_t signature = ecs__get_signature(ecs, id);
+	uint32_t i;
+
+	for (i = 0; i < ecs->num_queries; ++i)
+	{
+		ecs_query__update(&ecs->queries[i], id, signature);
+	}
 }
\ No newline at end of file
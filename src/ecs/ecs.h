@@ -19,9 +19,14 @@ INCLUDES
 #include "ecs/components/ecs_physics.h"
 #include "ecs/components/ecs_static_model.h"
 #include "ecs/components/ecs_transform.h"
+#include "ecs/ecs_cmd_buffer.h"
+#include "ecs/ecs_pool.h"
+#include "ecs/ecs_query.h"
+#include "ecs/ecs_sparse_set.h"
+#include "engine/kk_job.h"
 #include "lua/lua_script.h"
 #include "thirdparty/rxi_map/src/map.h"
-#include "utl/utl_ringbuf.h"
+#include "utl/utl_array.h"
 
 /*=========================================================
 CONSTANTS
@@ -29,7 +34,7 @@ CONSTANTS
 
 #define ECS_INVALID_ID 0xFFFFFFFF
 #define MAX_COMPONENT_NAME 64
-#define MAX_NUM_ENT 500
+#define MAX_NUM_QUERIES 16
 
 /*=========================================================
 TYPES
@@ -41,6 +46,25 @@ Component interface
 
 typedef void (*comp_intf_load_func)(ecs_t* ecs, entity_id_t entity, lua_script_t* lua);
 
+/**
+Checks if an entity has this component.
+
+@param ecs The ECS context.
+@param ent The entity id.
+@return TRUE if the entity has the component.
+*/
+typedef boolean (*comp_intf_has_func)(ecs_t* ecs, entity_id_t ent);
+
+/**
+Notifies a component that a property value was written through the pointer
+returned by get_property. Optional.
+
+@param ecs The ECS context.
+@param ent The entity id.
+@param property_idx The property index.
+*/
+typedef void (*comp_intf_property_changed_func)(ecs_t* ecs, entity_id_t ent, uint32_t property_idx);
+
 /**
 Gets information about the specified property. If the property index is invalid, FALSE is returned.
 
@@ -63,7 +87,9 @@ struct comp_intf_s
 	char						name[MAX_COMPONENT_NAME];		/* Component name. */
 
 	comp_intf_get_property		get_property;	/* Gets the property at the specified index. */
+	comp_intf_has_func			has;			/* Checks if an entity has the component. */
 	comp_intf_load_func			load;			/* Loads a component instance from the specified lua script. */
+	comp_intf_property_changed_func	property_changed;	/* Called after a property is modified. May be NULL. */
 };
 
 /*-------------------------------------
@@ -71,16 +97,27 @@ Entity component system
 -------------------------------------*/
 struct ecs_s
 {
-	ecs_physics_t			physics_comp[MAX_NUM_ENT];
-	ecs_player_t			player_comp[1];
-	ecs_static_model_t		static_model_comp[MAX_NUM_ENT];
-	ecs_transform_t			transform_comp[MAX_NUM_ENT];
-
-	entity_id_t				recycled_ids[MAX_NUM_ENT];
-	utl_ringbuf_t			recycled_ids_ringbuf;
+	ecs_sparse_set_t		physics_comp;			/* ecs_physics_t */
+	ecs_sparse_set_t		player_comp;			/* ecs_player_t */
+	ecs_sparse_set_t		static_model_comp;		/* ecs_static_model_t */
+	ecs_sparse_set_t		transform_comp;			/* ecs_transform_t */
+
+	ecs_pool_t				signatures;				/* Component bits for each entity (ecs_component_mask_t). */
+	ecs_query_t				queries[MAX_NUM_QUERIES];	/* Cached queries. */
+	uint32_t				num_queries;
+
+	utl_array_t(uint32_t)	recycled_ids;			/* Stack of freed entity ids. */
+	utl_array_t(uint32_t)	transform_order;		/* Transform entities in depth-first order, so each subtree is a contiguous range. */
+	utl_array_t(uint32_t)	transform_subtree_end;	/* For each transform_order entry, one past the last index of its subtree. */
+	utl_array_t(uint32_t)	transform_dirty_roots;	/* transform_order indices of transforms marked dirty since the last pass. */
+	boolean					transform_order_dirty;	/* Rebuild transform_order before the next transform pass. */
+	boolean					transform_ranges_valid;	/* Only removals since the last rebuild, so the subtree ranges still find each transform's children. */
+	uint32_t				transform_pass;			/* Incremented by each transform pass. */
 
 	entity_id_t				next_free_id;
 
+	ecs_cmd_buffer_t		cmd_buffers[KK_JOB_MAX_THREADS];	/* Deferred structural changes, one buffer per job system thread. */
+
 	map_t(comp_intf_t*)		component_registry;		/* Registry of known component types and their interfaces. */
 };
 
@@ -112,18 +149,77 @@ Allocates an entity id.
 entity_id_t ecs__alloc_entity(ecs_t* ecs);
 
 /**
-Frees an entity id.
+Applies the commands recorded in every thread's command buffer. Call when
+no system is running.
+@param ecs The ECS context.
+*/
+void ecs__apply_commands(ecs_t* ecs);
+
+/**
+Frees an entity id and removes all of its components.
 @param ecs The ECS context.
 @param id The id to free.
 */
 void ecs__free_entity(ecs_t* ecs, entity_id_t id);
 
+/**
+Gets an entity's signature.
+@param ecs The ECS context.
+@param id The entity id.
+@return Bitmask with a bit set for each component the entity has.
+*/
+ecs_component_mask_t ecs__get_signature(ecs_t* ecs, entity_id_t id);
+
+/**
+Gets the calling thread's command buffer. Systems running on the job system
+record entity spawns/destroys and component adds/removes here instead of
+changing the ECS while other systems iterate it.
+@param ecs The ECS context.
+@return The command buffer.
+*/
+ecs_cmd_buffer_t* ecs__get_cmd_buffer(ecs_t* ecs);
+
+/**
+Logs the memory used by each component type's storage.
+@param ecs The ECS context.
+*/
+void ecs__log_memory_usage(ecs_t* ecs);
+
 entity_id_t ecs__iterate(ecs_t* ecs, entity_id_t* id);
 
 void ecs__load_component(ecs_t* ecs, entity_id_t entity, const char* component_name, lua_script_t* lua);
 
 void ecs__load_entity(ecs_t* ecs, entity_id_t entity, lua_script_t* lua);
 
+/**
+Gets a cached query for the specified signature. The query is created on
+first use and its match list is kept up to date as components are added
+and removed.
+@param ecs The ECS context.
+@param required Component bits an entity must have.
+@param excluded Component bits an entity must not have.
+@return The query.
+*/
+ecs_query_t* ecs__query(ecs_t* ecs, ecs_component_mask_t required, ecs_component_mask_t excluded);
+
 void ecs__register_component_intf(ecs_t* ecs, comp_intf_t* comp_intf);
 
+/**
+Updates an entity's signature after a component is added. Called by
+component add functions.
+@param ecs The ECS context.
+@param id The entity id.
+@param type The component type that was added.
+*/
+void ecs__set_component_bit(ecs_t* ecs, entity_id_t id, ecs_component_type_t type);
+
+/**
+Updates an entity's signature after a component is removed. Called by
+component remove functions.
+@param ecs The ECS context.
+@param id The entity id.
+@param type The component type that was removed.
+*/
+void ecs__clear_component_bit(ecs_t* ecs, entity_id_t id, ecs_component_type_t type);
+
 #endif /* ECS_H */
\ No newline at end of file
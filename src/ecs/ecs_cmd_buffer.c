@@ -0,0 +1,414 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_cmd_buffer.h"
+#include "ecs/ecs_component.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_player.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "engine/kk_log.h"
+
+#include "autogen/ecs_cmd_buffer.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define DATA_ALIGN				(16)		/* Alignment of component data. Transforms hold a 16 byte aligned matrix. */
+#define MIN_DATA_CAPACITY		(1024)
+#define DESTROY_BUCKET			(ECS_COMPONENT_TYPE__COUNT)
+
+static const size_t COMPONENT_SIZES[ECS_COMPONENT_TYPE__COUNT] =
+{
+	sizeof(ecs_physics_t),			/* ECS_COMPONENT_TYPE_PHYSICS */
+	sizeof(ecs_player_t),			/* ECS_COMPONENT_TYPE_PLAYER */
+	sizeof(ecs_static_model_t),		/* ECS_COMPONENT_TYPE_STATIC_MODEL */
+	sizeof(ecs_transform_t),		/* ECS_COMPONENT_TYPE_TRANSFORM */
+};
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty command buffer.
+
+@param buf The buffer to construct.
+*/
+void ecs_cmd_buffer__construct(ecs_cmd_buffer_t* buf)
+{
+	clear_struct(buf);
+	utl_array_init(&buf->cmds);
+	utl_array_init(&buf->order);
+	utl_array_init(&buf->spawned);
+}
+
+//## public
+/**
+Destructs a command buffer. Commands that were not applied are discarded.
+
+@param buf The buffer to destruct.
+*/
+void ecs_cmd_buffer__destruct(ecs_cmd_buffer_t* buf)
+{
+	utl_array_destroy(&buf->cmds);
+	utl_array_destroy(&buf->order);
+	utl_array_destroy(&buf->spawned);
+	free(buf->data);
+	clear_struct(buf);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Records adding a component. Returns the component data to fill in, which is
+copied to the real component when the buffer is applied. The data is zeroed
+except for transforms, which start with identity rotation, unit scale and no
+parent. The pointer is only valid until the next command is recorded.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+@param type The component type.
+@return The component data.
+*/
+void* ecs_cmd_buffer__add(ecs_cmd_buffer_t* buf, entity_id_t ent, ecs_component_type_t type)
+{
+	ecs_component_t* comp;
+	ecs_transform_t* transform;
+	ecs_cmd_t cmd;
+	uint32_t offset;
+	uint32_t size = (uint32_t)COMPONENT_SIZES[type];
+
+	/* Grow the data */
+	offset = (buf->data_size + DATA_ALIGN - 1) & ~(DATA_ALIGN - 1);
+	if (offset + size > buf->data_capacity)
+	{
+		uint32_t capacity = max(max(buf->data_capacity * 2, offset + size), MIN_DATA_CAPACITY);
+		uint8_t* data = (uint8_t*)realloc(buf->data, capacity);
+		if (!data)
+		{
+			kk_log__fatal("Failed to grow ECS command buffer.");
+		}
+
+		buf->data = data;
+		buf->data_capacity = capacity;
+	}
+
+	buf->data_size = offset + size;
+
+	comp = (ecs_component_t*)(buf->data + offset);
+	memset(comp, 0, size);
+	comp->entity = ent;
+
+	if (type == ECS_COMPONENT_TYPE_TRANSFORM)
+	{
+		transform = (ecs_transform_t*)comp;
+		transform->rot.w = 1.0f;
+		transform->scale.x = transform->scale.y = transform->scale.z = 1.0f;
+		transform->parent = ECS_INVALID_ID;
+	}
+
+	cmd.op = ECS_CMD_OP_ADD;
+	cmd.type = (uint8_t)type;
+	cmd.ent = ent;
+	cmd.data_offset = offset;
+	utl_array_push(&buf->cmds, cmd);
+
+	return comp;
+}
+
+//## public
+/**
+Applies the commands from a set of buffers and empties them. Spawns are
+resolved first, then adds and removes are applied one component type at a
+time across all buffers, then entities are destroyed. Commands for the same
+component type keep the order they were recorded in within a buffer.
+
+@param bufs The buffers.
+@param num_bufs The number of buffers.
+@param ecs The ECS context.
+*/
+void ecs_cmd_buffer__apply(ecs_cmd_buffer_t* bufs, uint32_t num_bufs, ecs_t* ecs)
+{
+	ecs_cmd_buffer_t* buf;
+	uint32_t type;
+	uint32_t b, i;
+
+	/* Allocate real ids for spawned entities so later commands can refer to them */
+	for (b = 0; b < num_bufs; ++b)
+	{
+		buf = &bufs[b];
+
+		utl_array_resize(&buf->spawned, buf->num_spawns);
+		for (i = 0; i < buf->num_spawns; ++i)
+		{
+			buf->spawned.data[i] = ecs__alloc_entity(ecs);
+		}
+
+		sort_commands(buf);
+	}
+
+	/* Adds and removes, grouped by component type so each storage is touched once */
+	for (type = 0; type < ECS_COMPONENT_TYPE__COUNT; ++type)
+	{
+		for (b = 0; b < num_bufs; ++b)
+		{
+			buf = &bufs[b];
+			for (i = buf->bucket_start[type]; i < buf->bucket_start[type + 1]; ++i)
+			{
+				apply_component_cmd(buf, ecs, &buf->cmds.data[buf->order.data[i]]);
+			}
+		}
+	}
+
+	/* Parents can be set once every transform exists */
+	for (b = 0; b < num_bufs; ++b)
+	{
+		buf = &bufs[b];
+		for (i = buf->bucket_start[ECS_COMPONENT_TYPE_TRANSFORM]; i < buf->bucket_start[ECS_COMPONENT_TYPE_TRANSFORM + 1]; ++i)
+		{
+			ecs_cmd_t* cmd = &buf->cmds.data[buf->order.data[i]];
+			ecs_transform_t* transform = (ecs_transform_t*)(buf->data + cmd->data_offset);
+
+			if (cmd->op == ECS_CMD_OP_ADD && transform->parent != ECS_INVALID_ID)
+			{
+				ecs_transform__set_parent(ecs, resolve(buf, cmd->ent), resolve(buf, transform->parent));
+			}
+		}
+	}
+
+	/* Destroy entities last */
+	for (b = 0; b < num_bufs; ++b)
+	{
+		buf = &bufs[b];
+		for (i = buf->bucket_start[DESTROY_BUCKET]; i < buf->bucket_start[DESTROY_BUCKET + 1]; ++i)
+		{
+			entity_id_t ent = resolve(buf, buf->cmds.data[buf->order.data[i]].ent);
+			if (ent != ECS_INVALID_ID)
+			{
+				ecs__free_entity(ecs, ent);
+			}
+		}
+	}
+
+	for (b = 0; b < num_bufs; ++b)
+	{
+		ecs_cmd_buffer__clear(&bufs[b]);
+	}
+}
+
+//## public
+/**
+Discards all recorded commands. Allocations are kept for reuse.
+
+@param buf The buffer.
+*/
+void ecs_cmd_buffer__clear(ecs_cmd_buffer_t* buf)
+{
+	buf->cmds.count = 0;
+	buf->order.count = 0;
+	buf->spawned.count = 0;
+	buf->data_size = 0;
+	buf->num_spawns = 0;
+}
+
+//## public
+/**
+Records destroying an entity and all of its components.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+*/
+void ecs_cmd_buffer__destroy(ecs_cmd_buffer_t* buf, entity_id_t ent)
+{
+	ecs_cmd_t cmd;
+
+	clear_struct(&cmd);
+	cmd.op = ECS_CMD_OP_DESTROY;
+	cmd.ent = ent;
+	utl_array_push(&buf->cmds, cmd);
+}
+
+//## public
+/**
+Checks if a buffer has anything to apply.
+*/
+boolean ecs_cmd_buffer__is_empty(ecs_cmd_buffer_t* buf)
+{
+	return (buf->cmds.count == 0 && buf->num_spawns == 0);
+}
+
+//## public
+/**
+Records removing a component.
+
+@param buf The buffer.
+@param ent The entity id or a pending id from this buffer.
+@param type The component type.
+*/
+void ecs_cmd_buffer__remove(ecs_cmd_buffer_t* buf, entity_id_t ent, ecs_component_type_t type)
+{
+	ecs_cmd_t cmd;
+
+	clear_struct(&cmd);
+	cmd.op = ECS_CMD_OP_REMOVE;
+	cmd.type = (uint8_t)type;
+	cmd.ent = ent;
+	utl_array_push(&buf->cmds, cmd);
+}
+
+//## public
+/**
+Records spawning an entity. The returned pending id can be used with the
+other commands in this buffer. It is replaced by a real id when the buffer
+is applied.
+
+@param buf The buffer.
+@return The pending id.
+*/
+entity_id_t ecs_cmd_buffer__spawn(ecs_cmd_buffer_t* buf)
+{
+	return ECS_CMD_PENDING_BIT | buf->num_spawns++;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Applies an add or remove command.
+*/
+static void apply_component_cmd(ecs_cmd_buffer_t* buf, ecs_t* ecs, ecs_cmd_t* cmd)
+{
+	entity_id_t ent = resolve(buf, cmd->ent);
+	ecs_component_t* data = (ecs_component_t*)(buf->data + cmd->data_offset);
+	ecs_component_t* comp = NULL;
+
+	if (ent == ECS_INVALID_ID)
+	{
+		return;
+	}
+
+	if (cmd->op == ECS_CMD_OP_REMOVE)
+	{
+		switch (cmd->type)
+		{
+		case ECS_COMPONENT_TYPE_PHYSICS:		ecs_physics__remove(ecs, ent);		break;
+		case ECS_COMPONENT_TYPE_PLAYER:			ecs_player__remove(ecs, ent);		break;
+		case ECS_COMPONENT_TYPE_STATIC_MODEL:	ecs_static_model__remove(ecs, ent);	break;
+		case ECS_COMPONENT_TYPE_TRANSFORM:		ecs_transform__remove(ecs, ent);	break;
+		}
+
+		return;
+	}
+
+	switch (cmd->type)
+	{
+	case ECS_COMPONENT_TYPE_PHYSICS:
+		comp = (ecs_component_t*)ecs_physics__add(ecs, ent);
+		break;
+
+	case ECS_COMPONENT_TYPE_PLAYER:
+		comp = (ecs_component_t*)ecs_player__add(ecs, ent);
+		break;
+
+	case ECS_COMPONENT_TYPE_STATIC_MODEL:
+		comp = (ecs_component_t*)ecs_static_model__add(ecs, ent);
+		break;
+
+	case ECS_COMPONENT_TYPE_TRANSFORM:
+	{
+		/* Only copy the local transform, the rest is hierarchy bookkeeping. The parent is set after all adds. */
+		ecs_transform_t* transform = ecs_transform__add(ecs, ent);
+		if (transform)
+		{
+			transform->pos = ((ecs_transform_t*)data)->pos;
+			transform->rot = ((ecs_transform_t*)data)->rot;
+			transform->scale = ((ecs_transform_t*)data)->scale;
+		}
+		return;
+	}
+	}
+
+	if (comp)
+	{
+		/* Copy everything after the base */
+		memcpy(comp + 1, data + 1, COMPONENT_SIZES[cmd->type] - sizeof(ecs_component_t));
+	}
+}
+
+//## static
+/**
+Converts a pending id to the entity id it was given when applied. Other ids
+are returned unchanged.
+*/
+static entity_id_t resolve(ecs_cmd_buffer_t* buf, entity_id_t ent)
+{
+	uint32_t idx;
+
+	if (ent == ECS_INVALID_ID || !(ent & ECS_CMD_PENDING_BIT))
+	{
+		return ent;
+	}
+
+	idx = ent & ~ECS_CMD_PENDING_BIT;
+	if (idx >= buf->spawned.count)
+	{
+		kk_log__error("Pending entity id is from a different command buffer.");
+		return ECS_INVALID_ID;
+	}
+
+	return buf->spawned.data[idx];
+}
+
+//## static
+/**
+Counting sort of the command indices into one bucket per component type
+followed by a bucket of destroys. Keeps recorded order within a bucket.
+*/
+static void sort_commands(ecs_cmd_buffer_t* buf)
+{
+	uint32_t next[DESTROY_BUCKET + 1];
+	uint32_t bucket;
+	uint32_t i;
+
+	memset(buf->bucket_start, 0, sizeof(buf->bucket_start));
+
+	for (i = 0; i < buf->cmds.count; ++i)
+	{
+		buf->bucket_start[get_bucket(&buf->cmds.data[i]) + 1]++;
+	}
+
+	for (bucket = 0; bucket <= DESTROY_BUCKET; ++bucket)
+	{
+		buf->bucket_start[bucket + 1] += buf->bucket_start[bucket];
+		next[bucket] = buf->bucket_start[bucket];
+	}
+
+	utl_array_resize(&buf->order, buf->cmds.count);
+	for (i = 0; i < buf->cmds.count; ++i)
+	{
+		buf->order.data[next[get_bucket(&buf->cmds.data[i])]++] = i;
+	}
+}
+
+//## static
+static uint32_t get_bucket(ecs_cmd_t* cmd)
+{
+	return (cmd->op == ECS_CMD_OP_DESTROY) ? DESTROY_BUCKET : cmd->type;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef ECS_CMD_BUFFER_H
+#define ECS_CMD_BUFFER_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_cmd_buffer_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs_component.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+Entity ids returned by ecs_cmd_buffer__spawn have this bit set until the
+buffer is applied. Real entity ids never reach it.
+*/
+#define ECS_CMD_PENDING_BIT		(0x80000000)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef enum
+{
+	ECS_CMD_OP_ADD,
+	ECS_CMD_OP_REMOVE,
+	ECS_CMD_OP_DESTROY,
+
+} ecs_cmd_op_t;
+
+/**
+A recorded structural change.
+*/
+struct ecs_cmd_s
+{
+	uint8_t						op;				/* ecs_cmd_op_t */
+	uint8_t						type;			/* ecs_component_type_t. Unused for destroy. */
+	entity_id_t					ent;			/* Entity id or pending id. */
+	uint32_t					data_offset;	/* Offset of the component data for add. */
+};
+
+utl_array_declare_type(ecs_cmd_t);
+
+/**
+Records entity spawns, destroys and component adds/removes so they can be
+applied later at a point where no system is iterating the ECS. Each thread
+records into its own buffer.
+*/
+struct ecs_cmd_buffer_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(ecs_cmd_t)		cmds;
+	utl_array_t(uint32_t)		order;			/* Command indices grouped by component type, destroys last. Built when applied. */
+	utl_array_t(uint32_t)		spawned;		/* Real entity id for each pending id. Built when applied. */
+	uint8_t*					data;			/* Component data for add commands. */
+	uint32_t					data_capacity;
+
+	/*
+	Other
+	*/
+	uint32_t					data_size;
+	uint32_t					num_spawns;
+	uint32_t					bucket_start[ECS_COMPONENT_TYPE__COUNT + 2];	/* Start of each bucket in order. One bucket per component type, then destroys. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/ecs_cmd_buffer.public.h"
+
+#endif /* ECS_CMD_BUFFER_H */
\ No newline at end of file
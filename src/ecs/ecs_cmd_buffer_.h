@@ -0,0 +1,11 @@
+#ifndef ECS_CMD_BUFFER__H
+#define ECS_CMD_BUFFER__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct ecs_cmd_s ecs_cmd_t;
+typedef struct ecs_cmd_buffer_s ecs_cmd_buffer_t;
+
+#endif /* ECS_CMD_BUFFER__H */
\ No newline at end of file
@@ -21,12 +21,38 @@ INCLUDES
 CONSTANTS
 =========================================================*/
 
+/**
+Gets the signature bit for a component type.
+
+@param type The component type (ecs_component_type_t).
+*/
+#define ECS_COMPONENT_BIT(type)		((ecs_component_mask_t)1 << (type))
+
 /*=========================================================
 TYPES
 =========================================================*/
 
 utl_array_declare_type(ecs_component_prop_t);
 
+/**
+Bitmask of component types. Each entity has a mask (its signature) with a
+bit set for each component it has.
+*/
+typedef uint32_t ecs_component_mask_t;
+
+/**
+Component type ids. Used as the bit index in an ecs_component_mask_t.
+*/
+enum ecs_component_type_e
+{
+	ECS_COMPONENT_TYPE_PHYSICS,
+	ECS_COMPONENT_TYPE_PLAYER,
+	ECS_COMPONENT_TYPE_STATIC_MODEL,
+	ECS_COMPONENT_TYPE_TRANSFORM,
+
+	ECS_COMPONENT_TYPE__COUNT
+};
+
 enum ecs_component_prop_type_e
 {
 	ECS_COMPONENT_PROP_TYPE_BOOL,
@@ -35,6 +61,7 @@ enum ecs_component_prop_type_e
 	ECS_COMPONENT_PROP_TYPE_VEC3,
 	ECS_COMPONENT_PROP_TYPE_VEC4,
 	ECS_COMPONENT_PROP_TYPE_STRING,
+	ECS_COMPONENT_PROP_TYPE_ENTITY,		/* entity_id_t */
 
 	ECS_COMPONENT_PROP_TYPE__COUNT,
 };
@@ -53,7 +80,7 @@ Base struct for all components. Must be the chunk of data in each component.
 */
 struct ecs_component_s
 {
-	boolean 							is_used;
+	entity_id_t							entity;		/* The entity that owns this component. */
 };
 
 #endif /* ECS_COMPONENT_H */
\ No newline at end of file
@@ -8,5 +8,6 @@ DECLARATIONS
 typedef struct ecs_component_s ecs_component_t;
 typedef struct ecs_component_prop_s ecs_component_prop_t;
 typedef enum ecs_component_prop_type_e ecs_component_prop_type_t;
+typedef enum ecs_component_type_e ecs_component_type_t;
 
 #endif /* ECS_COMPONENT__H */
\ No newline at end of file
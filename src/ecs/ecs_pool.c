@@ -0,0 +1,130 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs_pool.h"
+#include "engine/kk_log.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+/*
+Want to keep these inline when possible. Need to have extern declarations in the source
+file to keep compiler happen since this is in a static library.
+*/
+
+extern void* ecs_pool__get(ecs_pool_t* pool, uint32_t idx);
+extern uint32_t ecs_pool__get_capacity(ecs_pool_t* pool);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty pool. No chunks are allocated until the pool is grown.
+
+@param pool The pool to construct.
+@param elem_size The size of an element.
+@param fill Byte value that new chunks are filled with.
+*/
+void ecs_pool__construct(ecs_pool_t* pool, size_t elem_size, uint8_t fill)
+{
+	clear_struct(pool);
+	pool->elem_size = elem_size;
+	pool->fill = fill;
+}
+
+//## public
+/**
+Destructs a pool and frees all chunks.
+
+@param pool The pool to destruct.
+*/
+void ecs_pool__destruct(ecs_pool_t* pool)
+{
+	uint32_t i;
+
+	for (i = 0; i < pool->num_chunks; ++i)
+	{
+		free(pool->chunks[i]);
+	}
+
+	free(pool->chunks);
+	clear_struct(pool);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Gets the number of bytes allocated by the pool.
+*/
+size_t ecs_pool__get_memory_usage(ecs_pool_t* pool)
+{
+	return (size_t)pool->num_chunks * ECS_POOL_CHUNK_SIZE * pool->elem_size
+		+ (size_t)pool->max_chunks * sizeof(uint8_t*);
+}
+
+//## public
+/**
+Grows the pool so it can hold at least the specified number of elements.
+Existing chunks are not moved.
+
+@param pool The pool.
+@param count The number of elements required.
+*/
+void ecs_pool__reserve(ecs_pool_t* pool, uint32_t count)
+{
+	uint32_t needed_chunks = (uint32_t)(((uint64_t)count + ECS_POOL_CHUNK_MASK) >> ECS_POOL_CHUNK_SHIFT);
+	size_t chunk_bytes = ECS_POOL_CHUNK_SIZE * pool->elem_size;
+
+	if (needed_chunks <= pool->num_chunks)
+	{
+		return;
+	}
+
+	/* Grow the chunk pointer table */
+	if (needed_chunks > pool->max_chunks)
+	{
+		uint32_t new_max = pool->max_chunks ? pool->max_chunks * 2 : 4;
+		uint8_t** new_chunks;
+
+		while (new_max < needed_chunks)
+		{
+			new_max *= 2;
+		}
+
+		new_chunks = (uint8_t**)realloc(pool->chunks, sizeof(uint8_t*) * new_max);
+		if (!new_chunks)
+		{
+			kk_log__fatal("Failed to grow ECS pool chunk table.");
+		}
+
+		pool->chunks = new_chunks;
+		pool->max_chunks = new_max;
+	}
+
+	/* Allocate new chunks */
+	while (pool->num_chunks < needed_chunks)
+	{
+		uint8_t* chunk = (uint8_t*)malloc(chunk_bytes);
+		if (!chunk)
+		{
+			kk_log__fatal("Failed to allocate ECS pool chunk.");
+		}
+
+		memset(chunk, pool->fill, chunk_bytes);
+		pool->chunks[pool->num_chunks++] = chunk;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef ECS_POOL_H
+#define ECS_POOL_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_pool_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define ECS_POOL_CHUNK_SHIFT 8
+#define ECS_POOL_CHUNK_SIZE (1 << ECS_POOL_CHUNK_SHIFT)		/* Number of elements in a chunk. */
+#define ECS_POOL_CHUNK_MASK (ECS_POOL_CHUNK_SIZE - 1)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Growable array of fixed size elements stored in fixed size chunks. Growing
+the pool allocates new chunks instead of reallocating existing ones, so
+element data is never copied and pointers to elements stay valid for the
+life of the pool. Only the small table of chunk pointers is reallocated.
+*/
+struct ecs_pool_s
+{
+	/*
+	Create/destroy
+	*/
+	uint8_t**					chunks;			/* Chunk pointer table. */
+	uint32_t					max_chunks;		/* Capacity of the chunk pointer table. */
+
+	/*
+	Other
+	*/
+	uint32_t					num_chunks;		/* Number of allocated chunks. */
+	size_t						elem_size;		/* Size of an element in bytes. */
+	uint8_t						fill;			/* Byte value new chunks are filled with. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Gets the element at the specified index.
+
+@param pool The pool.
+@param idx The element index. Must be less than the pool capacity.
+@return The element.
+*/
+KK_INLINE
+void* ecs_pool__get(ecs_pool_t* pool, uint32_t idx)
+{
+	return (void*)(pool->chunks[idx >> ECS_POOL_CHUNK_SHIFT] + (size_t)(idx & ECS_POOL_CHUNK_MASK) * pool->elem_size);
+}
+
+/**
+Gets the number of elements the pool can hold without growing.
+*/
+KK_INLINE
+uint32_t ecs_pool__get_capacity(ecs_pool_t* pool)
+{
+	return pool->num_chunks << ECS_POOL_CHUNK_SHIFT;
+}
+
+#include "autogen/ecs_pool.public.h"
+
+#endif /* ECS_POOL_H */
\ No newline at end of file
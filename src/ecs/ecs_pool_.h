@@ -0,0 +1,10 @@
+#ifndef ECS_POOL__H
+#define ECS_POOL__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct ecs_pool_s ecs_pool_t;
+
+#endif /* ECS_POOL__H */
\ No newline at end of file
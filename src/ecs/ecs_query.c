@@ -0,0 +1,119 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/ecs_query.h"
+#include "ecs/ecs_sparse_set.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs a query. The match list starts empty.
+
+@param query The query to construct.
+@param required Component bits an entity must have.
+@param excluded Component bits an entity must not have.
+*/
+void ecs_query__construct(ecs_query_t* query, ecs_component_mask_t required, ecs_component_mask_t excluded)
+{
+	clear_struct(query);
+	query->required = required;
+	query->excluded = excluded;
+
+	ecs_sparse_set__construct(&query->matches, sizeof(ecs_component_t));
+}
+
+//## public
+/**
+Destructs a query.
+
+@param query The query to destruct.
+*/
+void ecs_query__destruct(ecs_query_t* query)
+{
+	ecs_sparse_set__destruct(&query->matches);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Gets the number of matching entities.
+*/
+uint32_t ecs_query__get_count(ecs_query_t* query)
+{
+	return query->matches.count;
+}
+
+//## public
+/**
+Gets a matching entity by index. Index must be less than the match count.
+*/
+entity_id_t ecs_query__get_entity(ecs_query_t* query, uint32_t idx)
+{
+	return ((ecs_component_t*)ecs_sparse_set__get_at(&query->matches, idx))->entity;
+}
+
+//## public
+/**
+Gets the first matching entity. Used for queries that are expected to
+match a single entity, such as the player.
+
+@return The entity id, or ECS_INVALID_ID if nothing matches.
+*/
+entity_id_t ecs_query__get_single(ecs_query_t* query)
+{
+	if (query->matches.count == 0)
+	{
+		return ECS_INVALID_ID;
+	}
+
+	return ecs_query__get_entity(query, 0);
+}
+
+//## public
+/**
+Checks if a signature matches the query. An empty signature never matches
+since the entity has no components.
+*/
+boolean ecs_query__is_match(ecs_query_t* query, ecs_component_mask_t mask)
+{
+	return mask
+		&& ((mask & query->required) == query->required)
+		&& !(mask & query->excluded);
+}
+
+//## public
+/**
+Adds or removes an entity from the match list based on its signature.
+
+@param query The query.
+@param ent The entity id.
+@param mask The entity's current signature.
+*/
+void ecs_query__update(ecs_query_t* query, entity_id_t ent, ecs_component_mask_t mask)
+{
+	boolean is_match = ecs_query__is_match(query, mask);
+	boolean has = ecs_sparse_set__has(&query->matches, ent);
+
+	if (is_match && !has)
+	{
+		ecs_sparse_set__add(&query->matches, ent);
+	}
+	else if (!is_match && has)
+	{
+		ecs_sparse_set__remove(&query->matches, ent);
+	}
+}
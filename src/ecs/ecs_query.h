@@ -0,0 +1,49 @@
+#ifndef ECS_QUERY_H
+#define ECS_QUERY_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_query_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs_component.h"
+#include "ecs/ecs_sparse_set.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+A cached list of entities whose signature has all of the required
+component bits and none of the excluded bits. The match list is updated
+by the ECS as components are added and removed, so systems can iterate
+it directly instead of filtering every entity each frame.
+*/
+struct ecs_query_s
+{
+	/*
+	Create/destroy
+	*/
+	ecs_sparse_set_t			matches;		/* Set of ecs_component_t, one for each matching entity. */
+
+	/*
+	Other
+	*/
+	ecs_component_mask_t		required;		/* Component bits an entity must have. */
+	ecs_component_mask_t		excluded;		/* Component bits an entity must not have. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/ecs_query.public.h"
+
+#endif /* ECS_QUERY_H */
\ No newline at end of file
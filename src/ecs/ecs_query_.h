@@ -0,0 +1,10 @@
+#ifndef ECS_QUERY__H
+#define ECS_QUERY__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct ecs_query_s ecs_query_t;
+
+#endif /* ECS_QUERY__H */
\ No newline at end of file
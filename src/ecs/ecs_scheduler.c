@@ -0,0 +1,291 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "global.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_scheduler.h"
+#include "engine/kk_job.h"
+#include "engine/kk_log.h"
+#include "platform/platform.h"
+
+#include "autogen/ecs_scheduler.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define AVERAGE_WEIGHT		(0.1f)		/* Weight of the latest run in the running average. */
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty scheduler.
+
+@param sched The scheduler to construct.
+*/
+void ecs_scheduler__construct(ecs_scheduler_t* sched)
+{
+	clear_struct(sched);
+}
+
+//## public
+/**
+Destructs a scheduler.
+
+@param sched The scheduler to destruct.
+*/
+void ecs_scheduler__destruct(ecs_scheduler_t* sched)
+{
+	clear_struct(sched);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Adds a system. Systems that conflict run in the order they were added.
+
+@param sched The scheduler.
+@param name Name used in the schedule dump. Must outlive the scheduler.
+@param func The system function.
+@param context User context passed to func.
+@param reads Component types the system reads.
+@param writes Component types the system writes.
+@param flags ECS_SYSTEM_FLAG_* bits.
+@return The index of the system.
+*/
+uint32_t ecs_scheduler__add(ecs_scheduler_t* sched, const char* name, ecs_system_func func, void* context, ecs_component_mask_t reads, ecs_component_mask_t writes, uint32_t flags)
+{
+	ecs_system_t* sys;
+
+	if (sched->num_systems == ECS_SCHEDULER_MAX_SYSTEMS)
+	{
+		kk_log__fatal("Too many ECS systems.");
+	}
+
+	sys = &sched->systems[sched->num_systems];
+	clear_struct(sys);
+	sys->name = name;
+	sys->func = func;
+	sys->context = context;
+	sys->reads = reads;
+	sys->writes = writes;
+	sys->flags = flags;
+
+	return sched->num_systems++;
+}
+
+//## public
+/**
+Makes a system wait for an earlier system even if they share no component
+types. Use for state outside the ECS, like a camera.
+
+@param sched The scheduler.
+@param system Index of the system that waits.
+@param depends_on Index of the system to wait for. Must have been added before system.
+*/
+void ecs_scheduler__add_dependency(ecs_scheduler_t* sched, uint32_t system, uint32_t depends_on)
+{
+	if (system >= sched->num_systems || depends_on >= system)
+	{
+		kk_log__error("A system can only depend on a system added before it.");
+		return;
+	}
+
+	sched->systems[system].after |= (1u << depends_on);
+}
+
+//## public
+/**
+Logs the schedule and the timings from the last run.
+
+@param sched The scheduler.
+*/
+void ecs_scheduler__dump(ecs_scheduler_t* sched)
+{
+	ecs_system_t* sys;
+	uint32_t stage;
+	uint32_t i;
+
+	build_schedule(sched);
+
+	kk_log__info_fmt("System schedule: %u systems in %u stages. Last frame %.3f ms.", sched->num_systems, sched->num_stages, sched->frame_ms);
+
+	for (stage = 0; stage < sched->num_stages; ++stage)
+	{
+		kk_log__info_fmt("  Stage %u", stage);
+
+		for (i = 0; i < sched->num_systems; ++i)
+		{
+			sys = &sched->systems[i];
+			if (sys->stage != stage)
+			{
+				continue;
+			}
+
+			kk_log__info_fmt("    %-20s reads 0x%08x writes 0x%08x depends 0x%08x%s | start %.3f ms, last %.3f ms, avg %.3f ms",
+				sys->name,
+				sys->reads,
+				sys->writes,
+				sys->depends_on,
+				(sys->flags & ECS_SYSTEM_FLAG_MAIN_THREAD) ? " main thread" : "",
+				sys->start_ms,
+				sys->time_ms,
+				sys->avg_ms);
+		}
+	}
+}
+
+//## public
+/**
+Runs every system. Stages run in order. Systems in a stage run concurrently
+on the job system, except for main thread systems which the calling thread
+runs itself. The schedule is rebuilt each run. Commands recorded in the ECS
+command buffers are applied after the last stage.
+
+@param sched The scheduler.
+@param ecs The ECS context passed to the systems.
+*/
+void ecs_scheduler__run(ecs_scheduler_t* sched, ecs_t* ecs)
+{
+	kk_job_counter_t counter;
+	kk_job_t job;
+	uint32_t stage;
+	uint32_t i;
+
+	build_schedule(sched);
+
+	sched->ecs = ecs;
+	sched->frame_start = get_time();
+
+	job.func = run_system_job;
+	job.data = sched;
+	job.counter = &counter;
+
+	for (stage = 0; stage < sched->num_stages; ++stage)
+	{
+		clear_struct(&counter);
+
+		for (i = 0; i < sched->num_systems; ++i)
+		{
+			if (sched->systems[i].stage != stage)
+			{
+				continue;
+			}
+
+			/* ecs__query caches new queries, so nothing runs concurrently until every system has run once */
+			if (sched->num_runs == 0 || (sched->systems[i].flags & ECS_SYSTEM_FLAG_MAIN_THREAD))
+			{
+				run_system(sched, i);
+				continue;
+			}
+
+			job.start = i;
+			job.end = i + 1;
+			kk_job__run(g_jobs, &job);
+		}
+
+		kk_job__wait(g_jobs, &counter);
+	}
+
+	/* Structural changes recorded by the systems are applied once nothing is iterating */
+	if (ecs)
+	{
+		ecs__apply_commands(ecs);
+	}
+
+	sched->frame_ms = (float)((get_time() - sched->frame_start) * 1000.0);
+	sched->ecs = NULL;
+	sched->num_runs++;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Works out the dependencies and stage of each system.
+*/
+static void build_schedule(ecs_scheduler_t* sched)
+{
+	ecs_system_t* sys;
+	ecs_system_t* prev;
+	uint32_t i, j;
+
+	sched->num_stages = 0;
+
+	for (i = 0; i < sched->num_systems; ++i)
+	{
+		sys = &sched->systems[i];
+		sys->depends_on = sys->after;
+		sys->stage = 0;
+
+		for (j = 0; j < i; ++j)
+		{
+			prev = &sched->systems[j];
+
+			if ((prev->writes & (sys->reads | sys->writes)) || (sys->writes & prev->reads))
+			{
+				sys->depends_on |= (1u << j);
+			}
+
+			if (sys->depends_on & (1u << j))
+			{
+				sys->stage = max(sys->stage, prev->stage + 1);
+			}
+		}
+
+		sched->num_stages = max(sched->num_stages, sys->stage + 1);
+	}
+}
+
+//## static
+/**
+Gets the time in seconds, or 0 if the platform has no timer.
+*/
+static double get_time()
+{
+	if (!g_platform || !g_platform->get_time)
+	{
+		return 0.0;
+	}
+
+	return g_platform->get_time(g_platform);
+}
+
+//## static
+/**
+Runs a system and records how long it took.
+*/
+static void run_system(ecs_scheduler_t* sched, uint32_t idx)
+{
+	ecs_system_t* sys = &sched->systems[idx];
+	double start = get_time();
+
+	sys->func(sched->ecs, sys->context);
+
+	sys->start_ms = (float)((start - sched->frame_start) * 1000.0);
+	sys->time_ms = (float)((get_time() - start) * 1000.0);
+	sys->avg_ms = (sched->num_runs == 0) ? sys->time_ms : sys->avg_ms + (sys->time_ms - sys->avg_ms) * AVERAGE_WEIGHT;
+}
+
+//## static
+/**
+Job that runs the system at index start.
+*/
+static void run_system_job(void* data, uint32_t start, uint32_t end)
+{
+	run_system((ecs_scheduler_t*)data, start);
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef ECS_SCHEDULER_H
+#define ECS_SCHEDULER_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_scheduler_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs_component.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define ECS_SCHEDULER_MAX_SYSTEMS		(32)		/* Dependencies are stored as a bit per system. */
+
+/*
+System flags
+*/
+#define ECS_SYSTEM_FLAG_MAIN_THREAD		(1 << 0)	/* Always runs on the thread that calls ecs_scheduler__run. Use for systems that touch the GPU or window. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+System function.
+
+@param ecs The ECS context.
+@param context User context given when the system was added.
+*/
+typedef void (*ecs_system_func)(ecs_t* ecs, void* context);
+
+/**
+A system registered with the scheduler. The component types it reads and
+writes decide which other systems it can run alongside.
+*/
+struct ecs_system_s
+{
+	/*
+	Declaration
+	*/
+	const char*					name;
+	ecs_system_func				func;
+	void*						context;
+	ecs_component_mask_t		reads;			/* Component types the system reads. */
+	ecs_component_mask_t		writes;			/* Component types the system writes. */
+	uint32_t					flags;			/* ECS_SYSTEM_FLAG_* */
+	uint32_t					after;			/* Systems that must run first regardless of components. Bit per system index. */
+
+	/*
+	Schedule
+	*/
+	uint32_t					depends_on;		/* Every earlier system that must finish first. Bit per system index. */
+	uint32_t					stage;			/* Systems in the same stage have no conflicts and run concurrently. */
+
+	/*
+	Timing
+	*/
+	float						start_ms;		/* Start of the last run relative to the start of the frame. */
+	float						time_ms;		/* Duration of the last run. */
+	float						avg_ms;			/* Running average of the duration. */
+};
+
+/**
+Runs ECS systems in stages. A system conflicts with an earlier one if either
+writes a component type the other reads or writes. Each system is placed in
+the stage after the last system it conflicts with, so the schedule only
+depends on the order systems were added.
+*/
+struct ecs_scheduler_s
+{
+	/*
+	Create/destroy
+	*/
+	ecs_system_t				systems[ECS_SCHEDULER_MAX_SYSTEMS];
+	uint32_t					num_systems;
+
+	/*
+	Other
+	*/
+	ecs_t*						ecs;			/* ECS being run. Only valid during ecs_scheduler__run. */
+	uint32_t					num_stages;
+	uint32_t					num_runs;		/* The first run is serial so systems can create their queries safely. */
+	double						frame_start;	/* Time the current run started, in seconds. */
+	float						frame_ms;		/* Duration of the last run. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/ecs_scheduler.public.h"
+
+#endif /* ECS_SCHEDULER_H */
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef ECS_SCHEDULER__H
+#define ECS_SCHEDULER__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct ecs_scheduler_s ecs_scheduler_t;
+typedef struct ecs_system_s ecs_system_t;
+
+#endif /* ECS_SCHEDULER__H */
\ No newline at end of file
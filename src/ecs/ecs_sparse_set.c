@@ -0,0 +1,198 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/ecs_sparse_set.h"
+#include "engine/kk_log.h"
+
+#include "autogen/ecs_sparse_set.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+/*
+Want to keep these inline when possible. Need to have extern declarations in the source
+file to keep compiler happen since this is in a static library.
+*/
+
+extern void* ecs_sparse_set__get_at(ecs_sparse_set_t* set, uint32_t idx);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty sparse set. Storage is allocated as components are added.
+
+@param set The set to construct.
+@param elem_size The size of a component. Components must begin with an ecs_component_t.
+*/
+void ecs_sparse_set__construct(ecs_sparse_set_t* set, size_t elem_size)
+{
+	clear_struct(set);
+	set->elem_size = elem_size;
+
+	ecs_pool__construct(&set->dense, elem_size, 0);
+
+	/* New sparse chunks are filled with 0xFF so no entity has a component yet */
+	ecs_pool__construct(&set->sparse, sizeof(uint32_t), 0xFF);
+}
+
+//## public
+/**
+Destructs a sparse set.
+
+@param set The set to destruct.
+*/
+void ecs_sparse_set__destruct(ecs_sparse_set_t* set)
+{
+	ecs_pool__destruct(&set->dense);
+	ecs_pool__destruct(&set->sparse);
+	clear_struct(set);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Adds a component for an entity. The component is zeroed. If the entity
+already has the component, the existing component is zeroed and returned.
+
+@param set The set.
+@param ent The entity id.
+@return The component, or NULL if the entity id is invalid.
+*/
+void* ecs_sparse_set__add(ecs_sparse_set_t* set, entity_id_t ent)
+{
+	ecs_component_t* comp;
+	uint32_t* sparse;
+
+	if (ent == ECS_INVALID_ID)
+	{
+		kk_log__error("Invalid entity id for sparse set.");
+		return NULL;
+	}
+
+	ecs_pool__reserve(&set->sparse, ent + 1);
+	sparse = (uint32_t*)ecs_pool__get(&set->sparse, ent);
+	if (*sparse == ECS_INVALID_ID)
+	{
+		/* Append to the end of the dense array */
+		ecs_pool__reserve(&set->dense, set->count + 1);
+		*sparse = set->count++;
+	}
+
+	comp = (ecs_component_t*)ecs_sparse_set__get_at(set, *sparse);
+	memset(comp, 0, set->elem_size);
+	comp->entity = ent;
+
+	return comp;
+}
+
+//## public
+/**
+Gets the component for an entity.
+
+@param set The set.
+@param ent The entity id.
+@return The component, or NULL if the entity does not have one.
+*/
+void* ecs_sparse_set__get(ecs_sparse_set_t* set, entity_id_t ent)
+{
+	uint32_t slot = get_slot(set, ent);
+	if (slot == ECS_INVALID_ID)
+	{
+		return NULL;
+	}
+
+	return ecs_sparse_set__get_at(set, slot);
+}
+
+//## public
+/**
+Gets the number of bytes allocated by the set.
+*/
+size_t ecs_sparse_set__get_memory_usage(ecs_sparse_set_t* set)
+{
+	return ecs_pool__get_memory_usage(&set->dense) + ecs_pool__get_memory_usage(&set->sparse);
+}
+
+//## public
+/**
+Checks if an entity has a component in the set.
+
+@param set The set.
+@param ent The entity id.
+@return TRUE if the entity has the component.
+*/
+boolean ecs_sparse_set__has(ecs_sparse_set_t* set, entity_id_t ent)
+{
+	return (get_slot(set, ent) != ECS_INVALID_ID);
+}
+
+//## public
+/**
+Removes the component for an entity. The last component in the dense array
+is moved into the freed slot to keep the array packed, so pointers to that
+component are invalidated.
+
+@param set The set.
+@param ent The entity id.
+*/
+void ecs_sparse_set__remove(ecs_sparse_set_t* set, entity_id_t ent)
+{
+	ecs_component_t* last;
+	uint32_t slot;
+	uint32_t last_slot;
+
+	slot = get_slot(set, ent);
+	if (slot == ECS_INVALID_ID)
+	{
+		return;
+	}
+
+	last_slot = set->count - 1;
+
+	/* Move the last component into the hole */
+	if (slot != last_slot)
+	{
+		last = (ecs_component_t*)ecs_sparse_set__get_at(set, last_slot);
+		memcpy(ecs_sparse_set__get_at(set, slot), last, set->elem_size);
+		*(uint32_t*)ecs_pool__get(&set->sparse, last->entity) = slot;
+	}
+
+	*(uint32_t*)ecs_pool__get(&set->sparse, ent) = ECS_INVALID_ID;
+	set->count--;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Gets the dense slot for an entity, or ECS_INVALID_ID if the entity does not
+have a component. Entity ids past the end of the sparse index have none.
+*/
+static uint32_t get_slot(ecs_sparse_set_t* set, entity_id_t ent)
+{
+	if (ent >= ecs_pool__get_capacity(&set->sparse))
+	{
+		return ECS_INVALID_ID;
+	}
+
+	return *(uint32_t*)ecs_pool__get(&set->sparse, ent);
+}
@@ -0,0 +1,69 @@
+#ifndef ECS_SPARSE_SET_H
+#define ECS_SPARSE_SET_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_component_.h"
+#include "ecs/ecs_sparse_set_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs_pool.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Sparse set storage for a component type. Components are packed in a dense
+array so systems only visit live components. The sparse index maps an entity
+id to the dense slot that holds the entity's component.
+
+Each element must begin with an ecs_component_t so the owning entity of a
+dense slot is known when removing components.
+
+Both arrays are chunked pools that grow as components are added, so there
+is no fixed entity limit. Components do not move when the set grows, only
+when another component is swap-removed into their slot.
+*/
+struct ecs_sparse_set_s
+{
+	/*
+	Create/destroy
+	*/
+	ecs_pool_t					dense;			/* Packed component data. */
+	ecs_pool_t					sparse;			/* Entity id -> dense slot (uint32_t). ECS_INVALID_ID if the entity does not have the component. */
+
+	/*
+	Other
+	*/
+	uint32_t					count;			/* Number of components in the dense array. */
+	size_t						elem_size;		/* Size of a component in bytes. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Gets the component in the specified dense slot. Used to iterate the set.
+
+@param set The set.
+@param idx The dense slot index. Must be less than the set count.
+@return The component.
+*/
+KK_INLINE
+void* ecs_sparse_set__get_at(ecs_sparse_set_t* set, uint32_t idx)
+{
+	return ecs_pool__get(&set->dense, idx);
+}
+
+#include "autogen/ecs_sparse_set.public.h"
+
+#endif /* ECS_SPARSE_SET_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef ECS_SPARSE_SET__H
+#define ECS_SPARSE_SET__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct ecs_sparse_set_s ecs_sparse_set_t;
+
+#endif /* ECS_SPARSE_SET__H */
\ No newline at end of file
@@ -0,0 +1,459 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "global.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_bvh.h"
+#include "engine/kk_job.h"
+#include "engine/kk_math.h"
+#include "gpu/gpu_static_model.h"
+#include "platform/platform.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define COLLIDER_MASK	(ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM))
+
+#define RAY_GRAIN_SIZE	(64)	/* Rays per job in a batch. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	collision_system_t*			cs;
+	ecs_t*						ecs;
+	kk_aabb_t					box;
+	kk_vec3_t					center;
+	float						radius;
+	utl_array_t(uint32_t)*		entities;
+
+} overlap_query_t;
+
+typedef struct
+{
+	collision_system_t*			cs;
+	ecs_t*						ecs;
+	collision_system_hit_t*		hit;
+
+} raycast_query_t;
+
+typedef struct
+{
+	collision_system_t*			cs;
+	ecs_t*						ecs;
+	kk_ray_t*					rays;
+	collision_system_hit_t*		hits;
+
+} raycast_batch_job_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static gpu_static_model_t* get_collider(collision_system_t* cs, ecs_t* ecs, uint32_t proxy, kk_mat4_t* out__m);
+static uint32_t* get_proxy(collision_system_t* cs, entity_id_t ent);
+static boolean overlap_aabb_proxy(void* data, uint32_t proxy);
+static boolean overlap_sphere_proxy(void* data, uint32_t proxy);
+static float raycast_proxy(void* data, uint32_t proxy, kk_ray_t* ray);
+static void raycast_range(void* data, uint32_t start, uint32_t end);
+static void remove_stale_proxies(collision_system_t* cs, ecs_t* ecs);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+/**
+Constructs the collision system.
+
+@param cs The collision system to construct.
+*/
+void collision_system__construct(collision_system_t* cs)
+{
+	clear_struct(cs);
+	kk_broadphase__construct(&cs->broadphase);
+	utl_array_init(&cs->proxies);
+	kk_contacts__construct(&cs->contacts);
+	kk_islands__construct(&cs->islands);
+}
+
+/**
+Destructs the collision system.
+
+@param cs The collision system to destruct.
+*/
+void collision_system__destruct(collision_system_t* cs)
+{
+	kk_islands__destruct(&cs->islands);
+	kk_contacts__destruct(&cs->contacts);
+	utl_array_destroy(&cs->proxies);
+	kk_broadphase__destruct(&cs->broadphase);
+	clear_struct(cs);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Gets the world space bounds of a model at the transform's current tick.
+Uses the tick's pose rather than the cached world matrix, which may be
+blended between ticks or not rebuilt yet.
+
+@param ecs The ECS context.
+@param transform The transform.
+@param model The model.
+@param out__bounds The bounds.
+*/
+void collision_system__get_world_bounds(ecs_t* ecs, ecs_transform_t* transform, gpu_static_model_t* model, kk_aabb_t* out__bounds)
+{
+	ecs_transform__get_world_bounds(ecs, transform, 1.0f, &model->bounds, NULL, out__bounds, NULL);
+}
+
+/**
+Finds the colliders whose triangles overlap a box.
+
+@param cs The collision system.
+@param ecs The ECS context.
+@param box The box.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void collision_system__overlap_aabb(collision_system_t* cs, ecs_t* ecs, kk_aabb_t* box, utl_array_t(uint32_t)* out__entities)
+{
+	overlap_query_t query;
+
+	clear_struct(&query);
+	query.cs = cs;
+	query.ecs = ecs;
+	query.box = *box;
+	query.entities = out__entities;
+
+	out__entities->count = 0;
+	kk_broadphase__query(&cs->broadphase, box, overlap_aabb_proxy, &query);
+}
+
+/**
+Finds the colliders whose triangles overlap a sphere.
+
+@param cs The collision system.
+@param ecs The ECS context.
+@param center The center of the sphere.
+@param radius The radius of the sphere.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void collision_system__overlap_sphere(collision_system_t* cs, ecs_t* ecs, kk_vec3_t* center, float radius, utl_array_t(uint32_t)* out__entities)
+{
+	overlap_query_t query;
+
+	clear_struct(&query);
+	query.cs = cs;
+	query.ecs = ecs;
+	query.center = *center;
+	query.radius = radius;
+	query.entities = out__entities;
+
+	query.box.min.x = center->x - radius;
+	query.box.min.y = center->y - radius;
+	query.box.min.z = center->z - radius;
+	query.box.max.x = center->x + radius;
+	query.box.max.y = center->y + radius;
+	query.box.max.z = center->z + radius;
+
+	out__entities->count = 0;
+	kk_broadphase__query(&cs->broadphase, &query.box, overlap_sphere_proxy, &query);
+}
+
+/**
+Finds the closest collider triangle a ray hits. The broadphase tree narrows
+the colliders down to those whose boxes the ray passes through, nearest hit
+first clipping the rest, and each is tested against its model's triangle
+tree in model space.
+
+Queries see colliders where the last collision_system__run left them, at
+their tick pose. They only read shared state, so any number can run at once
+while nothing modifies the ECS.
+
+@param cs The collision system.
+@param ecs The ECS context.
+@param ray The ray, in world space.
+@param out__hit The closest hit. Its entity is ECS_INVALID_ID if there is none.
+@return TRUE if the ray hit a collider.
+*/
+boolean collision_system__raycast(collision_system_t* cs, ecs_t* ecs, kk_ray_t* ray, collision_system_hit_t* out__hit)
+{
+	raycast_query_t query;
+
+	clear_struct(out__hit);
+	out__hit->entity = ECS_INVALID_ID;
+	out__hit->t = ray->max_t;
+
+	query.cs = cs;
+	query.ecs = ecs;
+	query.hit = out__hit;
+	kk_broadphase__raycast(&cs->broadphase, ray, raycast_proxy, &query);
+
+	if (out__hit->entity == ECS_INVALID_ID)
+	{
+		return FALSE;
+	}
+
+	out__hit->point.x = ray->origin.x + ray->dir.x * out__hit->t;
+	out__hit->point.y = ray->origin.y + ray->dir.y * out__hit->t;
+	out__hit->point.z = ray->origin.z + ray->dir.z * out__hit->t;
+
+	return TRUE;
+}
+
+/**
+Casts a batch of rays, split across the job system's threads.
+
+@param cs The collision system.
+@param ecs The ECS context.
+@param rays The rays, in world space.
+@param count The number of rays.
+@param out__hits The closest hit for each ray, as collision_system__raycast.
+*/
+void collision_system__raycast_batch(collision_system_t* cs, ecs_t* ecs, kk_ray_t* rays, uint32_t count, collision_system_hit_t* out__hits)
+{
+	raycast_batch_job_t job;
+
+	job.cs = cs;
+	job.ecs = ecs;
+	job.rays = rays;
+	job.hits = out__hits;
+	kk_job__parallel_for(g_jobs, count, RAY_GRAIN_SIZE, raycast_range, &job);
+}
+
+/**
+Syncs the broadphase with the colliders in the ECS and finds the pairs of
+colliders that may touch. New colliders are added, dynamic colliders and
+static colliders with a dirty transform are moved, and removed colliders are
+dropped. Sleeping bodies are static until they wake. Must run after anything
+that moves entities and before the transform system clears the dirty flags.
+
+@param cs The collision system.
+@param ecs The ECS context.
+*/
+void collision_system__run(collision_system_t* cs, ecs_t* ecs)
+{
+	ecs_query_t* query = ecs__query(ecs, COLLIDER_MASK, 0);
+	ecs_physics_t* phys;
+	ecs_static_model_t* sm;
+	ecs_transform_t* transform;
+	kk_aabb_t bounds;
+	uint32_t* proxy;
+	boolean is_static;
+	uint32_t i;
+
+	remove_stale_proxies(cs, ecs);
+
+	/* The transform pass runs after collision, so a static child of a moving parent would not look dirty yet */
+	transform_system__propagate_dirty(ecs);
+
+	for (i = 0; i < ecs_query__get_count(query); ++i)
+	{
+		entity_id_t ent = ecs_query__get_entity(query, i);
+
+		sm = ecs_static_model__get(ecs, ent);
+		if (!sm->model)
+		{
+			continue;
+		}
+
+		transform = ecs_transform__get(ecs, ent);
+		phys = ecs_physics__get(ecs, ent);
+		is_static = !phys || phys->sleeping;
+		proxy = get_proxy(cs, ent);
+
+		if (*proxy == KK_BROADPHASE_NULL)
+		{
+			collision_system__get_world_bounds(ecs, transform, sm->model, &bounds);
+			*proxy = kk_broadphase__add(&cs->broadphase, &bounds, ent, is_static);
+			continue;
+		}
+
+		if (kk_broadphase__is_static(&cs->broadphase, *proxy) != is_static)
+		{
+			kk_broadphase__set_static(&cs->broadphase, *proxy, is_static);
+		}
+
+		if (!is_static || transform->dirty)
+		{
+			collision_system__get_world_bounds(ecs, transform, sm->model, &bounds);
+			kk_broadphase__move(&cs->broadphase, *proxy, &bounds);
+		}
+	}
+
+	kk_broadphase__update_pairs(&cs->broadphase);
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+/**
+Gets the model and tick pose world matrix of a broadphase proxy's collider.
+*/
+static gpu_static_model_t* get_collider(collision_system_t* cs, ecs_t* ecs, uint32_t proxy, kk_mat4_t* out__m)
+{
+	entity_id_t ent = kk_broadphase__get_user_data(&cs->broadphase, proxy);
+
+	ecs_transform__get_world_matrix(ecs, ecs_transform__get(ecs, ent), out__m);
+	return ecs_static_model__get(ecs, ent)->model;
+}
+
+/**
+Gets the proxy slot for an entity, growing the map if needed.
+*/
+static uint32_t* get_proxy(collision_system_t* cs, entity_id_t ent)
+{
+	uint32_t count = cs->proxies.count;
+	uint32_t i;
+
+	if (ent >= count)
+	{
+		utl_array_reserve(&cs->proxies, max(ent + 1, count * 2));
+		cs->proxies.count = cs->proxies.max;
+
+		for (i = count; i < cs->proxies.count; ++i)
+		{
+			cs->proxies.data[i] = KK_BROADPHASE_NULL;
+		}
+	}
+
+	return &cs->proxies.data[ent];
+}
+
+/**
+Broadphase callback that keeps colliders whose triangles overlap the box.
+*/
+static boolean overlap_aabb_proxy(void* data, uint32_t proxy)
+{
+	overlap_query_t* query = (overlap_query_t*)data;
+	gpu_static_model_t* model;
+	kk_mat4_t m;
+
+	model = get_collider(query->cs, query->ecs, proxy, &m);
+	if (kk_bvh__overlap_aabb(&model->bvh, &m, &query->box))
+	{
+		utl_array_push(query->entities, kk_broadphase__get_user_data(&query->cs->broadphase, proxy));
+	}
+
+	return TRUE;
+}
+
+/**
+Broadphase callback that keeps colliders whose triangles overlap the sphere.
+*/
+static boolean overlap_sphere_proxy(void* data, uint32_t proxy)
+{
+	overlap_query_t* query = (overlap_query_t*)data;
+	gpu_static_model_t* model;
+	kk_mat4_t m;
+
+	model = get_collider(query->cs, query->ecs, proxy, &m);
+	if (kk_bvh__overlap_sphere(&model->bvh, &m, &query->center, query->radius))
+	{
+		utl_array_push(query->entities, kk_broadphase__get_user_data(&query->cs->broadphase, proxy));
+	}
+
+	return TRUE;
+}
+
+/**
+Broadphase callback that casts the ray against a collider's triangles in
+model space. An affine transform keeps the ray parameter, so a hit clips the
+world ray directly.
+*/
+static float raycast_proxy(void* data, uint32_t proxy, kk_ray_t* ray)
+{
+	raycast_query_t* query = (raycast_query_t*)data;
+	collision_system_hit_t* out__hit = query->hit;
+	gpu_static_model_t* model;
+	kk_bvh_hit_t hit;
+	kk_ray_t local;
+	kk_mat4_t m;
+	kk_mat4_t inv;
+	kk_vec3_t n;
+
+	model = get_collider(query->cs, query->ecs, proxy, &m);
+	kk_math_mat4_inv(&m, &inv);
+
+	kk_math_mat4_mulv3(&inv, &ray->origin, 1.0f, &local.origin);
+	kk_math_mat4_mulv3(&inv, &ray->dir, 0.0f, &local.dir);
+	local.max_t = ray->max_t;
+
+	if (!kk_bvh__raycast(&model->bvh, &local, &hit))
+	{
+		return ray->max_t;
+	}
+
+	/* Normals go back to world space by the inverse transpose */
+	n = hit.normal;
+	out__hit->normal.x = inv.x.x * n.x + inv.x.y * n.y + inv.x.z * n.z;
+	out__hit->normal.y = inv.y.x * n.x + inv.y.y * n.y + inv.y.z * n.z;
+	out__hit->normal.z = inv.z.x * n.x + inv.z.y * n.y + inv.z.z * n.z;
+	kk_math_vec3_normalize(&out__hit->normal);
+
+	out__hit->entity = kk_broadphase__get_user_data(&query->cs->broadphase, proxy);
+	out__hit->t = hit.t;
+
+	return hit.t;
+}
+
+/**
+Job that casts a range of rays.
+*/
+static void raycast_range(void* data, uint32_t start, uint32_t end)
+{
+	raycast_batch_job_t* job = (raycast_batch_job_t*)data;
+	uint32_t i;
+
+	for (i = start; i < end; ++i)
+	{
+		collision_system__raycast(job->cs, job->ecs, &job->rays[i], &job->hits[i]);
+	}
+}
+
+/**
+Removes proxies for entities that are no longer colliders.
+*/
+static void remove_stale_proxies(collision_system_t* cs, ecs_t* ecs)
+{
+	ecs_static_model_t* sm;
+	uint32_t proxy;
+	entity_id_t ent;
+
+	for (ent = 0; ent < cs->proxies.count; ++ent)
+	{
+		proxy = cs->proxies.data[ent];
+		if (proxy == KK_BROADPHASE_NULL)
+		{
+			continue;
+		}
+
+		sm = ((ecs__get_signature(ecs, ent) & COLLIDER_MASK) == COLLIDER_MASK) ? ecs_static_model__get(ecs, ent) : NULL;
+		if (sm && sm->model)
+		{
+			continue;
+		}
+
+		kk_broadphase__remove(&cs->broadphase, proxy);
+		cs->proxies.data[ent] = KK_BROADPHASE_NULL;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef COLLISION_SYSTEM_H
+#define COLLISION_SYSTEM_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/components/ecs_transform_.h"
+#include "ecs/systems/collision_system_.h"
+#include "gpu/gpu_static_model_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "ecs/ecs.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_contacts.h"
+#include "engine/kk_islands.h"
+#include "engine/kk_math.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Closest collider a ray hit.
+*/
+typedef struct
+{
+	entity_id_t				entity;		/* ECS_INVALID_ID if nothing was hit. */
+	float					t;			/* Ray parameter of the hit. */
+	kk_vec3_t				point;
+	kk_vec3_t				normal;		/* Unit face normal, facing back along the ray. */
+
+} collision_system_hit_t;
+
+/**
+Collision detection state. Every entity with a static model and a transform
+is a collider bounded by its model's box. Entities with physics are dynamic
+while awake, the rest are static.
+*/
+struct collision_system_s
+{
+	/*
+	Create/destroy
+	*/
+	kk_broadphase_t			broadphase;		/* Pairs are reported by entity id. */
+	utl_array_t(uint32_t)	proxies;		/* Broadphase proxy for each entity id. KK_BROADPHASE_NULL if none. */
+	kk_contacts_t			contacts;		/* Manifolds for the pairs. Updated by the physics system. */
+	kk_islands_t			islands;		/* Bodies linked by the pairs. Updated by the physics system. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+void collision_system__construct(collision_system_t* cs);
+void collision_system__destruct(collision_system_t* cs);
+void collision_system__get_world_bounds(ecs_t* ecs, ecs_transform_t* transform, gpu_static_model_t* model, kk_aabb_t* out__bounds);
+void collision_system__overlap_aabb(collision_system_t* cs, ecs_t* ecs, kk_aabb_t* box, utl_array_t(uint32_t)* out__entities);
+void collision_system__overlap_sphere(collision_system_t* cs, ecs_t* ecs, kk_vec3_t* center, float radius, utl_array_t(uint32_t)* out__entities);
+boolean collision_system__raycast(collision_system_t* cs, ecs_t* ecs, kk_ray_t* ray, collision_system_hit_t* out__hit);
+void collision_system__raycast_batch(collision_system_t* cs, ecs_t* ecs, kk_ray_t* rays, uint32_t count, collision_system_hit_t* out__hits);
+void collision_system__run(collision_system_t* cs, ecs_t* ecs);
+
+#endif /* COLLISION_SYSTEM_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef COLLISION_SYSTEM__H
+#define COLLISION_SYSTEM__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct collision_system_s collision_system_t;
+
+#endif /* COLLISION_SYSTEM__H */
\ No newline at end of file
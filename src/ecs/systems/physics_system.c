@@ -7,96 +7,190 @@ INCLUDES
 #include "ecs/ecs.h"
 #include "ecs/components/ecs_physics.h"
 #include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "ecs/systems/physics_system.h"
+#include "engine/kk_contacts.h"
+#include "engine/kk_islands.h"
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
+#include "engine/kk_physics_bodies.h"
 #include "platform/platform.h"
 
 /*=========================================================
-VARIABLES
+CONSTANTS
 =========================================================*/
 
+/*
+Bodies per job. A multiple of every SIMD width so only the last range has a
+scalar tail.
+*/
+#define GRAIN_SIZE		(512)
+
+#define CONTACT_GRAIN_SIZE	(32)	/* Manifolds per job when updating contacts. */
+
 /*=========================================================
-FUNCTIONS
+TYPES
 =========================================================*/
 
+typedef struct
+{
+	kk_physics_bodies_t*	bodies;
+	float					delta_time;
+	uint32_t				num_steps;
 
+} integrate_job_t;
 
-static void update(ecs_physics_t* phys, ecs_transform_t* transform, float delta_time);
+typedef struct
+{
+	kk_contacts_t*			contacts;
+	kk_physics_bodies_t*	bodies;
 
+} contact_job_t;
 
+/*=========================================================
+VARIABLES
+=========================================================*/
 
-void physics_system__run(ecs_t* ecs, float delta_time)
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static void integrate_range(void* data, uint32_t start, uint32_t end);
+static void run_steps_with_contacts(kk_physics_bodies_t* bodies, kk_contacts_t* contacts, float delta_time, uint32_t num_steps);
+static void update_contacts_range(void* data, uint32_t start, uint32_t end);
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Advances all entities with physics and transform components by a number of
+fixed steps. Body state is copied into the structure-of-arrays buffer once,
+every step is integrated as a batch split across the job system's threads,
+then the result is copied back to the components.
+
+Without contacts each job runs all steps for its range so catching up after
+a slow frame costs one dispatch. With contacts the bodies interact, so each
+step updates the contact manifolds in parallel, solves them on the calling
+thread and then integrates in parallel. Contacts come from the collision
+system's broadphase pairs, which are a frame old.
+
+Bodies sleep in islands. Islands with an awake or disturbed body are woken
+before the bodies are gathered, sleeping bodies are left out of every step,
+and islands that stayed still long enough are put to sleep afterwards. The
+cost of a frame follows the number of awake bodies.
+
+The transforms keep the pose from before the last step so rendering can
+blend between ticks. With no steps, moving transforms are only marked dirty
+so the transform system re-blends them.
+
+@param ecs The ECS context.
+@param bodies Scratch body storage. Reused between frames.
+@param collision The collision system with the pairs to solve.
+@param delta_time The length of one step in seconds.
+@param num_steps The number of steps to run.
+*/
+void physics_system__run(ecs_t* ecs, kk_physics_bodies_t* bodies, collision_system_t* collision, float delta_time, uint32_t num_steps)
 {
-	ecs_physics_t*			phys = NULL;
-	ecs_transform_t*		transform = NULL;
+	ecs_query_t* query = ecs__query(ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM), 0);
 
-	uint32_t			i;
+	integrate_job_t job;
+	uint32_t i;
 
-	for (i = 0; i < ecs->next_free_id; ++i)
+	if (num_steps == 0)
 	{
-		phys = &ecs->physics_comp[i];
-		transform = &ecs->transform_comp[i];
-
-		/* Find entities */
-		if (!phys->base.is_used || !transform->base.is_used)
+		for (i = 0; i < ecs_query__get_count(query); ++i)
 		{
-			continue;
+			ecs_transform_t* transform = ecs_transform__get(ecs, ecs_query__get_entity(query, i));
+			if (transform->interpolated)
+			{
+				ecs_transform__set_dirty(ecs, transform);
+			}
 		}
 
-		update(phys, transform, delta_time);
+		return;
 	}
-}
 
-static void update(ecs_physics_t* phys, ecs_transform_t* transform, float delta_time)
-{
-	kk_vec3_t temp;
+	kk_islands__wake(&collision->islands, ecs, query, &collision->broadphase);
+	kk_physics_bodies__gather(bodies, ecs, query);
+	kk_contacts__sync(&collision->contacts, ecs, bodies, &collision->broadphase);
 
-	/*
-	Linear
-	*/
+	if (collision->contacts.manifolds.count)
+	{
+		run_steps_with_contacts(bodies, &collision->contacts, delta_time, num_steps);
+	}
+	else
+	{
+		job.bodies = bodies;
+		job.delta_time = delta_time;
+		job.num_steps = num_steps;
+		kk_job__parallel_for(g_jobs, bodies->count, GRAIN_SIZE, integrate_range, &job);
+	}
+
+	/* Scatter marks transforms dirty, which touches shared ECS state */
+	kk_physics_bodies__scatter(bodies, ecs);
+	kk_islands__sleep(&collision->islands, bodies, num_steps);
+}
 
-	// pos = pos + vel * dt
-	kk_math_vec3_scale(&phys->velocity, delta_time, &temp);
-	kk_math_vec3_add(&transform->pos, &temp, &transform->pos);
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
 
-	/* Update secondary values */
+/**
+Job that runs every step for a range of bodies.
+*/
+static void integrate_range(void* data, uint32_t start, uint32_t end)
+{
+	integrate_job_t* job = (integrate_job_t*)data;
+	uint32_t step;
+
+	for (step = 0; step < job->num_steps; ++step)
 	{
-		// velocity = momentum * inverse_mass
-		kk_math_vec3_scale(&phys->momentum, phys->inverse_mass, &phys->velocity);
+		/* Gather already saved the pose before the first step */
+		if (step > 0 && step == job->num_steps - 1)
+		{
+			kk_physics_bodies__save_previous_range(job->bodies, start, end);
+		}
+
+		kk_physics_bodies__integrate_range(job->bodies, start, end, job->delta_time);
 	}
+}
 
-	/*
-	Rotational
-	*/
+/**
+Runs each step as contact update, solve, then integrate.
+*/
+static void run_steps_with_contacts(kk_physics_bodies_t* bodies, kk_contacts_t* contacts, float delta_time, uint32_t num_steps)
+{
+	integrate_job_t integrate_job;
+	contact_job_t contact_job;
+	uint32_t step;
 
-	/* Integrate */
-	// orientation = orientation + spin * dt
-	transform->rot.x = transform->rot.x + (phys->spin.x * delta_time);
-	transform->rot.y = transform->rot.y + (phys->spin.y * delta_time);
-	transform->rot.z = transform->rot.z + (phys->spin.z * delta_time);
-	transform->rot.w = transform->rot.w + (phys->spin.w * delta_time);
+	integrate_job.bodies = bodies;
+	integrate_job.delta_time = delta_time;
+	integrate_job.num_steps = 1;
 
-	kk_math_quat_normalize(&transform->rot);
+	contact_job.contacts = contacts;
+	contact_job.bodies = bodies;
 
-	/* Update secondary values */
+	for (step = 0; step < num_steps; ++step)
 	{
-		// angular velocity = angular momentum * inverse inertia
-		kk_math_vec3_scale(&phys->angular_momentum, phys->inverse_inertia, &phys->angular_velocity);
-
-		// spin = (0.5 * (w * q)), where:
-		//	w is angular velocity as a quaternion (0, x, y, z) -- (x,y,z) are the angular velocity vector
-		//	q is the current orientation quaternion
-		//	The multiplication done between w and q is quaternion multiplication.
-
-		kk_vec4_t w;
-		w.x = phys->angular_velocity.x;
-		w.y = phys->angular_velocity.y;
-		w.z = phys->angular_velocity.z;
-		w.w = 0;
-
-		kk_math_quat_mul(&w, &transform->rot, &phys->spin);
-		phys->spin.x = phys->spin.x * 0.5f;
-		phys->spin.y = phys->spin.y * 0.5f;
-		phys->spin.z = phys->spin.z * 0.5f;
-		phys->spin.w = phys->spin.w * 0.5f;
+		/* Gather already saved the pose before the first step */
+		if (step > 0 && step == num_steps - 1)
+		{
+			kk_physics_bodies__save_previous_range(bodies, 0, bodies->count);
+		}
+
+		kk_job__parallel_for(g_jobs, contacts->manifolds.count, CONTACT_GRAIN_SIZE, update_contacts_range, &contact_job);
+		kk_contacts__solve(contacts, bodies, delta_time);
+		kk_job__parallel_for(g_jobs, bodies->count, GRAIN_SIZE, integrate_range, &integrate_job);
 	}
+}
+
+/**
+Job that updates a range of contact manifolds.
+*/
+static void update_contacts_range(void* data, uint32_t start, uint32_t end)
+{
+	contact_job_t* job = (contact_job_t*)data;
+	kk_contacts__update_range(job->contacts, job->bodies, start, end);
 }
\ No newline at end of file
@@ -6,6 +6,8 @@ INCLUDES
 =========================================================*/
 
 #include "ecs/ecs.h"
+#include "ecs/systems/collision_system.h"
+#include "engine/kk_physics_bodies.h"
 
 /*=========================================================
 TYPES
@@ -15,6 +17,6 @@ TYPES
 FUNCTIONS
 =========================================================*/
 
-void physics_system__run(ecs_t* ecs, float delta_time);
+void physics_system__run(ecs_t* ecs, kk_physics_bodies_t* bodies, collision_system_t* collision, float delta_time, uint32_t num_steps);
 
 #endif /* PHYSICS_SYSTEM_H */
\ No newline at end of file
@@ -13,6 +13,16 @@ INCLUDES
 #include "engine/kk_log.h"
 #include "platform/platform.h"
 
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/** Components required on the player entity. */
+#define PLAYER_MASK ( ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS) \
+					| ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PLAYER) \
+					| ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) \
+					| ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM) )
+
 /*=========================================================
 VARIABLES
 =========================================================*/
@@ -25,37 +35,25 @@ void player_system__run(ecs_t* ecs, kk_camera_t* cam, float frame_delta_time)
 {
 	ecs_physics_t*			phys = NULL;
 	ecs_static_model_t*		sm = NULL;
-	ecs_player_t*			player = NULL;
 	ecs_transform_t*		transform = NULL;
 
-	uint32_t			i;
+	entity_id_t			ent;
 
-	for (i = 0; i < ecs->next_free_id; ++i)
+	/* Find the player. Only one player component, so use the first match. */
+	ent = ecs_query__get_single(ecs__query(ecs, PLAYER_MASK, 0));
+	if (ent == ECS_INVALID_ID)
 	{
-		phys = &ecs->physics_comp[i];
-		sm = &ecs->static_model_comp[i];
-		player = &ecs->player_comp[i];
-		transform = &ecs->transform_comp[i];
-		
-		/* Find entities with static model and transform */
-		if (!sm->base.is_used || !phys->base.is_used || !player->base.is_used || !transform->base.is_used)
-		{
-			continue;
-		}
-
-		/* Make sure model is loaded */
-		if (!sm->model)
-		{
-			kk_log__fatal("Static model does not have a model assigned.");
-		}
-
-		/* Only one player component, so break here */
-		break;
+		return;
 	}
 
-	if (!phys || !phys->base.is_used)
+	phys = ecs_physics__get(ecs, ent);
+	sm = ecs_static_model__get(ecs, ent);
+	transform = ecs_transform__get(ecs, ent);
+
+	/* Make sure model is loaded */
+	if (!sm->model)
 	{
-		return;
+		kk_log__fatal("Static model does not have a model assigned.");
 	}
 
 	phys->momentum.x = 0.0f;
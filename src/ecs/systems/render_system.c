@@ -8,36 +8,167 @@ INCLUDES
 #include "ecs/ecs_component.h"
 #include "ecs/components/ecs_static_model.h"
 #include "ecs/components/ecs_transform.h"
+#include "ecs/systems/render_system.h"
+#include "engine/kk_camera.h"
+#include "engine/kk_frustum.h"
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
+#include "engine/kk_math.h"
 #include "gpu/gpu_frame.h"
 #include "gpu/gpu_plane.h"
+#include "gpu/gpu_render_queue.h"
 #include "gpu/gpu_static_model.h"
 #include "gpu/gpu_window.h"
 
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define GRAIN_SIZE		(256)	/* Entities per job when collecting draws. */
+#define CAPACITY_GRANULARITY	(64)	/* Capacity is rounded up to a multiple of this. Must be a multiple of KK_FRUSTUM_WIDTH. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	render_system_t*		rs;
+	ecs_t*					ecs;
+	ecs_query_t*			query;
+
+} collect_job_t;
+
 /*=========================================================
 VARIABLES
 =========================================================*/
 
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static void collect_range(void* data, uint32_t start, uint32_t end);
+static void reserve(render_system_t* rs, uint32_t count);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+/**
+Constructs the render system. The arrays are allocated on first use.
+
+@param rs The render system to construct.
+*/
+void render_system__construct(render_system_t* rs)
+{
+	clear_struct(rs);
+	gpu_render_queue__construct(&rs->queue);
+}
+
+/**
+Destructs the render system.
+
+@param rs The render system to destruct.
+*/
+void render_system__destruct(render_system_t* rs)
+{
+	gpu_render_queue__destruct(&rs->queue);
+	free(rs->visible);
+	free(rs->sphere_data);
+	free(rs->draws);
+	clear_struct(rs);
+}
+
 /*=========================================================
 FUNCTIONS
 =========================================================*/
 
-void render_system__run(ecs_t* ecs, gpu_window_t* window, gpu_frame_t* frame)
+/**
+Renders all entities with static model and transform components that may be
+in view. Component lookups and world bounds are split across the job
+system's threads. The bounds are then culled against the camera's frustum in
+SIMD batches. Each mesh of the visible models is queued with a key that
+groups GPU state and orders front to back, and the sorted queue is recorded
+on the calling thread since the GPU interface is not thread safe.
+
+@param rs The render system.
+@param ecs The ECS context.
+@param cam The camera. Its cached frustum is used, so culling matches what the backend draws.
+@param window The window to render to.
+@param frame The frame being recorded.
+*/
+void render_system__run(render_system_t* rs, ecs_t* ecs, kk_camera_t* cam, gpu_window_t* window, gpu_frame_t* frame)
 {
-	ecs_static_model_t* 	sm;
-	ecs_transform_t* 		transform;
+	render_system_draw_t*	draw;
+	gpu_render_draw_t		packet;
+	collect_job_t			job;
+	kk_vec3_t				to_center;
+	float					depth;
+	uint32_t				idx;
 	uint32_t				i;
-	
-	for (i = 0; i < ecs->next_free_id; ++i)
+
+	/* Find entities with static model and transform */
+	job.rs = rs;
+	job.ecs = ecs;
+	job.query = ecs__query(ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM), 0);
+
+	rs->count = ecs_query__get_count(job.query);
+	reserve(rs, rs->count);
+
+	kk_job__parallel_for(g_jobs, rs->count, GRAIN_SIZE, collect_range, &job);
+
+	/* Keep draws that may be in view */
+	kk_camera__update(cam);
+	rs->num_visible = kk_frustum__cull_spheres(&cam->frustum, rs->sphere[0], rs->sphere[1], rs->sphere[2], rs->sphere[3], rs->count, rs->visible);
+
+	/* Queue a packet per mesh */
+	gpu_render_queue__clear(&rs->queue);
+	clear_struct(&packet);
+	packet.pipeline = GPU_RENDER_PIPELINE_STATIC_MODEL;
+
+	for (i = 0; i < rs->num_visible; ++i)
 	{
-		sm = &ecs->static_model_comp[i];
-		transform = &ecs->transform_comp[i];
+		idx = rs->visible[i];
+		draw = &rs->draws[idx];
+
+		to_center.x = rs->sphere[0][idx] - cam->pos.x;
+		to_center.y = rs->sphere[1][idx] - cam->pos.y;
+		to_center.z = rs->sphere[2][idx] - cam->pos.z;
+		depth = (kk_math_vec3_dot(&to_center, &cam->dir) - KK_CAMERA_NEAR) / (KK_CAMERA_FAR - KK_CAMERA_NEAR);
+
+		packet.model = draw->model;
+		packet.world_matrix = &draw->transform->world_matrix;
 
-		/* Find entities with static model and transform */
-		if (!sm->base.is_used || !transform->base.is_used)
+		for (packet.mesh = 0; packet.mesh < draw->model->mesh_bounds.count; ++packet.mesh)
 		{
-			continue;
+			packet.key = gpu_render_queue__make_key(packet.pipeline, draw->model->id, packet.mesh, depth);
+			gpu_render_queue__push(&rs->queue, &packet);
 		}
+	}
+
+	gpu_render_queue__submit(&rs->queue, g_gpu, window, frame);
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+/**
+Job that looks up the components and world bounding sphere for a range of
+entities in the query.
+*/
+static void collect_range(void* data, uint32_t start, uint32_t end)
+{
+	collect_job_t*			job = (collect_job_t*)data;
+	render_system_t*		rs = job->rs;
+	ecs_static_model_t*		sm;
+	render_system_draw_t*	draw;
+	kk_sphere_t				sphere;
+	uint32_t				i;
+
+	for (i = start; i < end; ++i)
+	{
+		sm = ecs_static_model__get(job->ecs, ecs_query__get_entity(job->query, i));
 
 		/* Make sure model is loaded */
 		if (!sm->model)
@@ -45,7 +176,49 @@ void render_system__run(ecs_t* ecs, gpu_window_t* window, gpu_frame_t* frame)
 			kk_log__fatal("Static model does not have a model assigned.");
 		}
 
-		/* Render the model */
-		gpu_static_model__render(sm->model, g_gpu, window, frame, sm->material, transform);
+		draw = &rs->draws[i];
+		draw->model = sm->model;
+		draw->transform = ecs_transform__get(job->ecs, sm->base.entity);
+
+		/* Bounds where the model is drawn, so the blended matrix */
+		kk_math_sphere_transform(&sm->model->sphere, &draw->transform->world_matrix, &sphere);
+		rs->sphere[0][i] = sphere.center.x;
+		rs->sphere[1][i] = sphere.center.y;
+		rs->sphere[2][i] = sphere.center.z;
+		rs->sphere[3][i] = sphere.radius;
 	}
 }
+
+/**
+Makes sure the arrays can hold a number of draws.
+*/
+static void reserve(render_system_t* rs, uint32_t count)
+{
+	uint32_t capacity;
+	uint32_t i;
+
+	if (count <= rs->capacity)
+	{
+		return;
+	}
+
+	capacity = (count + CAPACITY_GRANULARITY - 1) / CAPACITY_GRANULARITY * CAPACITY_GRANULARITY;
+
+	free(rs->visible);
+	free(rs->sphere_data);
+	free(rs->draws);
+	rs->draws = (render_system_draw_t*)malloc(sizeof(render_system_draw_t) * capacity);
+	rs->sphere_data = (float*)malloc(sizeof(float) * 4 * capacity);
+	rs->visible = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+	if (!rs->draws || !rs->sphere_data || !rs->visible)
+	{
+		kk_log__fatal("Failed to allocate render system draws.");
+	}
+
+	for (i = 0; i < 4; ++i)
+	{
+		rs->sphere[i] = rs->sphere_data + i * capacity;
+	}
+
+	rs->capacity = capacity;
+}
\ No newline at end of file
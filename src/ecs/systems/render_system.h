@@ -5,23 +5,65 @@
 DECLARATIONS
 =========================================================*/
 
+#include "ecs/components/ecs_transform_.h"
+#include "ecs/systems/render_system_.h"
+#include "engine/kk_camera_.h"
 #include "gpu/gpu_window_.h"
 #include "gpu/gpu_frame_.h"
+#include "gpu/gpu_static_model_.h"
 
 /*=========================================================
 INCLUDES
 =========================================================*/
 
 #include "ecs/ecs.h"
+#include "gpu/gpu_render_queue.h"
 
 /*=========================================================
 TYPES
 =========================================================*/
 
+/**
+Everything needed to submit one static model.
+*/
+typedef struct
+{
+	gpu_static_model_t*		model;
+	ecs_transform_t*		transform;
+
+} render_system_draw_t;
+
+/**
+Render system state. Draws and their world space bounding spheres are
+collected across the job system's threads. The spheres are culled against
+the view frustum, then each mesh of the visible draws is queued, sorted and
+submitted to the GPU from the calling thread.
+*/
+struct render_system_s
+{
+	/*
+	Create/destroy
+	*/
+	render_system_draw_t*	draws;			/* One draw per entity matched by the query. */
+	float*					sphere_data;	/* Single allocation that holds the sphere arrays. */
+	uint32_t*				visible;		/* Indices of the draws that passed culling. */
+	uint32_t				capacity;		/* Number of draws the arrays can hold. */
+	gpu_render_queue_t		queue;			/* Mesh draws for the frame. */
+
+	/*
+	Other
+	*/
+	float*					sphere[4];		/* World space bounding sphere of each draw (x, y, z, radius). */
+	uint32_t				count;			/* Number of draws collected and tested this frame. Stat. */
+	uint32_t				num_visible;	/* Number of draws that passed culling this frame. Stat. */
+};
+
 /*=========================================================
 FUNCTIONS
 =========================================================*/
 
-void render_system__run(ecs_t* ecs, gpu_window_t* window, gpu_frame_t* frame);
+void render_system__construct(render_system_t* rs);
+void render_system__destruct(render_system_t* rs);
+void render_system__run(render_system_t* rs, ecs_t* ecs, kk_camera_t* cam, gpu_window_t* window, gpu_frame_t* frame);
 
 #endif /* RENDER_SYSTEM_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef RENDER_SYSTEM__H
+#define RENDER_SYSTEM__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct render_system_s render_system_t;
+
+#endif /* RENDER_SYSTEM__H */
\ No newline at end of file
@@ -0,0 +1,290 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <stdlib.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_log.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static int compare_indices(const void* a, const void* b);
+static int compare_order_keys(const void* a, const void* b);
+static ecs_transform_t* get_parent(ecs_t* ecs, ecs_transform_t* transform);
+static void rebuild_order(ecs_t* ecs);
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Marks every descendant of a dirty transform dirty, without rebuilding any
+matrices. Systems that run before the transform pass and skip transforms
+that have not moved, such as collision, call this first so a child moved
+by its parent is not mistaken for one that stayed put.
+
+@param ecs The ECS context.
+*/
+void transform_system__propagate_dirty(ecs_t* ecs)
+{
+	uint32_t covered_end = 0;
+	uint32_t start;
+	uint32_t end;
+	uint32_t i;
+	uint32_t j;
+
+	if (ecs->transform_order_dirty)
+	{
+		rebuild_order(ecs);
+	}
+
+	qsort(ecs->transform_dirty_roots.data, ecs->transform_dirty_roots.count, sizeof(uint32_t), compare_indices);
+
+	for (i = 0; i < ecs->transform_dirty_roots.count; ++i)
+	{
+		start = ecs->transform_dirty_roots.data[i];
+		if (start < covered_end)
+		{
+			continue;
+		}
+
+		/* Inside a dirty root's range, so the transform pass still rebuilds them */
+		end = ecs->transform_subtree_end.data[start];
+		for (j = start; j < end; ++j)
+		{
+			ecs_transform__get(ecs, ecs->transform_order.data[j])->dirty = TRUE;
+		}
+
+		covered_end = end;
+	}
+}
+
+/**
+Rebuilds the cached world matrix of every dirty transform and every
+descendant of a dirty transform. Transforms are kept in depth-first order,
+so the subtree of each dirty transform is one contiguous range and
+transforms outside the dirty subtrees are never visited. Should be called
+once per frame after all systems that move entities and before rendering.
+
+Interpolated transforms are blended between the previous and current
+simulation tick. Whatever moves them must mark them dirty each frame.
+
+@param ecs The ECS context.
+@param alpha Blend factor between the previous and current tick. 1 renders the current tick.
+*/
+void transform_system__run(ecs_t* ecs, float alpha)
+{
+	ecs_transform_t* transform;
+	uint32_t covered_end = 0;
+	uint32_t start;
+	uint32_t end;
+	uint32_t pass;
+	uint32_t i;
+	uint32_t j;
+
+	if (ecs->transform_order_dirty)
+	{
+		rebuild_order(ecs);
+	}
+
+	if (ecs->transform_dirty_roots.count == 0)
+	{
+		return;
+	}
+
+	pass = ++ecs->transform_pass;
+
+	/* Ascending order, so a root inside a subtree that was already rebuilt is skipped */
+	qsort(ecs->transform_dirty_roots.data, ecs->transform_dirty_roots.count, sizeof(uint32_t), compare_indices);
+
+	for (i = 0; i < ecs->transform_dirty_roots.count; ++i)
+	{
+		start = ecs->transform_dirty_roots.data[i];
+		if (start < covered_end)
+		{
+			continue;
+		}
+
+		/* Everything under a dirty transform is rebuilt, parents first */
+		end = ecs->transform_subtree_end.data[start];
+		for (j = start; j < end; ++j)
+		{
+			transform = ecs_transform__get(ecs, ecs->transform_order.data[j]);
+			ecs_transform__update_matrix(transform, get_parent(ecs, transform), alpha);
+			transform->update_pass = pass;
+		}
+
+		covered_end = end;
+	}
+
+	ecs->transform_dirty_roots.count = 0;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+/**
+Sorts 32-bit indices.
+*/
+static int compare_indices(const void* a, const void* b)
+{
+	uint32_t ia = *(const uint32_t*)a;
+	uint32_t ib = *(const uint32_t*)b;
+
+	return (ia > ib) - (ia < ib);
+}
+
+/**
+Sorts 64-bit (depth, entity) keys.
+*/
+static int compare_order_keys(const void* a, const void* b)
+{
+	uint64_t ka = *(const uint64_t*)a;
+	uint64_t kb = *(const uint64_t*)b;
+
+	return (ka > kb) - (ka < kb);
+}
+
+/**
+Gets the parent transform, or NULL if the transform is a root.
+*/
+static ecs_transform_t* get_parent(ecs_t* ecs, ecs_transform_t* transform)
+{
+	if (transform->parent == ECS_INVALID_ID)
+	{
+		return NULL;
+	}
+
+	return ecs_transform__get(ecs, transform->parent);
+}
+
+/**
+Lays out all transforms depth-first, so every parent comes before its
+children and each subtree is a contiguous range. Parents that do not exist
+are treated as roots. A cycle is broken at the transform where it is
+detected.
+*/
+static void rebuild_order(ecs_t* ecs)
+{
+	ecs_sparse_set_t* set = &ecs->transform_comp;
+	ecs_transform_t* transform;
+	ecs_transform_t* parent;
+	uint64_t* keys;
+	uint32_t* first_child;
+	uint32_t* next_sibling;
+	uint32_t* size;
+	uint32_t* stack;
+	uint32_t num_stack;
+	uint32_t pos;
+	uint32_t node;
+	uint32_t i;
+
+	utl_array_resize(&ecs->transform_order, set->count);
+	utl_array_resize(&ecs->transform_subtree_end, set->count);
+
+	keys = (uint64_t*)malloc(sizeof(uint64_t) * max(set->count, 1));
+	first_child = (uint32_t*)malloc(sizeof(uint32_t) * 4 * max(set->count, 1));
+	if (!keys || !first_child)
+	{
+		kk_log__fatal("Failed to allocate transform order.");
+	}
+
+	next_sibling = first_child + set->count;
+	size = next_sibling + set->count;
+	stack = size + set->count;
+
+	/* Depth of each transform. Until the order is built, order_idx holds the dense index. */
+	for (i = 0; i < set->count; ++i)
+	{
+		transform = (ecs_transform_t*)ecs_sparse_set__get_at(set, i);
+		ecs_transform_t* ancestor = get_parent(ecs, transform);
+
+		transform->order_idx = i;
+		transform->depth = 0;
+		while (ancestor)
+		{
+			if (++transform->depth > set->count)
+			{
+				kk_log__error("Transform hierarchy contains a cycle.");
+				transform->parent = ECS_INVALID_ID;
+				transform->depth = 0;
+				break;
+			}
+
+			ancestor = get_parent(ecs, ancestor);
+		}
+
+		keys[i] = ((uint64_t)transform->depth << 32) | transform->base.entity;
+		first_child[i] = ECS_INVALID_ID;
+		size[i] = 1;
+	}
+
+	/* Child lists and subtree sizes, deepest first so each child is complete before its parent */
+	qsort(keys, set->count, sizeof(uint64_t), compare_order_keys);
+
+	for (i = set->count; i-- > 0;)
+	{
+		transform = ecs_transform__get(ecs, (entity_id_t)(keys[i] & 0xFFFFFFFF));
+		parent = get_parent(ecs, transform);
+		if (!parent)
+		{
+			continue;
+		}
+
+		next_sibling[transform->order_idx] = first_child[parent->order_idx];
+		first_child[parent->order_idx] = transform->order_idx;
+		size[parent->order_idx] += size[transform->order_idx];
+	}
+
+	/* Walk each root's subtree. Keys start with the roots, in entity order. */
+	pos = 0;
+	for (i = 0; i < set->count && (keys[i] >> 32) == 0; ++i)
+	{
+		num_stack = 0;
+		stack[num_stack++] = ecs_transform__get(ecs, (entity_id_t)(keys[i] & 0xFFFFFFFF))->order_idx;
+
+		while (num_stack > 0)
+		{
+			node = stack[--num_stack];
+			transform = (ecs_transform_t*)ecs_sparse_set__get_at(set, node);
+
+			ecs->transform_order.data[pos] = transform->base.entity;
+			ecs->transform_subtree_end.data[pos] = pos + size[node];
+			pos++;
+
+			for (node = first_child[node]; node != ECS_INVALID_ID; node = next_sibling[node])
+			{
+				stack[num_stack++] = node;
+			}
+		}
+	}
+
+	/* Dense indices are no longer needed */
+	for (i = 0; i < set->count; ++i)
+	{
+		ecs_transform__get(ecs, ecs->transform_order.data[i])->order_idx = i;
+	}
+
+	free(first_child);
+	free(keys);
+
+	/* Indices changed, so sweep everything once */
+	ecs->transform_order_dirty = FALSE;
+	ecs->transform_ranges_valid = TRUE;
+	ecs->transform_dirty_roots.count = 0;
+	for (i = 0; i < set->count; i = ecs->transform_subtree_end.data[i])
+	{
+		utl_array_push(&ecs->transform_dirty_roots, i);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TRANSFORM_SYSTEM_H
+#define TRANSFORM_SYSTEM_H
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "ecs/ecs.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+void transform_system__propagate_dirty(ecs_t* ecs);
+
+void transform_system__run(ecs_t* ecs, float alpha);
+
+#endif /* TRANSFORM_SYSTEM_H */
\ No newline at end of file
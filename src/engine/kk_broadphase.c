@@ -0,0 +1,732 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <stdlib.h>
+
+#include "common.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_log.h"
+#include "engine/kk_math.h"
+
+#include "autogen/kk_broadphase.static.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	kk_broadphase_t*		bp;
+	uint32_t				proxy;
+
+} pair_query_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty broadphase.
+
+@param bp The broadphase to construct.
+*/
+void kk_broadphase__construct(kk_broadphase_t* bp)
+{
+	clear_struct(bp);
+	utl_array_init(&bp->nodes);
+	utl_array_init(&bp->dynamic_proxies);
+	utl_array_init(&bp->pairs);
+
+	bp->root = KK_BROADPHASE_NULL;
+	bp->free_list = KK_BROADPHASE_NULL;
+}
+
+//## public
+/**
+Destructs a broadphase.
+
+@param bp The broadphase to destruct.
+*/
+void kk_broadphase__destruct(kk_broadphase_t* bp)
+{
+	utl_array_destroy(&bp->nodes);
+	utl_array_destroy(&bp->dynamic_proxies);
+	utl_array_destroy(&bp->pairs);
+	clear_struct(bp);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Adds a proxy.
+
+@param bp The broadphase.
+@param box The proxy's bounds.
+@param user_data Value reported in pairs, usually an entity id.
+@param is_static Static proxies are never queried for pairs, so two static proxies never pair.
+@return The proxy.
+*/
+uint32_t kk_broadphase__add(kk_broadphase_t* bp, kk_aabb_t* box, uint32_t user_data, boolean is_static)
+{
+	uint32_t proxy = allocate_node(bp);
+	kk_broadphase_node_t* node = &bp->nodes.data[proxy];
+
+	fatten(box, &node->box);
+	node->height = 0;
+	node->user_data = user_data;
+	node->dynamic_idx = KK_BROADPHASE_NULL;
+
+	if (!is_static)
+	{
+		node->dynamic_idx = bp->dynamic_proxies.count;
+		utl_array_push(&bp->dynamic_proxies, proxy);
+	}
+
+	insert_leaf(bp, proxy);
+	bp->num_proxies++;
+
+	return proxy;
+}
+
+//## public
+/**
+Gets the height of the tree. A leaf has height 0.
+*/
+int32_t kk_broadphase__get_height(kk_broadphase_t* bp)
+{
+	return (bp->root == KK_BROADPHASE_NULL) ? 0 : bp->nodes.data[bp->root].height;
+}
+
+//## public
+uint32_t kk_broadphase__get_user_data(kk_broadphase_t* bp, uint32_t proxy)
+{
+	return bp->nodes.data[proxy].user_data;
+}
+
+//## public
+boolean kk_broadphase__is_static(kk_broadphase_t* bp, uint32_t proxy)
+{
+	return (bp->nodes.data[proxy].dynamic_idx == KK_BROADPHASE_NULL);
+}
+
+//## public
+/**
+Updates a proxy's bounds. The tree is only changed if the new box is not
+inside the proxy's fat box.
+
+@param bp The broadphase.
+@param proxy The proxy.
+@param box The new bounds.
+@return TRUE if the proxy was reinserted.
+*/
+boolean kk_broadphase__move(kk_broadphase_t* bp, uint32_t proxy, kk_aabb_t* box)
+{
+	if (kk_math_aabb_contains(&bp->nodes.data[proxy].box, box))
+	{
+		return FALSE;
+	}
+
+	remove_leaf(bp, proxy);
+	fatten(box, &bp->nodes.data[proxy].box);
+	insert_leaf(bp, proxy);
+	bp->num_reinserts++;
+
+	return TRUE;
+}
+
+//## public
+/**
+Calls a function for each proxy whose fat box overlaps a box.
+
+@param bp The broadphase.
+@param box The box to test.
+@param func Called for each overlapping proxy. Return FALSE to stop.
+@param data User data passed to func.
+*/
+void kk_broadphase__query(kk_broadphase_t* bp, kk_aabb_t* box, kk_broadphase_query_func func, void* data)
+{
+	uint32_t stack[KK_BROADPHASE_MAX_DEPTH];
+	uint32_t count = 0;
+	kk_broadphase_node_t* node;
+	uint32_t idx;
+
+	if (bp->root == KK_BROADPHASE_NULL)
+	{
+		return;
+	}
+
+	stack[count++] = bp->root;
+
+	while (count > 0)
+	{
+		idx = stack[--count];
+		node = &bp->nodes.data[idx];
+
+		if (!kk_math_aabb_overlaps(&node->box, box))
+		{
+			continue;
+		}
+
+		if (node->height == 0)
+		{
+			if (!func(data, idx))
+			{
+				return;
+			}
+
+			continue;
+		}
+
+		if (count + 2 > KK_BROADPHASE_MAX_DEPTH)
+		{
+			kk_log__error("Broadphase tree is too deep to query.");
+			return;
+		}
+
+		stack[count++] = node->child1;
+		stack[count++] = node->child2;
+	}
+}
+
+//## public
+/**
+Calls a function for each proxy whose fat box a ray hits. The function can
+clip the ray, which skips the parts of the tree past the closest hit.
+
+@param bp The broadphase.
+@param ray The ray to test.
+@param func Called for each proxy the ray hits.
+@param data User data passed to func.
+*/
+void kk_broadphase__raycast(kk_broadphase_t* bp, kk_ray_t* ray, kk_broadphase_ray_func func, void* data)
+{
+	uint32_t stack[KK_BROADPHASE_MAX_DEPTH];
+	uint32_t count = 0;
+	kk_broadphase_node_t* node;
+	kk_ray_t r = *ray;
+	kk_vec3_t inv_dir;
+	uint32_t idx;
+	float t;
+
+	if (bp->root == KK_BROADPHASE_NULL)
+	{
+		return;
+	}
+
+	inv_dir.x = 1.0f / r.dir.x;
+	inv_dir.y = 1.0f / r.dir.y;
+	inv_dir.z = 1.0f / r.dir.z;
+
+	stack[count++] = bp->root;
+
+	while (count > 0)
+	{
+		idx = stack[--count];
+		node = &bp->nodes.data[idx];
+
+		if (!kk_math_aabb_raycast(&node->box, &r, &inv_dir, &t))
+		{
+			continue;
+		}
+
+		if (node->height == 0)
+		{
+			t = func(data, idx, &r);
+			r.max_t = min(r.max_t, t);
+			if (r.max_t < 0.0f)
+			{
+				return;
+			}
+
+			continue;
+		}
+
+		if (count + 2 > KK_BROADPHASE_MAX_DEPTH)
+		{
+			kk_log__error("Broadphase tree is too deep to query.");
+			return;
+		}
+
+		stack[count++] = node->child1;
+		stack[count++] = node->child2;
+	}
+}
+
+//## public
+/**
+Removes a proxy.
+
+@param bp The broadphase.
+@param proxy The proxy to remove.
+*/
+void kk_broadphase__remove(kk_broadphase_t* bp, uint32_t proxy)
+{
+	kk_broadphase__set_static(bp, proxy, TRUE);
+	remove_leaf(bp, proxy);
+	free_node(bp, proxy);
+	bp->num_proxies--;
+}
+
+//## public
+/**
+Changes whether a proxy is queried for pairs. Sleeping bodies are made
+static so they stop pairing with each other but still pair with anything
+that moves into them.
+
+@param bp The broadphase.
+@param proxy The proxy.
+@param is_static Should the proxy be static.
+*/
+void kk_broadphase__set_static(kk_broadphase_t* bp, uint32_t proxy, boolean is_static)
+{
+	kk_broadphase_node_t* node = &bp->nodes.data[proxy];
+	uint32_t idx = node->dynamic_idx;
+	uint32_t last;
+
+	if (!is_static && idx == KK_BROADPHASE_NULL)
+	{
+		node->dynamic_idx = bp->dynamic_proxies.count;
+		utl_array_push(&bp->dynamic_proxies, proxy);
+	}
+	else if (is_static && idx != KK_BROADPHASE_NULL)
+	{
+		/* Swap the last dynamic proxy into the hole */
+		last = bp->dynamic_proxies.data[--bp->dynamic_proxies.count];
+		if (last != proxy)
+		{
+			bp->dynamic_proxies.data[idx] = last;
+			bp->nodes.data[last].dynamic_idx = idx;
+		}
+
+		node->dynamic_idx = KK_BROADPHASE_NULL;
+	}
+}
+
+//## public
+/**
+Finds every pair of proxies with overlapping fat boxes where at least one
+proxy is dynamic. Pairs are sorted by user data.
+
+@param bp The broadphase.
+*/
+void kk_broadphase__update_pairs(kk_broadphase_t* bp)
+{
+	pair_query_t query;
+	uint32_t i;
+
+	bp->pairs.count = 0;
+	query.bp = bp;
+
+	for (i = 0; i < bp->dynamic_proxies.count; ++i)
+	{
+		query.proxy = bp->dynamic_proxies.data[i];
+		kk_broadphase__query(bp, &bp->nodes.data[query.proxy].box, add_pair, &query);
+	}
+
+	if (bp->pairs.count > 1)
+	{
+		qsort(bp->pairs.data, bp->pairs.count, sizeof(kk_broadphase_pair_t), compare_pairs);
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Query callback that records a pair with the querying proxy.
+*/
+static boolean add_pair(void* data, uint32_t proxy)
+{
+	pair_query_t* query = (pair_query_t*)data;
+	kk_broadphase_node_t* nodes = query->bp->nodes.data;
+	kk_broadphase_pair_t pair;
+	uint32_t a, b;
+
+	if (proxy == query->proxy)
+	{
+		return TRUE;
+	}
+
+	/* Two dynamic proxies find each other, keep one */
+	if (nodes[proxy].dynamic_idx != KK_BROADPHASE_NULL && proxy < query->proxy)
+	{
+		return TRUE;
+	}
+
+	a = nodes[query->proxy].user_data;
+	b = nodes[proxy].user_data;
+	pair.a = min(a, b);
+	pair.b = max(a, b);
+	utl_array_push(&query->bp->pairs, pair);
+
+	return TRUE;
+}
+
+//## static
+/**
+Takes a node from the free list, growing the node array if needed.
+Invalidates node pointers.
+*/
+static uint32_t allocate_node(kk_broadphase_t* bp)
+{
+	kk_broadphase_node_t node;
+	uint32_t idx;
+
+	if (bp->free_list == KK_BROADPHASE_NULL)
+	{
+		clear_struct(&node);
+		utl_array_push(&bp->nodes, node);
+		idx = bp->nodes.count - 1;
+	}
+	else
+	{
+		idx = bp->free_list;
+		bp->free_list = bp->nodes.data[idx].parent;
+	}
+
+	bp->nodes.data[idx].parent = KK_BROADPHASE_NULL;
+	bp->nodes.data[idx].child1 = KK_BROADPHASE_NULL;
+	bp->nodes.data[idx].child2 = KK_BROADPHASE_NULL;
+	bp->nodes.data[idx].height = 0;
+	bp->nodes.data[idx].dynamic_idx = KK_BROADPHASE_NULL;
+
+	return idx;
+}
+
+//## static
+/**
+Rotates the subtree at node a if its children's heights differ by more than
+one. Returns the new root of the subtree.
+*/
+static uint32_t balance(kk_broadphase_t* bp, uint32_t ia)
+{
+	kk_broadphase_node_t* nodes = bp->nodes.data;
+	kk_broadphase_node_t* a = &nodes[ia];
+	kk_broadphase_node_t* b;
+	kk_broadphase_node_t* c;
+	uint32_t ib, ic;
+	int32_t diff;
+
+	if (a->height < 2)
+	{
+		return ia;
+	}
+
+	ib = a->child1;
+	ic = a->child2;
+	b = &nodes[ib];
+	c = &nodes[ic];
+	diff = c->height - b->height;
+
+	/* Rotate c up */
+	if (diff > 1)
+	{
+		uint32_t i_f = c->child1;
+		uint32_t i_g = c->child2;
+		kk_broadphase_node_t* f = &nodes[i_f];
+		kk_broadphase_node_t* g = &nodes[i_g];
+
+		c->child1 = ia;
+		c->parent = a->parent;
+		a->parent = ic;
+
+		replace_child(bp, c->parent, ia, ic);
+
+		if (f->height > g->height)
+		{
+			c->child2 = i_f;
+			a->child2 = i_g;
+			g->parent = ia;
+			kk_math_aabb_union(&b->box, &g->box, &a->box);
+			kk_math_aabb_union(&a->box, &f->box, &c->box);
+			a->height = 1 + max(b->height, g->height);
+			c->height = 1 + max(a->height, f->height);
+		}
+		else
+		{
+			c->child2 = i_g;
+			a->child2 = i_f;
+			f->parent = ia;
+			kk_math_aabb_union(&b->box, &f->box, &a->box);
+			kk_math_aabb_union(&a->box, &g->box, &c->box);
+			a->height = 1 + max(b->height, f->height);
+			c->height = 1 + max(a->height, g->height);
+		}
+
+		return ic;
+	}
+
+	/* Rotate b up */
+	if (diff < -1)
+	{
+		uint32_t i_d = b->child1;
+		uint32_t i_e = b->child2;
+		kk_broadphase_node_t* d = &nodes[i_d];
+		kk_broadphase_node_t* e = &nodes[i_e];
+
+		b->child1 = ia;
+		b->parent = a->parent;
+		a->parent = ib;
+
+		replace_child(bp, b->parent, ia, ib);
+
+		if (d->height > e->height)
+		{
+			b->child2 = i_d;
+			a->child1 = i_e;
+			e->parent = ia;
+			kk_math_aabb_union(&c->box, &e->box, &a->box);
+			kk_math_aabb_union(&a->box, &d->box, &b->box);
+			a->height = 1 + max(c->height, e->height);
+			b->height = 1 + max(a->height, d->height);
+		}
+		else
+		{
+			b->child2 = i_e;
+			a->child1 = i_d;
+			d->parent = ia;
+			kk_math_aabb_union(&c->box, &d->box, &a->box);
+			kk_math_aabb_union(&a->box, &e->box, &b->box);
+			a->height = 1 + max(c->height, d->height);
+			b->height = 1 + max(a->height, e->height);
+		}
+
+		return ib;
+	}
+
+	return ia;
+}
+
+//## static
+static int compare_pairs(const void* a, const void* b)
+{
+	const kk_broadphase_pair_t* pa = (const kk_broadphase_pair_t*)a;
+	const kk_broadphase_pair_t* pb = (const kk_broadphase_pair_t*)b;
+
+	if (pa->a != pb->a)
+	{
+		return (pa->a > pb->a) - (pa->a < pb->a);
+	}
+
+	return (pa->b > pb->b) - (pa->b < pb->b);
+}
+
+//## static
+static void fatten(kk_aabb_t* box, kk_aabb_t* out__fat)
+{
+	out__fat->min.x = box->min.x - KK_BROADPHASE_MARGIN;
+	out__fat->min.y = box->min.y - KK_BROADPHASE_MARGIN;
+	out__fat->min.z = box->min.z - KK_BROADPHASE_MARGIN;
+	out__fat->max.x = box->max.x + KK_BROADPHASE_MARGIN;
+	out__fat->max.y = box->max.y + KK_BROADPHASE_MARGIN;
+	out__fat->max.z = box->max.z + KK_BROADPHASE_MARGIN;
+}
+
+//## static
+static void free_node(kk_broadphase_t* bp, uint32_t idx)
+{
+	bp->nodes.data[idx].parent = bp->free_list;
+	bp->nodes.data[idx].height = -1;
+	bp->free_list = idx;
+}
+
+//## static
+/**
+Surface area of a box. Used as the cost of a node since it is proportional
+to the chance of a random ray or box hitting it.
+*/
+static float get_area(kk_aabb_t* box)
+{
+	float dx = box->max.x - box->min.x;
+	float dy = box->max.y - box->min.y;
+	float dz = box->max.z - box->min.z;
+
+	return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+//## static
+/**
+Inserts a leaf next to the sibling that adds the least area to the tree.
+*/
+static void insert_leaf(kk_broadphase_t* bp, uint32_t leaf)
+{
+	kk_aabb_t leaf_box = bp->nodes.data[leaf].box;
+	kk_aabb_t combined;
+	kk_broadphase_node_t* node;
+	uint32_t idx;
+	uint32_t sibling;
+	uint32_t old_parent;
+	uint32_t new_parent;
+
+	if (bp->root == KK_BROADPHASE_NULL)
+	{
+		bp->root = leaf;
+		bp->nodes.data[leaf].parent = KK_BROADPHASE_NULL;
+		return;
+	}
+
+	/* Descend to the cheapest sibling */
+	idx = bp->root;
+	while (bp->nodes.data[idx].height > 0)
+	{
+		float area, cost, inheritance, cost1, cost2;
+
+		node = &bp->nodes.data[idx];
+		area = get_area(&node->box);
+		kk_math_aabb_union(&node->box, &leaf_box, &combined);
+
+		/* Cost of making a new parent for this node and the leaf */
+		cost = 2.0f * get_area(&combined);
+
+		/* Minimum cost of pushing the leaf further down */
+		inheritance = 2.0f * (get_area(&combined) - area);
+		cost1 = get_descend_cost(bp, node->child1, &leaf_box) + inheritance;
+		cost2 = get_descend_cost(bp, node->child2, &leaf_box) + inheritance;
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		idx = (cost1 < cost2) ? node->child1 : node->child2;
+	}
+
+	sibling = idx;
+
+	/* Join the sibling and the leaf under a new parent */
+	new_parent = allocate_node(bp);
+	old_parent = bp->nodes.data[sibling].parent;
+
+	node = &bp->nodes.data[new_parent];
+	node->parent = old_parent;
+	node->child1 = sibling;
+	node->child2 = leaf;
+	node->height = bp->nodes.data[sibling].height + 1;
+	kk_math_aabb_union(&leaf_box, &bp->nodes.data[sibling].box, &node->box);
+
+	bp->nodes.data[sibling].parent = new_parent;
+	bp->nodes.data[leaf].parent = new_parent;
+
+	if (old_parent == KK_BROADPHASE_NULL)
+	{
+		bp->root = new_parent;
+	}
+	else
+	{
+		replace_child(bp, old_parent, sibling, new_parent);
+	}
+
+	refit(bp, bp->nodes.data[leaf].parent);
+}
+
+//## static
+/**
+Cost of descending into a child to insert a leaf.
+*/
+static float get_descend_cost(kk_broadphase_t* bp, uint32_t child, kk_aabb_t* leaf_box)
+{
+	kk_broadphase_node_t* node = &bp->nodes.data[child];
+	kk_aabb_t combined;
+
+	kk_math_aabb_union(leaf_box, &node->box, &combined);
+
+	if (node->height == 0)
+	{
+		return get_area(&combined);
+	}
+
+	return get_area(&combined) - get_area(&node->box);
+}
+
+//## static
+/**
+Walks from a node to the root, balancing and updating bounds and heights.
+*/
+static void refit(kk_broadphase_t* bp, uint32_t idx)
+{
+	kk_broadphase_node_t* node;
+
+	while (idx != KK_BROADPHASE_NULL)
+	{
+		idx = balance(bp, idx);
+
+		node = &bp->nodes.data[idx];
+		node->height = 1 + max(bp->nodes.data[node->child1].height, bp->nodes.data[node->child2].height);
+		kk_math_aabb_union(&bp->nodes.data[node->child1].box, &bp->nodes.data[node->child2].box, &node->box);
+
+		idx = node->parent;
+	}
+}
+
+//## static
+/**
+Detaches a leaf from the tree. Its parent is freed and the sibling takes the
+parent's place.
+*/
+static void remove_leaf(kk_broadphase_t* bp, uint32_t leaf)
+{
+	kk_broadphase_node_t* parent;
+	uint32_t parent_idx;
+	uint32_t grandparent;
+	uint32_t sibling;
+
+	if (leaf == bp->root)
+	{
+		bp->root = KK_BROADPHASE_NULL;
+		return;
+	}
+
+	parent_idx = bp->nodes.data[leaf].parent;
+	parent = &bp->nodes.data[parent_idx];
+	grandparent = parent->parent;
+	sibling = (parent->child1 == leaf) ? parent->child2 : parent->child1;
+
+	bp->nodes.data[sibling].parent = grandparent;
+	free_node(bp, parent_idx);
+
+	if (grandparent == KK_BROADPHASE_NULL)
+	{
+		bp->root = sibling;
+		return;
+	}
+
+	replace_child(bp, grandparent, parent_idx, sibling);
+	refit(bp, grandparent);
+}
+
+//## static
+/**
+Points a parent at a new child in place of an old one. A null parent means
+the new child becomes the root.
+*/
+static void replace_child(kk_broadphase_t* bp, uint32_t parent, uint32_t old_child, uint32_t new_child)
+{
+	kk_broadphase_node_t* node;
+
+	if (parent == KK_BROADPHASE_NULL)
+	{
+		bp->root = new_child;
+		return;
+	}
+
+	node = &bp->nodes.data[parent];
+	if (node->child1 == old_child)
+	{
+		node->child1 = new_child;
+	}
+	else
+	{
+		node->child2 = new_child;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef KK_BROADPHASE_H
+#define KK_BROADPHASE_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_broadphase_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_BROADPHASE_NULL			(0xFFFFFFFF)	/* No node/proxy. */
+#define KK_BROADPHASE_MARGIN		(0.1f)			/* Proxies are fattened by this much so small moves don't touch the tree. */
+#define KK_BROADPHASE_MAX_DEPTH		(256)			/* Maximum tree depth a query can traverse. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Called for each proxy whose fat box overlaps a query box. Return FALSE to
+stop the query.
+*/
+typedef boolean (*kk_broadphase_query_func)(void* data, uint32_t proxy);
+
+/**
+Called for each proxy whose fat box a ray hits. Returns the ray's new max_t,
+smaller to clip it to a hit or negative to stop the query.
+*/
+typedef float (*kk_broadphase_ray_func)(void* data, uint32_t proxy, kk_ray_t* ray);
+
+/**
+Tree node. Leaves are proxies.
+*/
+typedef struct
+{
+	kk_aabb_t				box;			/* Fat box for a leaf, union of the children otherwise. */
+	uint32_t				parent;			/* Parent node. Next free node while on the free list. */
+	uint32_t				child1;			/* KK_BROADPHASE_NULL for a leaf. */
+	uint32_t				child2;
+	int32_t					height;			/* 0 for a leaf, -1 while free. */
+	uint32_t				user_data;		/* Leaf only. */
+	uint32_t				dynamic_idx;	/* Leaf only. Index in the dynamic proxy list, KK_BROADPHASE_NULL if static. */
+
+} kk_broadphase_node_t;
+
+utl_array_declare_type(kk_broadphase_node_t);
+
+/**
+Two proxies whose fat boxes overlap. Identified by user data, a < b.
+*/
+typedef struct
+{
+	uint32_t				a;
+	uint32_t				b;
+
+} kk_broadphase_pair_t;
+
+utl_array_declare_type(kk_broadphase_pair_t);
+
+/**
+Dynamic AABB tree broadphase. Each proxy has a box fattened by
+KK_BROADPHASE_MARGIN. Moving a proxy only touches the tree when its new box
+leaves the fat box. Inserts pick the sibling with the lowest surface area
+cost and the tree is kept balanced with rotations.
+
+Pairs are found by querying the tree with every dynamic proxy, so static
+proxies never pair with each other and cost nothing while they don't move.
+*/
+struct kk_broadphase_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(kk_broadphase_node_t)	nodes;
+	utl_array_t(uint32_t)				dynamic_proxies;	/* Leaves that are queried for pairs. */
+	utl_array_t(kk_broadphase_pair_t)	pairs;				/* Pairs from the last kk_broadphase__update_pairs. */
+
+	/*
+	Other
+	*/
+	uint32_t							root;
+	uint32_t							free_list;
+	uint32_t							num_proxies;
+	uint32_t							num_reinserts;		/* Proxies that left their fat box. Stat, cleared by update_pairs. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_broadphase.public.h"
+
+#endif /* KK_BROADPHASE_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef KK_BROADPHASE__H
+#define KK_BROADPHASE__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_broadphase_s kk_broadphase_t;
+
+#endif /* KK_BROADPHASE__H */
\ No newline at end of file
@@ -0,0 +1,777 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "engine/kk_bvh.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Triangle reference used while building.
+*/
+typedef struct
+{
+	kk_aabb_t				box;
+	kk_vec3_t				centroid;
+	uint32_t				id;
+
+} build_ref_t;
+
+/**
+Split candidate bucket.
+*/
+typedef struct
+{
+	kk_aabb_t				box;
+	uint32_t				count;
+
+} build_bin_t;
+
+#include "autogen/kk_bvh.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Builds a tree over an indexed triangle mesh. The mesh is copied, so it can
+be freed afterwards.
+
+@param bvh The tree to construct.
+@param positions Vertex positions, three floats each.
+@param indices Vertex indices, three per triangle.
+@param num_triangles The number of triangles.
+*/
+void kk_bvh__construct(kk_bvh_t* bvh, const float* positions, const uint32_t* indices, uint32_t num_triangles)
+{
+	build_ref_t* refs;
+	kk_bvh_triangle_t* tri;
+	const float* p;
+	uint32_t i;
+	uint32_t j;
+
+	clear_struct(bvh);
+	utl_array_init(&bvh->nodes);
+	utl_array_init(&bvh->triangles);
+
+	if (num_triangles == 0)
+	{
+		return;
+	}
+
+	refs = (build_ref_t*)malloc(sizeof(build_ref_t) * num_triangles);
+	for (i = 0; i < num_triangles; ++i)
+	{
+		p = &positions[indices[i * 3] * 3];
+		refs[i].box.min.x = refs[i].box.max.x = p[0];
+		refs[i].box.min.y = refs[i].box.max.y = p[1];
+		refs[i].box.min.z = refs[i].box.max.z = p[2];
+
+		for (j = 1; j < 3; ++j)
+		{
+			p = &positions[indices[i * 3 + j] * 3];
+			refs[i].box.min.x = min(refs[i].box.min.x, p[0]);
+			refs[i].box.min.y = min(refs[i].box.min.y, p[1]);
+			refs[i].box.min.z = min(refs[i].box.min.z, p[2]);
+			refs[i].box.max.x = max(refs[i].box.max.x, p[0]);
+			refs[i].box.max.y = max(refs[i].box.max.y, p[1]);
+			refs[i].box.max.z = max(refs[i].box.max.z, p[2]);
+		}
+
+		refs[i].centroid.x = 0.5f * (refs[i].box.min.x + refs[i].box.max.x);
+		refs[i].centroid.y = 0.5f * (refs[i].box.min.y + refs[i].box.max.y);
+		refs[i].centroid.z = 0.5f * (refs[i].box.min.z + refs[i].box.max.z);
+		refs[i].id = i;
+	}
+
+	/* A binary tree with single triangle leaves has 2n - 1 nodes */
+	utl_array_reserve(&bvh->nodes, 2 * num_triangles - 1);
+	build_node(bvh, refs, 0, num_triangles, 0);
+
+	/* Leaves index the references, which are now in leaf order */
+	utl_array_resize(&bvh->triangles, num_triangles);
+	for (i = 0; i < num_triangles; ++i)
+	{
+		tri = &bvh->triangles.data[i];
+		tri->id = refs[i].id;
+
+		for (j = 0; j < 3; ++j)
+		{
+			p = &positions[indices[tri->id * 3 + j] * 3];
+			tri->v[j].x = p[0];
+			tri->v[j].y = p[1];
+			tri->v[j].z = p[2];
+		}
+	}
+
+	free(refs);
+}
+
+//## public
+/**
+Destructs a tree.
+
+@param bvh The tree to destruct.
+*/
+void kk_bvh__destruct(kk_bvh_t* bvh)
+{
+	utl_array_destroy(&bvh->triangles);
+	utl_array_destroy(&bvh->nodes);
+	clear_struct(bvh);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Checks if any triangle overlaps a box.
+
+@param bvh The tree.
+@param m Places the mesh in the space of the box.
+@param box The box.
+@return TRUE if a triangle overlaps the box.
+*/
+boolean kk_bvh__overlap_aabb(kk_bvh_t* bvh, kk_mat4_t* m, kk_aabb_t* box)
+{
+	uint32_t stack[KK_BVH_MAX_DEPTH];
+	uint32_t count = 0;
+	kk_bvh_node_t* node;
+	kk_aabb_t node_box;
+	kk_vec3_t v[3];
+	uint32_t i;
+
+	if (bvh->nodes.count == 0)
+	{
+		return FALSE;
+	}
+
+	stack[count++] = 0;
+
+	while (count > 0)
+	{
+		node = &bvh->nodes.data[stack[--count]];
+
+		kk_math_aabb_transform(&node->box, m, &node_box);
+		if (!kk_math_aabb_overlaps(&node_box, box))
+		{
+			continue;
+		}
+
+		if (node->count == 0)
+		{
+			stack[count++] = node->start;
+			stack[count++] = (uint32_t)(node - bvh->nodes.data) + 1;
+			continue;
+		}
+
+		for (i = node->start; i < node->start + node->count; ++i)
+		{
+			transform_triangle(&bvh->triangles.data[i], m, v);
+			if (overlap_triangle_box(v, box))
+			{
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+//## public
+/**
+Checks if any triangle overlaps a sphere.
+
+@param bvh The tree.
+@param m Places the mesh in the space of the sphere.
+@param center The center of the sphere.
+@param radius The radius of the sphere.
+@return TRUE if a triangle overlaps the sphere.
+*/
+boolean kk_bvh__overlap_sphere(kk_bvh_t* bvh, kk_mat4_t* m, kk_vec3_t* center, float radius)
+{
+	uint32_t stack[KK_BVH_MAX_DEPTH];
+	uint32_t count = 0;
+	kk_bvh_node_t* node;
+	kk_aabb_t node_box;
+	kk_vec3_t closest;
+	kk_vec3_t d;
+	kk_vec3_t v[3];
+	uint32_t i;
+
+	if (bvh->nodes.count == 0)
+	{
+		return FALSE;
+	}
+
+	stack[count++] = 0;
+
+	while (count > 0)
+	{
+		node = &bvh->nodes.data[stack[--count]];
+
+		kk_math_aabb_transform(&node->box, m, &node_box);
+		d.x = max(node_box.min.x - center->x, max(0.0f, center->x - node_box.max.x));
+		d.y = max(node_box.min.y - center->y, max(0.0f, center->y - node_box.max.y));
+		d.z = max(node_box.min.z - center->z, max(0.0f, center->z - node_box.max.z));
+		if (kk_math_vec3_dot(&d, &d) > radius * radius)
+		{
+			continue;
+		}
+
+		if (node->count == 0)
+		{
+			stack[count++] = node->start;
+			stack[count++] = (uint32_t)(node - bvh->nodes.data) + 1;
+			continue;
+		}
+
+		for (i = node->start; i < node->start + node->count; ++i)
+		{
+			transform_triangle(&bvh->triangles.data[i], m, v);
+			closest_point_on_triangle(v, center, &closest);
+			kk_math_vec3_sub(&closest, center, &d);
+
+			if (kk_math_vec3_dot(&d, &d) <= radius * radius)
+			{
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+//## public
+/**
+Finds the closest triangle a ray hits. Children are visited nearest first
+and anything past the closest hit so far is skipped. Triangles are hit from
+either side.
+
+@param bvh The tree.
+@param ray The ray, in the mesh's space.
+@param out__hit The closest hit.
+@return TRUE if the ray hit a triangle.
+*/
+boolean kk_bvh__raycast(kk_bvh_t* bvh, kk_ray_t* ray, kk_bvh_hit_t* out__hit)
+{
+	uint32_t stack[KK_BVH_MAX_DEPTH];
+	float stack_t[KK_BVH_MAX_DEPTH];
+	uint32_t count = 0;
+	kk_bvh_node_t* node;
+	kk_bvh_triangle_t* tri;
+	kk_ray_t r = *ray;
+	kk_vec3_t inv_dir;
+	uint32_t child[2];
+	float child_t[2];
+	boolean child_hit[2];
+	boolean hit = FALSE;
+	uint32_t idx;
+	uint32_t i;
+	float t;
+
+	if (bvh->nodes.count == 0)
+	{
+		return FALSE;
+	}
+
+	inv_dir.x = 1.0f / r.dir.x;
+	inv_dir.y = 1.0f / r.dir.y;
+	inv_dir.z = 1.0f / r.dir.z;
+
+	if (!kk_math_aabb_raycast(&bvh->nodes.data[0].box, &r, &inv_dir, &t))
+	{
+		return FALSE;
+	}
+
+	stack[count] = 0;
+	stack_t[count++] = t;
+
+	while (count > 0)
+	{
+		--count;
+		if (stack_t[count] > r.max_t)
+		{
+			continue;
+		}
+
+		idx = stack[count];
+		node = &bvh->nodes.data[idx];
+
+		if (node->count > 0)
+		{
+			for (i = node->start; i < node->start + node->count; ++i)
+			{
+				if (raycast_triangle(&bvh->triangles.data[i], &r, &t))
+				{
+					r.max_t = t;
+					out__hit->t = t;
+					out__hit->triangle = i;
+					hit = TRUE;
+				}
+			}
+
+			continue;
+		}
+
+		child[0] = idx + 1;
+		child[1] = node->start;
+		child_hit[0] = kk_math_aabb_raycast(&bvh->nodes.data[child[0]].box, &r, &inv_dir, &child_t[0]);
+		child_hit[1] = kk_math_aabb_raycast(&bvh->nodes.data[child[1]].box, &r, &inv_dir, &child_t[1]);
+
+		/* Far child goes on the stack first so the near one is popped next */
+		i = (child_hit[0] && child_hit[1] && child_t[1] < child_t[0]) ? 1 : 0;
+
+		if (child_hit[1 - i])
+		{
+			stack[count] = child[1 - i];
+			stack_t[count++] = child_t[1 - i];
+		}
+
+		if (child_hit[i])
+		{
+			stack[count] = child[i];
+			stack_t[count++] = child_t[i];
+		}
+	}
+
+	if (hit)
+	{
+		tri = &bvh->triangles.data[out__hit->triangle];
+		get_normal(tri->v, &ray->dir, &out__hit->normal);
+	}
+
+	return hit;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Builds the node for a range of references and everything below it. Splits
+on the axis and bin boundary with the lowest surface area cost, ordering the
+references so each child owns a contiguous range.
+*/
+static uint32_t build_node(kk_bvh_t* bvh, build_ref_t* refs, uint32_t begin, uint32_t end, uint32_t depth)
+{
+	build_bin_t bins[KK_BVH_NUM_BINS];
+	kk_aabb_t right_boxes[KK_BVH_NUM_BINS - 1];
+	uint32_t right_counts[KK_BVH_NUM_BINS - 1];
+	kk_bvh_node_t node;
+	kk_aabb_t centroids;
+	kk_aabb_t left_box;
+	kk_aabb_t right_box;
+	build_ref_t swap;
+	uint32_t idx = bvh->nodes.count;
+	uint32_t best_axis = 3;
+	uint32_t best_split = 0;
+	uint32_t left_count;
+	uint32_t right_count;
+	uint32_t axis;
+	uint32_t mid;
+	uint32_t i;
+	float best_cost = FLT_MAX;
+	float cmin;
+	float extent;
+	float cost;
+
+	clear_struct(&node);
+	node.box = refs[begin].box;
+	centroids.min = centroids.max = refs[begin].centroid;
+
+	for (i = begin + 1; i < end; ++i)
+	{
+		kk_math_aabb_union(&node.box, &refs[i].box, &node.box);
+		centroids.min.x = min(centroids.min.x, refs[i].centroid.x);
+		centroids.min.y = min(centroids.min.y, refs[i].centroid.y);
+		centroids.min.z = min(centroids.min.z, refs[i].centroid.z);
+		centroids.max.x = max(centroids.max.x, refs[i].centroid.x);
+		centroids.max.y = max(centroids.max.y, refs[i].centroid.y);
+		centroids.max.z = max(centroids.max.z, refs[i].centroid.z);
+	}
+
+	utl_array_push(&bvh->nodes, node);
+
+	if (end - begin <= KK_BVH_LEAF_SIZE || depth + 1 >= KK_BVH_MAX_DEPTH)
+	{
+		bvh->nodes.data[idx].start = begin;
+		bvh->nodes.data[idx].count = end - begin;
+		return idx;
+	}
+
+	for (axis = 0; axis < 3; ++axis)
+	{
+		cmin = ((float*)&centroids.min)[axis];
+		extent = ((float*)&centroids.max)[axis] - cmin;
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		clear_struct(&bins);
+		for (i = begin; i < end; ++i)
+		{
+			build_bin_t* bin = &bins[get_bin(&refs[i], axis, cmin, extent)];
+			if (bin->count == 0)
+			{
+				bin->box = refs[i].box;
+			}
+			else
+			{
+				kk_math_aabb_union(&bin->box, &refs[i].box, &bin->box);
+			}
+
+			bin->count++;
+		}
+
+		/* Sweep from the right to get everything after each boundary */
+		right_count = 0;
+		for (i = KK_BVH_NUM_BINS - 1; i > 0; --i)
+		{
+			if (bins[i].count > 0)
+			{
+				if (right_count == 0)
+				{
+					right_box = bins[i].box;
+				}
+				else
+				{
+					kk_math_aabb_union(&right_box, &bins[i].box, &right_box);
+				}
+
+				right_count += bins[i].count;
+			}
+
+			right_boxes[i - 1] = right_box;
+			right_counts[i - 1] = right_count;
+		}
+
+		/* Then from the left, splitting after bin i */
+		left_count = 0;
+		for (i = 0; i < KK_BVH_NUM_BINS - 1; ++i)
+		{
+			if (bins[i].count > 0)
+			{
+				if (left_count == 0)
+				{
+					left_box = bins[i].box;
+				}
+				else
+				{
+					kk_math_aabb_union(&left_box, &bins[i].box, &left_box);
+				}
+
+				left_count += bins[i].count;
+			}
+
+			if (left_count == 0 || right_counts[i] == 0)
+			{
+				continue;
+			}
+
+			cost = get_area(&left_box) * (float)left_count + get_area(&right_boxes[i]) * (float)right_counts[i];
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				best_axis = axis;
+				best_split = i;
+			}
+		}
+	}
+
+	/* Every centroid is in the same place, so there is nothing to split */
+	if (best_axis == 3)
+	{
+		bvh->nodes.data[idx].start = begin;
+		bvh->nodes.data[idx].count = end - begin;
+		return idx;
+	}
+
+	cmin = ((float*)&centroids.min)[best_axis];
+	extent = ((float*)&centroids.max)[best_axis] - cmin;
+	mid = begin;
+
+	for (i = begin; i < end; ++i)
+	{
+		if (get_bin(&refs[i], best_axis, cmin, extent) <= best_split)
+		{
+			swap = refs[i];
+			refs[i] = refs[mid];
+			refs[mid] = swap;
+			mid++;
+		}
+	}
+
+	/* First child follows this node, the second is linked */
+	build_node(bvh, refs, begin, mid, depth + 1);
+	i = build_node(bvh, refs, mid, end, depth + 1);
+	bvh->nodes.data[idx].start = i;
+
+	return idx;
+}
+
+//## static
+/**
+Finds the point on a triangle closest to a point.
+*/
+static void closest_point_on_triangle(kk_vec3_t* v, kk_vec3_t* p, kk_vec3_t* out__point)
+{
+	kk_vec3_t ab, ac, ap, bp, cp;
+	float d1, d2, d3, d4, d5, d6;
+	float va, vb, vc;
+	float denom;
+	float s, t;
+
+	kk_math_vec3_sub(&v[1], &v[0], &ab);
+	kk_math_vec3_sub(&v[2], &v[0], &ac);
+	kk_math_vec3_sub(p, &v[0], &ap);
+
+	/* Vertex regions, then edge regions, then the face */
+	d1 = kk_math_vec3_dot(&ab, &ap);
+	d2 = kk_math_vec3_dot(&ac, &ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+	{
+		*out__point = v[0];
+		return;
+	}
+
+	kk_math_vec3_sub(p, &v[1], &bp);
+	d3 = kk_math_vec3_dot(&ab, &bp);
+	d4 = kk_math_vec3_dot(&ac, &bp);
+	if (d3 >= 0.0f && d4 <= d3)
+	{
+		*out__point = v[1];
+		return;
+	}
+
+	vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+	{
+		s = d1 / (d1 - d3);
+		kk_math_vec3_scale(&ab, s, out__point);
+		kk_math_vec3_add(&v[0], out__point, out__point);
+		return;
+	}
+
+	kk_math_vec3_sub(p, &v[2], &cp);
+	d5 = kk_math_vec3_dot(&ab, &cp);
+	d6 = kk_math_vec3_dot(&ac, &cp);
+	if (d6 >= 0.0f && d5 <= d6)
+	{
+		*out__point = v[2];
+		return;
+	}
+
+	vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+	{
+		t = d2 / (d2 - d6);
+		kk_math_vec3_scale(&ac, t, out__point);
+		kk_math_vec3_add(&v[0], out__point, out__point);
+		return;
+	}
+
+	va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+	{
+		t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		kk_math_vec3_sub(&v[2], &v[1], out__point);
+		kk_math_vec3_scale(out__point, t, out__point);
+		kk_math_vec3_add(&v[1], out__point, out__point);
+		return;
+	}
+
+	denom = 1.0f / (va + vb + vc);
+	s = vb * denom;
+	t = vc * denom;
+	out__point->x = v[0].x + ab.x * s + ac.x * t;
+	out__point->y = v[0].y + ab.y * s + ac.y * t;
+	out__point->z = v[0].z + ab.z * s + ac.z * t;
+}
+
+//## static
+/**
+Surface area of a box, the cost of visiting a node.
+*/
+static float get_area(kk_aabb_t* box)
+{
+	float dx = box->max.x - box->min.x;
+	float dy = box->max.y - box->min.y;
+	float dz = box->max.z - box->min.z;
+
+	return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+//## static
+/**
+Gets the bin a reference's centroid falls in along an axis.
+*/
+static uint32_t get_bin(build_ref_t* ref, uint32_t axis, float cmin, float extent)
+{
+	float c = ((float*)&ref->centroid)[axis];
+	uint32_t bin = (uint32_t)((c - cmin) / extent * (float)KK_BVH_NUM_BINS);
+
+	return min(bin, KK_BVH_NUM_BINS - 1);
+}
+
+//## static
+/**
+Gets the unit normal of a triangle, facing against a direction.
+*/
+static void get_normal(kk_vec3_t* v, kk_vec3_t* dir, kk_vec3_t* out__normal)
+{
+	kk_vec3_t e1;
+	kk_vec3_t e2;
+
+	kk_math_vec3_sub(&v[1], &v[0], &e1);
+	kk_math_vec3_sub(&v[2], &v[0], &e2);
+	kk_math_cross(&e1, &e2, out__normal);
+	kk_math_vec3_normalize(out__normal);
+
+	if (kk_math_vec3_dot(out__normal, dir) > 0.0f)
+	{
+		kk_math_vec3_scale(out__normal, -1.0f, out__normal);
+	}
+}
+
+//## static
+/**
+Separating axis test between a triangle and a box. The axes are the box
+faces, the triangle's plane and the cross products of their edges.
+*/
+static boolean overlap_triangle_box(kk_vec3_t* v, kk_aabb_t* box)
+{
+	kk_vec3_t box_axes[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	kk_vec3_t center;
+	kk_vec3_t half;
+	kk_vec3_t p[3];
+	kk_vec3_t edges[3];
+	kk_vec3_t normal;
+	kk_vec3_t axis;
+	float p0, p1, p2, r;
+	int i, j;
+
+	center.x = 0.5f * (box->min.x + box->max.x);
+	center.y = 0.5f * (box->min.y + box->max.y);
+	center.z = 0.5f * (box->min.z + box->max.z);
+	kk_math_vec3_sub(&box->max, &center, &half);
+
+	for (i = 0; i < 3; ++i)
+	{
+		kk_math_vec3_sub(&v[i], &center, &p[i]);
+	}
+
+	/* Box faces */
+	if (min(p[0].x, min(p[1].x, p[2].x)) > half.x || max(p[0].x, max(p[1].x, p[2].x)) < -half.x
+	 || min(p[0].y, min(p[1].y, p[2].y)) > half.y || max(p[0].y, max(p[1].y, p[2].y)) < -half.y
+	 || min(p[0].z, min(p[1].z, p[2].z)) > half.z || max(p[0].z, max(p[1].z, p[2].z)) < -half.z)
+	{
+		return FALSE;
+	}
+
+	/* Triangle plane */
+	kk_math_vec3_sub(&p[1], &p[0], &edges[0]);
+	kk_math_vec3_sub(&p[2], &p[1], &edges[1]);
+	kk_math_vec3_sub(&p[0], &p[2], &edges[2]);
+	kk_math_cross(&edges[0], &edges[1], &normal);
+
+	r = half.x * fabsf(normal.x) + half.y * fabsf(normal.y) + half.z * fabsf(normal.z);
+	if (fabsf(kk_math_vec3_dot(&normal, &p[0])) > r)
+	{
+		return FALSE;
+	}
+
+	/* Edge pairs */
+	for (i = 0; i < 3; ++i)
+	{
+		for (j = 0; j < 3; ++j)
+		{
+			kk_math_cross(&box_axes[j], &edges[i], &axis);
+
+			p0 = kk_math_vec3_dot(&axis, &p[0]);
+			p1 = kk_math_vec3_dot(&axis, &p[1]);
+			p2 = kk_math_vec3_dot(&axis, &p[2]);
+			r = half.x * fabsf(axis.x) + half.y * fabsf(axis.y) + half.z * fabsf(axis.z);
+
+			if (min(p0, min(p1, p2)) > r || max(p0, max(p1, p2)) < -r)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+//## static
+/**
+Moller-Trumbore ray/triangle test. Hits either side.
+*/
+static boolean raycast_triangle(kk_bvh_triangle_t* tri, kk_ray_t* ray, float* out__t)
+{
+	kk_vec3_t e1, e2, p, s, q;
+	float det;
+	float inv_det;
+	float u, v, t;
+
+	kk_math_vec3_sub(&tri->v[1], &tri->v[0], &e1);
+	kk_math_vec3_sub(&tri->v[2], &tri->v[0], &e2);
+	kk_math_cross(&ray->dir, &e2, &p);
+
+	det = kk_math_vec3_dot(&e1, &p);
+	if (fabsf(det) < 1e-12f)
+	{
+		return FALSE;
+	}
+
+	inv_det = 1.0f / det;
+	kk_math_vec3_sub(&ray->origin, &tri->v[0], &s);
+	u = kk_math_vec3_dot(&s, &p) * inv_det;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return FALSE;
+	}
+
+	kk_math_cross(&s, &e1, &q);
+	v = kk_math_vec3_dot(&ray->dir, &q) * inv_det;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return FALSE;
+	}
+
+	t = kk_math_vec3_dot(&e2, &q) * inv_det;
+	if (t < 0.0f || t > ray->max_t)
+	{
+		return FALSE;
+	}
+
+	*out__t = t;
+	return TRUE;
+}
+
+//## static
+/**
+Transforms a triangle's vertices by a matrix.
+*/
+static void transform_triangle(kk_bvh_triangle_t* tri, kk_mat4_t* m, kk_vec3_t* out__v)
+{
+	kk_math_mat4_mulv3(m, &tri->v[0], 1.0f, &out__v[0]);
+	kk_math_mat4_mulv3(m, &tri->v[1], 1.0f, &out__v[1]);
+	kk_math_mat4_mulv3(m, &tri->v[2], 1.0f, &out__v[2]);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef KK_BVH_H
+#define KK_BVH_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_bvh_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_BVH_LEAF_SIZE		(4)		/* Most triangles in a leaf, unless they can't be split. */
+#define KK_BVH_MAX_DEPTH		(64)	/* Deeper nodes are made leaves so queries have a fixed stack. */
+#define KK_BVH_NUM_BINS			(8)		/* Split candidates per axis when building. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Tree node. The first child of an inner node follows it in the array.
+*/
+typedef struct
+{
+	kk_aabb_t				box;
+	uint32_t				start;		/* First triangle for a leaf, second child otherwise. */
+	uint32_t				count;		/* Triangles in a leaf, 0 otherwise. */
+
+} kk_bvh_node_t;
+
+utl_array_declare_type(kk_bvh_node_t);
+
+/**
+Triangle, stored in leaf order.
+*/
+typedef struct
+{
+	kk_vec3_t				v[3];
+	uint32_t				id;			/* Index of the triangle in the source mesh. */
+
+} kk_bvh_triangle_t;
+
+utl_array_declare_type(kk_bvh_triangle_t);
+
+/**
+Result of a raycast.
+*/
+typedef struct
+{
+	float					t;			/* Ray parameter of the hit. */
+	uint32_t				triangle;	/* Index into the tree's triangles. */
+	kk_vec3_t				normal;		/* Unit face normal, facing back along the ray. */
+
+} kk_bvh_hit_t;
+
+/**
+Bounding volume hierarchy over a static triangle mesh. Built once with
+binned surface area splits and never changed, so nodes are packed depth
+first and each triangle's vertices sit in its leaf's range.
+
+Queries run in the mesh's space. Shape overlaps take the matrix that places
+the mesh so they can test the exact triangles under any affine transform.
+*/
+struct kk_bvh_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(kk_bvh_node_t)		nodes;		/* Root first. Empty without triangles. */
+	utl_array_t(kk_bvh_triangle_t)	triangles;
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_bvh.public.h"
+
+#endif /* KK_BVH_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef KK_BVH__H
+#define KK_BVH__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_bvh_s kk_bvh_t;
+
+#endif /* KK_BVH__H */
\ No newline at end of file
@@ -2,6 +2,8 @@
 INCLUDES
 =========================================================*/
 
+#include <math.h>
+
 #include "common.h"
 #include "engine/kk_camera.h"
 #include "engine/kk_log.h"
@@ -41,6 +43,9 @@ void kk_camera__construct(kk_camera_t* cam)
 
 	cam->rot_x = 0.0f;
 	cam->rot_y = 180.0f;
+
+	cam->aspect = 1.0f;
+	cam->dirty = TRUE;
 }
 
 //## public
@@ -75,6 +80,46 @@ Gets a view matrix for the current camera state.
 //	//glm_lookat(&cam->pos, look_at, &cam->up, output);
 //}
 
+//## public
+/**
+Gets the world space ray through a point on the screen, from the camera to
+the far plane. Used to pick what is under the mouse.
+
+@param cam The camera.
+@param x The x position in pixels, from the left.
+@param y The y position in pixels, from the top.
+@param width The width of the screen in pixels.
+@param height The height of the screen in pixels.
+@param out__ray The ray. Its direction is normalized.
+*/
+void kk_camera__get_ray(kk_camera_t* cam, float x, float y, float width, float height, kk_ray_t* out__ray)
+{
+	float tan_half = tanf(kk_math_rad(KK_CAMERA_FOV_Y) * 0.5f);
+	float ndc_x = 2.0f * x / width - 1.0f;
+	float ndc_y = 1.0f - 2.0f * y / height;
+	kk_vec3_t fwd;
+	kk_vec3_t right;
+	kk_vec3_t up;
+
+	/* Same basis as the look at view matrix */
+	kk_math_vec3_copy(&cam->dir, &fwd);
+	kk_math_vec3_normalize(&fwd);
+	kk_math_vec3_copy(&cam->right, &right);
+	kk_math_vec3_normalize(&right);
+	kk_math_cross(&right, &fwd, &up);
+
+	kk_math_vec3_scale(&right, ndc_x * tan_half * width / height, &right);
+	kk_math_vec3_scale(&up, ndc_y * tan_half, &up);
+
+	out__ray->origin = cam->pos;
+	kk_math_vec3_add(&fwd, &right, &out__ray->dir);
+	kk_math_vec3_add(&out__ray->dir, &up, &out__ray->dir);
+	kk_math_vec3_normalize(&out__ray->dir);
+
+	/* The far plane is KK_CAMERA_FAR along the view axis, so off-center rays are longer */
+	out__ray->max_t = KK_CAMERA_FAR / kk_math_vec3_dot(&out__ray->dir, &fwd);
+}
+
 //## public
 /**
 Moves the camera forward or backward on the current view vector.
@@ -89,6 +134,7 @@ void kk_camera__move(kk_camera_t* cam, float move_delta)
 
 	kk_math_vec3_scale(&delta_vector, move_delta, &delta_vector);
 	kk_math_vec3_add(&cam->pos, &delta_vector, &cam->pos);
+	cam->dirty = TRUE;
 }
 
 //## public
@@ -105,6 +151,7 @@ void kk_camera__pan(kk_camera_t* cam, float vert_delta, float horz_delta)
 
 	kk_math_vec3_scale(&cam->up, vert_delta, &temp_vert);
 	kk_math_vec3_add(&cam->pos, &temp_vert, &cam->pos);
+	cam->dirty = TRUE;
 }
 
 //## public
@@ -125,6 +172,7 @@ void kk_camera__rot_x(kk_camera_t* cam, float delta_x)
 
 	// Update cam right vector
 	kk_math_cross(&cam->dir, &cam->up, &cam->right);
+	cam->dirty = TRUE;
 }
 
 //## public
@@ -145,4 +193,67 @@ void kk_camera__rot_y(kk_camera_t* cam, float delta_y)
 
 	// Update cam right vector
 	kk_math_cross(&cam->dir, &cam->up, &cam->right);
+	cam->dirty = TRUE;
+}
+
+//## public
+/**
+Sets the aspect ratio of the view. Only marks the cache dirty if it changed.
+
+@param cam The camera.
+@param aspect Width over height.
+*/
+void kk_camera__set_aspect(kk_camera_t* cam, float aspect)
+{
+	if (cam->aspect != aspect)
+	{
+		cam->aspect = aspect;
+		cam->dirty = TRUE;
+	}
+}
+
+//## public
+/**
+Places the camera and marks the cache dirty. Use this instead of writing the
+pose fields directly, otherwise kk_camera__update keeps the old matrices.
+
+@param cam The camera.
+@param pos The camera position.
+@param dir The view direction. Does not need to be normalized.
+@param up The up vector.
+*/
+void kk_camera__set_pose(kk_camera_t* cam, const kk_vec3_t* pos, const kk_vec3_t* dir, const kk_vec3_t* up)
+{
+	cam->pos = *pos;
+	cam->dir = *dir;
+	cam->up = *up;
+
+	/* Keep the right vector in step for picking rays */
+	kk_math_cross(&cam->dir, &cam->up, &cam->right);
+	cam->dirty = TRUE;
+}
+
+//## public
+/**
+Rebuilds the cached matrices and frustum if the camera changed since the
+last update.
+
+@param cam The camera.
+*/
+void kk_camera__update(kk_camera_t* cam)
+{
+	kk_vec3_t look_at;
+
+	if (!cam->dirty)
+	{
+		return;
+	}
+
+	kk_math_vec3_add(&cam->pos, &cam->dir, &look_at);
+	kk_math_lookat(&cam->pos, &look_at, &cam->up, &cam->view);
+	kk_math_perspective(kk_math_rad(KK_CAMERA_FOV_Y), cam->aspect, KK_CAMERA_NEAR, KK_CAMERA_FAR, &cam->proj);
+	kk_math_mat4_mul(&cam->proj, &cam->view, &cam->view_proj);
+	kk_frustum__from_matrix(&cam->frustum, &cam->view_proj);
+
+	cam->dirty = FALSE;
 }
\ No newline at end of file
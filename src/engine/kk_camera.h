@@ -12,20 +12,50 @@ INCLUDES
 =========================================================*/
 
 #include "common.h"
+#include "engine/kk_frustum.h"
 #include "engine/kk_math.h"
 
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_CAMERA_FOV_Y		(45.0f)		/* Vertical field of view in degrees. */
+#define KK_CAMERA_FAR		(1000.0f)
+
+#ifdef JETZ_CONFIG_PLATFORM_PSP
+	#define KK_CAMERA_NEAR	(0.5f)		/* GU's 16-bit depth buffer needs a farther near plane. */
+#else
+	#define KK_CAMERA_NEAR	(0.1f)
+#endif
+
 /*=========================================================
 TYPES
 =========================================================*/
 
+/**
+Camera. The matrices and frustum are cached and only rebuilt by
+kk_camera__update after the camera changes, so every backend and the
+culling share one set per frame. Change the camera through its functions
+so the cache is marked dirty.
+*/
 struct kk_camera_s
 {
 	kk_vec3_t			dir;
 	kk_vec3_t			pos;
 	kk_vec3_t			up;
 	kk_vec3_t			right;
-	float				rot_x;	/* degrees rotation on x axis */
-	float				rot_y;	/* degrees rotation on y axis */
+	float				rot_x;		/* degrees rotation on x axis */
+	float				rot_y;		/* degrees rotation on y axis */
+	float				aspect;		/* Width over height of the view. */
+
+	/*
+	Cache
+	*/
+	kk_mat4_t			view;
+	kk_mat4_t			proj;		/* OpenGL clip space. Backends adjust it for their own conventions. */
+	kk_mat4_t			view_proj;
+	kk_frustum_t		frustum;	/* World space planes of view_proj. */
+	boolean				dirty;		/* The cache is out of date. */
 };
 
 /*=========================================================
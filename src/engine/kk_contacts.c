@@ -0,0 +1,985 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <math.h>
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_contacts.h"
+#include "engine/kk_log.h"
+#include "engine/kk_math.h"
+#include "engine/kk_narrowphase.h"
+#include "engine/kk_physics_bodies.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_static_model.h"
+
+#include "autogen/kk_contacts.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define NUM_ARRAYS		29		/* Number of float arrays in the point state. */
+#define COLLIDER_MASK	(ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_STATIC_MODEL) | ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM))
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty set of contacts.
+
+@param contacts The contacts to construct.
+*/
+void kk_contacts__construct(kk_contacts_t* contacts)
+{
+	clear_struct(contacts);
+	utl_array_init(&contacts->manifolds);
+	utl_array_init(&contacts->scratch);
+	utl_array_init(&contacts->free_slots);
+	utl_array_init(&contacts->body_map);
+}
+
+//## public
+/**
+Destructs a set of contacts.
+
+@param contacts The contacts to destruct.
+*/
+void kk_contacts__destruct(kk_contacts_t* contacts)
+{
+	utl_array_destroy(&contacts->manifolds);
+	utl_array_destroy(&contacts->scratch);
+	utl_array_destroy(&contacts->free_slots);
+	utl_array_destroy(&contacts->body_map);
+	free(contacts->data);
+	clear_struct(contacts);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Applies contact impulses to the bodies. Accumulated impulses from the last
+step are applied first, then every point is solved in turn for
+KK_CONTACTS_ITERATIONS passes. Impulses change the bodies' momentum and
+angular momentum directly. Velocity and spin are then refreshed so the next
+integration step uses the result.
+
+@param contacts The contacts. Must be updated for the current step.
+@param bodies The bodies the contacts were synced with.
+@param delta_time The step length in seconds.
+*/
+void kk_contacts__solve(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, float delta_time)
+{
+	kk_contact_manifold_t* m;
+	uint32_t i;
+	uint32_t k;
+	int iteration;
+
+	if (delta_time <= 0.0f)
+	{
+		return;
+	}
+
+	for (i = 0; i < contacts->manifolds.count; ++i)
+	{
+		m = &contacts->manifolds.data[i];
+		for (k = 0; k < m->num_points; ++k)
+		{
+			prepare_point(contacts, bodies, m, m->slot * KK_CONTACTS_MAX_POINTS + k, 1.0f / delta_time);
+		}
+	}
+
+	for (iteration = 0; iteration < KK_CONTACTS_ITERATIONS; ++iteration)
+	{
+		for (i = 0; i < contacts->manifolds.count; ++i)
+		{
+			m = &contacts->manifolds.data[i];
+			for (k = 0; k < m->num_points; ++k)
+			{
+				solve_point(contacts, bodies, m, m->slot * KK_CONTACTS_MAX_POINTS + k);
+			}
+		}
+	}
+
+	for (i = 0; i < contacts->manifolds.count; ++i)
+	{
+		m = &contacts->manifolds.data[i];
+		update_velocity(bodies, m->body_a);
+		update_velocity(bodies, m->body_b);
+	}
+}
+
+//## public
+/**
+Matches manifolds to the broadphase pairs. Manifolds for pairs that still
+exist keep their points, new pairs get an empty manifold and the rest are
+freed. Pairs without a body on either side are skipped. Call once per frame
+after gathering the bodies.
+
+@param contacts The contacts.
+@param ecs The ECS context the pairs refer to.
+@param bodies The bodies gathered for this frame.
+@param broadphase The broadphase with up to date pairs.
+*/
+void kk_contacts__sync(kk_contacts_t* contacts, ecs_t* ecs, kk_physics_bodies_t* bodies, kk_broadphase_t* broadphase)
+{
+	kk_contact_manifold_t* old = contacts->manifolds.data;
+	kk_broadphase_pair_t* pair;
+	kk_contact_manifold_t manifold;
+	utl_array_t(kk_contact_manifold_t) temp;
+	uint32_t num_old = contacts->manifolds.count;
+	uint32_t i;
+	uint32_t j;
+
+	build_body_map(contacts, bodies);
+	contacts->scratch.count = 0;
+
+	for (i = 0, j = 0; i < broadphase->pairs.count || j < num_old; )
+	{
+		/* Old manifold without a pair */
+		if (j < num_old && (i == broadphase->pairs.count || compare_key(&old[j], &broadphase->pairs.data[i]) < 0))
+		{
+			utl_array_push(&contacts->free_slots, old[j].slot);
+			++j;
+			continue;
+		}
+
+		pair = &broadphase->pairs.data[i++];
+
+		if (j < num_old && compare_key(&old[j], pair) == 0)
+		{
+			manifold = old[j++];
+		}
+		else
+		{
+			clear_struct(&manifold);
+			manifold.ent_a = pair->a;
+			manifold.ent_b = pair->b;
+			manifold.body_a = KK_CONTACTS_STATIC;
+			manifold.body_b = KK_CONTACTS_STATIC;
+			manifold.slot = alloc_slot(contacts);
+		}
+
+		if (!setup_manifold(contacts, ecs, bodies, &manifold))
+		{
+			utl_array_push(&contacts->free_slots, manifold.slot);
+			continue;
+		}
+
+		utl_array_push(&contacts->scratch, manifold);
+	}
+
+	temp = contacts->manifolds;
+	contacts->manifolds = contacts->scratch;
+	contacts->scratch = temp;
+}
+
+//## public
+/**
+Updates every manifold for the bodies' current pose.
+
+@param contacts The contacts.
+@param bodies The bodies the contacts were synced with.
+*/
+void kk_contacts__update(kk_contacts_t* contacts, kk_physics_bodies_t* bodies)
+{
+	kk_contacts__update_range(contacts, bodies, 0, contacts->manifolds.count);
+}
+
+//## public
+/**
+Updates a range of manifolds for the bodies' current pose. Points that
+separated or slid apart are dropped, then the shapes are tested and the
+new point is merged into the manifold. A new point close to an existing one
+replaces it and keeps its accumulated impulses. Ranges that do not overlap
+may be updated concurrently.
+
+@param contacts The contacts.
+@param bodies The bodies the contacts were synced with.
+@param start The first manifold to update.
+@param end One past the last manifold to update.
+*/
+void kk_contacts__update_range(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, uint32_t start, uint32_t end)
+{
+	kk_narrowphase_contact_t contact;
+	kk_contact_manifold_t* m;
+	uint32_t i;
+
+	for (i = start; i < end; ++i)
+	{
+		m = &contacts->manifolds.data[i];
+
+		if (m->body_a != KK_CONTACTS_STATIC)
+		{
+			build_body_matrix(bodies, m->body_a, &m->scale_a, &m->world_a);
+		}
+
+		if (m->body_b != KK_CONTACTS_STATIC)
+		{
+			build_body_matrix(bodies, m->body_b, &m->scale_b, &m->world_b);
+		}
+
+		refresh_points(contacts, bodies, m);
+
+		if (kk_narrowphase__collide(m->shape_a, &m->world_a, m->shape_b, &m->world_b, &contact))
+		{
+			add_point(contacts, bodies, m, &contact);
+		}
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Merges a new contact into a manifold.
+*/
+static void add_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, kk_narrowphase_contact_t* contact)
+{
+	uint32_t base = m->slot * KK_CONTACTS_MAX_POINTS;
+	kk_vec3_t la;
+	kk_vec3_t lb;
+	kk_vec3_t d;
+	float best_dist;
+	uint32_t best;
+	uint32_t idx;
+	uint32_t k;
+
+	to_local(bodies, m->body_a, &contact->point_a, &la);
+	to_local(bodies, m->body_b, &contact->point_b, &lb);
+
+	/* Reuse the nearest point so its impulses carry over */
+	best = KK_CONTACTS_MAX_POINTS;
+	best_dist = KK_CONTACTS_BREAKING_DIST * KK_CONTACTS_BREAKING_DIST;
+
+	for (k = 0; k < m->num_points; ++k)
+	{
+		get_point(contacts->local_a, base + k, &d);
+		kk_math_vec3_sub(&la, &d, &d);
+		if (kk_math_vec3_dot(&d, &d) < best_dist)
+		{
+			best_dist = kk_math_vec3_dot(&d, &d);
+			best = k;
+		}
+	}
+
+	if (best == KK_CONTACTS_MAX_POINTS)
+	{
+		best = (m->num_points < KK_CONTACTS_MAX_POINTS) ? m->num_points++ : get_replace_index(contacts, m, &la, contact->depth);
+
+		idx = base + best;
+		contacts->normal_impulse[idx] = 0.0f;
+		contacts->tangent_impulse[0][idx] = 0.0f;
+		contacts->tangent_impulse[1][idx] = 0.0f;
+	}
+
+	idx = base + best;
+	set_point(contacts->local_a, idx, &la);
+	set_point(contacts->local_b, idx, &lb);
+	set_point(contacts->normal, idx, &contact->normal);
+	contacts->depth[idx] = contact->depth;
+}
+
+//## static
+/**
+Gets a free manifold slot, growing the point arrays if needed.
+*/
+static uint32_t alloc_slot(kk_contacts_t* contacts)
+{
+	if (contacts->free_slots.count == 0)
+	{
+		grow(contacts, contacts->num_slots ? contacts->num_slots * 2 : 16);
+	}
+
+	return contacts->free_slots.data[--contacts->free_slots.count];
+}
+
+//## static
+/**
+Applies an impulse to a body at an offset from its center.
+*/
+static void apply_impulse(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* r, kk_vec3_t* impulse)
+{
+	kk_vec3_t torque;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		return;
+	}
+
+	kk_math_cross(r, impulse, &torque);
+
+	bodies->momentum[0][body] += impulse->x;
+	bodies->momentum[1][body] += impulse->y;
+	bodies->momentum[2][body] += impulse->z;
+
+	bodies->angular_momentum[0][body] += torque.x;
+	bodies->angular_momentum[1][body] += torque.y;
+	bodies->angular_momentum[2][body] += torque.z;
+}
+
+//## static
+/**
+Maps each gathered body's entity id to its index.
+*/
+static void build_body_map(kk_contacts_t* contacts, kk_physics_bodies_t* bodies)
+{
+	uint32_t needed = 0;
+	uint32_t i;
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		needed = max(needed, bodies->entities[i] + 1);
+	}
+
+	if (needed > contacts->body_map.count)
+	{
+		utl_array_resize(&contacts->body_map, needed);
+	}
+
+	for (i = 0; i < contacts->body_map.count; ++i)
+	{
+		contacts->body_map.data[i] = KK_CONTACTS_STATIC;
+	}
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		contacts->body_map.data[bodies->entities[i]] = i;
+	}
+}
+
+//## static
+/**
+Builds a body's shape matrix from its current pose. Matches
+ecs_transform__get_local_matrix.
+*/
+static void build_body_matrix(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* scale, kk_mat4_t* out__m)
+{
+	kk_mat4_t* m = out__m;
+	kk_vec4_t rot;
+
+	rot.x = bodies->rot[0][body];
+	rot.y = bodies->rot[1][body];
+	rot.z = bodies->rot[2][body];
+	rot.w = bodies->rot[3][body];
+
+	kk_math_quat_mat4(&rot, m);
+
+	m->x.x *= scale->x;	m->y.x *= scale->x;	m->z.x *= scale->x;
+	m->x.y *= scale->y;	m->y.y *= scale->y;	m->z.y *= scale->y;
+	m->x.z *= scale->z;	m->y.z *= scale->z;	m->z.z *= scale->z;
+
+	m->w.x = bodies->pos[0][body];
+	m->w.y = bodies->pos[1][body];
+	m->w.z = bodies->pos[2][body];
+	m->w.w = 1.0f;
+}
+
+//## static
+/**
+Orders a manifold against a broadphase pair.
+*/
+static int compare_key(kk_contact_manifold_t* m, kk_broadphase_pair_t* pair)
+{
+	if (m->ent_a != pair->a)
+	{
+		return (m->ent_a < pair->a) ? -1 : 1;
+	}
+
+	if (m->ent_b != pair->b)
+	{
+		return (m->ent_b < pair->b) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+//## static
+/**
+Copies the persistent state of one point to another.
+*/
+static void copy_point(kk_contacts_t* contacts, uint32_t dst, uint32_t src)
+{
+	int a;
+
+	for (a = 0; a < 3; ++a)
+	{
+		contacts->local_a[a][dst] = contacts->local_a[a][src];
+		contacts->local_b[a][dst] = contacts->local_b[a][src];
+		contacts->normal[a][dst] = contacts->normal[a][src];
+	}
+
+	contacts->depth[dst] = contacts->depth[src];
+	contacts->normal_impulse[dst] = contacts->normal_impulse[src];
+	contacts->tangent_impulse[0][dst] = contacts->tangent_impulse[0][src];
+	contacts->tangent_impulse[1][dst] = contacts->tangent_impulse[1][src];
+}
+
+//## static
+/**
+Gets the body index of an entity.
+*/
+static uint32_t get_body(kk_contacts_t* contacts, entity_id_t ent)
+{
+	return (ent < contacts->body_map.count) ? contacts->body_map.data[ent] : KK_CONTACTS_STATIC;
+}
+
+//## static
+/**
+Gets the center of mass of a body. Static sides use the origin.
+*/
+static void get_center(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* out__center)
+{
+	if (body == KK_CONTACTS_STATIC)
+	{
+		clear_struct(out__center);
+		return;
+	}
+
+	out__center->x = bodies->pos[0][body];
+	out__center->y = bodies->pos[1][body];
+	out__center->z = bodies->pos[2][body];
+}
+
+//## static
+/**
+Gets the effective mass of a pair of bodies along a direction at a contact.
+*/
+static float get_effective_mass(kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, kk_vec3_t* r_a, kk_vec3_t* r_b, kk_vec3_t* dir)
+{
+	kk_vec3_t c;
+	float k = 0.0f;
+
+	if (m->body_a != KK_CONTACTS_STATIC)
+	{
+		kk_math_cross(r_a, dir, &c);
+		k += bodies->inverse_mass[m->body_a] + bodies->inverse_inertia[m->body_a] * kk_math_vec3_dot(&c, &c);
+	}
+
+	if (m->body_b != KK_CONTACTS_STATIC)
+	{
+		kk_math_cross(r_b, dir, &c);
+		k += bodies->inverse_mass[m->body_b] + bodies->inverse_inertia[m->body_b] * kk_math_vec3_dot(&c, &c);
+	}
+
+	return (k > 0.0f) ? (1.0f / k) : 0.0f;
+}
+
+//## static
+/**
+Reads a vector from a set of component arrays.
+*/
+static void get_point(float** arrays, uint32_t idx, kk_vec3_t* out__v)
+{
+	out__v->x = arrays[0][idx];
+	out__v->y = arrays[1][idx];
+	out__v->z = arrays[2][idx];
+}
+
+//## static
+/**
+Gets the velocity of a point on a body.
+*/
+static void get_point_velocity(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* r, kk_vec3_t* out__vel)
+{
+	kk_vec3_t w;
+	kk_vec3_t temp;
+	float inv_mass;
+	float inv_inertia;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		clear_struct(out__vel);
+		return;
+	}
+
+	inv_mass = bodies->inverse_mass[body];
+	inv_inertia = bodies->inverse_inertia[body];
+
+	w.x = bodies->angular_momentum[0][body] * inv_inertia;
+	w.y = bodies->angular_momentum[1][body] * inv_inertia;
+	w.z = bodies->angular_momentum[2][body] * inv_inertia;
+	kk_math_cross(&w, r, &temp);
+
+	out__vel->x = bodies->momentum[0][body] * inv_mass + temp.x;
+	out__vel->y = bodies->momentum[1][body] * inv_mass + temp.y;
+	out__vel->z = bodies->momentum[2][body] * inv_mass + temp.z;
+}
+
+//## static
+/**
+Picks the point to replace in a full manifold. Keeps the deepest point and
+maximizes the area of the remaining four.
+*/
+static uint32_t get_replace_index(kk_contacts_t* contacts, kk_contact_manifold_t* m, kk_vec3_t* new_point, float new_depth)
+{
+	uint32_t base = m->slot * KK_CONTACTS_MAX_POINTS;
+	kk_vec3_t p[KK_CONTACTS_MAX_POINTS];
+	kk_vec3_t e1;
+	kk_vec3_t e2;
+	kk_vec3_t c;
+	uint32_t deepest = KK_CONTACTS_MAX_POINTS;
+	uint32_t best = 0;
+	float max_depth = new_depth;
+	float best_area = -1.0f;
+	float area;
+	uint32_t k;
+
+	for (k = 0; k < KK_CONTACTS_MAX_POINTS; ++k)
+	{
+		get_point(contacts->local_a, base + k, &p[k]);
+		if (contacts->depth[base + k] > max_depth)
+		{
+			max_depth = contacts->depth[base + k];
+			deepest = k;
+		}
+	}
+
+	for (k = 0; k < KK_CONTACTS_MAX_POINTS; ++k)
+	{
+		if (k == deepest)
+		{
+			continue;
+		}
+
+		/* Diagonals of the quad with point k replaced */
+		switch (k)
+		{
+		case 0:  kk_math_vec3_sub(new_point, &p[1], &e1); kk_math_vec3_sub(&p[3], &p[2], &e2); break;
+		case 1:  kk_math_vec3_sub(new_point, &p[0], &e1); kk_math_vec3_sub(&p[3], &p[2], &e2); break;
+		case 2:  kk_math_vec3_sub(new_point, &p[0], &e1); kk_math_vec3_sub(&p[3], &p[1], &e2); break;
+		default: kk_math_vec3_sub(new_point, &p[0], &e1); kk_math_vec3_sub(&p[2], &p[1], &e2); break;
+		}
+
+		kk_math_cross(&e1, &e2, &c);
+		area = kk_math_vec3_dot(&c, &c);
+		if (area > best_area)
+		{
+			best_area = area;
+			best = k;
+		}
+	}
+
+	return best;
+}
+
+//## static
+/**
+Builds an orthonormal tangent basis for a normal.
+*/
+static void get_tangents(kk_vec3_t* n, kk_vec3_t* out__t1, kk_vec3_t* out__t2)
+{
+	if (fabsf(n->x) >= 0.57735f)
+	{
+		out__t1->x = n->y;
+		out__t1->y = -n->x;
+		out__t1->z = 0.0f;
+	}
+	else
+	{
+		out__t1->x = 0.0f;
+		out__t1->y = n->z;
+		out__t1->z = -n->y;
+	}
+
+	kk_math_vec3_normalize(out__t1);
+	kk_math_cross(n, out__t1, out__t2);
+}
+
+//## static
+/**
+Grows the point arrays to hold more manifold slots. Existing points are kept.
+*/
+static void grow(kk_contacts_t* contacts, uint32_t num_slots)
+{
+	uint32_t old_capacity = contacts->num_slots * KK_CONTACTS_MAX_POINTS;
+	uint32_t capacity = num_slots * KK_CONTACTS_MAX_POINTS;
+	float* data;
+	float* base;
+	int a;
+
+	data = (float*)calloc((size_t)capacity * NUM_ARRAYS, sizeof(float));
+	if (!data)
+	{
+		kk_log__fatal("Failed to allocate contact points.");
+	}
+
+	/* Every array is a contiguous block, so copy block by block */
+	for (a = 0; a < NUM_ARRAYS; ++a)
+	{
+		if (old_capacity)
+		{
+			memcpy(data + (size_t)a * capacity, contacts->data + (size_t)a * old_capacity, sizeof(float) * old_capacity);
+		}
+	}
+
+	free(contacts->data);
+	contacts->data = data;
+
+	/* Carve the arrays out of the single allocation */
+	base = data;
+	for (a = 0; a < 3; ++a) { contacts->local_a[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->local_b[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->normal[a] = base; base += capacity; }
+	contacts->depth = base; base += capacity;
+	contacts->normal_impulse = base; base += capacity;
+	for (a = 0; a < 2; ++a) { contacts->tangent_impulse[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->r_a[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->r_b[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->tangent[0][a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { contacts->tangent[1][a] = base; base += capacity; }
+	contacts->normal_mass = base; base += capacity;
+	for (a = 0; a < 2; ++a) { contacts->tangent_mass[a] = base; base += capacity; }
+	contacts->bias = base;
+
+	/* Hand out low slots first */
+	for (a = (int)num_slots - 1; a >= (int)contacts->num_slots; --a)
+	{
+		utl_array_push(&contacts->free_slots, (uint32_t)a);
+	}
+
+	contacts->num_slots = num_slots;
+}
+
+//## static
+/**
+Computes the per-step state of a point and applies its accumulated impulses.
+*/
+static void prepare_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, uint32_t idx, float inv_dt)
+{
+	kk_vec3_t pa, pb, p;
+	kk_vec3_t center;
+	kk_vec3_t r_a, r_b;
+	kk_vec3_t n, t1, t2;
+	kk_vec3_t impulse;
+	kk_vec3_t temp;
+	float depth = contacts->depth[idx];
+
+	get_point(contacts->local_a, idx, &pa);
+	get_point(contacts->local_b, idx, &pb);
+	to_world(bodies, m->body_a, &pa, &pa);
+	to_world(bodies, m->body_b, &pb, &pb);
+
+	/* Both bodies push on the point midway between their surfaces */
+	kk_math_vec3_add(&pa, &pb, &p);
+	kk_math_vec3_scale(&p, 0.5f, &p);
+
+	get_center(bodies, m->body_a, &center);
+	kk_math_vec3_sub(&p, &center, &r_a);
+	get_center(bodies, m->body_b, &center);
+	kk_math_vec3_sub(&p, &center, &r_b);
+
+	get_point(contacts->normal, idx, &n);
+	get_tangents(&n, &t1, &t2);
+
+	set_point(contacts->r_a, idx, &r_a);
+	set_point(contacts->r_b, idx, &r_b);
+	set_point(contacts->tangent[0], idx, &t1);
+	set_point(contacts->tangent[1], idx, &t2);
+
+	contacts->normal_mass[idx] = get_effective_mass(bodies, m, &r_a, &r_b, &n);
+	contacts->tangent_mass[0][idx] = get_effective_mass(bodies, m, &r_a, &r_b, &t1);
+	contacts->tangent_mass[1][idx] = get_effective_mass(bodies, m, &r_a, &r_b, &t2);
+
+	/* Push out part of the penetration, or let separated points close the gap this step */
+	contacts->bias[idx] = (depth > 0.0f) ? KK_CONTACTS_BAUMGARTE * inv_dt * max(depth - KK_CONTACTS_SLOP, 0.0f) : depth * inv_dt;
+
+	/* Warm start */
+	kk_math_vec3_scale(&n, contacts->normal_impulse[idx], &impulse);
+	kk_math_vec3_scale(&t1, contacts->tangent_impulse[0][idx], &temp);
+	kk_math_vec3_add(&impulse, &temp, &impulse);
+	kk_math_vec3_scale(&t2, contacts->tangent_impulse[1][idx], &temp);
+	kk_math_vec3_add(&impulse, &temp, &impulse);
+
+	apply_impulse(bodies, m->body_b, &r_b, &impulse);
+	kk_math_vec3_scale(&impulse, -1.0f, &impulse);
+	apply_impulse(bodies, m->body_a, &r_a, &impulse);
+}
+
+//## static
+/**
+Drops points that have separated or slid apart and updates the depth of
+the rest.
+*/
+static void refresh_points(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m)
+{
+	uint32_t base = m->slot * KK_CONTACTS_MAX_POINTS;
+	kk_vec3_t pa;
+	kk_vec3_t pb;
+	kk_vec3_t n;
+	kk_vec3_t d;
+	kk_vec3_t slide;
+	float depth;
+	uint32_t k;
+
+	for (k = 0; k < m->num_points; )
+	{
+		get_point(contacts->local_a, base + k, &pa);
+		get_point(contacts->local_b, base + k, &pb);
+		get_point(contacts->normal, base + k, &n);
+		to_world(bodies, m->body_a, &pa, &pa);
+		to_world(bodies, m->body_b, &pb, &pb);
+
+		kk_math_vec3_sub(&pa, &pb, &d);
+		depth = kk_math_vec3_dot(&d, &n);
+
+		kk_math_vec3_scale(&n, depth, &slide);
+		kk_math_vec3_sub(&d, &slide, &slide);
+
+		if (depth < -KK_CONTACTS_BREAKING_DIST
+		 || kk_math_vec3_dot(&slide, &slide) > KK_CONTACTS_BREAKING_DIST * KK_CONTACTS_BREAKING_DIST)
+		{
+			copy_point(contacts, base + k, base + m->num_points - 1);
+			m->num_points--;
+			continue;
+		}
+
+		contacts->depth[base + k] = depth;
+		++k;
+	}
+}
+
+//## static
+/**
+Rotates a vector by a body's orientation, or its inverse.
+*/
+static void rotate(kk_physics_bodies_t* bodies, uint32_t body, float sign, kk_vec3_t* v, kk_vec3_t* out__v)
+{
+	kk_vec3_t q;
+	kk_vec3_t t;
+	kk_vec3_t u;
+	float w = bodies->rot[3][body];
+
+	q.x = sign * bodies->rot[0][body];
+	q.y = sign * bodies->rot[1][body];
+	q.z = sign * bodies->rot[2][body];
+
+	/* v + 2w(q x v) + 2q x (q x v) */
+	kk_math_cross(&q, v, &t);
+	kk_math_vec3_scale(&t, 2.0f, &t);
+	kk_math_cross(&q, &t, &u);
+	kk_math_vec3_scale(&t, w, &t);
+
+	kk_math_vec3_add(v, &t, out__v);
+	kk_math_vec3_add(out__v, &u, out__v);
+}
+
+//## static
+/**
+Writes a vector to a set of component arrays.
+*/
+static void set_point(float** arrays, uint32_t idx, kk_vec3_t* v)
+{
+	arrays[0][idx] = v->x;
+	arrays[1][idx] = v->y;
+	arrays[2][idx] = v->z;
+}
+
+//## static
+/**
+Fills in the bodies, shapes and static matrices of a manifold. Returns FALSE
+if the pair is no longer valid.
+*/
+static boolean setup_manifold(kk_contacts_t* contacts, ecs_t* ecs, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m)
+{
+	uint32_t body_a = get_body(contacts, m->ent_a);
+	uint32_t body_b = get_body(contacts, m->ent_b);
+
+	if (body_a == KK_CONTACTS_STATIC && body_b == KK_CONTACTS_STATIC)
+	{
+		return FALSE;
+	}
+
+	/* Anchors on a side that switched between static and dynamic are in the wrong frame */
+	if ((body_a == KK_CONTACTS_STATIC) != (m->body_a == KK_CONTACTS_STATIC)
+	 || (body_b == KK_CONTACTS_STATIC) != (m->body_b == KK_CONTACTS_STATIC))
+	{
+		m->num_points = 0;
+	}
+
+	m->body_a = body_a;
+	m->body_b = body_b;
+
+	return setup_side(ecs, m->ent_a, body_a, &m->shape_a, &m->scale_a, &m->world_a)
+		&& setup_side(ecs, m->ent_b, body_b, &m->shape_b, &m->scale_b, &m->world_b);
+}
+
+//## static
+/**
+Gets the shape of one side of a pair, and either its scale or its world
+matrix if it is static.
+*/
+static boolean setup_side(ecs_t* ecs, entity_id_t ent, uint32_t body, kk_shape_t** out__shape, kk_vec3_t* out__scale, kk_mat4_t* out__world)
+{
+	ecs_static_model_t* sm;
+	ecs_transform_t* transform;
+
+	if ((ecs__get_signature(ecs, ent) & COLLIDER_MASK) != COLLIDER_MASK)
+	{
+		return FALSE;
+	}
+
+	sm = ecs_static_model__get(ecs, ent);
+	if (!sm->model)
+	{
+		return FALSE;
+	}
+
+	transform = ecs_transform__get(ecs, ent);
+	*out__shape = &sm->model->shape;
+	*out__scale = transform->scale;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		ecs_transform__get_world_matrix(ecs, transform, out__world);
+	}
+
+	return TRUE;
+}
+
+//## static
+/**
+Solves friction and then non-penetration for one point.
+*/
+static void solve_point(kk_contacts_t* contacts, kk_physics_bodies_t* bodies, kk_contact_manifold_t* m, uint32_t idx)
+{
+	kk_vec3_t r_a, r_b;
+	kk_vec3_t n, t;
+	kk_vec3_t va, vb, dv;
+	kk_vec3_t impulse;
+	float lambda;
+	float limit;
+	float old;
+	int a;
+
+	get_point(contacts->r_a, idx, &r_a);
+	get_point(contacts->r_b, idx, &r_b);
+
+	/* Friction, bounded by the normal impulse */
+	limit = KK_CONTACTS_FRICTION * contacts->normal_impulse[idx];
+
+	for (a = 0; a < 2; ++a)
+	{
+		get_point(contacts->tangent[a], idx, &t);
+		get_point_velocity(bodies, m->body_a, &r_a, &va);
+		get_point_velocity(bodies, m->body_b, &r_b, &vb);
+		kk_math_vec3_sub(&vb, &va, &dv);
+
+		lambda = -contacts->tangent_mass[a][idx] * kk_math_vec3_dot(&dv, &t);
+		old = contacts->tangent_impulse[a][idx];
+		contacts->tangent_impulse[a][idx] = max(-limit, min(limit, old + lambda));
+		lambda = contacts->tangent_impulse[a][idx] - old;
+
+		kk_math_vec3_scale(&t, lambda, &impulse);
+		apply_impulse(bodies, m->body_b, &r_b, &impulse);
+		kk_math_vec3_scale(&impulse, -1.0f, &impulse);
+		apply_impulse(bodies, m->body_a, &r_a, &impulse);
+	}
+
+	/* Non-penetration, only ever pushes */
+	get_point(contacts->normal, idx, &n);
+	get_point_velocity(bodies, m->body_a, &r_a, &va);
+	get_point_velocity(bodies, m->body_b, &r_b, &vb);
+	kk_math_vec3_sub(&vb, &va, &dv);
+
+	lambda = contacts->normal_mass[idx] * (contacts->bias[idx] - kk_math_vec3_dot(&dv, &n));
+	old = contacts->normal_impulse[idx];
+	contacts->normal_impulse[idx] = max(old + lambda, 0.0f);
+	lambda = contacts->normal_impulse[idx] - old;
+
+	kk_math_vec3_scale(&n, lambda, &impulse);
+	apply_impulse(bodies, m->body_b, &r_b, &impulse);
+	kk_math_vec3_scale(&impulse, -1.0f, &impulse);
+	apply_impulse(bodies, m->body_a, &r_a, &impulse);
+}
+
+//## static
+/**
+Takes a world point into a body's frame. Static sides stay in world space.
+*/
+static void to_local(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* p, kk_vec3_t* out__p)
+{
+	kk_vec3_t center;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		*out__p = *p;
+		return;
+	}
+
+	get_center(bodies, body, &center);
+	kk_math_vec3_sub(p, &center, out__p);
+	rotate(bodies, body, -1.0f, out__p, out__p);
+}
+
+//## static
+/**
+Takes a point in a body's frame to world space.
+*/
+static void to_world(kk_physics_bodies_t* bodies, uint32_t body, kk_vec3_t* p, kk_vec3_t* out__p)
+{
+	kk_vec3_t center;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		*out__p = *p;
+		return;
+	}
+
+	get_center(bodies, body, &center);
+	rotate(bodies, body, 1.0f, p, out__p);
+	kk_math_vec3_add(out__p, &center, out__p);
+}
+
+//## static
+/**
+Refreshes a body's velocity, angular velocity and spin from its momentum.
+*/
+static void update_velocity(kk_physics_bodies_t* bodies, uint32_t body)
+{
+	float qx, qy, qz, qw;
+	float wx, wy, wz;
+	int a;
+
+	if (body == KK_CONTACTS_STATIC)
+	{
+		return;
+	}
+
+	for (a = 0; a < 3; ++a)
+	{
+		bodies->velocity[a][body] = bodies->momentum[a][body] * bodies->inverse_mass[body];
+		bodies->angular_velocity[a][body] = bodies->angular_momentum[a][body] * bodies->inverse_inertia[body];
+	}
+
+	qx = bodies->rot[0][body];
+	qy = bodies->rot[1][body];
+	qz = bodies->rot[2][body];
+	qw = bodies->rot[3][body];
+	wx = bodies->angular_velocity[0][body];
+	wy = bodies->angular_velocity[1][body];
+	wz = bodies->angular_velocity[2][body];
+
+	// spin = 0.5 * (w * q), w = (wx, wy, wz, 0)
+	bodies->spin[0][body] = 0.5f * (wx * qw + wy * qz - wz * qy);
+	bodies->spin[1][body] = 0.5f * (-wx * qz + wy * qw + wz * qx);
+	bodies->spin[2][body] = 0.5f * (wx * qy - wy * qx + wz * qw);
+	bodies->spin[3][body] = 0.5f * (-wx * qx - wy * qy - wz * qz);
+}
\ No newline at end of file
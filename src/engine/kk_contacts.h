@@ -0,0 +1,110 @@
+#ifndef KK_CONTACTS_H
+#define KK_CONTACTS_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "engine/kk_broadphase_.h"
+#include "engine/kk_contacts_.h"
+#include "engine/kk_physics_bodies_.h"
+#include "engine/kk_shape_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_CONTACTS_MAX_POINTS		(4)				/* Points per manifold. Each manifold owns this many slots. */
+#define KK_CONTACTS_STATIC			(0xFFFFFFFF)	/* Body index of a collider without physics. */
+#define KK_CONTACTS_ITERATIONS		(4)				/* Velocity iterations per step. Warm starting makes a few enough. */
+#define KK_CONTACTS_BREAKING_DIST	(0.02f)			/* Points that separate or slide further than this are dropped. */
+#define KK_CONTACTS_SLOP			(0.005f)		/* Penetration left uncorrected to keep resting contacts stable. */
+#define KK_CONTACTS_BAUMGARTE		(0.2f)			/* Fraction of the remaining penetration corrected each step. */
+#define KK_CONTACTS_FRICTION		(0.5f)			/* Friction coefficient. There are no materials yet. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Contact points between one pair of colliders. Point data lives in the
+structure-of-arrays slots starting at slot * KK_CONTACTS_MAX_POINTS.
+*/
+typedef struct
+{
+	entity_id_t				ent_a;			/* Pair key. ent_a < ent_b. */
+	entity_id_t				ent_b;
+	uint32_t				body_a;			/* Index in the physics bodies, or KK_CONTACTS_STATIC. */
+	uint32_t				body_b;
+	kk_shape_t*				shape_a;
+	kk_shape_t*				shape_b;
+	kk_vec3_t				scale_a;		/* Transform scale of dynamic sides. */
+	kk_vec3_t				scale_b;
+	kk_mat4_t				world_a;		/* Shape to world matrix. Static sides are set once per frame. */
+	kk_mat4_t				world_b;
+	uint32_t				slot;
+	uint32_t				num_points;
+
+} kk_contact_manifold_t;
+
+utl_array_declare_type(kk_contact_manifold_t);
+
+/**
+Persistent contact manifolds and a sequential impulse solver. Manifolds are
+matched to broadphase pairs each frame and keep their points, including the
+accumulated impulses used to warm start the solver, for as long as the pair
+stays in contact.
+
+Point state is stored as structure-of-arrays in fixed slots of
+KK_CONTACTS_MAX_POINTS, so a manifold's points fill one SIMD register per
+value. Slots don't move when manifolds come and go.
+*/
+struct kk_contacts_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(kk_contact_manifold_t)	manifolds;		/* Sorted by pair. */
+	utl_array_t(kk_contact_manifold_t)	scratch;		/* Next manifold list while syncing. */
+	utl_array_t(uint32_t)				free_slots;
+	utl_array_t(uint32_t)				body_map;		/* Body index for each entity id. */
+	float*								data;			/* Single allocation that holds every point array. */
+	uint32_t							num_slots;		/* Number of manifold slots the arrays can hold. */
+
+	/*
+	Point state, persists between frames
+	*/
+	float*					local_a[3];			/* Anchor on A in its body frame. World space for a static side. */
+	float*					local_b[3];
+	float*					normal[3];			/* World space, from A to B. */
+	float*					depth;				/* Penetration. Negative while separated. */
+	float*					normal_impulse;		/* Accumulated impulses. */
+	float*					tangent_impulse[2];
+
+	/*
+	Point state, rebuilt each step
+	*/
+	float*					r_a[3];				/* Contact point relative to each body's center. */
+	float*					r_b[3];
+	float*					tangent[2][3];
+	float*					normal_mass;
+	float*					tangent_mass[2];
+	float*					bias;				/* Target normal velocity. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_contacts.public.h"
+
+#endif /* KK_CONTACTS_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef KK_CONTACTS__H
+#define KK_CONTACTS__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_contacts_s kk_contacts_t;
+
+#endif /* KK_CONTACTS__H */
\ No newline at end of file
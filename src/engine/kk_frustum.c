@@ -0,0 +1,229 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <math.h>
+
+#include "common.h"
+#include "engine/kk_frustum.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+SIMD
+=========================================================*/
+
+/*
+Thin wrappers over the intrinsics picked up by cglm's simd/intrin.h.
+simd_inside gives a bit per lane that is not negative.
+*/
+
+#if defined(CGLM_AVX_FP)
+	typedef __m256 simd_t;
+	#define simd_load(p)			_mm256_loadu_ps(p)
+	#define simd_set1(s)			_mm256_set1_ps(s)
+	#define simd_add(a, b)			_mm256_add_ps(a, b)
+	#define simd_mul(a, b)			_mm256_mul_ps(a, b)
+	#define simd_min(a, b)			_mm256_min_ps(a, b)
+	#define simd_inside(a)			_mm256_movemask_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ))
+#elif defined(CGLM_SSE_FP)
+	typedef __m128 simd_t;
+	#define simd_load(p)			_mm_loadu_ps(p)
+	#define simd_set1(s)			_mm_set1_ps(s)
+	#define simd_add(a, b)			_mm_add_ps(a, b)
+	#define simd_mul(a, b)			_mm_mul_ps(a, b)
+	#define simd_min(a, b)			_mm_min_ps(a, b)
+	#define simd_inside(a)			_mm_movemask_ps(_mm_cmpge_ps(a, _mm_setzero_ps()))
+#elif defined(CGLM_NEON_FP)
+	typedef float32x4_t simd_t;
+	#define simd_load(p)			vld1q_f32(p)
+	#define simd_set1(s)			vdupq_n_f32(s)
+	#define simd_add(a, b)			vaddq_f32(a, b)
+	#define simd_mul(a, b)			vmulq_f32(a, b)
+	#define simd_min(a, b)			vminq_f32(a, b)
+	#define simd_inside(a)			neon_inside(a)
+
+	/* NEON has no movemask, so gather a bit from each lane */
+	static inline int neon_inside(float32x4_t a)
+	{
+		uint32x4_t m = vcgeq_f32(a, vdupq_n_f32(0.0f));
+		return (int)((vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2)
+			| (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8));
+	}
+#endif
+
+#include "autogen/kk_frustum.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Culls a batch of spheres stored as separate arrays. Groups of
+KK_FRUSTUM_WIDTH spheres are tested with SIMD and any remainder one at a
+time. Gives the same results as kk_frustum__test_sphere.
+
+@param f The frustum.
+@param x The sphere centers' x components.
+@param y The sphere centers' y components.
+@param z The sphere centers' z components.
+@param r The sphere radii.
+@param count The number of spheres.
+@param out__visible Filled with the indices of the spheres that may be visible, in order. Must hold count indices.
+@return The number of spheres that may be visible.
+*/
+uint32_t kk_frustum__cull_spheres
+	(
+	kk_frustum_t*			f,
+	const float*			x,
+	const float*			y,
+	const float*			z,
+	const float*			r,
+	uint32_t				count,
+	uint32_t*				out__visible
+	)
+{
+	uint32_t num_visible = 0;
+	uint32_t i = 0;
+	kk_sphere_t sphere;
+
+#if KK_FRUSTUM_WIDTH > 1
+	simd_t px[KK_FRUSTUM_PLANE_COUNT];
+	simd_t py[KK_FRUSTUM_PLANE_COUNT];
+	simd_t pz[KK_FRUSTUM_PLANE_COUNT];
+	simd_t pw[KK_FRUSTUM_PLANE_COUNT];
+	simd_t cx, cy, cz, cr, d, dmin;
+	int mask;
+	int j;
+
+	for (j = 0; j < KK_FRUSTUM_PLANE_COUNT; ++j)
+	{
+		px[j] = simd_set1(f->planes[j].x);
+		py[j] = simd_set1(f->planes[j].y);
+		pz[j] = simd_set1(f->planes[j].z);
+		pw[j] = simd_set1(f->planes[j].w);
+	}
+
+	for (; i + KK_FRUSTUM_WIDTH <= count; i += KK_FRUSTUM_WIDTH)
+	{
+		cx = simd_load(&x[i]);
+		cy = simd_load(&y[i]);
+		cz = simd_load(&z[i]);
+		cr = simd_load(&r[i]);
+
+		/* Smallest signed distance to any plane, pushed out by the radius */
+		dmin = simd_add(simd_add(simd_mul(px[0], cx), simd_mul(py[0], cy)), simd_add(simd_mul(pz[0], cz), pw[0]));
+		for (j = 1; j < KK_FRUSTUM_PLANE_COUNT; ++j)
+		{
+			d = simd_add(simd_add(simd_mul(px[j], cx), simd_mul(py[j], cy)), simd_add(simd_mul(pz[j], cz), pw[j]));
+			dmin = simd_min(dmin, d);
+		}
+
+		mask = simd_inside(simd_add(dmin, cr));
+		for (j = 0; mask; ++j, mask >>= 1)
+		{
+			if (mask & 1)
+			{
+				out__visible[num_visible++] = i + j;
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		sphere.center.x = x[i];
+		sphere.center.y = y[i];
+		sphere.center.z = z[i];
+		sphere.radius = r[i];
+
+		if (kk_frustum__test_sphere(f, &sphere))
+		{
+			out__visible[num_visible++] = i;
+		}
+	}
+
+	return num_visible;
+}
+
+//## public
+/**
+Extracts the planes from a view projection matrix. The planes are in the
+space the matrix transforms from, so a view projection matrix gives world
+space planes. Clip depth is taken as -w to w, which also holds every point
+of a 0 to w projection.
+
+@param f The frustum to set.
+@param m The view projection matrix.
+*/
+void kk_frustum__from_matrix(kk_frustum_t* f, kk_mat4_t* m)
+{
+	kk_vec4_t* p;
+	float len;
+	int i;
+
+	for (i = 0; i < KK_FRUSTUM_PLANE_COUNT; ++i)
+	{
+		p = &f->planes[i];
+		p->x = get_plane_term(&m->x, i);
+		p->y = get_plane_term(&m->y, i);
+		p->z = get_plane_term(&m->z, i);
+		p->w = get_plane_term(&m->w, i);
+
+		len = sqrtf(p->x * p->x + p->y * p->y + p->z * p->z);
+		if (len > 0.0f)
+		{
+			p->x /= len;
+			p->y /= len;
+			p->z /= len;
+			p->w /= len;
+		}
+	}
+}
+
+//## public
+/**
+Tests whether a sphere may be inside the frustum. Spheres near a corner
+that are outside two planes but not fully outside either are kept.
+
+@param f The frustum.
+@param sphere The sphere, in the same space as the planes.
+@return TRUE if the sphere may be visible.
+*/
+boolean kk_frustum__test_sphere(kk_frustum_t* f, kk_sphere_t* sphere)
+{
+	kk_vec4_t* p;
+	int i;
+
+	for (i = 0; i < KK_FRUSTUM_PLANE_COUNT; ++i)
+	{
+		p = &f->planes[i];
+		if (p->x * sphere->center.x + p->y * sphere->center.y + p->z * sphere->center.z + p->w + sphere->radius < 0.0f)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Gets one column's term of a plane. Each plane is the matrix's last row plus
+or minus one of the others.
+*/
+static float get_plane_term(kk_vec4_t* col, int plane)
+{
+	float* c = (float*)col;
+	float row = c[plane / 2];
+
+	return (plane % 2 == 0) ? c[3] + row : c[3] - row;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef KK_FRUSTUM_H
+#define KK_FRUSTUM_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_frustum_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+Number of spheres tested per SIMD iteration. Matches the physics bodies so
+the same intrinsics are used.
+*/
+#if defined(CGLM_AVX_FP)
+	#define KK_FRUSTUM_WIDTH 8
+#elif defined(CGLM_SSE_FP) || defined(CGLM_NEON_FP)
+	#define KK_FRUSTUM_WIDTH 4
+#else
+	#define KK_FRUSTUM_WIDTH 1
+#endif
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Indices of the frustum planes.
+*/
+typedef enum
+{
+	KK_FRUSTUM_PLANE_LEFT,
+	KK_FRUSTUM_PLANE_RIGHT,
+	KK_FRUSTUM_PLANE_BOTTOM,
+	KK_FRUSTUM_PLANE_TOP,
+	KK_FRUSTUM_PLANE_NEAR,
+	KK_FRUSTUM_PLANE_FAR,
+	KK_FRUSTUM_PLANE_COUNT
+
+} kk_frustum_plane_t;
+
+/**
+View volume as six planes. Each plane is (x, y, z, w) with a unit normal
+facing inwards, so a point p is inside when dot(n, p) + w >= 0 for every
+plane.
+*/
+struct kk_frustum_s
+{
+	kk_vec4_t				planes[KK_FRUSTUM_PLANE_COUNT];
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_frustum.public.h"
+
+#endif /* KK_FRUSTUM_H */
\ No newline at end of file
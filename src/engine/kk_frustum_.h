@@ -0,0 +1,10 @@
+#ifndef KK_FRUSTUM__H
+#define KK_FRUSTUM__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_frustum_s kk_frustum_t;
+
+#endif /* KK_FRUSTUM__H */
\ No newline at end of file
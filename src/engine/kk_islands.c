@@ -0,0 +1,307 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_transform.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_islands.h"
+#include "engine/kk_physics_bodies.h"
+
+#include "autogen/kk_islands.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty set of islands.
+
+@param islands The islands to construct.
+*/
+void kk_islands__construct(kk_islands_t* islands)
+{
+	clear_struct(islands);
+	utl_array_init(&islands->parent);
+	utl_array_init(&islands->root_state);
+}
+
+//## public
+/**
+Destructs a set of islands.
+
+@param islands The islands to destruct.
+*/
+void kk_islands__destruct(kk_islands_t* islands)
+{
+	utl_array_destroy(&islands->root_state);
+	utl_array_destroy(&islands->parent);
+	clear_struct(islands);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Puts islands to sleep once every body in them has been still for
+KK_ISLANDS_SLEEP_TICKS. Call after the bodies are integrated and scattered,
+with the islands from the same frame's wake. Sleeping bodies have their
+motion cleared and stop blending between ticks.
+
+@param islands The islands.
+@param bodies The bodies that were simulated.
+@param num_steps The number of steps the bodies were simulated for.
+*/
+void kk_islands__sleep(kk_islands_t* islands, kk_physics_bodies_t* bodies, uint32_t num_steps)
+{
+	const float linear_sq = KK_ISLANDS_LINEAR_SLEEP * KK_ISLANDS_LINEAR_SLEEP;
+	const float angular_sq = KK_ISLANDS_ANGULAR_SLEEP * KK_ISLANDS_ANGULAR_SLEEP;
+	uint32_t* state = islands->root_state.data;
+	ecs_physics_t* phys;
+	uint32_t root;
+	uint32_t i;
+	float v;
+	float w;
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		state[find(islands, bodies->entities[i])] = 0xFFFFFFFF;
+	}
+
+	/* Count still ticks and keep the fewest for each island */
+	for (i = 0; i < bodies->count; ++i)
+	{
+		phys = bodies->phys[i];
+
+		v = bodies->velocity[0][i] * bodies->velocity[0][i]
+		  + bodies->velocity[1][i] * bodies->velocity[1][i]
+		  + bodies->velocity[2][i] * bodies->velocity[2][i];
+
+		w = bodies->angular_velocity[0][i] * bodies->angular_velocity[0][i]
+		  + bodies->angular_velocity[1][i] * bodies->angular_velocity[1][i]
+		  + bodies->angular_velocity[2][i] * bodies->angular_velocity[2][i];
+
+		phys->still_ticks = (v < linear_sq && w < angular_sq) ? phys->still_ticks + num_steps : 0;
+
+		root = find(islands, bodies->entities[i]);
+		state[root] = min(state[root], phys->still_ticks);
+	}
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		root = find(islands, bodies->entities[i]);
+		if (state[root] >= KK_ISLANDS_SLEEP_TICKS)
+		{
+			put_to_sleep(bodies->phys[i], bodies->transform[i], root);
+			islands->num_sleeping++;
+		}
+	}
+}
+
+//## public
+/**
+Builds the islands from the broadphase pairs and wakes every sleeping body
+in an island that has an awake body. Sleeping bodies don't pair with each
+other, so they are kept with the island they fell asleep in. A sleeping body
+is also woken when something writes to it, seen as a dirty transform or
+motion set since it went to sleep. Call before the bodies are gathered.
+
+@param islands The islands.
+@param ecs The ECS context.
+@param query The physics bodies. Must require physics and transform components.
+@param broadphase The broadphase with the pairs from the last collision update.
+*/
+void kk_islands__wake(kk_islands_t* islands, ecs_t* ecs, ecs_query_t* query, kk_broadphase_t* broadphase)
+{
+	uint32_t count = ecs_query__get_count(query);
+	uint32_t needed = 0;
+	kk_broadphase_pair_t* pair;
+	ecs_physics_t* phys;
+	entity_id_t ent;
+	uint32_t root;
+	uint32_t i;
+
+	for (i = 0; i < count; ++i)
+	{
+		ent = ecs_query__get_entity(query, i);
+		phys = ecs_physics__get(ecs, ent);
+		needed = max(needed, (phys->sleeping ? max(ent, phys->island) : ent) + 1);
+	}
+
+	if (needed > islands->parent.count)
+	{
+		utl_array_resize(&islands->parent, needed);
+		utl_array_resize(&islands->root_state, needed);
+	}
+
+	for (i = 0; i < islands->parent.count; ++i)
+	{
+		islands->parent.data[i] = KK_ISLANDS_NONE;
+		islands->root_state.data[i] = KK_ISLANDS_NONE;
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		ent = ecs_query__get_entity(query, i);
+		islands->parent.data[ent] = ent;
+	}
+
+	/* Link sleeping bodies through the first body seen from their island */
+	for (i = 0; i < count; ++i)
+	{
+		ent = ecs_query__get_entity(query, i);
+		phys = ecs_physics__get(ecs, ent);
+
+		if (!phys->sleeping)
+		{
+			continue;
+		}
+
+		if (islands->root_state.data[phys->island] == KK_ISLANDS_NONE)
+		{
+			islands->root_state.data[phys->island] = ent;
+		}
+		else
+		{
+			unite(islands, ent, islands->root_state.data[phys->island]);
+		}
+	}
+
+	/* Link bodies that may touch */
+	for (i = 0; i < broadphase->pairs.count; ++i)
+	{
+		pair = &broadphase->pairs.data[i];
+		if (pair->b < islands->parent.count
+		 && islands->parent.data[pair->a] != KK_ISLANDS_NONE
+		 && islands->parent.data[pair->b] != KK_ISLANDS_NONE)
+		{
+			unite(islands, pair->a, pair->b);
+		}
+	}
+
+	/* Find islands with an awake body */
+	islands->num_islands = 0;
+
+	for (i = 0; i < count; ++i)
+	{
+		islands->root_state.data[find(islands, ecs_query__get_entity(query, i))] = FALSE;
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		ent = ecs_query__get_entity(query, i);
+		phys = ecs_physics__get(ecs, ent);
+		root = find(islands, ent);
+
+		if (root == ent)
+		{
+			islands->num_islands++;
+		}
+
+		if (!phys->sleeping || was_written(phys, ecs_transform__get(ecs, ent)))
+		{
+			islands->root_state.data[root] = TRUE;
+		}
+	}
+
+	/* Wake the rest of those islands */
+	islands->num_sleeping = 0;
+
+	for (i = 0; i < count; ++i)
+	{
+		ent = ecs_query__get_entity(query, i);
+		phys = ecs_physics__get(ecs, ent);
+
+		if (!phys->sleeping)
+		{
+			continue;
+		}
+
+		if (islands->root_state.data[find(islands, ent)])
+		{
+			ecs_physics__wake(ecs, ent);
+		}
+		else
+		{
+			islands->num_sleeping++;
+		}
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Finds the root of an entity's island, halving the path on the way.
+*/
+static uint32_t find(kk_islands_t* islands, uint32_t ent)
+{
+	uint32_t* parent = islands->parent.data;
+
+	while (parent[ent] != ent)
+	{
+		parent[ent] = parent[parent[ent]];
+		ent = parent[ent];
+	}
+
+	return ent;
+}
+
+//## static
+/**
+Clears a body's motion and marks it asleep in an island. The previous pose
+is matched to the current one so the transform stops blending.
+*/
+static void put_to_sleep(ecs_physics_t* phys, ecs_transform_t* transform, uint32_t island)
+{
+	clear_struct(&phys->momentum);
+	clear_struct(&phys->velocity);
+	clear_struct(&phys->angular_momentum);
+	clear_struct(&phys->angular_velocity);
+	clear_struct(&phys->spin);
+	phys->sleeping = TRUE;
+	phys->island = island;
+
+	transform->prev_pos = transform->pos;
+	transform->prev_rot = transform->rot;
+	transform->interpolated = FALSE;
+}
+
+//## static
+/**
+Merges the islands of two entities.
+*/
+static void unite(kk_islands_t* islands, uint32_t a, uint32_t b)
+{
+	a = find(islands, a);
+	b = find(islands, b);
+
+	if (a != b)
+	{
+		/* Lower id becomes the root so results don't depend on pair order */
+		islands->parent.data[max(a, b)] = min(a, b);
+	}
+}
+
+//## static
+/**
+Checks if anything wrote to a sleeping body. Sleep clears its motion and the
+transform isn't touched by physics while it sleeps.
+*/
+static boolean was_written(ecs_physics_t* phys, ecs_transform_t* transform)
+{
+	return transform->dirty
+		|| phys->momentum.x != 0.0f || phys->momentum.y != 0.0f || phys->momentum.z != 0.0f
+		|| phys->angular_momentum.x != 0.0f || phys->angular_momentum.y != 0.0f || phys->angular_momentum.z != 0.0f;
+}
\ No newline at end of file
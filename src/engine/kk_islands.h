@@ -0,0 +1,62 @@
+#ifndef KK_ISLANDS_H
+#define KK_ISLANDS_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_query_.h"
+#include "engine/kk_broadphase_.h"
+#include "engine/kk_islands_.h"
+#include "engine/kk_physics_bodies_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_ISLANDS_NONE				(0xFFFFFFFF)	/* Entity without physics. */
+#define KK_ISLANDS_SLEEP_TICKS		(30)			/* Ticks every body in an island must stay still before it sleeps. */
+#define KK_ISLANDS_LINEAR_SLEEP		(0.05f)			/* Speed below which a body is still. */
+#define KK_ISLANDS_ANGULAR_SLEEP	(0.05f)			/* Angular speed below which a body is still. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Groups physics bodies that touch into islands so they sleep and wake
+together. Islands are rebuilt each frame from the broadphase pairs with a
+union-find over entity ids, so a body resting on a sleeping stack keeps the
+whole stack awake and a hit on any body wakes all of it. Colliders without
+physics don't join islands, so the ground doesn't link everything on it.
+*/
+struct kk_islands_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(uint32_t)	parent;			/* Union-find parent for each entity id. KK_ISLANDS_NONE without physics. */
+	utl_array_t(uint32_t)	root_state;		/* For each island root, the awake flag while waking, fewest still ticks while sleeping. */
+
+	/*
+	Other
+	*/
+	uint32_t				num_islands;	/* Islands found by the last wake. Stat. */
+	uint32_t				num_sleeping;	/* Bodies asleep after the last wake or sleep. Stat. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_islands.public.h"
+
+#endif /* KK_ISLANDS_H */
\ No newline at end of file
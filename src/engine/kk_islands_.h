@@ -0,0 +1,10 @@
+#ifndef KK_ISLANDS__H
+#define KK_ISLANDS__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_islands_s kk_islands_t;
+
+#endif /* KK_ISLANDS__H */
\ No newline at end of file
@@ -0,0 +1,752 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_job.h"
+#include "engine/kk_log.h"
+
+#if defined(JETZ_CONFIG_PLATFORM_PSP)
+	/* Single thread, jobs run inline */
+#elif defined(_WIN32)
+	#define KK_JOB_THREADS
+	#define KK_JOB_WIN32
+	#define WIN32_LEAN_AND_MEAN		/* Keeps rpcndr.h and its boolean typedef out */
+	#include <windows.h>
+#else
+	#define KK_JOB_THREADS
+	#define KK_JOB_PTHREADS
+	#include <pthread.h>
+	#include <sched.h>
+	#include <unistd.h>
+#endif
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define DEQUE_MASK					(KK_JOB_DEQUE_SIZE - 1)
+#define SPLITS_PER_THREAD			(4)		/* Ranges per thread when parallel_for picks the grain size. */
+#define SPIN_COUNT					(64)	/* Failed attempts to find work before a worker sleeps. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	kk_job_system_t*		sys;
+	uint32_t				index;
+
+} job_worker_t;
+
+typedef struct
+{
+#if defined(KK_JOB_WIN32)
+	HANDLE					threads[KK_JOB_MAX_THREADS];
+	CRITICAL_SECTION		lock;
+	CONDITION_VARIABLE		wake;
+#elif defined(KK_JOB_PTHREADS)
+	pthread_t				threads[KK_JOB_MAX_THREADS];
+	pthread_mutex_t			lock;
+	pthread_cond_t			wake;
+#endif
+	job_worker_t			workers[KK_JOB_MAX_THREADS];
+
+} job_context_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+#if defined(KK_JOB_WIN32)
+static __declspec(thread) uint32_t s_worker_index;
+#elif defined(KK_JOB_PTHREADS)
+static __thread uint32_t s_worker_index;
+#else
+static uint32_t s_worker_index;
+#endif
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "autogen/kk_job.static.h"
+
+/*=========================================================
+PLATFORM
+=========================================================*/
+
+#if defined(KK_JOB_WIN32)
+
+static int64_t atomic_add(kk_job_atomic_t* p, int64_t v)
+{
+	return InterlockedExchangeAdd64((volatile LONG64*)p, v) + v;
+}
+
+static boolean atomic_cas(kk_job_atomic_t* p, int64_t expected, int64_t desired)
+{
+	return InterlockedCompareExchange64((volatile LONG64*)p, desired, expected) == expected;
+}
+
+static int64_t atomic_get(kk_job_atomic_t* p)
+{
+	return InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+}
+
+static void atomic_set(kk_job_atomic_t* p, int64_t v)
+{
+	InterlockedExchange64((volatile LONG64*)p, v);
+}
+
+static uint32_t get_num_cores()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (uint32_t)info.dwNumberOfProcessors;
+}
+
+static DWORD WINAPI thread_main(LPVOID param)
+{
+	job_worker_t* worker = (job_worker_t*)param;
+	s_worker_index = worker->index;
+	worker_loop(worker->sys);
+	return 0;
+}
+
+static void thread_yield()
+{
+	SwitchToThread();
+}
+
+static void start_threads(kk_job_system_t* sys, job_context_t* ctx)
+{
+	uint32_t i;
+
+	InitializeCriticalSection(&ctx->lock);
+	InitializeConditionVariable(&ctx->wake);
+
+	for (i = 1; i < sys->num_threads; ++i)
+	{
+		ctx->threads[i] = CreateThread(NULL, 0, thread_main, &ctx->workers[i], 0, NULL);
+		if (!ctx->threads[i])
+		{
+			kk_log__fatal("Failed to create job thread.");
+		}
+	}
+}
+
+static void stop_threads(kk_job_system_t* sys, job_context_t* ctx)
+{
+	uint32_t i;
+
+	EnterCriticalSection(&ctx->lock);
+	atomic_set(&sys->running, FALSE);
+	WakeAllConditionVariable(&ctx->wake);
+	LeaveCriticalSection(&ctx->lock);
+
+	for (i = 1; i < sys->num_threads; ++i)
+	{
+		WaitForSingleObject(ctx->threads[i], INFINITE);
+		CloseHandle(ctx->threads[i]);
+	}
+
+	DeleteCriticalSection(&ctx->lock);
+}
+
+static void sleep_worker(kk_job_system_t* sys, job_context_t* ctx)
+{
+	EnterCriticalSection(&ctx->lock);
+	atomic_add(&sys->num_sleeping, 1);
+
+	while (atomic_get(&sys->running) && atomic_get(&sys->num_queued) == 0)
+	{
+		SleepConditionVariableCS(&ctx->wake, &ctx->lock, INFINITE);
+	}
+
+	atomic_add(&sys->num_sleeping, -1);
+	LeaveCriticalSection(&ctx->lock);
+}
+
+static void wake_worker(kk_job_system_t* sys, job_context_t* ctx)
+{
+	EnterCriticalSection(&ctx->lock);
+	WakeConditionVariable(&ctx->wake);
+	LeaveCriticalSection(&ctx->lock);
+}
+
+#elif defined(KK_JOB_PTHREADS)
+
+static int64_t atomic_add(kk_job_atomic_t* p, int64_t v)
+{
+	return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST);
+}
+
+static boolean atomic_cas(kk_job_atomic_t* p, int64_t expected, int64_t desired)
+{
+	return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static int64_t atomic_get(kk_job_atomic_t* p)
+{
+	return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+static void atomic_set(kk_job_atomic_t* p, int64_t v)
+{
+	__atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+static uint32_t get_num_cores()
+{
+	long num = sysconf(_SC_NPROCESSORS_ONLN);
+	return num > 0 ? (uint32_t)num : 1;
+}
+
+static void* thread_main(void* param)
+{
+	job_worker_t* worker = (job_worker_t*)param;
+	s_worker_index = worker->index;
+	worker_loop(worker->sys);
+	return NULL;
+}
+
+static void thread_yield()
+{
+	sched_yield();
+}
+
+static void start_threads(kk_job_system_t* sys, job_context_t* ctx)
+{
+	uint32_t i;
+
+	pthread_mutex_init(&ctx->lock, NULL);
+	pthread_cond_init(&ctx->wake, NULL);
+
+	for (i = 1; i < sys->num_threads; ++i)
+	{
+		if (pthread_create(&ctx->threads[i], NULL, thread_main, &ctx->workers[i]) != 0)
+		{
+			kk_log__fatal("Failed to create job thread.");
+		}
+	}
+}
+
+static void stop_threads(kk_job_system_t* sys, job_context_t* ctx)
+{
+	uint32_t i;
+
+	pthread_mutex_lock(&ctx->lock);
+	atomic_set(&sys->running, FALSE);
+	pthread_cond_broadcast(&ctx->wake);
+	pthread_mutex_unlock(&ctx->lock);
+
+	for (i = 1; i < sys->num_threads; ++i)
+	{
+		pthread_join(ctx->threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&ctx->wake);
+	pthread_mutex_destroy(&ctx->lock);
+}
+
+static void sleep_worker(kk_job_system_t* sys, job_context_t* ctx)
+{
+	pthread_mutex_lock(&ctx->lock);
+	atomic_add(&sys->num_sleeping, 1);
+
+	while (atomic_get(&sys->running) && atomic_get(&sys->num_queued) == 0)
+	{
+		pthread_cond_wait(&ctx->wake, &ctx->lock);
+	}
+
+	atomic_add(&sys->num_sleeping, -1);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+static void wake_worker(kk_job_system_t* sys, job_context_t* ctx)
+{
+	pthread_mutex_lock(&ctx->lock);
+	pthread_cond_signal(&ctx->wake);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+#else
+
+/*
+Single thread. Nothing is shared so plain reads and writes are enough.
+*/
+
+static int64_t atomic_add(kk_job_atomic_t* p, int64_t v)
+{
+	*p += v;
+	return *p;
+}
+
+static boolean atomic_cas(kk_job_atomic_t* p, int64_t expected, int64_t desired)
+{
+	if (*p != expected)
+	{
+		return FALSE;
+	}
+
+	*p = desired;
+	return TRUE;
+}
+
+static int64_t atomic_get(kk_job_atomic_t* p)
+{
+	return *p;
+}
+
+static void atomic_set(kk_job_atomic_t* p, int64_t v)
+{
+	*p = v;
+}
+
+static void thread_yield()
+{
+}
+
+#endif
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs a job system. The calling thread becomes worker 0 and must be the
+thread that later waits on jobs from outside of a job.
+
+@param sys The job system to construct.
+@param num_threads Number of workers including the calling thread. 0 uses one per core. Always 1 on the PSP.
+*/
+void kk_job__construct(kk_job_system_t* sys, uint32_t num_threads)
+{
+	uint32_t i;
+
+	clear_struct(sys);
+
+#if defined(KK_JOB_THREADS)
+	if (num_threads == 0)
+	{
+		num_threads = get_num_cores();
+	}
+#else
+	num_threads = 1;
+#endif
+
+	sys->num_threads = max(1, min(num_threads, KK_JOB_MAX_THREADS));
+	sys->running = TRUE;
+	s_worker_index = 0;
+
+	sys->deques = (kk_job_deque_t*)calloc(sys->num_threads, sizeof(kk_job_deque_t));
+	if (!sys->deques)
+	{
+		kk_log__fatal("Failed to allocate job deques.");
+	}
+
+	for (i = 0; i < sys->num_threads; ++i)
+	{
+		sys->deques[i].jobs = (kk_job_t*)malloc(sizeof(kk_job_t) * KK_JOB_DEQUE_SIZE);
+		if (!sys->deques[i].jobs)
+		{
+			kk_log__fatal("Failed to allocate job deque.");
+		}
+	}
+
+#if defined(KK_JOB_THREADS)
+	{
+		job_context_t* ctx = (job_context_t*)calloc(1, sizeof(job_context_t));
+		if (!ctx)
+		{
+			kk_log__fatal("Failed to allocate job threads.");
+		}
+
+		for (i = 0; i < sys->num_threads; ++i)
+		{
+			ctx->workers[i].sys = sys;
+			ctx->workers[i].index = i;
+		}
+
+		sys->context = ctx;
+		start_threads(sys, ctx);
+	}
+#endif
+
+	kk_log__dbg_fmt("Job system started with %u threads.", sys->num_threads);
+}
+
+//## public
+/**
+Destructs a job system. Waits for the worker threads to exit. Jobs still
+queued are discarded.
+
+@param sys The job system to destruct.
+*/
+void kk_job__destruct(kk_job_system_t* sys)
+{
+	uint32_t i;
+
+#if defined(KK_JOB_THREADS)
+	stop_threads(sys, (job_context_t*)sys->context);
+	free(sys->context);
+#endif
+
+	for (i = 0; i < sys->num_threads; ++i)
+	{
+		free(sys->deques[i].jobs);
+	}
+
+	free(sys->deques);
+	clear_struct(sys);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Gets the index of the calling thread's worker. 0 is the thread that
+constructed the job system. Only meaningful on threads of the job system.
+*/
+uint32_t kk_job__get_thread_index()
+{
+	return s_worker_index;
+}
+
+//## public
+/**
+Runs func over [0, count) split into ranges of grain indices. The calling
+thread runs the first range itself and helps with the others until all of
+them are done. Ranges run concurrently, so func must only write to data owned
+by its range.
+
+@param sys The job system.
+@param count Number of indices.
+@param grain Indices per range. 0 picks a size that gives each thread a few ranges.
+@param func The function to run on each range.
+@param data User data passed to func.
+*/
+void kk_job__parallel_for(kk_job_system_t* sys, uint32_t count, uint32_t grain, kk_job_func func, void* data)
+{
+	kk_job_counter_t counter;
+	kk_job_t job;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (grain == 0)
+	{
+		grain = max(1, count / (sys->num_threads * SPLITS_PER_THREAD));
+	}
+
+	/* Not worth splitting */
+	if (sys->num_threads == 1 || count <= grain)
+	{
+		func(data, 0, count);
+		return;
+	}
+
+	clear_struct(&counter);
+	job.func = func;
+	job.data = data;
+	job.counter = &counter;
+
+	for (job.start = grain; job.start < count; job.start = job.end)
+	{
+		job.end = (count - job.start > grain) ? job.start + grain : count;
+		kk_job__run(sys, &job);
+	}
+
+	func(data, 0, grain);
+	kk_job__wait(sys, &counter);
+}
+
+//## public
+/**
+Submits a job. The job is copied, so it can be a local. On the PSP the job
+runs before this returns.
+
+@param sys The job system.
+@param job The job to run.
+*/
+void kk_job__run(kk_job_system_t* sys, const kk_job_t* job)
+{
+	if (job->counter)
+	{
+		atomic_add(&job->counter->value, 1);
+	}
+
+	submit(sys, job);
+}
+
+//## public
+/**
+Submits a job that will not start until a counter reaches zero. The job's own
+counter is incremented immediately, so waiting on it also waits for the
+dependency.
+
+@param sys The job system.
+@param job The job to run.
+@param dependency The counter to wait for.
+*/
+void kk_job__run_after(kk_job_system_t* sys, const kk_job_t* job, kk_job_counter_t* dependency)
+{
+	boolean deferred = FALSE;
+
+	if (job->counter)
+	{
+		atomic_add(&job->counter->value, 1);
+	}
+
+	lock_counter(dependency);
+	if (atomic_get(&dependency->value) > 0 && dependency->num_continuations < KK_JOB_MAX_CONTINUATIONS)
+	{
+		dependency->continuations[dependency->num_continuations++] = *job;
+		deferred = TRUE;
+	}
+	atomic_set(&dependency->lock, 0);
+
+	if (deferred)
+	{
+		return;
+	}
+
+	/* Continuation list is full, wait for the dependency here instead */
+	kk_job__wait(sys, dependency);
+	submit(sys, job);
+}
+
+//## public
+/**
+Waits until a counter reaches zero. The calling thread runs queued jobs while
+it waits.
+
+@param sys The job system.
+@param counter The counter to wait on.
+*/
+void kk_job__wait(kk_job_system_t* sys, kk_job_counter_t* counter)
+{
+	/* The lock is checked too so the counter is not released while a worker is still finishing with it */
+	while (atomic_get(&counter->value) > 0 || atomic_get(&counter->lock) != 0)
+	{
+		if (!run_one(sys))
+		{
+			thread_yield();
+		}
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Takes the job from the bottom of a deque. Only the owning thread may pop.
+*/
+static boolean deque_pop(kk_job_deque_t* dq, kk_job_t* job)
+{
+	int64_t b = atomic_get(&dq->bottom) - 1;
+	int64_t t;
+	boolean found = TRUE;
+
+	/* Claim the bottom slot before checking for thieves */
+	atomic_set(&dq->bottom, b);
+	t = atomic_get(&dq->top);
+
+	if (t > b)
+	{
+		/* Empty */
+		atomic_set(&dq->bottom, b + 1);
+		return FALSE;
+	}
+
+	*job = dq->jobs[b & DEQUE_MASK];
+
+	if (t == b)
+	{
+		/* Last job, a thief may be taking it too */
+		found = atomic_cas(&dq->top, t, t + 1);
+		atomic_set(&dq->bottom, b + 1);
+	}
+
+	return found;
+}
+
+//## static
+/**
+Adds a job to the bottom of a deque. Only the owning thread may push.
+@return FALSE if the deque is full.
+*/
+static boolean deque_push(kk_job_deque_t* dq, const kk_job_t* job)
+{
+	int64_t b = atomic_get(&dq->bottom);
+	int64_t t = atomic_get(&dq->top);
+
+	if (b - t >= KK_JOB_DEQUE_SIZE)
+	{
+		return FALSE;
+	}
+
+	dq->jobs[b & DEQUE_MASK] = *job;
+	atomic_set(&dq->bottom, b + 1);
+	return TRUE;
+}
+
+//## static
+/**
+Takes the job from the top of another thread's deque.
+*/
+static boolean deque_steal(kk_job_deque_t* dq, kk_job_t* job)
+{
+	int64_t t = atomic_get(&dq->top);
+	int64_t b = atomic_get(&dq->bottom);
+
+	if (t >= b)
+	{
+		return FALSE;
+	}
+
+	/* The slot can't be reused until top moves past it, so the copy is only kept if the CAS wins */
+	*job = dq->jobs[t & DEQUE_MASK];
+	return atomic_cas(&dq->top, t, t + 1);
+}
+
+//## static
+/**
+Runs a job and signals its counter.
+*/
+static void execute(kk_job_system_t* sys, const kk_job_t* job)
+{
+	kk_job_t continuations[KK_JOB_MAX_CONTINUATIONS];
+	kk_job_counter_t* counter = job->counter;
+	uint32_t num_continuations = 0;
+	uint32_t i;
+
+	job->func(job->data, job->start, job->end);
+
+	if (!counter)
+	{
+		return;
+	}
+
+	/* Take the continuations while holding the lock, the counter may be released once it is dropped */
+	lock_counter(counter);
+	if (atomic_add(&counter->value, -1) == 0)
+	{
+		num_continuations = counter->num_continuations;
+		memcpy(continuations, counter->continuations, sizeof(kk_job_t) * num_continuations);
+		counter->num_continuations = 0;
+	}
+	atomic_set(&counter->lock, 0);
+
+	for (i = 0; i < num_continuations; ++i)
+	{
+		submit(sys, &continuations[i]);
+	}
+}
+
+//## static
+/**
+Spins until the counter's continuation list is acquired.
+*/
+static void lock_counter(kk_job_counter_t* counter)
+{
+	while (!atomic_cas(&counter->lock, 0, 1))
+	{
+		thread_yield();
+	}
+}
+
+//## static
+/**
+Runs one queued job, preferring the calling thread's own deque and stealing
+from the other threads if it is empty.
+@return TRUE if a job was run.
+*/
+static boolean run_one(kk_job_system_t* sys)
+{
+	kk_job_t job;
+	uint32_t self = s_worker_index;
+	uint32_t i;
+
+	if (deque_pop(&sys->deques[self], &job))
+	{
+		atomic_add(&sys->num_queued, -1);
+		execute(sys, &job);
+		return TRUE;
+	}
+
+	for (i = 1; i < sys->num_threads; ++i)
+	{
+		if (deque_steal(&sys->deques[(self + i) % sys->num_threads], &job))
+		{
+			atomic_add(&sys->num_queued, -1);
+			execute(sys, &job);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+//## static
+/**
+Queues a job on the calling thread's deque. Runs it inline if there is only
+one thread or the deque is full.
+*/
+static void submit(kk_job_system_t* sys, const kk_job_t* job)
+{
+	if (sys->num_threads == 1 || !deque_push(&sys->deques[s_worker_index], job))
+	{
+		execute(sys, job);
+		return;
+	}
+
+	atomic_add(&sys->num_queued, 1);
+
+#if defined(KK_JOB_THREADS)
+	if (atomic_get(&sys->num_sleeping) > 0)
+	{
+		wake_worker(sys, (job_context_t*)sys->context);
+	}
+#endif
+}
+
+//## static
+/**
+Main loop of a worker thread. Runs jobs until the system stops, sleeping when
+there is nothing to do.
+*/
+static void worker_loop(kk_job_system_t* sys)
+{
+	uint32_t spins = 0;
+
+	while (atomic_get(&sys->running))
+	{
+		if (run_one(sys))
+		{
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < SPIN_COUNT)
+		{
+			thread_yield();
+			continue;
+		}
+
+		spins = 0;
+#if defined(KK_JOB_THREADS)
+		sleep_worker(sys, (job_context_t*)sys->context);
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef KK_JOB_H
+#define KK_JOB_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_job_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_JOB_MAX_THREADS				(32)	/* Max threads in a job system, including the thread that constructs it. */
+#define KK_JOB_DEQUE_SIZE				(1024)	/* Jobs each worker can have queued. Must be a power of 2. */
+#define KK_JOB_MAX_CONTINUATIONS		(8)		/* Jobs that can wait on a single counter. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Value shared between threads. Only accessed through the atomic helpers in kk_job.c.
+*/
+typedef volatile int64_t kk_job_atomic_t;
+
+/**
+Job function. Runs on the range [start, end) of the work described by data.
+Jobs that are not part of a range get start = end = 0.
+*/
+typedef void (*kk_job_func)(void* data, uint32_t start, uint32_t end);
+
+/**
+A unit of work.
+*/
+struct kk_job_s
+{
+	kk_job_func				func;
+	void*					data;		/* User data passed to func. */
+	uint32_t				start;		/* First index of the range. */
+	uint32_t				end;		/* One past the last index of the range. */
+	kk_job_counter_t*		counter;	/* Optional. Incremented when the job is submitted and decremented once it completes. */
+};
+
+/**
+Tracks a group of outstanding jobs. Other jobs can be queued to run once the
+count reaches zero. Zero a counter with clear_struct before first use.
+*/
+struct kk_job_counter_s
+{
+	kk_job_atomic_t			value;											/* Number of jobs still outstanding. */
+	kk_job_atomic_t			lock;											/* Guards the continuation list. */
+	uint32_t				num_continuations;
+	kk_job_t				continuations[KK_JOB_MAX_CONTINUATIONS];		/* Jobs submitted once value reaches zero. */
+};
+
+/**
+Work-stealing deque. The owning thread pushes and pops at the bottom, other
+threads steal from the top.
+*/
+struct kk_job_deque_s
+{
+	kk_job_atomic_t			top;
+	kk_job_atomic_t			bottom;
+	kk_job_t*				jobs;		/* Ring of KK_JOB_DEQUE_SIZE jobs. */
+};
+
+/**
+Job system. Each thread owns a deque of jobs and steals from the others when
+it runs dry. The thread that constructs the system is worker 0 and runs jobs
+while it waits on counters.
+
+On the PSP there is a single thread and jobs run inline when submitted.
+*/
+struct kk_job_system_s
+{
+	/*
+	Create/destroy
+	*/
+	uint32_t				num_threads;	/* Number of workers, including the thread that constructed the system. */
+	kk_job_deque_t*			deques;			/* One deque per worker. */
+	void*					context;		/* Platform threads and wake signal. */
+
+	/*
+	Other
+	*/
+	kk_job_atomic_t			running;		/* Cleared to stop the worker threads. */
+	kk_job_atomic_t			num_queued;		/* Jobs sitting in deques. */
+	kk_job_atomic_t			num_sleeping;	/* Workers waiting for jobs. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_job.public.h"
+
+#endif /* KK_JOB_H */
\ No newline at end of file
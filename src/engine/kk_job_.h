@@ -0,0 +1,13 @@
+#ifndef KK_JOB__H
+#define KK_JOB__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_job_s kk_job_t;
+typedef struct kk_job_counter_s kk_job_counter_t;
+typedef struct kk_job_deque_s kk_job_deque_t;
+typedef struct kk_job_system_s kk_job_system_t;
+
+#endif /* KK_JOB__H */
\ No newline at end of file
@@ -22,9 +22,17 @@ Want to keep these inline when possible. Need to have extern declarations in the
 file to keep compiler happen since this is in a static library.
 */
 
+extern boolean kk_math_aabb_contains(kk_aabb_t* outer, kk_aabb_t* inner);
+extern boolean kk_math_aabb_overlaps(kk_aabb_t* a, kk_aabb_t* b);
+extern boolean kk_math_aabb_raycast(kk_aabb_t* box, kk_ray_t* ray, kk_vec3_t* inv_dir, float* out__t);
+extern void kk_math_aabb_transform(kk_aabb_t* box, kk_mat4_t* m, kk_aabb_t* dest);
+extern void kk_math_aabb_union(kk_aabb_t* a, kk_aabb_t* b, kk_aabb_t* dest);
 extern void kk_math_cross(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* dest);
 extern float kk_math_deg(float rad);
 extern void kk_math_lookat(kk_vec3_t* eye, kk_vec3_t* center, kk_vec3_t* up, kk_mat4_t* dest);
+extern void kk_math_mat4_inv(kk_mat4_t* m, kk_mat4_t* dest);
+extern void kk_math_mat4_mul(kk_mat4_t* a, kk_mat4_t* b, kk_mat4_t* dest);
+extern void kk_math_mat4_mulv3(kk_mat4_t* m, kk_vec3_t* v, float w, kk_vec3_t* dest);
 extern void kk_math_perspective(float fovy, float aspect, float near_val, float far_val, kk_mat4_t* dest);
 extern float kk_math_quat_angle(kk_vec4_t* q);
 extern void kk_math_quat_axis(kk_vec4_t* q, kk_vec3_t* dest);
@@ -32,8 +40,14 @@ extern void kk_math_quat_mat4(kk_vec4_t* q, kk_mat4_t* dest);
 extern void kk_math_quat_mul(kk_vec4_t* p, kk_vec4_t* q, kk_vec4_t* dest);
 extern void kk_math_quat_normalize(kk_vec4_t* q);
 extern void kk_math_quat_rotatev(kk_vec4_t* q, kk_vec3_t* v, kk_vec3_t* dest);
+extern void kk_math_quat_slerp(kk_vec4_t* from, kk_vec4_t* to, float t, kk_vec4_t* dest);
 extern float kk_math_rad(float deg);
+extern void kk_math_sphere_transform(kk_sphere_t* sphere, kk_mat4_t* m, kk_sphere_t* dest);
 extern void kk_math_vec3_add(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* dest);
 extern void kk_math_vec3_copy(kk_vec3_t* a, kk_vec3_t* dest);
+extern float kk_math_vec3_dot(kk_vec3_t* a, kk_vec3_t* b);
+extern void kk_math_vec3_lerp(kk_vec3_t* from, kk_vec3_t* to, float t, kk_vec3_t* dest);
+extern float kk_math_vec3_norm(kk_vec3_t* v);
+extern void kk_math_vec3_normalize(kk_vec3_t* v);
 extern void kk_math_vec3_sub(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* dest);
 extern void kk_math_vec3_scale(kk_vec3_t* v, float s, kk_vec3_t* dest);
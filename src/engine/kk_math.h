@@ -90,10 +90,161 @@ typedef struct
 } kk_mat4_t;
 #endif
 
+/*-------------------------------------
+Common types
+-------------------------------------*/
+
+/**
+Axis-aligned bounding box.
+*/
+typedef struct {
+	kk_vec3_t min; kk_vec3_t max;
+} kk_aabb_t;
+
+/**
+Bounding sphere.
+*/
+typedef struct {
+	kk_vec3_t center; float radius;
+} kk_sphere_t;
+
+/**
+Ray segment. Points on the ray are origin + t * dir for t in [0, max_t], so t
+is a distance when dir is normalized.
+*/
+typedef struct {
+	kk_vec3_t origin; kk_vec3_t dir; float max_t;
+} kk_ray_t;
+
 /*=========================================================
 FUNCTIONS
 =========================================================*/
 
+/*
+Bounding boxes
+*/
+
+KK_INLINE
+boolean kk_math_aabb_contains(kk_aabb_t* outer, kk_aabb_t* inner)
+{
+	return outer->min.x <= inner->min.x && outer->min.y <= inner->min.y && outer->min.z <= inner->min.z
+		&& outer->max.x >= inner->max.x && outer->max.y >= inner->max.y && outer->max.z >= inner->max.z;
+}
+
+KK_INLINE
+boolean kk_math_aabb_overlaps(kk_aabb_t* a, kk_aabb_t* b)
+{
+	return a->min.x <= b->max.x && a->max.x >= b->min.x
+		&& a->min.y <= b->max.y && a->max.y >= b->min.y
+		&& a->min.z <= b->max.z && a->max.z >= b->min.z;
+}
+
+/**
+Bounds of a box after it is transformed by a matrix. Each corner's
+contribution to an axis is the smaller/larger of the min and max terms, so
+no corners need to be generated.
+*/
+KK_INLINE
+void kk_math_aabb_transform(kk_aabb_t* box, kk_mat4_t* m, kk_aabb_t* dest)
+{
+	float* cols = (float*)m;
+	float* bmin = (float*)&box->min;
+	float* bmax = (float*)&box->max;
+	float dmin[3];
+	float dmax[3];
+	int i, j;
+
+	for (i = 0; i < 3; ++i)
+	{
+		dmin[i] = dmax[i] = cols[12 + i];
+
+		for (j = 0; j < 3; ++j)
+		{
+			float a = cols[j * 4 + i] * bmin[j];
+			float b = cols[j * 4 + i] * bmax[j];
+			dmin[i] += (a < b) ? a : b;
+			dmax[i] += (a < b) ? b : a;
+		}
+	}
+
+	dest->min.x = dmin[0]; dest->min.y = dmin[1]; dest->min.z = dmin[2];
+	dest->max.x = dmax[0]; dest->max.y = dmax[1]; dest->max.z = dmax[2];
+}
+
+/**
+Slab test of a ray against a box. inv_dir is 1 / dir per axis, computed once
+per ray. On a hit, out__t is where the ray enters the box, 0 if it starts
+inside.
+*/
+KK_INLINE
+boolean kk_math_aabb_raycast(kk_aabb_t* box, kk_ray_t* ray, kk_vec3_t* inv_dir, float* out__t)
+{
+	float t1, t2;
+	float tmin = 0.0f;
+	float tmax = ray->max_t;
+
+	t1 = (box->min.x - ray->origin.x) * inv_dir->x;
+	t2 = (box->max.x - ray->origin.x) * inv_dir->x;
+	tmin = max(tmin, min(t1, t2));
+	tmax = min(tmax, max(t1, t2));
+
+	t1 = (box->min.y - ray->origin.y) * inv_dir->y;
+	t2 = (box->max.y - ray->origin.y) * inv_dir->y;
+	tmin = max(tmin, min(t1, t2));
+	tmax = min(tmax, max(t1, t2));
+
+	t1 = (box->min.z - ray->origin.z) * inv_dir->z;
+	t2 = (box->max.z - ray->origin.z) * inv_dir->z;
+	tmin = max(tmin, min(t1, t2));
+	tmax = min(tmax, max(t1, t2));
+
+	*out__t = tmin;
+	return tmin <= tmax;
+}
+
+KK_INLINE
+void kk_math_aabb_union(kk_aabb_t* a, kk_aabb_t* b, kk_aabb_t* dest)
+{
+	dest->min.x = (a->min.x < b->min.x) ? a->min.x : b->min.x;
+	dest->min.y = (a->min.y < b->min.y) ? a->min.y : b->min.y;
+	dest->min.z = (a->min.z < b->min.z) ? a->min.z : b->min.z;
+	dest->max.x = (a->max.x > b->max.x) ? a->max.x : b->max.x;
+	dest->max.y = (a->max.y > b->max.y) ? a->max.y : b->max.y;
+	dest->max.z = (a->max.z > b->max.z) ? a->max.z : b->max.z;
+}
+
+/*
+Bounding spheres
+*/
+
+/**
+Bounds of a sphere after it is transformed by a matrix. The radius grows by
+the longest basis vector, so non-uniform scale gives a loose sphere.
+*/
+KK_INLINE
+void kk_math_sphere_transform(kk_sphere_t* sphere, kk_mat4_t* m, kk_sphere_t* dest)
+{
+	float sx = m->x.x * m->x.x + m->x.y * m->x.y + m->x.z * m->x.z;
+	float sy = m->y.x * m->y.x + m->y.y * m->y.y + m->y.z * m->y.z;
+	float sz = m->z.x * m->z.x + m->z.y * m->z.y + m->z.z * m->z.z;
+	float s = (sx > sy) ? sx : sy;
+	float c[3];
+	int i;
+
+	s = (s > sz) ? s : sz;
+
+	for (i = 0; i < 3; ++i)
+	{
+		c[i] = ((float*)&m->x)[i] * sphere->center.x + ((float*)&m->y)[i] * sphere->center.y
+			 + ((float*)&m->z)[i] * sphere->center.z + ((float*)&m->w)[i];
+	}
+
+	dest->center.x = c[0];
+	dest->center.y = c[1];
+	dest->center.z = c[2];
+	dest->radius = sphere->radius * sqrtf(s);
+}
+
 /*
 GLM wrappers
 */
@@ -113,13 +264,55 @@ float kk_math_deg(float rad)
 KK_INLINE
 void kk_math_lookat(kk_vec3_t* eye, kk_vec3_t* center, kk_vec3_t* up, kk_mat4_t* dest)
 {
-	glm_lookat((float*)eye, (float*)center, (float*)up, (vec4*)dest);
+	/* glm_lookat uses aligned SIMD stores, and kk_mat4_t isn't always aligned */
+	CGLM_ALIGN_MAT mat4 r;
+	glm_lookat((float*)eye, (float*)center, (float*)up, r);
+	glm_mat4_ucopy(r, (vec4*)dest);
+}
+
+KK_INLINE
+void kk_math_mat4_inv(kk_mat4_t* m, kk_mat4_t* dest)
+{
+	/* glm_mat4_inv uses aligned SIMD loads/stores, and kk_mat4_t isn't always aligned */
+	CGLM_ALIGN_MAT mat4 a, r;
+	glm_mat4_ucopy((vec4*)m, a);
+	glm_mat4_inv(a, r);
+	glm_mat4_ucopy(r, (vec4*)dest);
+}
+
+KK_INLINE
+void kk_math_mat4_mul(kk_mat4_t* a, kk_mat4_t* b, kk_mat4_t* dest)
+{
+	/* glm_mat4_mul uses aligned SIMD loads/stores, and kk_mat4_t isn't always aligned */
+	CGLM_ALIGN_MAT mat4 x, y, r;
+	glm_mat4_ucopy((vec4*)a, x);
+	glm_mat4_ucopy((vec4*)b, y);
+	glm_mat4_mul(x, y, r);
+	glm_mat4_ucopy(r, (vec4*)dest);
+}
+
+/**
+Transforms a vector by a matrix, treating it as a point when w is 1 and a
+direction when w is 0.
+*/
+KK_INLINE
+void kk_math_mat4_mulv3(kk_mat4_t* m, kk_vec3_t* v, float w, kk_vec3_t* dest)
+{
+	kk_vec3_t r;
+
+	r.x = m->x.x * v->x + m->y.x * v->y + m->z.x * v->z + m->w.x * w;
+	r.y = m->x.y * v->x + m->y.y * v->y + m->z.y * v->z + m->w.y * w;
+	r.z = m->x.z * v->x + m->y.z * v->y + m->z.z * v->z + m->w.z * w;
+	*dest = r;
 }
 
 KK_INLINE
 void kk_math_perspective(float fovy, float aspect, float near_val, float far_val, kk_mat4_t* dest)
 {
-	glm_perspective(fovy, aspect, near_val, far_val, (vec4*)dest);
+	/* glm_perspective uses aligned SIMD stores, and kk_mat4_t isn't always aligned */
+	CGLM_ALIGN_MAT mat4 r;
+	glm_perspective(fovy, aspect, near_val, far_val, r);
+	glm_mat4_ucopy(r, (vec4*)dest);
 }
 
 KK_INLINE
@@ -158,6 +351,17 @@ void kk_math_quat_rotatev(kk_vec4_t* q, kk_vec3_t* v, kk_vec3_t* dest)
 	glm_quat_rotatev((float*)q, (float*)v, (float*)dest);
 }
 
+KK_INLINE
+void kk_math_quat_slerp(kk_vec4_t* from, kk_vec4_t* to, float t, kk_vec4_t* dest)
+{
+	/* glm_quat_slerp uses aligned SIMD loads/stores, and kk_vec4_t isn't always aligned */
+	CGLM_ALIGN(16) versor a, b, r;
+	glm_vec4_ucopy((float*)from, a);
+	glm_vec4_ucopy((float*)to, b);
+	glm_quat_slerp(a, b, t, r);
+	glm_vec4_ucopy(r, (float*)dest);
+}
+
 KK_INLINE
 float kk_math_rad(float deg)
 {
@@ -176,6 +380,30 @@ void kk_math_vec3_copy(kk_vec3_t* a, kk_vec3_t* dest)
 	glm_vec3_copy((float*)a, (float*)dest);
 }
 
+KK_INLINE
+float kk_math_vec3_dot(kk_vec3_t* a, kk_vec3_t* b)
+{
+	return glm_vec3_dot((float*)a, (float*)b);
+}
+
+KK_INLINE
+void kk_math_vec3_lerp(kk_vec3_t* from, kk_vec3_t* to, float t, kk_vec3_t* dest)
+{
+	glm_vec3_lerp((float*)from, (float*)to, t, (float*)dest);
+}
+
+KK_INLINE
+float kk_math_vec3_norm(kk_vec3_t* v)
+{
+	return glm_vec3_norm((float*)v);
+}
+
+KK_INLINE
+void kk_math_vec3_normalize(kk_vec3_t* v)
+{
+	glm_vec3_normalize((float*)v);
+}
+
 KK_INLINE
 void kk_math_vec3_sub(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* dest)
 {
@@ -0,0 +1,685 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <float.h>
+#include <math.h>
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "engine/kk_narrowphase.h"
+#include "engine/kk_shape.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define EPSILON				(1e-6f)
+#define MPR_MAX_ITERATIONS	(32)		/* Portal refinement gives up after this many support points. */
+#define MPR_TOLERANCE		(1e-4f)		/* Portal refinement stops when the boundary moves less than this. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Shape placed in the world by an affine matrix.
+*/
+typedef struct
+{
+	kk_shape_t*			shape;
+	kk_mat4_t*			m;
+
+} posed_shape_t;
+
+/**
+Point on the boundary of the Minkowski difference A - B, with the support
+points of A and B that made it.
+*/
+typedef struct
+{
+	kk_vec3_t			v;
+	kk_vec3_t			a;
+	kk_vec3_t			b;
+
+} mpr_point_t;
+
+#include "autogen/kk_narrowphase.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Finds the deepest point of contact between two shapes. Pairs of spheres and
+sphere-box pairs are solved directly. Every other pair uses Minkowski Portal
+Refinement on the shapes' support functions, so each call finds a single
+point. Callers build up a full manifold over several steps.
+
+Sphere radii are scaled by the largest axis scale of their matrix.
+
+@param a The first shape.
+@param ma World matrix of the first shape.
+@param b The second shape.
+@param mb World matrix of the second shape.
+@param out__contact The contact. Only written if the shapes overlap.
+@return TRUE if the shapes overlap.
+*/
+boolean kk_narrowphase__collide(kk_shape_t* a, kk_mat4_t* ma, kk_shape_t* b, kk_mat4_t* mb, kk_narrowphase_contact_t* out__contact)
+{
+	posed_shape_t pa;
+	posed_shape_t pb;
+	kk_vec3_t temp;
+
+	pa.shape = a;
+	pa.m = ma;
+	pb.shape = b;
+	pb.m = mb;
+
+	if (a->type == KK_SHAPE_TYPE_SPHERE && b->type == KK_SHAPE_TYPE_SPHERE)
+	{
+		return collide_spheres(&pa, &pb, out__contact);
+	}
+
+	if (a->type == KK_SHAPE_TYPE_BOX && b->type == KK_SHAPE_TYPE_SPHERE)
+	{
+		return collide_box_sphere(&pa, &pb, out__contact);
+	}
+
+	if (a->type == KK_SHAPE_TYPE_SPHERE && b->type == KK_SHAPE_TYPE_BOX)
+	{
+		if (!collide_box_sphere(&pb, &pa, out__contact))
+		{
+			return FALSE;
+		}
+
+		/* Flip so the contact goes from A to B */
+		kk_math_vec3_scale(&out__contact->normal, -1.0f, &out__contact->normal);
+		temp = out__contact->point_a;
+		out__contact->point_a = out__contact->point_b;
+		out__contact->point_b = temp;
+		return TRUE;
+	}
+
+	return collide_mpr(&pa, &pb, out__contact);
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Finds the point of a triangle closest to the origin.
+*/
+static void closest_to_origin(kk_vec3_t* a, kk_vec3_t* b, kk_vec3_t* c, kk_vec3_t* out__point)
+{
+	kk_vec3_t ab, ac, ap, bp, cp;
+	float d1, d2, d3, d4, d5, d6;
+	float va, vb, vc;
+	float v, w, denom;
+
+	kk_math_vec3_sub(b, a, &ab);
+	kk_math_vec3_sub(c, a, &ac);
+	kk_math_vec3_scale(a, -1.0f, &ap);
+
+	/* Vertex region A */
+	d1 = kk_math_vec3_dot(&ab, &ap);
+	d2 = kk_math_vec3_dot(&ac, &ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+	{
+		*out__point = *a;
+		return;
+	}
+
+	/* Vertex region B */
+	kk_math_vec3_scale(b, -1.0f, &bp);
+	d3 = kk_math_vec3_dot(&ab, &bp);
+	d4 = kk_math_vec3_dot(&ac, &bp);
+	if (d3 >= 0.0f && d4 <= d3)
+	{
+		*out__point = *b;
+		return;
+	}
+
+	/* Edge region AB */
+	vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+	{
+		v = d1 / (d1 - d3);
+		kk_math_vec3_scale(&ab, v, &ab);
+		kk_math_vec3_add(a, &ab, out__point);
+		return;
+	}
+
+	/* Vertex region C */
+	kk_math_vec3_scale(c, -1.0f, &cp);
+	d5 = kk_math_vec3_dot(&ab, &cp);
+	d6 = kk_math_vec3_dot(&ac, &cp);
+	if (d6 >= 0.0f && d5 <= d6)
+	{
+		*out__point = *c;
+		return;
+	}
+
+	/* Edge region AC */
+	vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+	{
+		w = d2 / (d2 - d6);
+		kk_math_vec3_scale(&ac, w, &ac);
+		kk_math_vec3_add(a, &ac, out__point);
+		return;
+	}
+
+	/* Edge region BC */
+	va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+	{
+		w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		kk_math_vec3_sub(c, b, &bp);
+		kk_math_vec3_scale(&bp, w, &bp);
+		kk_math_vec3_add(b, &bp, out__point);
+		return;
+	}
+
+	/* Face region */
+	denom = 1.0f / (va + vb + vc);
+	v = vb * denom;
+	w = vc * denom;
+	kk_math_vec3_scale(&ab, v, &ab);
+	kk_math_vec3_scale(&ac, w, &ac);
+	kk_math_vec3_add(a, &ab, out__point);
+	kk_math_vec3_add(out__point, &ac, out__point);
+}
+
+//## static
+/**
+Box against sphere. The normal points from the box to the sphere.
+*/
+static boolean collide_box_sphere(posed_shape_t* box, posed_shape_t* sphere, kk_narrowphase_contact_t* out__contact)
+{
+	kk_mat4_t* m = box->m;
+	kk_vec3_t origin;
+	kk_vec3_t center;
+	kk_vec3_t axes[3];
+	kk_vec3_t closest;
+	kk_vec3_t d;
+	float extents[3];
+	float local[3];
+	float clamped[3];
+	float radius;
+	float dist;
+	float best;
+	boolean inside;
+	int best_axis;
+	int i;
+
+	transform_point(box->m, &box->shape->center, &origin);
+	transform_point(sphere->m, &sphere->shape->center, &center);
+	radius = sphere->shape->radius * get_max_scale(sphere->m);
+
+	/* Sphere center in the box's frame */
+	kk_math_vec3_sub(&center, &origin, &d);
+	inside = TRUE;
+
+	axes[0].x = m->x.x; axes[0].y = m->x.y; axes[0].z = m->x.z;
+	axes[1].x = m->y.x; axes[1].y = m->y.y; axes[1].z = m->y.z;
+	axes[2].x = m->z.x; axes[2].y = m->z.y; axes[2].z = m->z.z;
+
+	for (i = 0; i < 3; ++i)
+	{
+		extents[i] = ((float*)&box->shape->half_extents)[i] * kk_math_vec3_norm(&axes[i]);
+		kk_math_vec3_normalize(&axes[i]);
+
+		local[i] = kk_math_vec3_dot(&d, &axes[i]);
+		clamped[i] = max(-extents[i], min(extents[i], local[i]));
+		inside = inside && (clamped[i] == local[i]);
+	}
+
+	if (inside)
+	{
+		/* Push out through the nearest face */
+		best_axis = 0;
+		best = FLT_MAX;
+		for (i = 0; i < 3; ++i)
+		{
+			dist = extents[i] - fabsf(local[i]);
+			if (dist < best)
+			{
+				best = dist;
+				best_axis = i;
+			}
+		}
+
+		clamped[best_axis] = (local[best_axis] < 0.0f) ? -extents[best_axis] : extents[best_axis];
+		kk_math_vec3_scale(&axes[best_axis], (local[best_axis] < 0.0f) ? -1.0f : 1.0f, &out__contact->normal);
+		out__contact->depth = best + radius;
+	}
+
+	/* Closest point on the box */
+	closest = origin;
+	for (i = 0; i < 3; ++i)
+	{
+		kk_math_vec3_scale(&axes[i], clamped[i], &d);
+		kk_math_vec3_add(&closest, &d, &closest);
+	}
+
+	if (!inside)
+	{
+		kk_math_vec3_sub(&center, &closest, &d);
+		dist = kk_math_vec3_norm(&d);
+		if (dist > radius || dist < EPSILON)
+		{
+			return FALSE;
+		}
+
+		kk_math_vec3_scale(&d, 1.0f / dist, &out__contact->normal);
+		out__contact->depth = radius - dist;
+	}
+
+	out__contact->point_a = closest;
+	kk_math_vec3_scale(&out__contact->normal, -radius, &d);
+	kk_math_vec3_add(&center, &d, &out__contact->point_b);
+
+	return TRUE;
+}
+
+//## static
+/**
+Minkowski Portal Refinement. Finds a portal triangle on the boundary of
+A - B that the ray from an interior point to the origin passes through,
+refines it until it contains the origin, then pushes it out to the boundary
+for the penetration depth.
+*/
+static boolean collide_mpr(posed_shape_t* a, posed_shape_t* b, kk_narrowphase_contact_t* out__contact)
+{
+	mpr_point_t v0, v1, v2, v3, v4;
+	mpr_point_t swap;
+	kk_vec3_t dir;
+	kk_vec3_t e1, e2;
+	kk_vec3_t temp;
+	int iterations;
+
+	/*
+	Discover portal
+	*/
+
+	/* Interior point of A - B */
+	transform_point(a->m, &a->shape->center, &v0.a);
+	transform_point(b->m, &b->shape->center, &v0.b);
+	kk_math_vec3_sub(&v0.a, &v0.b, &v0.v);
+	if (kk_math_vec3_dot(&v0.v, &v0.v) < EPSILON)
+	{
+		/* Centers coincide, any direction will do */
+		v0.v.x += 10.0f * EPSILON;
+	}
+
+	kk_math_vec3_scale(&v0.v, -1.0f, &dir);
+	kk_math_vec3_normalize(&dir);
+	mpr_support(a, b, &dir, &v1);
+	if (kk_math_vec3_dot(&v1.v, &dir) <= 0.0f)
+	{
+		return FALSE;
+	}
+
+	kk_math_cross(&v0.v, &v1.v, &dir);
+	if (kk_math_vec3_dot(&dir, &dir) < EPSILON)
+	{
+		/* Origin lies on the segment from v0 to v1 */
+		out__contact->normal = v1.v;
+		kk_math_vec3_normalize(&out__contact->normal);
+		out__contact->depth = kk_math_vec3_norm(&v1.v);
+		out__contact->point_a = v1.a;
+		out__contact->point_b = v1.b;
+		return TRUE;
+	}
+
+	kk_math_vec3_normalize(&dir);
+	mpr_support(a, b, &dir, &v2);
+	if (kk_math_vec3_dot(&v2.v, &dir) <= 0.0f)
+	{
+		return FALSE;
+	}
+
+	kk_math_vec3_sub(&v1.v, &v0.v, &e1);
+	kk_math_vec3_sub(&v2.v, &v0.v, &e2);
+	kk_math_cross(&e1, &e2, &dir);
+	kk_math_vec3_normalize(&dir);
+
+	/* Wind the portal so its normal faces away from v0 */
+	if (kk_math_vec3_dot(&dir, &v0.v) > 0.0f)
+	{
+		swap = v1; v1 = v2; v2 = swap;
+		kk_math_vec3_scale(&dir, -1.0f, &dir);
+	}
+
+	for (iterations = 0; ; ++iterations)
+	{
+		if (iterations == MPR_MAX_ITERATIONS)
+		{
+			return FALSE;
+		}
+
+		mpr_support(a, b, &dir, &v3);
+		if (kk_math_vec3_dot(&v3.v, &dir) <= 0.0f)
+		{
+			return FALSE;
+		}
+
+		/* Origin outside the v0, v1, v3 plane, replace v2 */
+		kk_math_cross(&v1.v, &v3.v, &temp);
+		if (kk_math_vec3_dot(&temp, &v0.v) < 0.0f)
+		{
+			v2 = v3;
+			kk_math_vec3_sub(&v1.v, &v0.v, &e1);
+			kk_math_vec3_sub(&v3.v, &v0.v, &e2);
+			kk_math_cross(&e1, &e2, &dir);
+			kk_math_vec3_normalize(&dir);
+			continue;
+		}
+
+		/* Origin outside the v0, v3, v2 plane, replace v1 */
+		kk_math_cross(&v3.v, &v2.v, &temp);
+		if (kk_math_vec3_dot(&temp, &v0.v) < 0.0f)
+		{
+			v1 = v3;
+			kk_math_vec3_sub(&v3.v, &v0.v, &e1);
+			kk_math_vec3_sub(&v2.v, &v0.v, &e2);
+			kk_math_cross(&e1, &e2, &dir);
+			kk_math_vec3_normalize(&dir);
+			continue;
+		}
+
+		break;
+	}
+
+	/*
+	Refine until the portal contains the origin
+	*/
+
+	for (iterations = 0; ; ++iterations)
+	{
+		get_portal_dir(&v1, &v2, &v3, &dir);
+		if (kk_math_vec3_dot(&dir, &v1.v) >= 0.0f)
+		{
+			break;
+		}
+
+		mpr_support(a, b, &dir, &v4);
+		if (kk_math_vec3_dot(&v4.v, &dir) < 0.0f
+		 || iterations == MPR_MAX_ITERATIONS
+		 || reached_tolerance(&v1, &v2, &v3, &v4, &dir))
+		{
+			return FALSE;
+		}
+
+		expand_portal(&v0, &v1, &v2, &v3, &v4);
+	}
+
+	/*
+	Push the portal out to the boundary
+	*/
+
+	for (iterations = 0; ; ++iterations)
+	{
+		get_portal_dir(&v1, &v2, &v3, &dir);
+		mpr_support(a, b, &dir, &v4);
+
+		if (iterations == MPR_MAX_ITERATIONS || reached_tolerance(&v1, &v2, &v3, &v4, &dir))
+		{
+			break;
+		}
+
+		expand_portal(&v0, &v1, &v2, &v3, &v4);
+	}
+
+	closest_to_origin(&v1.v, &v2.v, &v3.v, &temp);
+	out__contact->depth = kk_math_vec3_norm(&temp);
+	if (out__contact->depth > EPSILON)
+	{
+		kk_math_vec3_scale(&temp, 1.0f / out__contact->depth, &out__contact->normal);
+	}
+	else
+	{
+		out__contact->normal = dir;
+	}
+
+	/* Contact points either side of where the origin maps onto A and B */
+	find_position(&v0, &v1, &v2, &v3, &dir, &temp);
+	kk_math_vec3_scale(&out__contact->normal, 0.5f * out__contact->depth, &e1);
+	kk_math_vec3_add(&temp, &e1, &out__contact->point_a);
+	kk_math_vec3_sub(&temp, &e1, &out__contact->point_b);
+
+	return TRUE;
+}
+
+//## static
+/**
+Sphere against sphere.
+*/
+static boolean collide_spheres(posed_shape_t* a, posed_shape_t* b, kk_narrowphase_contact_t* out__contact)
+{
+	kk_vec3_t ca;
+	kk_vec3_t cb;
+	kk_vec3_t d;
+	float ra;
+	float rb;
+	float dist;
+
+	transform_point(a->m, &a->shape->center, &ca);
+	transform_point(b->m, &b->shape->center, &cb);
+	ra = a->shape->radius * get_max_scale(a->m);
+	rb = b->shape->radius * get_max_scale(b->m);
+
+	kk_math_vec3_sub(&cb, &ca, &d);
+	dist = kk_math_vec3_norm(&d);
+	if (dist > ra + rb)
+	{
+		return FALSE;
+	}
+
+	if (dist > EPSILON)
+	{
+		kk_math_vec3_scale(&d, 1.0f / dist, &out__contact->normal);
+	}
+	else
+	{
+		out__contact->normal.x = 0.0f;
+		out__contact->normal.y = 1.0f;
+		out__contact->normal.z = 0.0f;
+	}
+
+	out__contact->depth = ra + rb - dist;
+
+	kk_math_vec3_scale(&out__contact->normal, ra, &d);
+	kk_math_vec3_add(&ca, &d, &out__contact->point_a);
+	kk_math_vec3_scale(&out__contact->normal, -rb, &d);
+	kk_math_vec3_add(&cb, &d, &out__contact->point_b);
+
+	return TRUE;
+}
+
+//## static
+/**
+Replaces one portal point with a new support point so the portal stays on
+the ray from v0 to the origin.
+*/
+static void expand_portal(mpr_point_t* v0, mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, mpr_point_t* v4)
+{
+	kk_vec3_t v4v0;
+
+	kk_math_cross(&v4->v, &v0->v, &v4v0);
+
+	if (kk_math_vec3_dot(&v1->v, &v4v0) > 0.0f)
+	{
+		if (kk_math_vec3_dot(&v2->v, &v4v0) > 0.0f)
+		{
+			*v1 = *v4;
+		}
+		else
+		{
+			*v3 = *v4;
+		}
+	}
+	else
+	{
+		if (kk_math_vec3_dot(&v3->v, &v4v0) > 0.0f)
+		{
+			*v2 = *v4;
+		}
+		else
+		{
+			*v1 = *v4;
+		}
+	}
+}
+
+//## static
+/**
+Finds where the origin maps onto A and B using its barycentric coordinates
+in the tetrahedron v0, v1, v2, v3. Returns the midpoint of the two.
+*/
+static void find_position(mpr_point_t* v0, mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, kk_vec3_t* dir, kk_vec3_t* out__pos)
+{
+	mpr_point_t* pts[4];
+	kk_vec3_t temp;
+	kk_vec3_t pa;
+	kk_vec3_t pb;
+	float weights[4];
+	float sum;
+	int i;
+
+	pts[0] = v0; pts[1] = v1; pts[2] = v2; pts[3] = v3;
+
+	kk_math_cross(&v1->v, &v2->v, &temp);
+	weights[0] = kk_math_vec3_dot(&temp, &v3->v);
+	kk_math_cross(&v3->v, &v2->v, &temp);
+	weights[1] = kk_math_vec3_dot(&temp, &v0->v);
+	kk_math_cross(&v0->v, &v1->v, &temp);
+	weights[2] = kk_math_vec3_dot(&temp, &v3->v);
+	kk_math_cross(&v2->v, &v1->v, &temp);
+	weights[3] = kk_math_vec3_dot(&temp, &v0->v);
+	sum = weights[0] + weights[1] + weights[2] + weights[3];
+
+	if (sum <= 0.0f)
+	{
+		/* Origin is on the portal, use the portal triangle alone */
+		weights[0] = 0.0f;
+		kk_math_cross(&v2->v, &v3->v, &temp);
+		weights[1] = kk_math_vec3_dot(&temp, dir);
+		kk_math_cross(&v3->v, &v1->v, &temp);
+		weights[2] = kk_math_vec3_dot(&temp, dir);
+		kk_math_cross(&v1->v, &v2->v, &temp);
+		weights[3] = kk_math_vec3_dot(&temp, dir);
+		sum = weights[1] + weights[2] + weights[3];
+	}
+
+	clear_struct(&pa);
+	clear_struct(&pb);
+
+	for (i = 0; i < 4; ++i)
+	{
+		kk_math_vec3_scale(&pts[i]->a, weights[i], &temp);
+		kk_math_vec3_add(&pa, &temp, &pa);
+		kk_math_vec3_scale(&pts[i]->b, weights[i], &temp);
+		kk_math_vec3_add(&pb, &temp, &pb);
+	}
+
+	kk_math_vec3_add(&pa, &pb, out__pos);
+	kk_math_vec3_scale(out__pos, (sum != 0.0f) ? 0.5f / sum : 0.0f, out__pos);
+}
+
+//## static
+/**
+Gets the largest scale along any of a matrix's axes.
+*/
+static float get_max_scale(kk_mat4_t* m)
+{
+	float sx = m->x.x * m->x.x + m->x.y * m->x.y + m->x.z * m->x.z;
+	float sy = m->y.x * m->y.x + m->y.y * m->y.y + m->y.z * m->y.z;
+	float sz = m->z.x * m->z.x + m->z.y * m->z.y + m->z.z * m->z.z;
+
+	return sqrtf(max(max(sx, sy), sz));
+}
+
+//## static
+/**
+Gets the outward normal of the portal triangle.
+*/
+static void get_portal_dir(mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, kk_vec3_t* out__dir)
+{
+	kk_vec3_t e1;
+	kk_vec3_t e2;
+
+	kk_math_vec3_sub(&v2->v, &v1->v, &e1);
+	kk_math_vec3_sub(&v3->v, &v1->v, &e2);
+	kk_math_cross(&e1, &e2, out__dir);
+	kk_math_vec3_normalize(out__dir);
+}
+
+//## static
+/**
+Gets the support point of A - B in a direction.
+*/
+static void mpr_support(posed_shape_t* a, posed_shape_t* b, kk_vec3_t* dir, mpr_point_t* out__point)
+{
+	kk_vec3_t neg;
+
+	support(a, dir, &out__point->a);
+	kk_math_vec3_scale(dir, -1.0f, &neg);
+	support(b, &neg, &out__point->b);
+	kk_math_vec3_sub(&out__point->a, &out__point->b, &out__point->v);
+}
+
+//## static
+/**
+Checks if a new support point is too close to the portal to refine further.
+*/
+static boolean reached_tolerance(mpr_point_t* v1, mpr_point_t* v2, mpr_point_t* v3, mpr_point_t* v4, kk_vec3_t* dir)
+{
+	float d4 = kk_math_vec3_dot(&v4->v, dir);
+	float d1 = d4 - kk_math_vec3_dot(&v1->v, dir);
+	float d2 = d4 - kk_math_vec3_dot(&v2->v, dir);
+	float d3 = d4 - kk_math_vec3_dot(&v3->v, dir);
+
+	return min(min(d1, d2), d3) <= MPR_TOLERANCE;
+}
+
+//## static
+/**
+Gets the world space support point of a posed shape. The direction is taken
+into model space with the transpose of the matrix, which is exact for any
+affine matrix.
+*/
+static void support(posed_shape_t* p, kk_vec3_t* dir, kk_vec3_t* out__point)
+{
+	kk_mat4_t* m = p->m;
+	kk_vec3_t local_dir;
+	kk_vec3_t local;
+
+	local_dir.x = m->x.x * dir->x + m->x.y * dir->y + m->x.z * dir->z;
+	local_dir.y = m->y.x * dir->x + m->y.y * dir->y + m->y.z * dir->z;
+	local_dir.z = m->z.x * dir->x + m->z.y * dir->y + m->z.z * dir->z;
+
+	kk_shape__support(p->shape, &local_dir, &local);
+	transform_point(m, &local, out__point);
+}
+
+//## static
+/**
+Transforms a point by an affine matrix.
+*/
+static void transform_point(kk_mat4_t* m, kk_vec3_t* p, kk_vec3_t* out__point)
+{
+	kk_vec3_t v = *p;
+
+	out__point->x = m->x.x * v.x + m->y.x * v.y + m->z.x * v.z + m->w.x;
+	out__point->y = m->x.y * v.x + m->y.y * v.y + m->z.y * v.z + m->w.y;
+	out__point->z = m->x.z * v.x + m->y.z * v.y + m->z.z * v.z + m->w.z;
+}
\ No newline at end of file
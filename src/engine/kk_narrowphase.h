@@ -0,0 +1,39 @@
+#ifndef KK_NARROWPHASE_H
+#define KK_NARROWPHASE_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_narrowphase_.h"
+#include "engine/kk_shape_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Deepest point of contact between two overlapping shapes.
+*/
+struct kk_narrowphase_contact_s
+{
+	kk_vec3_t			normal;			/* Unit normal pointing from A to B. */
+	kk_vec3_t			point_a;		/* Point on A's surface, world space. */
+	kk_vec3_t			point_b;		/* Point on B's surface, world space. */
+	float				depth;			/* Penetration along the normal. dot(point_a - point_b, normal). */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_narrowphase.public.h"
+
+#endif /* KK_NARROWPHASE_H */
\ No newline at end of file
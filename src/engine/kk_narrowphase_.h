@@ -0,0 +1,10 @@
+#ifndef KK_NARROWPHASE__H
+#define KK_NARROWPHASE__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_narrowphase_contact_s kk_narrowphase_contact_t;
+
+#endif /* KK_NARROWPHASE__H */
\ No newline at end of file
@@ -0,0 +1,541 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <math.h>
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_transform.h"
+#include "engine/kk_log.h"
+#include "engine/kk_math.h"
+#include "engine/kk_physics_bodies.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define NUM_ARRAYS 32				/* Number of float arrays in the body state. */
+#define CAPACITY_GRANULARITY 64		/* Capacity is rounded up to a multiple of this. Must be a multiple of KK_PHYSICS_BODIES_WIDTH. */
+
+/*=========================================================
+SIMD
+=========================================================*/
+
+/*
+Thin wrappers over the intrinsics picked up by cglm's simd/intrin.h. The
+batch integrator is written once against these.
+*/
+
+#if defined(CGLM_AVX_FP)
+	typedef __m256 simd_t;
+	typedef __m256 simd_mask_t;
+	#define simd_load(p)			_mm256_loadu_ps(p)
+	#define simd_store(p, a)		_mm256_storeu_ps(p, a)
+	#define simd_set1(s)			_mm256_set1_ps(s)
+	#define simd_add(a, b)			_mm256_add_ps(a, b)
+	#define simd_sub(a, b)			_mm256_sub_ps(a, b)
+	#define simd_mul(a, b)			_mm256_mul_ps(a, b)
+	#define simd_rsqrt(a)			_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(a))
+	#define simd_gt(a, b)			_mm256_cmp_ps(a, b, _CMP_GT_OQ)
+	#define simd_select(m, a, b)	_mm256_blendv_ps(b, a, m)
+#elif defined(CGLM_SSE_FP)
+	typedef __m128 simd_t;
+	typedef __m128 simd_mask_t;
+	#define simd_load(p)			_mm_loadu_ps(p)
+	#define simd_store(p, a)		_mm_storeu_ps(p, a)
+	#define simd_set1(s)			_mm_set1_ps(s)
+	#define simd_add(a, b)			_mm_add_ps(a, b)
+	#define simd_sub(a, b)			_mm_sub_ps(a, b)
+	#define simd_mul(a, b)			_mm_mul_ps(a, b)
+	#define simd_rsqrt(a)			_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a))
+	#define simd_gt(a, b)			_mm_cmpgt_ps(a, b)
+	#define simd_select(m, a, b)	_mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#elif defined(CGLM_NEON_FP)
+	typedef float32x4_t simd_t;
+	typedef uint32x4_t simd_mask_t;
+	#define simd_load(p)			vld1q_f32(p)
+	#define simd_store(p, a)		vst1q_f32(p, a)
+	#define simd_set1(s)			vdupq_n_f32(s)
+	#define simd_add(a, b)			vaddq_f32(a, b)
+	#define simd_sub(a, b)			vsubq_f32(a, b)
+	#define simd_mul(a, b)			vmulq_f32(a, b)
+	#define simd_rsqrt(a)			neon_rsqrt(a)
+	#define simd_gt(a, b)			vcgtq_f32(a, b)
+	#define simd_select(m, a, b)	vbslq_f32(m, a, b)
+
+	/* Reciprocal square root estimate refined with two Newton-Raphson steps */
+	static inline float32x4_t neon_rsqrt(float32x4_t a)
+	{
+		float32x4_t e = vrsqrteq_f32(a);
+		e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+		e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+		return e;
+	}
+#endif
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+static void integrate_scalar(kk_physics_bodies_t* bodies, uint32_t i, float delta_time);
+
+#if KK_PHYSICS_BODIES_WIDTH > 1
+static void integrate_simd(kk_physics_bodies_t* bodies, uint32_t i, float delta_time);
+#endif
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty set of bodies.
+
+@param bodies The bodies to construct.
+*/
+void kk_physics_bodies__construct(kk_physics_bodies_t* bodies)
+{
+	clear_struct(bodies);
+}
+
+//## public
+/**
+Destructs a set of bodies.
+
+@param bodies The bodies to destruct.
+*/
+void kk_physics_bodies__destruct(kk_physics_bodies_t* bodies)
+{
+	free(bodies->data);
+	free(bodies->phys);
+	free(bodies->transform);
+	free(bodies->entities);
+	clear_struct(bodies);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Copies body state from the components matched by a query into the arrays.
+The query must require both the physics and transform components. Sleeping
+bodies are skipped.
+
+@param bodies The bodies.
+@param ecs The ECS context.
+@param query The query to gather.
+*/
+void kk_physics_bodies__gather(kk_physics_bodies_t* bodies, ecs_t* ecs, ecs_query_t* query)
+{
+	uint32_t count = ecs_query__get_count(query);
+	uint32_t i;
+	uint32_t j;
+	int a;
+
+	kk_physics_bodies__reserve(bodies, count);
+	bodies->count = 0;
+
+	for (j = 0; j < count; ++j)
+	{
+		entity_id_t ent = ecs_query__get_entity(query, j);
+		ecs_physics_t* phys = ecs_physics__get(ecs, ent);
+		ecs_transform_t* transform;
+
+		if (phys->sleeping)
+		{
+			continue;
+		}
+
+		i = bodies->count++;
+		transform = ecs_transform__get(ecs, ent);
+
+		bodies->phys[i] = phys;
+		bodies->transform[i] = transform;
+		bodies->entities[i] = ent;
+
+		bodies->pos[0][i] = transform->pos.x;
+		bodies->pos[1][i] = transform->pos.y;
+		bodies->pos[2][i] = transform->pos.z;
+
+		bodies->rot[0][i] = transform->rot.x;
+		bodies->rot[1][i] = transform->rot.y;
+		bodies->rot[2][i] = transform->rot.z;
+		bodies->rot[3][i] = transform->rot.w;
+
+		for (a = 0; a < 3; ++a) { bodies->prev_pos[a][i] = bodies->pos[a][i]; }
+		for (a = 0; a < 4; ++a) { bodies->prev_rot[a][i] = bodies->rot[a][i]; }
+
+		bodies->momentum[0][i] = phys->momentum.x;
+		bodies->momentum[1][i] = phys->momentum.y;
+		bodies->momentum[2][i] = phys->momentum.z;
+
+		bodies->velocity[0][i] = phys->velocity.x;
+		bodies->velocity[1][i] = phys->velocity.y;
+		bodies->velocity[2][i] = phys->velocity.z;
+
+		bodies->inverse_mass[i] = phys->inverse_mass;
+
+		bodies->angular_momentum[0][i] = phys->angular_momentum.x;
+		bodies->angular_momentum[1][i] = phys->angular_momentum.y;
+		bodies->angular_momentum[2][i] = phys->angular_momentum.z;
+
+		bodies->angular_velocity[0][i] = phys->angular_velocity.x;
+		bodies->angular_velocity[1][i] = phys->angular_velocity.y;
+		bodies->angular_velocity[2][i] = phys->angular_velocity.z;
+
+		bodies->spin[0][i] = phys->spin.x;
+		bodies->spin[1][i] = phys->spin.y;
+		bodies->spin[2][i] = phys->spin.z;
+		bodies->spin[3][i] = phys->spin.w;
+
+		bodies->inverse_inertia[i] = phys->inverse_inertia;
+	}
+}
+
+//## public
+/**
+Integrates all bodies using the widest SIMD path available.
+
+@param bodies The bodies.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate(kk_physics_bodies_t* bodies, float delta_time)
+{
+	kk_physics_bodies__integrate_range(bodies, 0, bodies->count, delta_time);
+}
+
+//## public
+/**
+Integrates a range of bodies. Groups of KK_PHYSICS_BODIES_WIDTH bodies are
+integrated with SIMD and any remainder with the scalar path. Ranges that do
+not overlap may be integrated concurrently.
+
+@param bodies The bodies.
+@param start The first body to integrate.
+@param end One past the last body to integrate.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate_range(kk_physics_bodies_t* bodies, uint32_t start, uint32_t end, float delta_time)
+{
+	uint32_t i = start;
+
+#if KK_PHYSICS_BODIES_WIDTH > 1
+	for (; i + KK_PHYSICS_BODIES_WIDTH <= end; i += KK_PHYSICS_BODIES_WIDTH)
+	{
+		integrate_simd(bodies, i, delta_time);
+	}
+#endif
+
+	for (; i < end; ++i)
+	{
+		integrate_scalar(bodies, i, delta_time);
+	}
+}
+
+//## public
+/**
+Integrates all bodies one at a time without SIMD. Produces the same results
+as kk_physics_bodies__integrate within floating point rounding.
+
+@param bodies The bodies.
+@param delta_time The time step in seconds.
+*/
+void kk_physics_bodies__integrate_scalar(kk_physics_bodies_t* bodies, float delta_time)
+{
+	uint32_t i;
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		integrate_scalar(bodies, i, delta_time);
+	}
+}
+
+//## public
+/**
+Ensures the arrays can hold the specified number of bodies. Existing body
+state is discarded if the arrays need to grow.
+
+@param bodies The bodies.
+@param count The number of bodies required.
+*/
+void kk_physics_bodies__reserve(kk_physics_bodies_t* bodies, uint32_t count)
+{
+	uint32_t capacity;
+	float* base;
+	int a;
+
+	if (count <= bodies->capacity)
+	{
+		return;
+	}
+
+	capacity = (count + CAPACITY_GRANULARITY - 1) & ~(uint32_t)(CAPACITY_GRANULARITY - 1);
+
+	free(bodies->data);
+	free(bodies->phys);
+	free(bodies->transform);
+	free(bodies->entities);
+
+	bodies->data = (float*)calloc((size_t)capacity * NUM_ARRAYS, sizeof(float));
+	bodies->phys = (ecs_physics_t**)malloc(sizeof(ecs_physics_t*) * capacity);
+	bodies->transform = (ecs_transform_t**)malloc(sizeof(ecs_transform_t*) * capacity);
+	bodies->entities = (entity_id_t*)malloc(sizeof(entity_id_t) * capacity);
+	if (!bodies->data || !bodies->phys || !bodies->transform || !bodies->entities)
+	{
+		kk_log__fatal("Failed to allocate physics bodies.");
+	}
+
+	bodies->capacity = capacity;
+	bodies->count = 0;
+
+	/* Carve the arrays out of the single allocation */
+	base = bodies->data;
+	for (a = 0; a < 3; ++a) { bodies->pos[a] = base; base += capacity; }
+	for (a = 0; a < 4; ++a) { bodies->rot[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { bodies->prev_pos[a] = base; base += capacity; }
+	for (a = 0; a < 4; ++a) { bodies->prev_rot[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { bodies->momentum[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { bodies->velocity[a] = base; base += capacity; }
+	bodies->inverse_mass = base; base += capacity;
+	for (a = 0; a < 3; ++a) { bodies->angular_momentum[a] = base; base += capacity; }
+	for (a = 0; a < 3; ++a) { bodies->angular_velocity[a] = base; base += capacity; }
+	for (a = 0; a < 4; ++a) { bodies->spin[a] = base; base += capacity; }
+	bodies->inverse_inertia = base;
+}
+
+//## public
+/**
+Saves the current position and orientation of a range of bodies as the
+previous state. Call before the last step of a tick so rendering can blend
+from it. Ranges that do not overlap may be saved concurrently.
+
+@param bodies The bodies.
+@param start The first body to save.
+@param end One past the last body to save.
+*/
+void kk_physics_bodies__save_previous_range(kk_physics_bodies_t* bodies, uint32_t start, uint32_t end)
+{
+	size_t size = sizeof(float) * (end - start);
+	int a;
+
+	for (a = 0; a < 3; ++a) { memcpy(bodies->prev_pos[a] + start, bodies->pos[a] + start, size); }
+	for (a = 0; a < 4; ++a) { memcpy(bodies->prev_rot[a] + start, bodies->rot[a] + start, size); }
+}
+
+//## public
+/**
+Copies integrated body state back to the source components and marks the
+transforms dirty. Momentum is copied too since contacts change it. The
+state from before the last step is copied to the transforms' previous pose
+for interpolation.
+
+@param bodies The bodies.
+@param ecs The ECS context the bodies were gathered from.
+*/
+void kk_physics_bodies__scatter(kk_physics_bodies_t* bodies, ecs_t* ecs)
+{
+	uint32_t i;
+
+	for (i = 0; i < bodies->count; ++i)
+	{
+		ecs_physics_t* phys = bodies->phys[i];
+		ecs_transform_t* transform = bodies->transform[i];
+
+		transform->pos.x = bodies->pos[0][i];
+		transform->pos.y = bodies->pos[1][i];
+		transform->pos.z = bodies->pos[2][i];
+
+		transform->rot.x = bodies->rot[0][i];
+		transform->rot.y = bodies->rot[1][i];
+		transform->rot.z = bodies->rot[2][i];
+		transform->rot.w = bodies->rot[3][i];
+
+		transform->prev_pos.x = bodies->prev_pos[0][i];
+		transform->prev_pos.y = bodies->prev_pos[1][i];
+		transform->prev_pos.z = bodies->prev_pos[2][i];
+
+		transform->prev_rot.x = bodies->prev_rot[0][i];
+		transform->prev_rot.y = bodies->prev_rot[1][i];
+		transform->prev_rot.z = bodies->prev_rot[2][i];
+		transform->prev_rot.w = bodies->prev_rot[3][i];
+
+		/* Only bodies that moved need blending */
+		transform->interpolated = memcmp(&transform->prev_pos, &transform->pos, sizeof(transform->pos))
+			|| memcmp(&transform->prev_rot, &transform->rot, sizeof(transform->rot));
+
+		phys->momentum.x = bodies->momentum[0][i];
+		phys->momentum.y = bodies->momentum[1][i];
+		phys->momentum.z = bodies->momentum[2][i];
+
+		phys->angular_momentum.x = bodies->angular_momentum[0][i];
+		phys->angular_momentum.y = bodies->angular_momentum[1][i];
+		phys->angular_momentum.z = bodies->angular_momentum[2][i];
+
+		phys->velocity.x = bodies->velocity[0][i];
+		phys->velocity.y = bodies->velocity[1][i];
+		phys->velocity.z = bodies->velocity[2][i];
+
+		phys->angular_velocity.x = bodies->angular_velocity[0][i];
+		phys->angular_velocity.y = bodies->angular_velocity[1][i];
+		phys->angular_velocity.z = bodies->angular_velocity[2][i];
+
+		phys->spin.x = bodies->spin[0][i];
+		phys->spin.y = bodies->spin[1][i];
+		phys->spin.z = bodies->spin[2][i];
+		phys->spin.w = bodies->spin[3][i];
+
+		ecs_transform__set_dirty(ecs, transform);
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+/**
+Integrates a single body.
+*/
+static void integrate_scalar(kk_physics_bodies_t* bodies, uint32_t i, float delta_time)
+{
+	float qx, qy, qz, qw;
+	float wx, wy, wz;
+	float dot;
+
+	/*
+	Linear
+	*/
+
+	// pos = pos + vel * dt
+	bodies->pos[0][i] += bodies->velocity[0][i] * delta_time;
+	bodies->pos[1][i] += bodies->velocity[1][i] * delta_time;
+	bodies->pos[2][i] += bodies->velocity[2][i] * delta_time;
+
+	// velocity = momentum * inverse_mass
+	bodies->velocity[0][i] = bodies->momentum[0][i] * bodies->inverse_mass[i];
+	bodies->velocity[1][i] = bodies->momentum[1][i] * bodies->inverse_mass[i];
+	bodies->velocity[2][i] = bodies->momentum[2][i] * bodies->inverse_mass[i];
+
+	/*
+	Rotational
+	*/
+
+	// orientation = orientation + spin * dt
+	qx = bodies->rot[0][i] + bodies->spin[0][i] * delta_time;
+	qy = bodies->rot[1][i] + bodies->spin[1][i] * delta_time;
+	qz = bodies->rot[2][i] + bodies->spin[2][i] * delta_time;
+	qw = bodies->rot[3][i] + bodies->spin[3][i] * delta_time;
+
+	/* Normalize, zero length becomes identity */
+	dot = qx * qx + qy * qy + qz * qz + qw * qw;
+	if (dot > 0.0f)
+	{
+		float inv_len = 1.0f / sqrtf(dot);
+		qx *= inv_len;
+		qy *= inv_len;
+		qz *= inv_len;
+		qw *= inv_len;
+	}
+	else
+	{
+		qx = qy = qz = 0.0f;
+		qw = 1.0f;
+	}
+
+	bodies->rot[0][i] = qx;
+	bodies->rot[1][i] = qy;
+	bodies->rot[2][i] = qz;
+	bodies->rot[3][i] = qw;
+
+	// angular velocity = angular momentum * inverse inertia
+	wx = bodies->angular_momentum[0][i] * bodies->inverse_inertia[i];
+	wy = bodies->angular_momentum[1][i] * bodies->inverse_inertia[i];
+	wz = bodies->angular_momentum[2][i] * bodies->inverse_inertia[i];
+
+	bodies->angular_velocity[0][i] = wx;
+	bodies->angular_velocity[1][i] = wy;
+	bodies->angular_velocity[2][i] = wz;
+
+	// spin = 0.5 * (w * q), w = (wx, wy, wz, 0)
+	bodies->spin[0][i] = 0.5f * (wx * qw + wy * qz - wz * qy);
+	bodies->spin[1][i] = 0.5f * (-wx * qz + wy * qw + wz * qx);
+	bodies->spin[2][i] = 0.5f * (wx * qy - wy * qx + wz * qw);
+	bodies->spin[3][i] = 0.5f * (-wx * qx - wy * qy - wz * qz);
+}
+
+#if KK_PHYSICS_BODIES_WIDTH > 1
+/**
+Integrates KK_PHYSICS_BODIES_WIDTH bodies starting at the specified index.
+Same math as integrate_scalar.
+*/
+static void integrate_simd(kk_physics_bodies_t* bodies, uint32_t i, float delta_time)
+{
+	simd_t dt = simd_set1(delta_time);
+	simd_t half = simd_set1(0.5f);
+	simd_t zero = simd_set1(0.0f);
+	simd_t one = simd_set1(1.0f);
+	simd_t inv_mass, inv_inertia;
+	simd_t qx, qy, qz, qw;
+	simd_t wx, wy, wz;
+	simd_t dot, inv_len;
+	simd_mask_t valid;
+	int a;
+
+	/*
+	Linear
+	*/
+
+	inv_mass = simd_load(bodies->inverse_mass + i);
+	for (a = 0; a < 3; ++a)
+	{
+		simd_t vel = simd_load(bodies->velocity[a] + i);
+		simd_store(bodies->pos[a] + i, simd_add(simd_load(bodies->pos[a] + i), simd_mul(vel, dt)));
+		simd_store(bodies->velocity[a] + i, simd_mul(simd_load(bodies->momentum[a] + i), inv_mass));
+	}
+
+	/*
+	Rotational
+	*/
+
+	qx = simd_add(simd_load(bodies->rot[0] + i), simd_mul(simd_load(bodies->spin[0] + i), dt));
+	qy = simd_add(simd_load(bodies->rot[1] + i), simd_mul(simd_load(bodies->spin[1] + i), dt));
+	qz = simd_add(simd_load(bodies->rot[2] + i), simd_mul(simd_load(bodies->spin[2] + i), dt));
+	qw = simd_add(simd_load(bodies->rot[3] + i), simd_mul(simd_load(bodies->spin[3] + i), dt));
+
+	/* Normalize, zero length lanes become identity */
+	dot = simd_add(simd_add(simd_mul(qx, qx), simd_mul(qy, qy)), simd_add(simd_mul(qz, qz), simd_mul(qw, qw)));
+	valid = simd_gt(dot, zero);
+	inv_len = simd_rsqrt(dot);
+	qx = simd_select(valid, simd_mul(qx, inv_len), zero);
+	qy = simd_select(valid, simd_mul(qy, inv_len), zero);
+	qz = simd_select(valid, simd_mul(qz, inv_len), zero);
+	qw = simd_select(valid, simd_mul(qw, inv_len), one);
+
+	simd_store(bodies->rot[0] + i, qx);
+	simd_store(bodies->rot[1] + i, qy);
+	simd_store(bodies->rot[2] + i, qz);
+	simd_store(bodies->rot[3] + i, qw);
+
+	inv_inertia = simd_load(bodies->inverse_inertia + i);
+	wx = simd_mul(simd_load(bodies->angular_momentum[0] + i), inv_inertia);
+	wy = simd_mul(simd_load(bodies->angular_momentum[1] + i), inv_inertia);
+	wz = simd_mul(simd_load(bodies->angular_momentum[2] + i), inv_inertia);
+
+	simd_store(bodies->angular_velocity[0] + i, wx);
+	simd_store(bodies->angular_velocity[1] + i, wy);
+	simd_store(bodies->angular_velocity[2] + i, wz);
+
+	simd_store(bodies->spin[0] + i, simd_mul(half, simd_sub(simd_add(simd_mul(wx, qw), simd_mul(wy, qz)), simd_mul(wz, qy))));
+	simd_store(bodies->spin[1] + i, simd_mul(half, simd_add(simd_sub(simd_mul(wy, qw), simd_mul(wx, qz)), simd_mul(wz, qx))));
+	simd_store(bodies->spin[2] + i, simd_mul(half, simd_add(simd_sub(simd_mul(wx, qy), simd_mul(wy, qx)), simd_mul(wz, qw))));
+	simd_store(bodies->spin[3] + i, simd_mul(half, simd_sub(simd_sub(simd_sub(zero, simd_mul(wx, qx)), simd_mul(wy, qy)), simd_mul(wz, qz))));
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef KK_PHYSICS_BODIES_H
+#define KK_PHYSICS_BODIES_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "ecs/ecs_.h"
+#include "ecs/ecs_query_.h"
+#include "ecs/components/ecs_physics_.h"
+#include "ecs/components/ecs_transform_.h"
+#include "engine/kk_physics_bodies_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+Number of bodies integrated per SIMD iteration. Capacity is always a
+multiple of this so the vector loop never reads past the arrays.
+*/
+#if defined(CGLM_AVX_FP)
+	#define KK_PHYSICS_BODIES_WIDTH 8
+#elif defined(CGLM_SSE_FP) || defined(CGLM_NEON_FP)
+	#define KK_PHYSICS_BODIES_WIDTH 4
+#else
+	#define KK_PHYSICS_BODIES_WIDTH 1
+#endif
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Structure-of-arrays copy of rigid body state. Each component of each vector
+is stored in its own packed float array so the integrator can process
+several bodies per instruction.
+
+The physics system gathers ecs_physics_t/ecs_transform_t pairs into the
+arrays, integrates them as a batch, then scatters the results back.
+*/
+struct kk_physics_bodies_s
+{
+	/*
+	Create/destroy
+	*/
+	float*					data;					/* Single allocation that holds every array. */
+	ecs_physics_t**			phys;					/* Source physics component for each body. */
+	ecs_transform_t**		transform;				/* Source transform component for each body. */
+	entity_id_t*			entities;				/* Source entity for each body. */
+	uint32_t				capacity;				/* Number of bodies the arrays can hold. */
+
+	/*
+	Other
+	*/
+	uint32_t				count;					/* Number of bodies. */
+
+	float*					pos[3];					/* Position (x, y, z). Stored in the transform component. */
+	float*					rot[4];					/* Orientation quaternion (x, y, z, w). Stored in the transform component. */
+	float*					prev_pos[3];			/* Position before the last step. Used to interpolate rendering. */
+	float*					prev_rot[4];			/* Orientation before the last step. */
+	float*					momentum[3];
+	float*					velocity[3];
+	float*					inverse_mass;
+	float*					angular_momentum[3];
+	float*					angular_velocity[3];
+	float*					spin[4];				/* Quaternion (x, y, z, w). */
+	float*					inverse_inertia;
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_physics_bodies.public.h"
+
+#endif /* KK_PHYSICS_BODIES_H */
\ No newline at end of file
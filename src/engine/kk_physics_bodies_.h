@@ -0,0 +1,10 @@
+#ifndef KK_PHYSICS_BODIES__H
+#define KK_PHYSICS_BODIES__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_physics_bodies_s kk_physics_bodies_t;
+
+#endif /* KK_PHYSICS_BODIES__H */
\ No newline at end of file
@@ -0,0 +1,361 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "engine/kk_math.h"
+#include "engine/kk_shape.h"
+
+#include "autogen/kk_shape.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define MIN_SPHERE_POINTS	(12)	/* Fewer points than this are never treated as a sphere. */
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs a box shape.
+
+@param shape The shape to construct.
+@param center The center of the box.
+@param half_extents Half the size of the box on each axis.
+*/
+void kk_shape__construct_box(kk_shape_t* shape, kk_vec3_t* center, kk_vec3_t* half_extents)
+{
+	clear_struct(shape);
+	shape->type = KK_SHAPE_TYPE_BOX;
+	shape->center = *center;
+	shape->half_extents = *half_extents;
+	shape->radius = kk_math_vec3_norm(half_extents);
+}
+
+//## public
+/**
+Constructs a shape that encloses a set of points. Points on the corners of
+their bounds become a box, points about the same distance from their center
+become a sphere and anything else becomes a convex hull of the unique
+points. Point sets too large for a hull fall back to their box.
+
+@param shape The shape to construct.
+@param points Packed x, y, z positions.
+@param count The number of points.
+*/
+void kk_shape__construct_from_points(kk_shape_t* shape, const float* points, uint32_t count)
+{
+	kk_vec3_t min_pt;
+	kk_vec3_t max_pt;
+	kk_vec3_t center;
+	kk_vec3_t half;
+	const float* p;
+	uint32_t i;
+
+	if (count == 0)
+	{
+		clear_struct(&center);
+		kk_shape__construct_box(shape, &center, &center);
+		return;
+	}
+
+	/* Bounds */
+	min_pt.x = max_pt.x = points[0];
+	min_pt.y = max_pt.y = points[1];
+	min_pt.z = max_pt.z = points[2];
+
+	for (i = 1; i < count; ++i)
+	{
+		p = &points[i * 3];
+		min_pt.x = min(min_pt.x, p[0]); max_pt.x = max(max_pt.x, p[0]);
+		min_pt.y = min(min_pt.y, p[1]); max_pt.y = max(max_pt.y, p[1]);
+		min_pt.z = min(min_pt.z, p[2]); max_pt.z = max(max_pt.z, p[2]);
+	}
+
+	center.x = 0.5f * (min_pt.x + max_pt.x);
+	center.y = 0.5f * (min_pt.y + max_pt.y);
+	center.z = 0.5f * (min_pt.z + max_pt.z);
+	half.x = 0.5f * (max_pt.x - min_pt.x);
+	half.y = 0.5f * (max_pt.y - min_pt.y);
+	half.z = 0.5f * (max_pt.z - min_pt.z);
+
+	kk_shape__construct_box(shape, &center, &half);
+
+	if (is_box(points, count, &min_pt, &max_pt))
+	{
+		return;
+	}
+
+	if (is_sphere(points, count, &center, &half, &shape->radius))
+	{
+		shape->type = KK_SHAPE_TYPE_SPHERE;
+		return;
+	}
+
+	build_hull(shape, points, count);
+}
+
+//## public
+/**
+Constructs a sphere shape.
+
+@param shape The shape to construct.
+@param center The center of the sphere.
+@param radius The radius of the sphere.
+*/
+void kk_shape__construct_sphere(kk_shape_t* shape, kk_vec3_t* center, float radius)
+{
+	clear_struct(shape);
+	shape->type = KK_SHAPE_TYPE_SPHERE;
+	shape->center = *center;
+	shape->half_extents.x = shape->half_extents.y = shape->half_extents.z = radius;
+	shape->radius = radius;
+}
+
+//## public
+/**
+Destructs a shape.
+
+@param shape The shape to destruct.
+*/
+void kk_shape__destruct(kk_shape_t* shape)
+{
+	free(shape->vertices);
+	clear_struct(shape);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Finds the point of a shape furthest in a direction, in model space.
+
+@param shape The shape.
+@param dir The direction. Does not need to be normalized.
+@param out__point The support point.
+*/
+void kk_shape__support(kk_shape_t* shape, kk_vec3_t* dir, kk_vec3_t* out__point)
+{
+	kk_vec3_t* v;
+	float best;
+	float d;
+	uint32_t i;
+
+	switch (shape->type)
+	{
+	case KK_SHAPE_TYPE_BOX:
+		out__point->x = shape->center.x + (dir->x < 0.0f ? -shape->half_extents.x : shape->half_extents.x);
+		out__point->y = shape->center.y + (dir->y < 0.0f ? -shape->half_extents.y : shape->half_extents.y);
+		out__point->z = shape->center.z + (dir->z < 0.0f ? -shape->half_extents.z : shape->half_extents.z);
+		break;
+
+	case KK_SHAPE_TYPE_SPHERE:
+		d = kk_math_vec3_norm(dir);
+		if (d > 0.0f)
+		{
+			d = shape->radius / d;
+			out__point->x = shape->center.x + dir->x * d;
+			out__point->y = shape->center.y + dir->y * d;
+			out__point->z = shape->center.z + dir->z * d;
+		}
+		else
+		{
+			*out__point = shape->center;
+			out__point->x += shape->radius;
+		}
+		break;
+
+	case KK_SHAPE_TYPE_HULL:
+		v = shape->vertices;
+		best = kk_math_vec3_dot(&v[0], dir);
+		*out__point = v[0];
+
+		for (i = 1; i < shape->num_vertices; ++i)
+		{
+			d = kk_math_vec3_dot(&v[i], dir);
+			if (d > best)
+			{
+				best = d;
+				*out__point = v[i];
+			}
+		}
+		break;
+
+	default:
+		kk_log__fatal("Unknown shape type.");
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Copies the unique points into the shape as a hull. Falls back to the box the
+shape was constructed as when there are too many.
+*/
+static void build_hull(kk_shape_t* shape, const float* points, uint32_t count)
+{
+	kk_vec3_t* sorted;
+	uint32_t num_unique;
+	uint32_t i;
+
+	/* Sort so duplicates are adjacent */
+	sorted = (kk_vec3_t*)malloc(sizeof(kk_vec3_t) * count);
+	if (!sorted)
+	{
+		kk_log__fatal("Failed to allocate hull vertices.");
+	}
+
+	memcpy(sorted, points, sizeof(kk_vec3_t) * count);
+	qsort(sorted, count, sizeof(kk_vec3_t), compare_points);
+
+	num_unique = 1;
+	for (i = 1; i < count; ++i)
+	{
+		if (compare_points(&sorted[i], &sorted[num_unique - 1]) != 0)
+		{
+			sorted[num_unique++] = sorted[i];
+		}
+	}
+
+	if (num_unique > KK_SHAPE_MAX_HULL_VERTICES)
+	{
+		free(sorted);
+		return;
+	}
+
+	shape->type = KK_SHAPE_TYPE_HULL;
+	shape->vertices = (kk_vec3_t*)realloc(sorted, sizeof(kk_vec3_t) * num_unique);
+	shape->num_vertices = num_unique;
+}
+
+//## static
+/**
+Orders points by x, then y, then z.
+*/
+static int compare_points(const void* a, const void* b)
+{
+	const float* pa = (const float*)a;
+	const float* pb = (const float*)b;
+	int i;
+
+	for (i = 0; i < 3; ++i)
+	{
+		if (pa[i] < pb[i]) return -1;
+		if (pa[i] > pb[i]) return 1;
+	}
+
+	return 0;
+}
+
+//## static
+/**
+Checks if the points are exactly the corners of the bounds. Flat axes only
+have one side, so a quad needs four corners and a full box needs eight.
+*/
+static boolean is_box(const float* points, uint32_t count, kk_vec3_t* min_pt, kk_vec3_t* max_pt)
+{
+	const float* lo = (const float*)min_pt;
+	const float* hi = (const float*)max_pt;
+	float eps = 1e-4f * (1.0f + max(max(hi[0] - lo[0], hi[1] - lo[1]), hi[2] - lo[2]));
+	uint32_t corners = 0;
+	uint32_t expected = 0xFF;
+	uint32_t corner;
+	uint32_t i;
+	int a;
+
+	for (a = 0; a < 3; ++a)
+	{
+		if (hi[a] - lo[a] <= eps)
+		{
+			/* Only corners on the low side exist */
+			expected &= (a == 0) ? 0x55 : (a == 1) ? 0x33 : 0x0F;
+		}
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		corner = 0;
+
+		for (a = 0; a < 3; ++a)
+		{
+			float v = points[i * 3 + a];
+			if (fabsf(v - lo[a]) <= eps)
+			{
+				continue;
+			}
+			else if (fabsf(v - hi[a]) <= eps)
+			{
+				corner |= 1 << a;
+			}
+			else
+			{
+				return FALSE;
+			}
+		}
+
+		corners |= 1 << corner;
+	}
+
+	return corners == expected;
+}
+
+//## static
+/**
+Checks if the points sit on a sphere around the center of their bounds. The
+bounds must be about a cube and every point about the same distance from
+the center.
+*/
+static boolean is_sphere(const float* points, uint32_t count, kk_vec3_t* center, kk_vec3_t* half, float* out__radius)
+{
+	float min_half = min(min(half->x, half->y), half->z);
+	float max_half = max(max(half->x, half->y), half->z);
+	float min_dist;
+	float max_dist;
+	kk_vec3_t d;
+	uint32_t i;
+
+	if (count < MIN_SPHERE_POINTS || max_half - min_half > KK_SHAPE_SPHERE_TOLERANCE * max_half)
+	{
+		return FALSE;
+	}
+
+	min_dist = FLT_MAX;
+	max_dist = 0.0f;
+
+	for (i = 0; i < count; ++i)
+	{
+		d.x = points[i * 3 + 0] - center->x;
+		d.y = points[i * 3 + 1] - center->y;
+		d.z = points[i * 3 + 2] - center->z;
+
+		float dist = kk_math_vec3_norm(&d);
+		min_dist = min(min_dist, dist);
+		max_dist = max(max_dist, dist);
+	}
+
+	if (max_dist - min_dist > KK_SHAPE_SPHERE_TOLERANCE * max_dist)
+	{
+		return FALSE;
+	}
+
+	*out__radius = max_dist;
+	return TRUE;
+}
\ No newline at end of file
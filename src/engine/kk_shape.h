@@ -0,0 +1,63 @@
+#ifndef KK_SHAPE_H
+#define KK_SHAPE_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "engine/kk_shape_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define KK_SHAPE_MAX_HULL_VERTICES	(256)	/* Point clouds with more unique points collide as their box. */
+#define KK_SHAPE_SPHERE_TOLERANCE	(0.05f)	/* Relative spread of point distances that still counts as a sphere. */
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef enum
+{
+	KK_SHAPE_TYPE_BOX,
+	KK_SHAPE_TYPE_SPHERE,
+	KK_SHAPE_TYPE_HULL,
+
+} kk_shape_type_t;
+
+/**
+Convex collision shape in model space. Built from a model's vertices, which
+picks the cheapest shape that fits them.
+*/
+struct kk_shape_s
+{
+	/*
+	Create/destroy
+	*/
+	kk_vec3_t*			vertices;		/* Unique hull points. NULL unless a hull. */
+	uint32_t			num_vertices;
+
+	/*
+	Other
+	*/
+	kk_shape_type_t		type;
+	kk_vec3_t			center;			/* Center of the box or sphere. */
+	kk_vec3_t			half_extents;	/* Box half size. */
+	float				radius;			/* Sphere radius. For a box or hull, the radius of a sphere around the center that encloses it. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/kk_shape.public.h"
+
+#endif /* KK_SHAPE_H */
\ No newline at end of file
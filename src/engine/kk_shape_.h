@@ -0,0 +1,10 @@
+#ifndef KK_SHAPE__H
+#define KK_SHAPE__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct kk_shape_s kk_shape_t;
+
+#endif /* KK_SHAPE__H */
\ No newline at end of file
@@ -35,6 +35,8 @@ void kk_world__construct(kk_world_t* world, const char* filename)
 
 	ecs__construct(&world->ecs);
 	geo__construct(&world->geo);
+	kk_physics_bodies__construct(&world->bodies);
+	collision_system__construct(&world->collision);
 	load_world_file(world, filename);
 }
 
@@ -45,6 +47,8 @@ Destructs a world.
 */
 void kk_world__destruct(kk_world_t* world)
 {
+	collision_system__destruct(&world->collision);
+	kk_physics_bodies__destruct(&world->bodies);
 	geo__destruct(&world->geo);
 	ecs__destruct(&world->ecs);
 }
@@ -111,6 +115,12 @@ void kk_world__export_lua(kk_world_t* world, const char* filename)
 					continue;
 				}
 
+				/* Skip components the entity does not have */
+				if (!comp->has(ecs, ent))
+				{
+					continue;
+				}
+
 				/* Add a comma to the end of the previous component */
 				if (!first_component)
 				{
@@ -171,6 +181,19 @@ void kk_world__export_lua(kk_world_t* world, const char* filename)
 						fprintf_s(f, "{ %.2f, %.2f, %.2f }", val.x, val.y, val.z);
 						break;
 					}
+					case ECS_COMPONENT_PROP_TYPE_VEC4:
+					{
+						kk_vec4_t val = *(kk_vec4_t*)prop_info.value;
+						fprintf_s(f, "{ %.2f, %.2f, %.2f, %.2f }", val.x, val.y, val.z, val.w);
+						break;
+					}
+					case ECS_COMPONENT_PROP_TYPE_ENTITY:
+					{
+						/* ECS_INVALID_ID is written as -1 */
+						entity_id_t val = *(entity_id_t*)prop_info.value;
+						fprintf_s(f, "%d", (int)val);
+						break;
+					}
 					default:
 						kk_log__error("Unknown component type.");
 						break;
@@ -205,6 +228,62 @@ void kk_world__export_lua(kk_world_t* world, const char* filename)
 	fclose(f);
 }
 
+//## public
+/**
+Finds the colliders whose triangles overlap a box.
+
+@param world The world.
+@param box The box, in world space.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void kk_world__overlap_aabb(kk_world_t* world, kk_aabb_t* box, utl_array_t(uint32_t)* out__entities)
+{
+	collision_system__overlap_aabb(&world->collision, &world->ecs, box, out__entities);
+}
+
+//## public
+/**
+Finds the colliders whose triangles overlap a sphere.
+
+@param world The world.
+@param center The center of the sphere, in world space.
+@param radius The radius of the sphere.
+@param out__entities Cleared, then filled with the colliders' entities.
+*/
+void kk_world__overlap_sphere(kk_world_t* world, kk_vec3_t* center, float radius, utl_array_t(uint32_t)* out__entities)
+{
+	collision_system__overlap_sphere(&world->collision, &world->ecs, center, radius, out__entities);
+}
+
+//## public
+/**
+Finds the closest collider a ray hits. Colliders are tested against their
+model's triangles, as of the last collision system update.
+
+@param world The world.
+@param ray The ray, in world space.
+@param out__hit The closest hit. Its entity is ECS_INVALID_ID if there is none.
+@return TRUE if the ray hit a collider.
+*/
+boolean kk_world__raycast(kk_world_t* world, kk_ray_t* ray, collision_system_hit_t* out__hit)
+{
+	return collision_system__raycast(&world->collision, &world->ecs, ray, out__hit);
+}
+
+//## public
+/**
+Casts a batch of rays across the job system's threads.
+
+@param world The world.
+@param rays The rays, in world space.
+@param count The number of rays.
+@param out__hits The closest hit for each ray.
+*/
+void kk_world__raycast_batch(kk_world_t* world, kk_ray_t* rays, uint32_t count, collision_system_hit_t* out__hits)
+{
+	collision_system__raycast_batch(&world->collision, &world->ecs, rays, count, out__hits);
+}
+
 //## static
 static void load_world_file(kk_world_t* world, const char* filename)
 {
@@ -256,6 +335,8 @@ static void load_world_file(kk_world_t* world, const char* filename)
 
 		/* Pop entities list */
 		lua_script__pop(&script, 1);
+
+		ecs__log_memory_usage(ecs);
 	}
 
 	/* Process geometry */
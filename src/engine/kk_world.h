@@ -13,6 +13,8 @@ INCLUDES
 
 #include "common.h"
 #include "ecs/ecs.h"
+#include "ecs/systems/collision_system.h"
+#include "engine/kk_physics_bodies.h"
 #include "geo/geo.h"
 
 /*=========================================================
@@ -24,8 +26,10 @@ struct kk_world_s
 	/**
 	Create/destroy
 	*/
-	geo_t			geo;	/* World geometry */
-	ecs_t			ecs;
+	geo_t					geo;	/* World geometry */
+	ecs_t					ecs;
+	kk_physics_bodies_t		bodies;	/* Structure-of-arrays body state used by the physics system */
+	collision_system_t		collision;	/* Broadphase over every collider in the ECS */
 };
 
 /*=========================================================
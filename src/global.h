@@ -10,6 +10,7 @@ DECLARATIONS
 =========================================================*/
 
 #include "app/app_.h"
+#include "engine/kk_job_.h"
 #include "engine/kk_log_.h"
 #include "gpu/gpu_.h"
 #include "platform/platform_.h"
@@ -24,6 +25,7 @@ VARIABLES
 
 extern app_t*			g_app;			/* Current app instance. */
 extern gpu_t*			g_gpu;			/* Current GPU instance. */
+extern kk_job_system_t*	g_jobs;			/* Job system. Jobs are submitted from the main thread. */
 extern kk_log_t*		g_log;			/* Current logging instance. */
 extern platform_t*		g_platform;		/* Current platform instance. */
 
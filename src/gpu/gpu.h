@@ -21,6 +21,7 @@ INCLUDES
 #include "common.h"
 #include "engine/kk_math.h"
 #include "gpu/gpu_material.h"
+#include "gpu/gpu_render_queue.h"
 #include "gpu/gpu_texture.h"
 #include "thirdparty/cimgui/imgui_jetz.h"
 #include "thirdparty/rxi_map/src/map.h"
@@ -52,6 +53,7 @@ typedef void (*gpu_plane_update_verts_func)(gpu_plane_t* plane, gpu_t* gpu, kk_v
 typedef void (*gpu_static_model_construct_func)(gpu_static_model_t* model, gpu_t* gpu, const tinyobj_t* obj);
 typedef void (*gpu_static_model_destruct_func)(gpu_static_model_t* model, gpu_t* gpu);
 typedef void (*gpu_static_model_render_func)(gpu_static_model_t* model, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, ecs_transform_t* transform);
+typedef void (*gpu_static_model_render_batch_func)(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count);
 
 typedef void (*gpu_texture_construct_func)(gpu_texture_t* texture, gpu_t* gpu, void* img, int width, int height);
 typedef void (*gpu_texture_destruct_func)(gpu_texture_t* texture, gpu_t* gpu);
@@ -85,6 +87,7 @@ struct gpu_intf_s
 	gpu_static_model_construct_func	static_model__construct;
 	gpu_static_model_destruct_func	static_model__destruct;
 	gpu_static_model_render_func	static_model__render;
+	gpu_static_model_render_batch_func	static_model__render_batch;	/* Records draws sorted by key, at most once per frame. Backends may merge runs of the same model and mesh into instanced draws. */
 	gpu_texture_construct_func		texture__construct;
 	gpu_texture_destruct_func		texture__destruct;
 	gpu_window_begin_frame_func		window__begin_frame;
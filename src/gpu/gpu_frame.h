@@ -34,6 +34,13 @@ struct gpu_frame_s
 	Other
 	*/
 	uint8_t				frame_idx;
+	uint32_t			num_binds_issued;	/* Stat. Pipeline, descriptor set and buffer binds recorded last frame. Vulkan only. */
+	uint32_t			num_binds_skipped;	/* Stat. Binds skipped last frame because they were already bound. Vulkan only. */
+	uint64_t			geometry_bytes_used;		/* Stat. Static mesh geometry allocated in the arenas. Vulkan only. */
+	uint64_t			geometry_bytes_reserved;	/* Stat. Total size of the geometry arenas. Vulkan only. */
+	float				geometry_fragmentation;		/* Stat. 0 when the free arena space is one range, near 1 when scattered. Vulkan only. */
+	uint32_t			upload_submits;				/* Stat. Upload batches submitted since startup. Vulkan only. */
+	uint64_t			upload_bytes;				/* Stat. Bytes uploaded to device-local memory since startup. Vulkan only. */
 };
 
 /*=========================================================
@@ -0,0 +1,599 @@
+/*=========================================================
+Mesh optimization for indexed triangle lists. Runs after
+vertex welding and before upload:
+
+1. Triangles are reordered for the post-transform vertex
+   cache using Tom Forsyth's "Linear-Speed Vertex Cache
+   Optimisation".
+2. The cache-ordered triangles are split into clusters
+   where the order jumps to a new region of the mesh. The
+   clusters are sorted so those facing out from the mesh
+   center are drawn first, which lets them occlude the
+   rest. The order is kept only if ACMR stays within
+   GPU_MESH_OPT_OVERDRAW_THRESHOLD.
+3. Vertices are reordered to first use, so vertex fetch
+   walks memory forwards.
+=========================================================*/
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <math.h>
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "engine/kk_math.h"
+#include "gpu/gpu_mesh_opt.h"
+#include "gpu/gpu_vertex_weld.h"
+
+#include "autogen/gpu_mesh_opt.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define INVALID_INDEX			(0xFFFFFFFF)
+
+/* Scoring values from Forsyth's paper */
+#define DECAY_POWER				(1.5f)
+#define LAST_TRI_SCORE			(0.75f)
+#define VALENCE_BOOST_SCALE		(2.0f)
+#define VALENCE_BOOST_POWER		(0.5f)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	uint32_t			first;			/* First triangle of the cluster. */
+	uint32_t			count;			/* Number of triangles. */
+	float				sort_key;		/* Larger faces further out from the mesh center. */
+
+} cluster_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Optimizes a welded mesh in place for the vertex cache, overdraw and vertex
+fetch. Vertices are reordered, so nothing more can be added to the weld
+afterwards.
+
+@param weld The welded mesh.
+@param position_offset Byte offset of the three float position in the vertex type.
+@param stats Cache misses before and after are added to these stats.
+*/
+void gpu_mesh_opt__optimize(gpu_vertex_weld_t* weld, uint32_t position_offset, gpu_mesh_opt_stats_t* stats)
+{
+	uint32_t n = weld->num_indices;
+	uint32_t nv = weld->num_vertices;
+
+	stats->num_triangles += n / 3;
+	stats->misses_before += gpu_mesh_opt__count_misses(weld->indices, n, nv, GPU_MESH_OPT_ACMR_CACHE_SIZE);
+
+	gpu_mesh_opt__optimize_vertex_cache(weld->indices, n, nv);
+	gpu_mesh_opt__optimize_overdraw(weld->indices, n, weld->vertices + position_offset, weld->vertex_size, nv);
+	gpu_mesh_opt__optimize_vertex_fetch(weld->vertices, weld->vertex_size, weld->indices, n, nv);
+
+	stats->misses_after += gpu_mesh_opt__count_misses(weld->indices, n, nv, GPU_MESH_OPT_ACMR_CACHE_SIZE);
+}
+
+//## public
+/**
+Counts post-transform cache misses when drawing a triangle list through a
+FIFO cache.
+
+@param indices The index list.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices referenced.
+@param cache_size The number of cache entries.
+@return The number of misses.
+*/
+uint32_t gpu_mesh_opt__count_misses(const uint32_t* indices, uint32_t num_indices, uint32_t num_vertices, uint32_t cache_size)
+{
+	uint32_t* stamps;
+	uint32_t time = cache_size + 1;
+	uint32_t misses = 0;
+	uint32_t i;
+
+	stamps = calloc(max(num_vertices, 1), sizeof(uint32_t));
+	if (!stamps)
+	{
+		kk_log__fatal("Failed to allocate memory for cache simulation.");
+	}
+
+	/* A vertex is cached while fewer than cache_size misses have happened since it was loaded */
+	for (i = 0; i < num_indices; ++i)
+	{
+		if (time - stamps[indices[i]] > cache_size)
+		{
+			stamps[indices[i]] = time++;
+			misses++;
+		}
+	}
+
+	free(stamps);
+	return misses;
+}
+
+//## public
+/**
+Gets the average cache miss ratio: misses per triangle. 3 is the worst, 0.5
+is the best possible for a large regular grid.
+
+@param stats The stats.
+@param after TRUE for the optimized meshes, FALSE for the input.
+@return The ACMR, or 0 if there are no triangles.
+*/
+float gpu_mesh_opt__get_acmr(const gpu_mesh_opt_stats_t* stats, boolean after)
+{
+	if (stats->num_triangles == 0)
+	{
+		return 0.0f;
+	}
+
+	return (float)(after ? stats->misses_after : stats->misses_before) / (float)stats->num_triangles;
+}
+
+//## public
+/**
+Reorders triangles for the post-transform vertex cache. The triangle with the
+best score among those using cached vertices is emitted next. Vertices score
+higher the more recently they were used and the fewer triangles they have
+left, so the order finishes off regions instead of leaving stragglers.
+
+@param indices The index list to reorder in place.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices referenced.
+*/
+void gpu_mesh_opt__optimize_vertex_cache(uint32_t* indices, uint32_t num_indices, uint32_t num_vertices)
+{
+	uint32_t num_tris = num_indices / 3;
+	uint32_t* adj_offset;
+	uint32_t* adj;
+	uint32_t* live;
+	float* score;
+	uint8_t* emitted;
+	uint32_t* out;
+	uint32_t cache[GPU_MESH_OPT_CACHE_SIZE + 3];
+	uint32_t new_cache[GPU_MESH_OPT_CACHE_SIZE + 3];
+	uint32_t cache_count = 0;
+	uint32_t new_count;
+	uint32_t scan = 0;
+	uint32_t best = 0;
+	float best_score;
+	float s;
+	uint32_t t;
+	uint32_t v;
+	uint32_t c;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+
+	if (num_tris < 2)
+	{
+		return;
+	}
+
+	adj_offset = calloc(num_vertices + 1, sizeof(uint32_t));
+	adj = malloc(sizeof(uint32_t) * num_indices);
+	live = calloc(num_vertices, sizeof(uint32_t));
+	score = malloc(sizeof(float) * num_vertices);
+	emitted = calloc(num_tris, sizeof(uint8_t));
+	out = malloc(sizeof(uint32_t) * num_indices);
+	if (!adj_offset || !adj || !live || !score || !emitted || !out)
+	{
+		kk_log__fatal("Failed to allocate memory for vertex cache optimization.");
+	}
+
+	/* Triangles using each vertex. The live ones are kept at the front of each list. */
+	for (i = 0; i < num_indices; ++i)
+	{
+		live[indices[i]]++;
+	}
+
+	for (v = 0; v < num_vertices; ++v)
+	{
+		adj_offset[v + 1] = adj_offset[v] + live[v];
+		live[v] = 0;
+	}
+
+	for (i = 0; i < num_indices; ++i)
+	{
+		v = indices[i];
+		adj[adj_offset[v] + live[v]++] = i / 3;
+	}
+
+	for (v = 0; v < num_vertices; ++v)
+	{
+		score[v] = vertex_score(-1, live[v]);
+	}
+
+	for (t = 0; t < num_tris; ++t)
+	{
+		/* Nothing is cached after a jump, so take the next triangle not yet emitted */
+		if (best == INVALID_INDEX)
+		{
+			while (emitted[scan])
+			{
+				scan++;
+			}
+
+			best = scan;
+		}
+
+		/* Emit the triangle and drop it from its vertices' live lists */
+		memcpy(&out[t * 3], &indices[best * 3], sizeof(uint32_t) * 3);
+		emitted[best] = TRUE;
+
+		for (k = 0; k < 3; ++k)
+		{
+			v = indices[best * 3 + k];
+			for (j = adj_offset[v]; adj[j] != best; ++j);
+			adj[j] = adj[adj_offset[v] + live[v] - 1];
+			adj[adj_offset[v] + live[v] - 1] = best;
+			live[v]--;
+		}
+
+		/* LRU cache: the triangle's vertices move to the front */
+		new_count = 0;
+		for (k = 0; k < 3; ++k)
+		{
+			v = indices[best * 3 + k];
+			if (!is_in_list(new_cache, new_count, v))
+			{
+				new_cache[new_count++] = v;
+			}
+		}
+
+		for (c = 0; c < cache_count; ++c)
+		{
+			if (!is_in_list(new_cache, new_count, cache[c]))
+			{
+				new_cache[new_count++] = cache[c];
+			}
+		}
+
+		for (c = GPU_MESH_OPT_CACHE_SIZE; c < new_count; ++c)
+		{
+			v = new_cache[c];
+			score[v] = vertex_score(-1, live[v]);
+		}
+
+		cache_count = min(new_count, GPU_MESH_OPT_CACHE_SIZE);
+		for (c = 0; c < cache_count; ++c)
+		{
+			v = new_cache[c];
+			cache[c] = v;
+			score[v] = vertex_score((int32_t)c, live[v]);
+		}
+
+		/* The next triangle is the best scoring one touching the cache */
+		best = INVALID_INDEX;
+		best_score = -1.0f;
+		for (c = 0; c < cache_count; ++c)
+		{
+			v = cache[c];
+			for (j = adj_offset[v]; j < adj_offset[v] + live[v]; ++j)
+			{
+				i = adj[j] * 3;
+				s = score[indices[i]] + score[indices[i + 1]] + score[indices[i + 2]];
+				if (s > best_score)
+				{
+					best_score = s;
+					best = adj[j];
+				}
+			}
+		}
+	}
+
+	memcpy(indices, out, sizeof(uint32_t) * num_indices);
+
+	free(out);
+	free(emitted);
+	free(score);
+	free(live);
+	free(adj);
+	free(adj_offset);
+}
+
+//## public
+/**
+Reorders clusters of cache-ordered triangles so outward facing clusters are
+drawn first. Triangles within a cluster keep their order. Call after
+gpu_mesh_opt__optimize_vertex_cache.
+
+@param indices The index list to reorder in place.
+@param num_indices The number of indices.
+@param positions The first vertex position, three floats.
+@param stride Bytes between vertex positions.
+@param num_vertices The number of vertices referenced.
+*/
+void gpu_mesh_opt__optimize_overdraw(uint32_t* indices, uint32_t num_indices, const uint8_t* positions, uint32_t stride, uint32_t num_vertices)
+{
+	uint32_t num_tris = num_indices / 3;
+	uint32_t num_clusters = 0;
+	uint32_t* stamps;
+	uint32_t* out;
+	cluster_t* clusters;
+	cluster_t* cluster;
+	kk_vec3_t mesh_center;
+	kk_vec3_t center;
+	kk_vec3_t normal;
+	kk_vec3_t tri_center;
+	kk_vec3_t tri_normal;
+	kk_vec3_t offset;
+	float area_sum = 0.0f;
+	float area;
+	float len;
+	uint32_t time = GPU_MESH_OPT_ACMR_CACHE_SIZE + 1;
+	uint32_t tri_misses;
+	uint32_t misses_before;
+	uint32_t misses_after;
+	uint32_t t;
+	uint32_t i;
+	uint32_t k;
+
+	if (num_tris < 2)
+	{
+		return;
+	}
+
+	stamps = calloc(max(num_vertices, 1), sizeof(uint32_t));
+	clusters = malloc(sizeof(cluster_t) * num_tris);
+	out = malloc(sizeof(uint32_t) * num_indices);
+	if (!stamps || !clusters || !out)
+	{
+		kk_log__fatal("Failed to allocate memory for overdraw optimization.");
+	}
+
+	/* A cluster starts wherever all three corners miss the cache, i.e. the order jumped */
+	for (t = 0; t < num_tris; ++t)
+	{
+		tri_misses = 0;
+		for (k = 0; k < 3; ++k)
+		{
+			i = indices[t * 3 + k];
+			if (time - stamps[i] > GPU_MESH_OPT_ACMR_CACHE_SIZE)
+			{
+				stamps[i] = time++;
+				tri_misses++;
+			}
+		}
+
+		if (t == 0 || tri_misses == 3)
+		{
+			clusters[num_clusters].first = t;
+			clusters[num_clusters].count = 0;
+			num_clusters++;
+		}
+
+		clusters[num_clusters - 1].count++;
+	}
+
+	if (num_clusters < 2)
+	{
+		free(out);
+		free(clusters);
+		free(stamps);
+		return;
+	}
+
+	/* Area weighted mesh center */
+	clear_struct(&mesh_center);
+	for (t = 0; t < num_tris; ++t)
+	{
+		get_triangle(&indices[t * 3], positions, stride, &tri_center, &tri_normal);
+		area = kk_math_vec3_norm(&tri_normal);
+		kk_math_vec3_scale(&tri_center, area, &tri_center);
+		kk_math_vec3_add(&mesh_center, &tri_center, &mesh_center);
+		area_sum += area;
+	}
+
+	if (area_sum > 0.0f)
+	{
+		kk_math_vec3_scale(&mesh_center, 1.0f / area_sum, &mesh_center);
+	}
+
+	/* Score each cluster by how far out along its average normal it sits */
+	for (i = 0; i < num_clusters; ++i)
+	{
+		cluster = &clusters[i];
+		clear_struct(&center);
+		clear_struct(&normal);
+		area_sum = 0.0f;
+
+		for (t = cluster->first; t < cluster->first + cluster->count; ++t)
+		{
+			get_triangle(&indices[t * 3], positions, stride, &tri_center, &tri_normal);
+			area = kk_math_vec3_norm(&tri_normal);
+			kk_math_vec3_scale(&tri_center, area, &tri_center);
+			kk_math_vec3_add(&center, &tri_center, &center);
+			kk_math_vec3_add(&normal, &tri_normal, &normal);
+			area_sum += area;
+		}
+
+		cluster->sort_key = 0.0f;
+		len = kk_math_vec3_norm(&normal);
+		if (area_sum > 0.0f && len > 0.0f)
+		{
+			kk_math_vec3_scale(&center, 1.0f / area_sum, &center);
+			kk_math_vec3_sub(&center, &mesh_center, &offset);
+			cluster->sort_key = kk_math_vec3_dot(&offset, &normal) / len;
+		}
+	}
+
+	qsort(clusters, num_clusters, sizeof(cluster_t), compare_clusters);
+
+	k = 0;
+	for (i = 0; i < num_clusters; ++i)
+	{
+		memcpy(&out[k], &indices[clusters[i].first * 3], sizeof(uint32_t) * clusters[i].count * 3);
+		k += clusters[i].count * 3;
+	}
+
+	/* Keep the new order only if it does not cost too much vertex cache efficiency */
+	misses_before = gpu_mesh_opt__count_misses(indices, num_indices, num_vertices, GPU_MESH_OPT_ACMR_CACHE_SIZE);
+	misses_after = gpu_mesh_opt__count_misses(out, num_indices, num_vertices, GPU_MESH_OPT_ACMR_CACHE_SIZE);
+	if ((float)misses_after <= (float)misses_before * GPU_MESH_OPT_OVERDRAW_THRESHOLD)
+	{
+		memcpy(indices, out, sizeof(uint32_t) * num_indices);
+	}
+
+	free(out);
+	free(clusters);
+	free(stamps);
+}
+
+//## public
+/**
+Reorders vertices into the order the index list first uses them and remaps
+the indices to match. Vertices that are never used are moved to the end.
+
+@param vertices The vertex data to reorder in place.
+@param vertex_size The size of one vertex in bytes.
+@param indices The index list to remap in place.
+@param num_indices The number of indices.
+@param num_vertices The number of vertices.
+*/
+void gpu_mesh_opt__optimize_vertex_fetch(uint8_t* vertices, uint32_t vertex_size, uint32_t* indices, uint32_t num_indices, uint32_t num_vertices)
+{
+	uint32_t* remap;
+	uint8_t* out;
+	uint32_t next = 0;
+	uint32_t i;
+
+	if (num_vertices == 0)
+	{
+		return;
+	}
+
+	remap = malloc(sizeof(uint32_t) * num_vertices);
+	out = malloc((size_t)vertex_size * num_vertices);
+	if (!remap || !out)
+	{
+		kk_log__fatal("Failed to allocate memory for vertex fetch optimization.");
+	}
+
+	memset(remap, 0xFF, sizeof(uint32_t) * num_vertices);
+
+	for (i = 0; i < num_indices; ++i)
+	{
+		if (remap[indices[i]] == INVALID_INDEX)
+		{
+			remap[indices[i]] = next++;
+		}
+
+		indices[i] = remap[indices[i]];
+	}
+
+	for (i = 0; i < num_vertices; ++i)
+	{
+		if (remap[i] == INVALID_INDEX)
+		{
+			remap[i] = next++;
+		}
+
+		memcpy(out + (size_t)remap[i] * vertex_size, vertices + (size_t)i * vertex_size, vertex_size);
+	}
+
+	memcpy(vertices, out, (size_t)vertex_size * num_vertices);
+
+	free(out);
+	free(remap);
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Sorts clusters by descending key. Ties keep the cache order.
+*/
+static int compare_clusters(const void* a, const void* b)
+{
+	const cluster_t* ca = (const cluster_t*)a;
+	const cluster_t* cb = (const cluster_t*)b;
+
+	if (ca->sort_key != cb->sort_key)
+	{
+		return (ca->sort_key < cb->sort_key) ? 1 : -1;
+	}
+
+	return (ca->first > cb->first) - (ca->first < cb->first);
+}
+
+//## static
+/**
+Gets a triangle's centroid and its normal scaled by twice its area.
+*/
+static void get_triangle(const uint32_t* tri, const uint8_t* positions, uint32_t stride, kk_vec3_t* out__center, kk_vec3_t* out__normal)
+{
+	kk_vec3_t p[3];
+	kk_vec3_t e1;
+	kk_vec3_t e2;
+	uint32_t k;
+
+	for (k = 0; k < 3; ++k)
+	{
+		memcpy(&p[k], positions + (size_t)tri[k] * stride, sizeof(kk_vec3_t));
+	}
+
+	kk_math_vec3_sub(&p[1], &p[0], &e1);
+	kk_math_vec3_sub(&p[2], &p[0], &e2);
+	kk_math_cross(&e1, &e2, out__normal);
+
+	kk_math_vec3_add(&p[0], &p[1], out__center);
+	kk_math_vec3_add(out__center, &p[2], out__center);
+	kk_math_vec3_scale(out__center, 1.0f / 3.0f, out__center);
+}
+
+//## static
+static boolean is_in_list(const uint32_t* list, uint32_t count, uint32_t value)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; ++i)
+	{
+		if (list[i] == value)
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+//## static
+/**
+Scores a vertex from its LRU cache position (-1 if not cached) and the
+number of triangles still to be emitted that use it.
+*/
+static float vertex_score(int32_t cache_pos, uint32_t live)
+{
+	const float scale = 1.0f / (float)(GPU_MESH_OPT_CACHE_SIZE - 3);
+	float score = 0.0f;
+
+	if (live == 0)
+	{
+		return -1.0f;
+	}
+
+	if (cache_pos >= 0)
+	{
+		/* The last triangle's vertices get a fixed score so the next one does not reuse them too eagerly */
+		score = (cache_pos < 3) ? LAST_TRI_SCORE : powf(1.0f - (float)(cache_pos - 3) * scale, DECAY_POWER);
+	}
+
+	return score + VALENCE_BOOST_SCALE * powf((float)live, -VALENCE_BOOST_POWER);
+}
\ No newline at end of file
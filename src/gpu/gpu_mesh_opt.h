@@ -0,0 +1,58 @@
+#ifndef GPU_MESH_OPT_H
+#define GPU_MESH_OPT_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "gpu/gpu_mesh_opt_.h"
+#include "gpu/gpu_vertex_weld_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+Size of the FIFO cache ACMR is measured with.
+*/
+#define GPU_MESH_OPT_ACMR_CACHE_SIZE		(16)
+
+/*
+Size of the LRU cache the triangle order is optimized for.
+*/
+#define GPU_MESH_OPT_CACHE_SIZE				(32)
+
+/*
+How much worse than the vertex cache order the overdraw order may be, as a
+ratio of ACMR, before it is rejected.
+*/
+#define GPU_MESH_OPT_OVERDRAW_THRESHOLD		(1.05f)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Post-transform cache misses before and after optimizing one or more meshes.
+ACMR is misses divided by triangles.
+*/
+struct gpu_mesh_opt_stats_s
+{
+	uint32_t			num_triangles;
+	uint32_t			misses_before;
+	uint32_t			misses_after;
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/gpu_mesh_opt.public.h"
+
+#endif /* GPU_MESH_OPT_H */
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef GPU_MESH_OPT__H
+#define GPU_MESH_OPT__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct gpu_mesh_opt_stats_s gpu_mesh_opt_stats_t;
+
+#endif /* GPU_MESH_OPT__H */
\ No newline at end of file
@@ -0,0 +1,264 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "gpu/gpu.h"
+#include "gpu/gpu_render_queue.h"
+#include "utl/utl_array.h"
+
+#include "autogen/gpu_render_queue.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define RADIX_BITS		(8)
+#define RADIX_SIZE		(1 << RADIX_BITS)
+#define RADIX_PASSES	(64 / RADIX_BITS)
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an empty render queue.
+
+@param q The queue to construct.
+*/
+void gpu_render_queue__construct(gpu_render_queue_t* q)
+{
+	clear_struct(q);
+	utl_array_init(&q->draws);
+	utl_array_init(&q->sorted);
+	utl_array_init(&q->keys[0]);
+	utl_array_init(&q->keys[1]);
+	utl_array_init(&q->order[0]);
+	utl_array_init(&q->order[1]);
+}
+
+//## public
+/**
+Destructs a render queue.
+
+@param q The queue to destruct.
+*/
+void gpu_render_queue__destruct(gpu_render_queue_t* q)
+{
+	utl_array_destroy(&q->order[1]);
+	utl_array_destroy(&q->order[0]);
+	utl_array_destroy(&q->keys[1]);
+	utl_array_destroy(&q->keys[0]);
+	utl_array_destroy(&q->sorted);
+	utl_array_destroy(&q->draws);
+	clear_struct(q);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Removes every draw. Memory is kept for the next frame.
+
+@param q The queue.
+*/
+void gpu_render_queue__clear(gpu_render_queue_t* q)
+{
+	q->draws.count = 0;
+	q->sorted.count = 0;
+}
+
+//## public
+/**
+Packs a draw's state into a sort key. Each field is masked to its width, so
+ids past the limit only group less well.
+
+@param pipeline The pipeline.
+@param model_id The model's id, which selects the material set.
+@param mesh The mesh index in the model.
+@param depth View depth, 0 at the near plane and 1 at the far plane. Clamped.
+@return The key.
+*/
+uint64_t gpu_render_queue__make_key(gpu_render_pipeline_t pipeline, uint32_t model_id, uint32_t mesh, float depth)
+{
+	const uint32_t depth_max = (1u << GPU_RENDER_QUEUE_DEPTH_BITS) - 1;
+	uint64_t key;
+	uint32_t d;
+
+	depth = (depth > 0.0f) ? depth : 0.0f;
+	d = (depth < 1.0f) ? (uint32_t)(depth * (float)depth_max) : depth_max;
+
+	key = (uint64_t)pipeline & ((1u << GPU_RENDER_QUEUE_PIPELINE_BITS) - 1);
+	key = (key << GPU_RENDER_QUEUE_MODEL_BITS) | (model_id & ((1u << GPU_RENDER_QUEUE_MODEL_BITS) - 1));
+	key = (key << GPU_RENDER_QUEUE_MESH_BITS) | (mesh & ((1u << GPU_RENDER_QUEUE_MESH_BITS) - 1));
+	key = (key << GPU_RENDER_QUEUE_DEPTH_BITS) | d;
+
+	return key;
+}
+
+//## public
+/**
+Adds a draw. The packet is copied.
+
+@param q The queue.
+@param draw The draw, with its key set.
+*/
+void gpu_render_queue__push(gpu_render_queue_t* q, gpu_render_draw_t* draw)
+{
+	utl_array_push(&q->draws, *draw);
+}
+
+//## public
+/**
+Sorts the draws by key into the sorted array. Draws with equal keys keep the
+order they were pushed in.
+
+@param q The queue.
+*/
+void gpu_render_queue__sort(gpu_render_queue_t* q)
+{
+	uint32_t n = q->draws.count;
+	uint32_t result;
+	uint32_t i;
+
+	reserve(q, n);
+
+	for (i = 0; i < n; ++i)
+	{
+		q->keys[0].data[i] = q->draws.data[i].key;
+		q->order[0].data[i] = i;
+	}
+
+	result = radix_sort(q, n);
+
+	q->sorted.count = n;
+	for (i = 0; i < n; ++i)
+	{
+		q->sorted.data[i] = q->draws.data[q->order[result].data[i]];
+	}
+}
+
+//## public
+/**
+Sorts the draws and records them with one call into the backend.
+
+@param q The queue.
+@param gpu The GPU context.
+@param window The window to render to.
+@param frame The frame being recorded.
+*/
+void gpu_render_queue__submit(gpu_render_queue_t* q, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame)
+{
+	gpu_render_queue__sort(q);
+
+	if (q->sorted.count > 0)
+	{
+		gpu->intf->static_model__render_batch(gpu, window, frame, q->sorted.data, q->sorted.count);
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Sorts keys[0] and order[0] with a least significant digit radix sort. The
+histograms for every digit are built in one pass, and a digit that is the
+same for every key is skipped, so unused key bits cost nothing.
+
+@return The index of the key/order arrays that hold the result.
+*/
+static uint32_t radix_sort(gpu_render_queue_t* q, uint32_t n)
+{
+	uint32_t hist[RADIX_PASSES][RADIX_SIZE];
+	uint32_t* count;
+	uint64_t* keys_in;
+	uint64_t* keys_out;
+	uint32_t* order_in;
+	uint32_t* order_out;
+	uint32_t src = 0;
+	uint32_t sum;
+	uint32_t shift;
+	uint32_t digit;
+	uint32_t pass;
+	uint32_t i;
+
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	memset(hist, 0, sizeof(hist));
+	for (i = 0; i < n; ++i)
+	{
+		for (pass = 0; pass < RADIX_PASSES; ++pass)
+		{
+			hist[pass][(q->keys[0].data[i] >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	for (pass = 0; pass < RADIX_PASSES; ++pass)
+	{
+		shift = pass * RADIX_BITS;
+		count = hist[pass];
+
+		if (count[(q->keys[0].data[0] >> shift) & (RADIX_SIZE - 1)] == n)
+		{
+			continue;
+		}
+
+		/* Counts to starting offsets */
+		sum = 0;
+		for (i = 0; i < RADIX_SIZE; ++i)
+		{
+			digit = count[i];
+			count[i] = sum;
+			sum += digit;
+		}
+
+		keys_in = q->keys[src].data;
+		keys_out = q->keys[src ^ 1].data;
+		order_in = q->order[src].data;
+		order_out = q->order[src ^ 1].data;
+
+		for (i = 0; i < n; ++i)
+		{
+			digit = (uint32_t)(keys_in[i] >> shift) & (RADIX_SIZE - 1);
+			keys_out[count[digit]] = keys_in[i];
+			order_out[count[digit]] = order_in[i];
+			count[digit]++;
+		}
+
+		src ^= 1;
+	}
+
+	return src;
+}
+
+//## static
+/**
+Makes sure the sort arrays can hold a number of draws.
+*/
+static void reserve(gpu_render_queue_t* q, uint32_t n)
+{
+	if (n <= q->sorted.max)
+	{
+		return;
+	}
+
+	utl_array_reserve(&q->sorted, n);
+	utl_array_reserve(&q->keys[0], n);
+	utl_array_reserve(&q->keys[1], n);
+	utl_array_reserve(&q->order[0], n);
+	utl_array_reserve(&q->order[1], n);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef GPU_RENDER_QUEUE_H
+#define GPU_RENDER_QUEUE_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "gpu/gpu_.h"
+#include "gpu/gpu_frame_.h"
+#include "gpu/gpu_render_queue_.h"
+#include "gpu/gpu_static_model_.h"
+#include "gpu/gpu_window_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+Draw key layout, most significant bits first. Draws sort by pipeline, then
+material set (the model), then mesh, then front to back.
+*/
+#define GPU_RENDER_QUEUE_PIPELINE_BITS		(4)
+#define GPU_RENDER_QUEUE_MODEL_BITS			(20)
+#define GPU_RENDER_QUEUE_MESH_BITS			(16)
+#define GPU_RENDER_QUEUE_DEPTH_BITS			(24)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Pipelines a draw can use.
+*/
+typedef enum
+{
+	GPU_RENDER_PIPELINE_STATIC_MODEL,
+	GPU_RENDER_PIPELINE_COUNT
+
+} gpu_render_pipeline_t;
+
+/**
+One draw packet.
+*/
+typedef struct
+{
+	uint64_t					key;			/* Sort key from gpu_render_queue__make_key. */
+	gpu_render_pipeline_t		pipeline;
+	gpu_static_model_t*			model;			/* Provides the material set and mesh. */
+	uint32_t					mesh;			/* Index of the mesh in the model. */
+	kk_mat4_t*					world_matrix;	/* Instance data. Must stay valid until the queue is submitted. */
+
+} gpu_render_draw_t;
+
+utl_array_declare_type(gpu_render_draw_t);
+
+/**
+Draws pushed by systems during a frame. The queue is sorted once by key,
+then handed to the backend in one call.
+*/
+struct gpu_render_queue_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(gpu_render_draw_t)	draws;		/* In the order they were pushed. */
+	utl_array_t(gpu_render_draw_t)	sorted;		/* Draws in key order after sorting. */
+	utl_array_t(uint64_t)			keys[2];	/* Radix sort keys, ping-ponged between passes. */
+	utl_array_t(uint32_t)			order[2];	/* Draw index for each key. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/gpu_render_queue.public.h"
+
+#endif /* GPU_RENDER_QUEUE_H */
\ No newline at end of file
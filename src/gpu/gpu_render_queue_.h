@@ -0,0 +1,10 @@
+#ifndef GPU_RENDER_QUEUE__H
+#define GPU_RENDER_QUEUE__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct gpu_render_queue_s gpu_render_queue_t;
+
+#endif /* GPU_RENDER_QUEUE__H */
\ No newline at end of file
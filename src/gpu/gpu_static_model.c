@@ -2,12 +2,16 @@
 INCLUDES
 =========================================================*/
 
+#include <math.h>
+
 #include "common.h"
 #include "global.h"
 #include "ecs/components/ecs_transform.h"
+#include "engine/kk_bvh.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
 #include "gpu/gpu_material.h"
+#include "gpu/gpu_mesh_opt.h"
 #include "gpu/gpu_static_model.h"
 #include "platform/platform.h"
 #include "thirdparty/tinyobj/tinyobj.h"
@@ -19,6 +23,8 @@ INCLUDES
 VARIABLES
 =========================================================*/
 
+static uint32_t s_next_id;		/* Id for the next model constructed. */
+
 /*=========================================================
 DECLARATIONS
 =========================================================*/
@@ -40,7 +46,9 @@ void gpu_static_model__construct(gpu_static_model_t* model, gpu_t* gpu, const ch
 	kk_log__dbg_fmt("gpu_static_model__construct: %s", filename);
 
 	clear_struct(model);
+	model->id = s_next_id++;
 	utl_array_init(&model->materials);
+	utl_array_init(&model->mesh_bounds);
 
 	long size;
 	tinyobj_t obj;
@@ -64,9 +72,25 @@ void gpu_static_model__construct(gpu_static_model_t* model, gpu_t* gpu, const ch
 
 	kk_log__dbg("gpu_static_model__construct - materials loaded");
 
+	/* Bounds, shape and triangles are kept on the CPU for collision, queries and culling */
+	compute_bounds(&obj.attrib, NULL, obj.attrib.num_vertices, &model->bounds, &model->sphere);
+
+	utl_array_resize(&model->mesh_bounds, obj.shapes_cnt);
+	for (int i = 0; i < obj.shapes_cnt; ++i)
+	{
+		gpu_static_mesh_bounds_t* mesh = &model->mesh_bounds.data[i];
+		compute_bounds(&obj.attrib, &obj.attrib.faces[obj.shapes[i].face_offset * 3], obj.shapes[i].length * 3, &mesh->box, &mesh->sphere);
+	}
+	kk_shape__construct_from_points(&model->shape, obj.attrib.vertices, obj.attrib.num_vertices);
+	build_bvh(&obj.attrib, &model->bvh);
+
 	/* Construct */
 	gpu->intf->static_model__construct(model, gpu, &obj);
 
+	kk_log__dbg_fmt("gpu_static_model__construct - ACMR %.3f -> %.3f (%u -> %u misses, %u triangles)",
+		gpu_mesh_opt__get_acmr(&model->cache_stats, FALSE), gpu_mesh_opt__get_acmr(&model->cache_stats, TRUE),
+		model->cache_stats.misses_before, model->cache_stats.misses_after, model->cache_stats.num_triangles);
+
 	/* Free obj */
 	tinyobj_attrib_free(&obj.attrib);
 	tinyobj_shapes_free(obj.shapes, obj.shapes_cnt);
@@ -93,6 +117,9 @@ void gpu_static_model__destruct(gpu_static_model_t* model, gpu_t* gpu)
 	}
 
 	utl_array_destroy(&model->materials);
+	utl_array_destroy(&model->mesh_bounds);
+	kk_shape__destruct(&model->shape);
+	kk_bvh__destruct(&model->bvh);
 }
 
 /*=========================================================
@@ -117,6 +144,87 @@ void gpu_static_model__render
 STATIC FUNCTIONS
 =========================================================*/
 
+//## static
+/**
+Builds the triangle tree from the faces, which are triangulated on load.
+*/
+static void build_bvh(tinyobj_attrib_t* attrib, kk_bvh_t* out__bvh)
+{
+	utl_array_t(uint32_t) indices;
+	unsigned int i;
+
+	utl_array_init(&indices);
+	utl_array_resize(&indices, attrib->num_faces);
+
+	for (i = 0; i < attrib->num_faces; ++i)
+	{
+		indices.data[i] = (uint32_t)attrib->faces[i].v_idx;
+	}
+
+	kk_bvh__construct(out__bvh, attrib->vertices, indices.data, attrib->num_faces / 3);
+	utl_array_destroy(&indices);
+}
+
+//## static
+/**
+Computes the bounds of a set of vertices, either the first count vertices or
+those referenced by count face indices. The sphere is centered on the box
+and reaches the farthest vertex, which is tighter than the box's corners.
+No vertices gets empty bounds at the origin.
+*/
+static void compute_bounds
+	(
+	tinyobj_attrib_t*				attrib,
+	const tinyobj_vertex_index_t*	faces,
+	unsigned int					count,
+	kk_aabb_t*						out__box,
+	kk_sphere_t*					out__sphere
+	)
+{
+	kk_vec3_t d;
+	float radius_sq = 0.0f;
+	float* v;
+	unsigned int i;
+
+	clear_struct(out__box);
+	clear_struct(out__sphere);
+	if (count == 0)
+	{
+		return;
+	}
+
+	v = get_vertex(attrib, faces, 0);
+	out__box->min.x = out__box->max.x = v[0];
+	out__box->min.y = out__box->max.y = v[1];
+	out__box->min.z = out__box->max.z = v[2];
+
+	for (i = 1; i < count; ++i)
+	{
+		v = get_vertex(attrib, faces, i);
+		out__box->min.x = min(out__box->min.x, v[0]);
+		out__box->min.y = min(out__box->min.y, v[1]);
+		out__box->min.z = min(out__box->min.z, v[2]);
+		out__box->max.x = max(out__box->max.x, v[0]);
+		out__box->max.y = max(out__box->max.y, v[1]);
+		out__box->max.z = max(out__box->max.z, v[2]);
+	}
+
+	out__sphere->center.x = 0.5f * (out__box->min.x + out__box->max.x);
+	out__sphere->center.y = 0.5f * (out__box->min.y + out__box->max.y);
+	out__sphere->center.z = 0.5f * (out__box->min.z + out__box->max.z);
+
+	for (i = 0; i < count; ++i)
+	{
+		v = get_vertex(attrib, faces, i);
+		d.x = v[0] - out__sphere->center.x;
+		d.y = v[1] - out__sphere->center.y;
+		d.z = v[2] - out__sphere->center.z;
+		radius_sq = max(radius_sq, d.x * d.x + d.y * d.y + d.z * d.z);
+	}
+
+	out__sphere->radius = sqrtf(radius_sq);
+}
+
 //## static
 static void file_reader
 	(
@@ -145,3 +253,13 @@ static void file_reader
 		*buf = NULL;
 	}
 }
+
+//## static
+/**
+Gets a vertex position, the i-th vertex or the one referenced by the i-th
+face index.
+*/
+static float* get_vertex(tinyobj_attrib_t* attrib, const tinyobj_vertex_index_t* faces, unsigned int i)
+{
+	return &attrib->vertices[(faces ? (unsigned int)faces[i].v_idx : i) * 3];
+}
\ No newline at end of file
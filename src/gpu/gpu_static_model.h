@@ -17,6 +17,10 @@ INCLUDES
 =========================================================*/
 
 #include "common.h"
+#include "engine/kk_bvh.h"
+#include "engine/kk_math.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_mesh_opt.h"
 #include "utl/utl_array.h"
 #include "thirdparty/tinyobj/tinyobj.h"
 
@@ -26,10 +30,29 @@ TYPES
 
 utl_array_declare_type(gpu_material_t);
 
+/**
+Model space bounds of one mesh.
+*/
+typedef struct
+{
+	kk_aabb_t						box;
+	kk_sphere_t						sphere;		/* Centered on the box, just reaching the farthest vertex. */
+
+} gpu_static_mesh_bounds_t;
+
+utl_array_declare_type(gpu_static_mesh_bounds_t);
+
 struct gpu_static_model_s
 {
 	void*							data;		/* Pointer to GPU-specific data. */
+	uint32_t						id;			/* Unique among loaded models. Used to sort draws. */
 	utl_array_t(gpu_material_t)		materials;
+	utl_array_t(gpu_static_mesh_bounds_t)	mesh_bounds;	/* One per mesh, in the order the backends build them (one per OBJ shape). */
+	kk_aabb_t						bounds;		/* Model space bounds of every vertex. */
+	kk_sphere_t						sphere;		/* Centered on bounds, just reaching the farthest vertex. */
+	kk_shape_t						shape;		/* Convex collision shape built from the vertices. */
+	kk_bvh_t						bvh;		/* Model space triangles for world queries. */
+	gpu_mesh_opt_stats_t			cache_stats;	/* Stat. Vertex cache misses before and after mesh optimization, filled in by the backend. */
 };
 
 /*=========================================================
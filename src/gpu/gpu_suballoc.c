@@ -0,0 +1,238 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "gpu/gpu_suballoc.h"
+#include "utl/utl_array.h"
+
+#include "autogen/gpu_suballoc.static.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs an allocator with the whole range free.
+
+@param a The allocator to construct.
+@param size The size of the range.
+*/
+void gpu_suballoc__construct(gpu_suballoc_t* a, uint64_t size)
+{
+	gpu_suballoc_block_t block;
+
+	clear_struct(a);
+	a->size = size;
+	utl_array_init(&a->free_blocks);
+
+	block.offset = 0;
+	block.size = size;
+	utl_array_push(&a->free_blocks, block);
+}
+
+//## public
+/**
+Destructs an allocator. Live allocations are simply forgotten.
+
+@param a The allocator to destruct.
+*/
+void gpu_suballoc__destruct(gpu_suballoc_t* a)
+{
+	utl_array_destroy(&a->free_blocks);
+	clear_struct(a);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Allocates a range. The alignment does not have to be a power of two, so
+vertex data can be aligned to its stride.
+
+@param a The allocator.
+@param size The size to allocate. Must not be 0.
+@param alignment The offset is a multiple of this.
+@param out__offset Receives the offset of the allocation.
+@return TRUE if the range was allocated, FALSE if no free range fits.
+*/
+boolean gpu_suballoc__alloc(gpu_suballoc_t* a, uint64_t size, uint64_t alignment, uint64_t* out__offset)
+{
+	gpu_suballoc_block_t* block;
+	gpu_suballoc_block_t tail;
+	uint64_t offset;
+	uint64_t padding;
+	uint32_t i;
+
+	alignment = max(alignment, 1);
+
+	for (i = 0; i < a->free_blocks.count; ++i)
+	{
+		block = &a->free_blocks.data[i];
+		offset = (block->offset + alignment - 1) / alignment * alignment;
+		padding = offset - block->offset;
+		if (padding + size > block->size)
+		{
+			continue;
+		}
+
+		/* What is left after the allocation stays free */
+		tail.offset = offset + size;
+		tail.size = block->size - padding - size;
+
+		/* Padding before the allocation stays free too */
+		if (padding > 0)
+		{
+			block->size = padding;
+			if (tail.size > 0)
+			{
+				insert_block(a, i + 1, tail);
+			}
+		}
+		else if (tail.size > 0)
+		{
+			*block = tail;
+		}
+		else
+		{
+			remove_block(a, i);
+		}
+
+		a->used += size;
+		a->num_allocs++;
+		*out__offset = offset;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+//## public
+/**
+Frees a range returned by gpu_suballoc__alloc.
+
+@param a The allocator.
+@param offset The offset of the allocation.
+@param size The size it was allocated with.
+*/
+void gpu_suballoc__free(gpu_suballoc_t* a, uint64_t offset, uint64_t size)
+{
+	gpu_suballoc_block_t block;
+	gpu_suballoc_block_t* prev;
+	gpu_suballoc_block_t* next;
+	uint32_t i;
+
+	/* Find where the range goes in the sorted list */
+	for (i = 0; i < a->free_blocks.count && a->free_blocks.data[i].offset < offset; ++i);
+
+	prev = (i > 0) ? &a->free_blocks.data[i - 1] : NULL;
+	next = (i < a->free_blocks.count) ? &a->free_blocks.data[i] : NULL;
+
+	if ((prev && prev->offset + prev->size > offset)
+		|| (next && offset + size > next->offset))
+	{
+		kk_log__fatal("Freed range overlaps free space.");
+	}
+
+	a->used -= size;
+	a->num_allocs--;
+
+	/* Merge with the neighbours where they touch */
+	if (prev && prev->offset + prev->size == offset)
+	{
+		prev->size += size;
+		if (next && offset + size == next->offset)
+		{
+			prev->size += next->size;
+			remove_block(a, i);
+		}
+	}
+	else if (next && offset + size == next->offset)
+	{
+		next->offset = offset;
+		next->size += size;
+	}
+	else
+	{
+		block.offset = offset;
+		block.size = size;
+		insert_block(a, i, block);
+	}
+}
+
+//## public
+/**
+Gets external fragmentation: how much of the free space is unusable by an
+allocation as large as all of it. 0 when the free space is one range, near
+1 when it is scattered in small pieces.
+
+@param a The allocator.
+@return The fragmentation from 0 to 1.
+*/
+float gpu_suballoc__get_fragmentation(const gpu_suballoc_t* a)
+{
+	uint64_t total = a->size - a->used;
+
+	if (total == 0)
+	{
+		return 0.0f;
+	}
+
+	return 1.0f - (float)gpu_suballoc__get_largest_free(a) / (float)total;
+}
+
+//## public
+/**
+Gets the size of the largest free range, which is the largest allocation
+that can succeed without alignment padding.
+
+@param a The allocator.
+@return The size in bytes.
+*/
+uint64_t gpu_suballoc__get_largest_free(const gpu_suballoc_t* a)
+{
+	uint64_t largest = 0;
+	uint32_t i;
+
+	for (i = 0; i < a->free_blocks.count; ++i)
+	{
+		largest = max(largest, a->free_blocks.data[i].size);
+	}
+
+	return largest;
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+Inserts a free range at an index of the sorted list.
+*/
+static void insert_block(gpu_suballoc_t* a, uint32_t idx, gpu_suballoc_block_t block)
+{
+	utl_array_push(&a->free_blocks, block);
+	memmove(&a->free_blocks.data[idx + 1], &a->free_blocks.data[idx], sizeof(gpu_suballoc_block_t) * (a->free_blocks.count - 1 - idx));
+	a->free_blocks.data[idx] = block;
+}
+
+//## static
+/**
+Removes the free range at an index of the sorted list.
+*/
+static void remove_block(gpu_suballoc_t* a, uint32_t idx)
+{
+	memmove(&a->free_blocks.data[idx], &a->free_blocks.data[idx + 1], sizeof(gpu_suballoc_block_t) * (a->free_blocks.count - 1 - idx));
+	a->free_blocks.count--;
+}
\ No newline at end of file
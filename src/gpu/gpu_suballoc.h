@@ -0,0 +1,63 @@
+#ifndef GPU_SUBALLOC_H
+#define GPU_SUBALLOC_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "gpu/gpu_suballoc_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+A free range of the allocator.
+*/
+struct gpu_suballoc_block_s
+{
+	uint64_t			offset;
+	uint64_t			size;
+};
+
+utl_array_declare_type(gpu_suballoc_block_t);
+
+/**
+Places allocations inside one large range, such as a GPU buffer. Free space
+is kept as a list of ranges sorted by offset. Allocation takes the first
+range that fits and freed ranges merge with their neighbours. The allocator
+only does the bookkeeping; it never touches the memory itself.
+*/
+struct gpu_suballoc_s
+{
+	/*
+	Create/destroy
+	*/
+	utl_array_t(gpu_suballoc_block_t)	free_blocks;	/* Sorted by offset, never adjacent. */
+
+	/*
+	Other
+	*/
+	uint64_t			size;			/* Size of the whole range. */
+	uint64_t			used;			/* Stat. Bytes allocated. */
+	uint32_t			num_allocs;		/* Stat. Live allocations. */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/gpu_suballoc.public.h"
+
+#endif /* GPU_SUBALLOC_H */
\ No newline at end of file
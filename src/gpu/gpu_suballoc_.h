@@ -0,0 +1,11 @@
+#ifndef GPU_SUBALLOC__H
+#define GPU_SUBALLOC__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct gpu_suballoc_s gpu_suballoc_t;
+typedef struct gpu_suballoc_block_s gpu_suballoc_block_t;
+
+#endif /* GPU_SUBALLOC__H */
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "gpu/gpu_vertex_weld.h"
+
+#include "autogen/gpu_vertex_weld.static.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define EMPTY_SLOT		(0xFFFFFFFF)
+#define FNV_OFFSET		(2166136261u)
+#define FNV_PRIME		(16777619u)
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+//## public
+/**
+Constructs a vertex weld with room for a fixed number of corners. The hash
+table is sized for the worst case of every corner being unique, so adding
+never reallocates.
+
+@param w The weld to construct.
+@param vertex_size The size of one vertex in bytes.
+@param max_corners The most corners that will be added.
+*/
+void gpu_vertex_weld__construct(gpu_vertex_weld_t* w, uint32_t vertex_size, uint32_t max_corners)
+{
+	uint32_t table_size = 16;
+
+	clear_struct(w);
+	w->vertex_size = vertex_size;
+	w->max_corners = max_corners;
+
+	/* Keep the table at most half full */
+	while (table_size < 2 * max_corners)
+	{
+		table_size *= 2;
+	}
+
+	w->table_mask = table_size - 1;
+	w->vertices = malloc((size_t)vertex_size * max(max_corners, 1));
+	w->indices = malloc(sizeof(uint32_t) * max(max_corners, 1));
+	w->table = malloc(sizeof(uint32_t) * table_size);
+	if (!w->vertices || !w->indices || !w->table)
+	{
+		kk_log__fatal("Failed to allocate memory for vertex weld.");
+	}
+
+	memset(w->table, 0xFF, sizeof(uint32_t) * table_size);
+}
+
+//## public
+/**
+Destructs a vertex weld.
+
+@param w The weld to destruct.
+*/
+void gpu_vertex_weld__destruct(gpu_vertex_weld_t* w)
+{
+	free(w->table);
+	free(w->indices);
+	free(w->vertices);
+	clear_struct(w);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+//## public
+/**
+Adds a face corner. If an identical vertex was added before its index is
+reused, otherwise the vertex is appended.
+
+@param w The weld.
+@param vertex The corner's vertex data, vertex_size bytes.
+@return The vertex index of the corner.
+*/
+uint32_t gpu_vertex_weld__add(gpu_vertex_weld_t* w, const void* vertex)
+{
+	uint32_t slot = hash_vertex(vertex, w->vertex_size) & w->table_mask;
+	uint32_t index;
+
+	if (w->num_indices >= w->max_corners)
+	{
+		kk_log__fatal("Vertex weld corner limit exceeded.");
+	}
+
+	/* Linear probe until the vertex or an empty slot is found */
+	while ((index = w->table[slot]) != EMPTY_SLOT)
+	{
+		if (memcmp(w->vertices + (size_t)index * w->vertex_size, vertex, w->vertex_size) == 0)
+		{
+			break;
+		}
+
+		slot = (slot + 1) & w->table_mask;
+	}
+
+	if (index == EMPTY_SLOT)
+	{
+		index = w->num_vertices++;
+		memcpy(w->vertices + (size_t)index * w->vertex_size, vertex, w->vertex_size);
+		w->table[slot] = index;
+	}
+
+	w->indices[w->num_indices++] = index;
+	return index;
+}
+
+//## public
+/**
+Gets the size of one index in bytes: 2 when every vertex can be addressed
+with 16 bits, 4 otherwise.
+
+@param w The weld.
+@return The index size in bytes.
+*/
+uint32_t gpu_vertex_weld__get_index_size(const gpu_vertex_weld_t* w)
+{
+	return (w->num_vertices <= GPU_VERTEX_WELD_MAX_16BIT_VERTICES) ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+//## public
+/**
+Copies the indices packed at the size from gpu_vertex_weld__get_index_size.
+
+@param w The weld.
+@param dest Receives num_indices indices.
+*/
+void gpu_vertex_weld__copy_indices(const gpu_vertex_weld_t* w, void* dest)
+{
+	uint16_t* dest16 = (uint16_t*)dest;
+	uint32_t i;
+
+	if (gpu_vertex_weld__get_index_size(w) == sizeof(uint32_t))
+	{
+		memcpy(dest, w->indices, sizeof(uint32_t) * w->num_indices);
+		return;
+	}
+
+	for (i = 0; i < w->num_indices; ++i)
+	{
+		dest16[i] = (uint16_t)w->indices[i];
+	}
+}
+
+/*=========================================================
+STATIC FUNCTIONS
+=========================================================*/
+
+//## static
+/**
+FNV-1a hash of the vertex bytes.
+*/
+static uint32_t hash_vertex(const void* vertex, uint32_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)vertex;
+	uint32_t hash = FNV_OFFSET;
+	uint32_t i;
+
+	for (i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+
+	return hash;
+}
\ No newline at end of file
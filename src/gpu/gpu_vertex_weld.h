@@ -0,0 +1,59 @@
+#ifndef GPU_VERTEX_WELD_H
+#define GPU_VERTEX_WELD_H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+#include "gpu/gpu_vertex_weld_.h"
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+/*
+The most vertices that can be addressed with 16-bit indices.
+*/
+#define GPU_VERTEX_WELD_MAX_16BIT_VERTICES	(0x10000)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+Builds an indexed mesh from face corners, merging corners whose vertex data
+is identical. Vertices are compared byte for byte, so any padding in the
+vertex type must be cleared before a vertex is added.
+*/
+struct gpu_vertex_weld_s
+{
+	/*
+	Create/destroy
+	*/
+	uint8_t*			vertices;		/* Unique vertices, vertex_size bytes each, in the order first added. */
+	uint32_t*			indices;		/* One vertex index per added corner. */
+	uint32_t*			table;			/* Open addressing hash table of vertex indices. */
+
+	/*
+	Other
+	*/
+	uint32_t			vertex_size;
+	uint32_t			max_corners;	/* Most corners that can be added. */
+	uint32_t			table_mask;
+	uint32_t			num_vertices;
+	uint32_t			num_indices;
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+#include "autogen/gpu_vertex_weld.public.h"
+
+#endif /* GPU_VERTEX_WELD_H */
\ No newline at end of file
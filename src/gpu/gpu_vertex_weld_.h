@@ -0,0 +1,10 @@
+#ifndef GPU_VERTEX_WELD__H
+#define GPU_VERTEX_WELD__H
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+typedef struct gpu_vertex_weld_s gpu_vertex_weld_t;
+
+#endif /* GPU_VERTEX_WELD__H */
\ No newline at end of file
@@ -4,6 +4,7 @@ INCLUDES
 
 #include "common.h"
 #include "global.h"
+#include "engine/kk_camera.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
 #include "gpu/gpu_frame.h"
@@ -63,6 +64,14 @@ gpu_frame_t* gpu_window__begin_frame(gpu_window_t* window, kk_camera_t* camera,
 	gpu_frame_t* frame = &window->frames[window->frame_idx];
 	frame->frame_idx = window->frame_idx;
 
+	/* Camera matrices are shared by the backend and culling */
+	if (window->height > 0)
+	{
+		kk_camera__set_aspect(camera, (float)window->width / (float)window->height);
+	}
+
+	kk_camera__update(camera);
+
 	/* Interface */
 	window->gpu->intf->window__begin_frame(window, frame, camera);
 
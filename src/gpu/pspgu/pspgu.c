@@ -83,6 +83,7 @@ void pspgu__init_gpu_intf(gpu_intf_t* intf)
 	intf->static_model__construct = pspgu_static_model__construct;
 	intf->static_model__destruct = pspgu_static_model__destruct;
 	intf->static_model__render = pspgu_static_model__render;
+	intf->static_model__render_batch = pspgu_static_model__render_batch;
 	intf->texture__construct = pspgu_texture__construct;
 	intf->texture__destruct = pspgu_texture__destruct;
 	intf->window__begin_frame = pspgu_window__begin_frame;
@@ -337,7 +338,7 @@ static void pspgu_static_model__construct(gpu_static_model_t* model, gpu_t* gpu,
 	}
 
 	/* Construct */
-	_pspgu_static_model__construct((_pspgu_static_model_t*)model->data, ctx, obj);
+	_pspgu_static_model__construct((_pspgu_static_model_t*)model->data, ctx, obj, &model->cache_stats);
 }
 
 //## static
@@ -353,20 +354,9 @@ static void pspgu_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gp
 {
 	_pspgu_t* ctx = _pspgu__get_context(gpu);
 
+	/* Use the cached model matrix */
 	sceGumMatrixMode(GU_MODEL);
- 	sceGumLoadIdentity();
- 	{
-		/* Translate */
- 		sceGumTranslate(&transform->pos);
-
-		/* Scale */
-		sceGumScale(&transform->scale);
-
-		/* Rotate */
-		kk_mat4_t rotation_matrix;
-		kk_math_quat_mat4(&transform->rot, &rotation_matrix);
-		sceGumMultMatrix(&rotation_matrix);
- 	}
+	sceGumLoadMatrix(&transform->world_matrix);
 
 	/* Setup material */
 	//if (material)
@@ -392,6 +382,82 @@ static void pspgu_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gp
 	_pspgu_static_model__render((_pspgu_static_model_t*)model->data, ctx);
 }
 
+//## static
+static void pspgu_static_model__render_batch(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count)
+{
+	_pspgu_t* ctx = _pspgu__get_context(gpu);
+	_pspgu_static_model_t* psp_model;
+	kk_mat4_t* world_matrix = NULL;
+	gpu_render_draw_t* draw;
+	uint32_t start;
+	uint32_t end;
+	uint32_t run;
+	uint32_t num_runs;
+	uint32_t i;
+	uint32_t j;
+
+	sceGumMatrixMode(GU_MODEL);
+
+	/*
+	Draws are sorted by model and then mesh. The GU has no instancing and
+	gains nothing from mesh order, so each model is drawn instance by
+	instance instead, loading each matrix once.
+	*/
+	for (start = 0; start < count; start = end)
+	{
+		for (end = start + 1; end < count && draws[end].model == draws[start].model; ++end);
+
+		run = get_instance_run_length(&draws[start], end - start);
+		num_runs = (end - start) / run;
+
+		for (j = 0; j < run; ++j)
+		{
+			for (i = 0; i < num_runs; ++i)
+			{
+				draw = &draws[start + i * run + j];
+
+				if (draw->world_matrix != world_matrix)
+				{
+					world_matrix = draw->world_matrix;
+					sceGumLoadMatrix(world_matrix);
+				}
+
+				psp_model = (_pspgu_static_model_t*)draw->model->data;
+				_pspgu_static_mesh__render(&psp_model->meshes.data[draw->mesh], ctx);
+			}
+		}
+	}
+}
+
+//## static
+/**
+Gets the length of each mesh's run in a model's sorted draws when every
+mesh was queued for the same instances in the same order, which is the
+usual case. Otherwise returns count, so the draws are used in sorted order.
+*/
+static uint32_t get_instance_run_length(gpu_render_draw_t* draws, uint32_t count)
+{
+	uint32_t run;
+	uint32_t i;
+
+	for (run = 1; run < count && draws[run].mesh == draws[0].mesh; ++run);
+
+	if (count % run != 0)
+	{
+		return count;
+	}
+
+	for (i = run; i < count; ++i)
+	{
+		if (draws[i].world_matrix != draws[i % run].world_matrix)
+		{
+			return count;
+		}
+	}
+
+	return run;
+}
+
 //## static
 static void pspgu_texture__construct(gpu_texture_t* texture, gpu_t* gpu, void* img, int width, int height)
 {
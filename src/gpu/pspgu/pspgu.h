@@ -5,6 +5,7 @@
 DECLARATIONS
 =========================================================*/
 
+#include "gpu/gpu_mesh_opt_.h"
 #include "gpu/pspgu/pspgu_.h"
 
 /*=========================================================
@@ -33,11 +34,13 @@ struct _pspgu_static_mesh_s
 	Create/destroy
 	*/
 	_pspgu_vertex_t* vertex_array;
+	uint16_t* index_array;		/* NULL if the mesh has too many vertices for 16-bit indices. */
 
 	/*
 	Other
 	*/
 	int num_verts;
+	int num_indices;
 };
 
 struct _pspgu_static_model_s
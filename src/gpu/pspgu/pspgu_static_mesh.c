@@ -4,9 +4,12 @@ INCLUDES
 
 #include <pspgu.h>
 #include <pspgum.h>
+#include <stddef.h>
 
 #include "common.h"
 #include "engine/kk_log.h"
+#include "gpu/gpu_mesh_opt.h"
+#include "gpu/gpu_vertex_weld.h"
 #include "gpu/pspgu/pspgu.h"
 #include "thirdparty/tinyobj/tinyobj.h"
 #include "utl/utl.h"
@@ -35,16 +38,18 @@ void _pspgu_static_mesh__construct
 	_pspgu_static_mesh_t*		mesh,
 	_pspgu_t*					ctx,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats
 	)
 {
 	clear_struct(mesh);
-	load_mesh(mesh, ctx, obj, obj_shape);
+	load_mesh(mesh, ctx, obj, obj_shape, stats);
 }
 
 //## internal
 void _pspgu_static_mesh__destruct(_pspgu_static_mesh_t* mesh)
 {
+	free(mesh->index_array);
 	free(mesh->vertex_array);
 }
 
@@ -59,8 +64,16 @@ void _pspgu_static_mesh__render
 	_pspgu_t*					ctx
 	)
 {
- 	// draw cube
- 	sceGumDrawArray(GU_TRIANGLES, GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_32BITF | GU_TRANSFORM_3D, mesh->num_verts, 0, mesh->vertex_array);	
+	int vtype = GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_32BITF | GU_TRANSFORM_3D;
+
+	if (mesh->index_array)
+	{
+		sceGumDrawArray(GU_TRIANGLES, vtype | GU_INDEX_16BIT, mesh->num_indices, mesh->index_array, mesh->vertex_array);
+	}
+	else
+	{
+		sceGumDrawArray(GU_TRIANGLES, vtype, mesh->num_verts, 0, mesh->vertex_array);
+	}
 }
 
 //## static
@@ -70,56 +83,81 @@ static void load_mesh
 	_pspgu_static_mesh_t*		mesh,
 	_pspgu_t*					ctx,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats
 	)
 {
-	/* For now going wasteful and not eliminating duplicate vertex data */
+	gpu_vertex_weld_t weld;
+	_pspgu_vertex_t vert;
 	int num_faces = obj_shape->length;
-	int num_verts = num_faces * 3;
-	mesh->num_verts = num_verts;
-
-	kk_log__dbg_fmt("Loading mesh: verts(%i), faces(%i)", num_verts, num_faces);
-
-	/* Allocate memory for the vertex data */
-	uint32_t vert_array_size = sizeof(_pspgu_vertex_t) * num_verts;
-	mesh->vertex_array = malloc(vert_array_size);
-	if (!mesh->vertex_array)
-	{
-		kk_log__fatal("Failed to allocate memory for mesh vertices.");
-	}
-
-	/* Go through faces and determine the number of vertices we actually need */
 	int first_face_idx = obj_shape->face_offset;
 	int last_face_idx = first_face_idx + obj_shape->length;
-	uint16_t index = 0;
 
-	/* Populate buffers with data */
+	kk_log__dbg_fmt("Loading mesh: faces(%i)", num_faces);
+
+	/* Merge face corners that share position, tex coord and material color */
+	gpu_vertex_weld__construct(&weld, sizeof(vert), num_faces * 3);
+
 	for (int i = first_face_idx; i < last_face_idx; ++i)
 	{
 		for (int j = 0; j < 3; ++j)
 		{
 			int v_idx = obj->attrib.faces[i * 3 + j].v_idx;
 			int vt_idx = obj->attrib.faces[i * 3 + j].vt_idx;
-			//int vn_idx = obj->attrib.faces[i * 3 + j].vn_idx;
-
-			mesh->vertex_array[index].x = obj->attrib.vertices[v_idx * 3 + 0];
-			mesh->vertex_array[index].y = obj->attrib.vertices[v_idx * 3 + 1];
-			mesh->vertex_array[index].z = obj->attrib.vertices[v_idx * 3 + 2];
-							
-			//mesh->vertex_array[index].normal.x = obj->attrib.normals[vn_idx * 3 + 0];
-			//mesh->vertex_array[index].normal.y = obj->attrib.normals[vn_idx * 3 + 1];
-			//mesh->vertex_array[index].normal.z = obj->attrib.normals[vn_idx * 3 + 2];
-							
-			mesh->vertex_array[index].u = obj->attrib.texcoords[vt_idx * 2 + 0];
-			mesh->vertex_array[index].v = obj->attrib.texcoords[vt_idx * 2 + 1];
+
+			/* The weld compares raw bytes */
+			clear_struct(&vert);
+
+			vert.x = obj->attrib.vertices[v_idx * 3 + 0];
+			vert.y = obj->attrib.vertices[v_idx * 3 + 1];
+			vert.z = obj->attrib.vertices[v_idx * 3 + 2];
+
+			vert.u = obj->attrib.texcoords[vt_idx * 2 + 0];
+			vert.v = obj->attrib.texcoords[vt_idx * 2 + 1];
 
 			int material_id = obj->attrib.material_ids[i];
 			tinyobj_material_t* mat = &obj->materials[material_id];
-			mesh->vertex_array[index].color = utl_pack_rgba_float(mat->diffuse[0], mat->diffuse[1], mat->diffuse[2], 1.0f);
+			vert.color = utl_pack_rgba_float(mat->diffuse[0], mat->diffuse[1], mat->diffuse[2], 1.0f);
 
-			index++;
+			gpu_vertex_weld__add(&weld, &vert);
 		}
 	}
 
-	kk_log__dbg("Loading mesh: done");
-}
+	/* Reorder for the vertex cache, overdraw and vertex fetch */
+	gpu_mesh_opt__optimize(&weld, offsetof(_pspgu_vertex_t, x), stats);
+
+	if (gpu_vertex_weld__get_index_size(&weld) == sizeof(uint16_t))
+	{
+		/* Take the welded vertices and 16-bit indices */
+		mesh->num_verts = weld.num_vertices;
+		mesh->num_indices = weld.num_indices;
+		mesh->vertex_array = malloc(sizeof(_pspgu_vertex_t) * mesh->num_verts);
+		mesh->index_array = malloc(sizeof(uint16_t) * mesh->num_indices);
+		if (!mesh->vertex_array || !mesh->index_array)
+		{
+			kk_log__fatal("Failed to allocate memory for mesh.");
+		}
+
+		memcpy(mesh->vertex_array, weld.vertices, sizeof(_pspgu_vertex_t) * mesh->num_verts);
+		gpu_vertex_weld__copy_indices(&weld, mesh->index_array);
+	}
+	else
+	{
+		/* The GE has no 32-bit indices, so very large meshes stay unindexed */
+		mesh->num_verts = weld.num_indices;
+		mesh->vertex_array = malloc(sizeof(_pspgu_vertex_t) * mesh->num_verts);
+		if (!mesh->vertex_array)
+		{
+			kk_log__fatal("Failed to allocate memory for mesh vertices.");
+		}
+
+		for (uint32_t i = 0; i < weld.num_indices; ++i)
+		{
+			mesh->vertex_array[i] = ((_pspgu_vertex_t*)weld.vertices)[weld.indices[i]];
+		}
+	}
+
+	gpu_vertex_weld__destruct(&weld);
+
+	kk_log__dbg_fmt("Loading mesh: done, verts(%i), indices(%i)", mesh->num_verts, mesh->num_indices);
+}
\ No newline at end of file
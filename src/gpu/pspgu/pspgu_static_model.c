@@ -31,12 +31,13 @@ void _pspgu_static_model__construct
 	(
 	_pspgu_static_model_t*		model,
 	_pspgu_t*					ctx,
-	const tinyobj_t*			obj
+	const tinyobj_t*			obj,
+	gpu_mesh_opt_stats_t*		stats
 	)
 {
 	clear_struct(model);
 
-	create_meshes(model, ctx, obj);
+	create_meshes(model, ctx, obj, stats);
 }
 
 //## internal
@@ -64,7 +65,7 @@ void _pspgu_static_model__render
 
 //## static
 /** Initializes the meshes in the model. */
-static void create_meshes(_pspgu_static_model_t* model, _pspgu_t* ctx, const tinyobj_t* obj)
+static void create_meshes(_pspgu_static_model_t* model, _pspgu_t* ctx, const tinyobj_t* obj, gpu_mesh_opt_stats_t* stats)
 {
 	uint32_t num_meshes = obj->shapes_cnt;
 	kk_log__dbg_fmt("Creating static meshes: %i", num_meshes);
@@ -74,7 +75,7 @@ static void create_meshes(_pspgu_static_model_t* model, _pspgu_t* ctx, const tin
 
 	for (uint32_t i = 0; i < num_meshes; ++i)
 	{
-		_pspgu_static_mesh__construct(&model->meshes.data[i], ctx, obj, &obj->shapes[i]);
+		_pspgu_static_mesh__construct(&model->meshes.data[i], ctx, obj, &obj->shapes[i], stats);
 	}
 }
 
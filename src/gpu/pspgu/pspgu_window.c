@@ -35,6 +35,9 @@ void pspgu_window__construct(
 	uint32_t width,
 	uint32_t height)
 {
+	/* The display is a fixed size, and culling uses the window's aspect */
+	window->width = SCREEN_WIDTH;
+	window->height = SCREEN_HEIGHT;
 }
 
 //## public
@@ -59,21 +62,12 @@ void pspgu_window__begin_frame(gpu_window_t* window, gpu_frame_t* frame, kk_came
 	sceGuClearDepth(0);
 	sceGuClear(GU_COLOR_BUFFER_BIT | GU_DEPTH_BUFFER_BIT);
 
-	/* Setup projection matrix */
+	/* Cached camera matrices */
 	sceGumMatrixMode(GU_PROJECTION);
-	sceGumLoadIdentity();
-	sceGumPerspective(45.0f, 16.0f / 9.0f, 0.5f, 1000.0f);
+	sceGumLoadMatrix(&cam->proj);
 
-	/* Setup view matrix */
 	sceGumMatrixMode(GU_VIEW);
-	sceGumLoadIdentity();
-
-	ScePspFVector3 look_at;
-	look_at.x = cam->pos.x + cam->dir.x;
-	look_at.y = cam->pos.y + cam->dir.y;
-	look_at.z = cam->pos.z + cam->dir.z;
-
-	sceGumLookAt(&cam->pos, &look_at, &cam->up);
+	sceGumLoadMatrix(&cam->view);
 
 
 
@@ -104,4 +98,6 @@ void pspgu_window__render_imgui(gpu_window_t* window, gpu_frame_t* frame, ImDraw
 //## public
 void pspgu_window__resize(gpu_window_t* window, uint32_t width, uint32_t height)
 {
+	window->width = SCREEN_WIDTH;
+	window->height = SCREEN_HEIGHT;
 }
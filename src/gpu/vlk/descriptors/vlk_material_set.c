@@ -74,7 +74,7 @@ void _vlk_material_set__bind
 	)
 {
 	uint32_t firstSetNum = 1; // TODO ??
-	vkCmdBindDescriptorSets(frame->cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, firstSetNum, 1, &set->sets[frame->image_idx], 0, NULL);
+	_vlk_cmd_state__bind_descriptor_set(&frame->state, pipelineLayout, firstSetNum, set->sets[frame->image_idx]);
 }
 
 /*=========================================================
@@ -66,13 +66,13 @@ _vlk_per_view_set__bind
 void _vlk_per_view_set__bind
 	(
 	_vlk_descriptor_set_t*			set,
-	VkCommandBuffer					cmd_buf,
+	_vlk_cmd_state_t*				state,
 	_vlk_frame_t*					frame,
 	VkPipelineLayout				pipelineLayout
 	)
 {
 	uint32_t setNum = 0; // TODO : hardcoded for now
-	vkCmdBindDescriptorSets(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setNum, 1, &set->sets[frame->image_idx], 0, NULL);
+	_vlk_cmd_state__bind_descriptor_set(state, pipelineLayout, setNum, set->sets[frame->image_idx]);
 }
 
 /**
@@ -82,24 +82,18 @@ void _vlk_per_view_set__update
 	(
 	_vlk_descriptor_set_t*			set,
 	_vlk_frame_t*					frame,
-	kk_camera_t*					camera,
-	VkExtent2D						extent
+	kk_camera_t*					camera
 	)
 {
 	_vlk_per_view_ubo_t ubo;
 	clear_struct(&ubo);
 
-	/* View matrix */
-	vec3 look_at;
-	kk_math_vec3_add(&camera->pos, &camera->dir, &look_at);
-	kk_math_lookat(&camera->pos, &look_at, &camera->up, &ubo.view);
-
-	/* Projection matrix */
-	kk_math_perspective(kk_math_rad(45.0f), extent.width / (float)extent.height, 0.1f, 1000.0f, &ubo.proj);
+	/* Cached camera matrices, with y flipped for Vulkan's clip space */
+	ubo.view = camera->view;
+	ubo.proj = camera->proj;
 	ubo.proj.y.y *= -1;
 
 	/* Camera position */
-	//camera__get_pos(camera, &ubo.camera_pos);
 	kk_math_vec3_copy(&camera->pos, &ubo.camera_pos);
 	
 	/* Update the UBO */
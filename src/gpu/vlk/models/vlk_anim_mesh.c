@@ -101,18 +101,15 @@ void _vlk_anim_mesh__prepare
 void _vlk_anim_mesh__render
 	(
 	_vlk_anim_mesh_t*			mesh,
-	VkCommandBuffer				cmd,
+	_vlk_cmd_state_t*			state,
 	const ecs_transform_t*		transform
 	)
 {
-	VkBuffer vertBufs[] = { mesh->vertex_buffer.handle };
-	VkDeviceSize vertBufOffsets[] = { 0 };
-	
 	// TODO : Model matrix transform
 
-	vkCmdBindVertexBuffers(cmd, 0, 1, vertBufs, vertBufOffsets);
-	vkCmdBindIndexBuffer(cmd, mesh->index_buffer.handle, 0, VK_INDEX_TYPE_UINT16);
-	vkCmdDrawIndexed(cmd, mesh->num_indices, 1, 0, 0, 0);
+	_vlk_cmd_state__bind_vertex_buffer(state, 0, mesh->vertex_buffer.handle, 0);
+	_vlk_cmd_state__bind_index_buffer(state, mesh->index_buffer.handle, 0, VK_INDEX_TYPE_UINT16);
+	vkCmdDrawIndexed(state->cmd, mesh->num_indices, 1, 0, 0, 0);
 }
 
 static void create_buffers(_vlk_anim_mesh_t* mesh, _vlk_dev_t* dev)
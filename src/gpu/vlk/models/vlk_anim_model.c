@@ -53,13 +53,13 @@ FUNCTIONS
 void _vlk_anim_model__render
 	(
 	_vlk_anim_model_t*			model,
-	VkCommandBuffer				cmd,
+	_vlk_cmd_state_t*			state,
 	ecs_transform_t*			transform
 	)
 {
 	for (uint32_t i = 0; i < model->meshes.count; ++i)
 	{
-		_vlk_anim_mesh__render(&model->meshes.data[i], cmd, transform);
+		_vlk_anim_mesh__render(&model->meshes.data[i], state, transform);
 	}
 }
 
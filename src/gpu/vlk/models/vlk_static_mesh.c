@@ -2,104 +2,41 @@
 INCLUDES
 =========================================================*/
 
+#include <stddef.h>
+
 #include "common.h"
 #include "engine/kk_log.h"
+#include "gpu/gpu_mesh_opt.h"
+#include "gpu/gpu_vertex_weld.h"
 #include "gpu/vlk/vlk.h"
 #include "gpu/vlk/vlk_prv.h"
 #include "gpu/vlk/models/vlk_static_mesh.h"
-#include "thirdparty/vma/vma.h"
 #include "thirdparty/tinyobj/tinyobj.h"
 
-#include "autogen/vlk_static_mesh.static.h"
-
-/*=========================================================
-CONSTRUCTORS
-=========================================================*/
-
-//## public
-/**
-Constructs a static mesh.
-*/
-void _vlk_static_mesh__construct
-	(
-	_vlk_static_mesh_t*			mesh,
-	_vlk_dev_t*					device,
-	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
-	)
-{
-	clear_struct(mesh);
-
-	create_buffers(mesh, device, obj, obj_shape);
-}
-
-//## public
-/**
-Destructs a static mesh.
-*/
-void _vlk_static_mesh__destruct(_vlk_static_mesh_t* mesh)
-{
-	destroy_buffers(mesh);
-}
-
 /*=========================================================
 FUNCTIONS
 =========================================================*/
 
 //## public
 /**
-Renders a static mesh. The appropriate pipeline must already be bound.
+Welds and optimizes the vertices of one shape. The caller packs the result
+into the model's geometry and destructs the weld.
 */
-void _vlk_static_mesh__render
+void _vlk_static_mesh__build
 	(
-	_vlk_static_mesh_t*			mesh,
-	VkCommandBuffer				cmd
-	)
-{
-	VkBuffer vertBufs[] = { mesh->vertex_buffer.handle };
-	VkDeviceSize vertBufOffsets[] = { 0 };
-
-	vkCmdBindVertexBuffers(cmd, 0, 1, vertBufs, vertBufOffsets);
-	vkCmdBindIndexBuffer(cmd, mesh->index_buffer.handle, 0, VK_INDEX_TYPE_UINT16);
-	vkCmdDrawIndexed(cmd, mesh->num_indices, 1, 0, 0, 0);
-}
-
-//## static
-static void create_buffers
-	(
-	_vlk_static_mesh_t*			mesh,
-	_vlk_dev_t*					dev,
 	const tinyobj_t*			obj,
-	const tinyobj_shape_t*		obj_shape
+	const tinyobj_shape_t*		obj_shape,
+	gpu_mesh_opt_stats_t*		stats,
+	gpu_vertex_weld_t*			out__weld
 	)
 {
-	/* For now going wasteful and not eliminating duplicate vertex data */
-	int num_faces = obj_shape->length;
-	int num_verts = num_faces * 3;
-
-	/* Allocate a temp vertex buffer to send to the GPU */
-	VkDeviceSize vert_array_size = sizeof(_vlk_static_mesh_vertex_t) * num_verts;
-	_vlk_static_mesh_vertex_t* vert_array = malloc(vert_array_size);
-	if (!vert_array)
-	{
-		kk_log__fatal("Failed to allocate memory for mesh vertices.");
-	}
-
-	/* Allocate a temp index buffer to send to the GPU */
-	mesh->num_indices = num_faces * 3;
-	VkDeviceSize index_array_size = sizeof(uint16_t) * mesh->num_indices;
-	uint16_t* index_array = malloc(index_array_size);
-	if (!index_array)
-	{
-		kk_log__fatal("Failed to allocate memory for mesh indices.");
-	}
-
-	/* Go through faces and determine the number of vertices we actually need */
+	_vlk_static_mesh_vertex_t vert;
 	int first_face_idx = obj_shape->face_offset;
 	int last_face_idx = first_face_idx + obj_shape->length;
-	uint16_t index = 0;
 
-	/* Populate buffers with data */
+	/* Merge face corners that share position, normal, tex coord and material */
+	gpu_vertex_weld__construct(out__weld, sizeof(vert), obj_shape->length * 3);
+
 	for (int i = first_face_idx; i < last_face_idx; ++i)
 	{
 		for (int j = 0; j < 3; ++j)
@@ -108,42 +45,45 @@ static void create_buffers
 			int vt_idx = obj->attrib.faces[i * 3 + j].vt_idx;
 			int vn_idx = obj->attrib.faces[i * 3 + j].vn_idx;
 
-			vert_array[index].pos.x = obj->attrib.vertices[v_idx * 3 + 0];
-			vert_array[index].pos.y = obj->attrib.vertices[v_idx * 3 + 1];
-			vert_array[index].pos.z = obj->attrib.vertices[v_idx * 3 + 2];
-							
-			vert_array[index].normal.x = obj->attrib.normals[vn_idx * 3 + 0];
-			vert_array[index].normal.y = obj->attrib.normals[vn_idx * 3 + 1];
-			vert_array[index].normal.z = obj->attrib.normals[vn_idx * 3 + 2];
-							
-			vert_array[index].tex.x = obj->attrib.texcoords[vt_idx * 2 + 0];
-			vert_array[index].tex.y = obj->attrib.texcoords[vt_idx * 2 + 1];
+			/* The weld compares raw bytes */
+			clear_struct(&vert);
+
+			vert.pos.x = obj->attrib.vertices[v_idx * 3 + 0];
+			vert.pos.y = obj->attrib.vertices[v_idx * 3 + 1];
+			vert.pos.z = obj->attrib.vertices[v_idx * 3 + 2];
+
+			vert.normal.x = obj->attrib.normals[vn_idx * 3 + 0];
+			vert.normal.y = obj->attrib.normals[vn_idx * 3 + 1];
+			vert.normal.z = obj->attrib.normals[vn_idx * 3 + 2];
+
+			vert.tex.x = obj->attrib.texcoords[vt_idx * 2 + 0];
+			vert.tex.y = obj->attrib.texcoords[vt_idx * 2 + 1];
 
 			/* Material ids are assigned per face by tinyobj */
-			vert_array[index].material_idx = obj->attrib.material_ids[i];
+			vert.material_idx = obj->attrib.material_ids[i];
 
-			/* Index buffer is superfulous at this point until duplicate vertices handled */
-			index_array[index] = index;
-			index++;
+			gpu_vertex_weld__add(out__weld, &vert);
 		}
 	}
 
-	/* Create index buffer and load data to GPU */
-	_vlk_buffer__construct(&mesh->index_buffer, dev, index_array_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-	_vlk_buffer__update(&mesh->index_buffer, index_array, 0, index_array_size);
-
-	/* Create vertex buffer and load data to GPU */
-	_vlk_buffer__construct(&mesh->vertex_buffer, dev, vert_array_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-	_vlk_buffer__update(&mesh->vertex_buffer, vert_array, 0, vert_array_size);
+	/* Reorder for the vertex cache, overdraw and vertex fetch */
+	gpu_mesh_opt__optimize(out__weld, offsetof(_vlk_static_mesh_vertex_t, pos), stats);
 
-	/* Free the temp arrays */
-	free(vert_array);
-	free(index_array);
+	kk_log__dbg_fmt("Loading mesh: verts(%i), indices(%i)", out__weld->num_vertices, out__weld->num_indices);
 }
 
-//## static
-static void destroy_buffers(_vlk_static_mesh_t* mesh)
+//## public
+/**
+Renders several instances of a static mesh in one draw. The appropriate
+pipeline, the model's geometry and any instance data must already be bound.
+*/
+void _vlk_static_mesh__render_instances
+	(
+	_vlk_static_mesh_t*			mesh,
+	_vlk_cmd_state_t*			state,
+	uint32_t					instance_count,
+	uint32_t					first_instance
+	)
 {
-	_vlk_buffer__destruct(&mesh->index_buffer);
-	_vlk_buffer__destruct(&mesh->vertex_buffer);
-}
+	vkCmdDrawIndexed(state->cmd, mesh->num_indices, instance_count, mesh->first_index, mesh->vertex_offset, first_instance);
+}
\ No newline at end of file
@@ -5,6 +5,8 @@
 DECLARATIONS
 =========================================================*/
 
+#include "gpu/gpu_mesh_opt_.h"
+#include "gpu/gpu_vertex_weld_.h"
 #include "gpu/vlk/models/vlk_static_mesh_.h"
 
 /*=========================================================
@@ -22,18 +24,16 @@ CONSTANTS
 TYPES
 =========================================================*/
 
+/**
+One shape of a static model. The vertices and indices live in a geometry
+arena shared with other models; a mesh is the range of them it draws.
+*/
 struct _vlk_static_mesh_s
 {
-	/*
-	Create/destroy
-	*/
-	_vlk_buffer_t			vertex_buffer;
-	_vlk_buffer_t			index_buffer;
-
-	/*
-	Other
-	*/
+	uint32_t				first_index;	/* First index in the arena, counted in indices. */
 	uint32_t				num_indices;
+	int32_t					vertex_offset;	/* First vertex in the arena, counted in vertices. Indices are relative to it. */
+	uint32_t				num_verts;
 };
 
 /**
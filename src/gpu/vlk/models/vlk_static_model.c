@@ -5,6 +5,7 @@ INCLUDES
 #include "common.h"
 #include "ecs/components/ecs_transform.h"
 #include "engine/kk_log.h"
+#include "gpu/gpu_vertex_weld.h"
 #include "gpu/vlk/vlk.h"
 #include "gpu/vlk/vlk_prv.h"
 #include "gpu/vlk/models/vlk_static_mesh.h"
@@ -69,57 +70,6 @@ void vlk_static_model__destruct(gpu_static_model_t* base, gpu_t* gpu)
 FUNCTIONS
 =========================================================*/
 
-//## public
-/**
-Renders the model to the picker buffer.
-*/
-void vlk_static_model__render_to_picker_buffer
-	(
-	gpu_static_model_t*		model, 
-	gpu_t*					gpu, 
-	gpu_window_t*			window, 
-	gpu_frame_t*			frame,
-	kk_vec4_t				color,
-	ecs_transform_t*		transform
-	)
-{
-	_vlk_t* vlk = _vlk__from_base(gpu);
-	_vlk_frame_t* vlk_frame = _vlk_frame__from_base(frame);
-	_vlk_window_t* vlk_window = _vlk_window__from_base(window);
-
-	/* Bind picker pipeline */
-	_vlk_picker_pipeline__bind(&vlk_window->picker_pipeline, vlk_frame->picker_cmd_buf);
-
-	/* Bind per-view descriptor set */
-	_vlk_per_view_set__bind(&vlk_window->per_view_set, vlk_frame->picker_cmd_buf, vlk_frame, vlk_window->picker_pipeline.layout);
-
-	/* Update push constants */
-	_vlk_picker_push_constant_t picker_pc;
-	clear_struct(&picker_pc);
-
-	glm_mat4_identity(&picker_pc.vertex.model_matrix);
-	glm_translate(&picker_pc.vertex.model_matrix, &transform->pos);
-	glm_scale(&picker_pc.vertex.model_matrix, &transform->scale);
-
-	kk_vec3_t axis;
-	float angle = glm_quat_angle(&transform->rot);
-	glm_quat_axis(&transform->rot, &axis);
-	glm_rotate(&picker_pc.vertex.model_matrix, angle, &axis);
-
-	/* Set the color to render the object - this is the object id */
-	picker_pc.frag.id_color = color;
-
-	uint32_t picker_pc_vert_size = sizeof(_vlk_picker_push_constant_vertex_t);
-	uint32_t picker_pc_frag_size = sizeof(_vlk_picker_push_constant_frag_t);
-	uint32_t picker_pc_frag_offset = offsetof(_vlk_picker_push_constant_t, frag);
-
-	vkCmdPushConstants(vlk_frame->picker_cmd_buf, vlk_window->picker_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, picker_pc_vert_size, &picker_pc.vertex);
-	vkCmdPushConstants(vlk_frame->picker_cmd_buf, vlk_window->picker_pipeline.layout, VK_SHADER_STAGE_FRAGMENT_BIT, picker_pc_frag_offset, picker_pc_frag_size, &picker_pc.frag);
-
-	/* Render the model */
-	_vlk_static_model__render((_vlk_static_model_t*)model->data, vlk_frame->picker_cmd_buf);
-}
-
 //## public
 _vlk_static_model_t* _vlk_static_model__from_base(gpu_static_model_t* base)
 {
@@ -133,16 +83,33 @@ Renders a static model. The appropriate pipeline must already be bound.
 void _vlk_static_model__render
 	(
 	_vlk_static_model_t*		model,
-	VkCommandBuffer				cmd
+	_vlk_cmd_state_t*			state
 	)
 {
-	/* Render each mesh in the model */
+	/* Bind once and draw each mesh's range */
+	_vlk_static_model__bind_buffers(model, state);
+
 	for (uint32_t i = 0; i < model->meshes.count; ++i)
 	{
-		_vlk_static_mesh__render(&model->meshes.data[i], cmd);
+		_vlk_static_mesh__render_instances(&model->meshes.data[i], state, 1, 0);
 	}
 }
 
+//## public
+/**
+Binds the geometry arena holding the model's meshes. Every model in the same
+arena shares the binding.
+*/
+void _vlk_static_model__bind_buffers
+	(
+	_vlk_static_model_t*		model,
+	_vlk_cmd_state_t*			state
+	)
+{
+	_vlk_cmd_state__bind_vertex_buffer(state, 0, model->geometry.buffer, 0);
+	_vlk_cmd_state__bind_index_buffer(state, model->geometry.buffer, 0, model->index_type);
+}
+
 //## static
 static void create_material_set(_vlk_static_model_t* model, _vlk_dev_t* device)
 {
@@ -154,17 +121,94 @@ static void create_material_set(_vlk_static_model_t* model, _vlk_dev_t* device)
 }
 
 //## static
+/**
+Packs every shape into one range of vertices and one range of indices in a
+geometry arena, so the model needs no buffers of its own.
+*/
 static void create_meshes(_vlk_static_model_t* model, _vlk_dev_t* device, const tinyobj_t* obj)
 {
 	uint32_t num_meshes = obj->shapes_cnt;
+	uint32_t num_verts = 0;
+	uint32_t num_indices = 0;
+	uint32_t index_size = sizeof(uint16_t);
+	gpu_vertex_weld_t* welds;
+	_vlk_static_mesh_t* mesh;
 
 	utl_array_init(&model->meshes);
 	utl_array_resize(&model->meshes, num_meshes);
 
+	welds = malloc(sizeof(gpu_vertex_weld_t) * max(num_meshes, 1));
+	if (!welds)
+	{
+		kk_log__fatal("Failed to allocate memory for mesh welds.");
+	}
+
+	/* Weld each shape and lay the ranges out back to back */
 	for (uint32_t i = 0; i < num_meshes; ++i)
 	{
-		_vlk_static_mesh__construct(&model->meshes.data[i], device, obj, &obj->shapes[i]);
+		_vlk_static_mesh__build(obj, &obj->shapes[i], &model->base->cache_stats, &welds[i]);
+
+		mesh = &model->meshes.data[i];
+		clear_struct(mesh);
+		mesh->first_index = num_indices;
+		mesh->num_indices = welds[i].num_indices;
+		mesh->vertex_offset = (int32_t)num_verts;
+		mesh->num_verts = welds[i].num_vertices;
+
+		num_indices += mesh->num_indices;
+		num_verts += mesh->num_verts;
+
+		/* Indices are relative to each mesh's vertex offset, so only the largest mesh decides the size */
+		index_size = max(index_size, gpu_vertex_weld__get_index_size(&welds[i]));
+	}
+
+	model->index_type = (index_size == sizeof(uint16_t)) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+	kk_log__dbg_fmt("Loading model: meshes(%i), verts(%i), indices(%i)", num_meshes, num_verts, num_indices);
+
+	/* Allocate temp arrays to send to the GPU */
+	VkDeviceSize vert_array_size = sizeof(_vlk_static_mesh_vertex_t) * num_verts;
+	VkDeviceSize index_array_size = (VkDeviceSize)index_size * num_indices;
+	uint8_t* vert_array = malloc(vert_array_size);
+	uint8_t* index_array = malloc(index_array_size);
+	if (!vert_array || !index_array)
+	{
+		kk_log__fatal("Failed to allocate memory for model buffers.");
 	}
+
+	for (uint32_t i = 0; i < num_meshes; ++i)
+	{
+		mesh = &model->meshes.data[i];
+		memcpy(vert_array + sizeof(_vlk_static_mesh_vertex_t) * mesh->vertex_offset, welds[i].vertices, sizeof(_vlk_static_mesh_vertex_t) * mesh->num_verts);
+
+		if (index_size == sizeof(uint32_t))
+		{
+			memcpy(index_array + sizeof(uint32_t) * mesh->first_index, welds[i].indices, sizeof(uint32_t) * mesh->num_indices);
+		}
+		else
+		{
+			gpu_vertex_weld__copy_indices(&welds[i], index_array + sizeof(uint16_t) * mesh->first_index);
+		}
+
+		gpu_vertex_weld__destruct(&welds[i]);
+	}
+
+	/* Place the geometry in an arena and load data to GPU */
+	_vlk_geometry__alloc(&device->geometry, vert_array_size, sizeof(_vlk_static_mesh_vertex_t), index_array_size, index_size, &model->geometry);
+	_vlk_geometry__update(&device->geometry, &model->geometry, vert_array, index_array);
+
+	/* Draws index the whole arena, so offset the ranges by where the model landed */
+	for (uint32_t i = 0; i < num_meshes; ++i)
+	{
+		mesh = &model->meshes.data[i];
+		mesh->first_index += (uint32_t)(model->geometry.index_offset / index_size);
+		mesh->vertex_offset += (int32_t)(model->geometry.vertex_offset / sizeof(_vlk_static_mesh_vertex_t));
+	}
+
+	/* Free the temp data */
+	free(index_array);
+	free(vert_array);
+	free(welds);
 }
 
 //## static
@@ -176,12 +220,7 @@ static void destroy_material_set(_vlk_static_model_t* model)
 //## static
 static void destroy_meshes(_vlk_static_model_t* model)
 {
-	uint32_t num_meshes = model->meshes.count;
-
-	for (uint32_t i = 0; i < num_meshes; ++i)
-	{
-		_vlk_static_mesh__destruct(&model->meshes.data[i]);
-	}
+	_vlk_geometry__free(&model->vlk->dev.geometry, &model->geometry);
 
 	utl_array_destroy(&model->meshes);
 }
@@ -36,7 +36,13 @@ struct _vlk_static_model_s
 	Create/destroy
 	*/
 	_vlk_material_set_t					material_set;	/* The material desriptor set for this model. */
-	utl_array_t(_vlk_static_mesh_t)		meshes;			/* List of meshes the comprise the model. */
+	utl_array_t(_vlk_static_mesh_t)		meshes;			/* List of meshes the comprise the model. Each is a range of the geometry. */
+	_vlk_geometry_alloc_t				geometry;		/* Vertices and indices of every mesh, in one of the device's geometry arenas. */
+
+	/*
+	Other
+	*/
+	VkIndexType							index_type;		/* 16-bit unless a mesh has too many vertices. */
 };
 
 /*=========================================================
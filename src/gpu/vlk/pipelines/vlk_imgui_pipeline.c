@@ -57,9 +57,9 @@ void _vlk_imgui_pipeline__destruct(_vlk_imgui_pipeline_t* pipeline)
 	destroy_buffers(pipeline);
 }
 
-void _vlk_imgui_pipeline__bind(_vlk_imgui_pipeline_t* pipeline, VkCommandBuffer cmd)
+void _vlk_imgui_pipeline__bind(_vlk_imgui_pipeline_t* pipeline, _vlk_cmd_state_t* state)
 {
-	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
+	_vlk_cmd_state__bind_pipeline(state, pipeline->handle);
 }
 
 void _vlk_imgui_pipeline__render(_vlk_imgui_pipeline_t* pipeline, _vlk_frame_t* frame, ImDrawData* draw_data)
@@ -138,16 +138,14 @@ void _vlk_imgui_pipeline__render(_vlk_imgui_pipeline_t* pipeline, _vlk_frame_t*
 	/*
 	Bind pipeline and descriptor sets
 	*/
-	vkCmdBindPipeline(frame->cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
-	vkCmdBindDescriptorSets(frame->cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->layout, 0, 1, &pipeline->descriptor_sets[frame->image_idx], 0, NULL);
+	_vlk_imgui_pipeline__bind(pipeline, &frame->state);
+	_vlk_cmd_state__bind_descriptor_set(&frame->state, pipeline->layout, 0, pipeline->descriptor_sets[frame->image_idx]);
 
 	/*
 	Bind buffers
 	*/
-	VkBuffer vertex_buffers[1] = { pipeline->vertex_buffers.data[frame->image_idx].handle };
-	VkDeviceSize vertex_offset[1] = { 0 };
-	vkCmdBindVertexBuffers(frame->cmd_buf, 0, 1, vertex_buffers, vertex_offset);
-	vkCmdBindIndexBuffer(frame->cmd_buf, pipeline->index_buffers.data[frame->image_idx].handle, 0, VK_INDEX_TYPE_UINT16);
+	_vlk_cmd_state__bind_vertex_buffer(&frame->state, 0, pipeline->vertex_buffers.data[frame->image_idx].handle, 0);
+	_vlk_cmd_state__bind_index_buffer(&frame->state, pipeline->index_buffers.data[frame->image_idx].handle, 0, VK_INDEX_TYPE_UINT16);
 
 	/*
 	Setup viewport
@@ -60,9 +60,9 @@ void _vlk_md5_pipeline__destruct(_vlk_md5_pipeline_t* pipeline)
 	destroy_layout(pipeline);
 }
 
-void _vlk_md5_pipeline__bind(_vlk_md5_pipeline_t* pipeline, VkCommandBuffer cmd)
+void _vlk_md5_pipeline__bind(_vlk_md5_pipeline_t* pipeline, _vlk_cmd_state_t* state)
 {
-	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
+	_vlk_cmd_state__bind_pipeline(state, pipeline->handle);
 }
 
 /*=========================================================
@@ -25,8 +25,11 @@ DECLARATIONS
 /** Creates the pipeline layout. */
 static void create_layout(_vlk_obj_pipeline_t* pipeline);
 
-/** Creates the pipeline */
-static void create_pipeline(_vlk_obj_pipeline_t* pipeline);
+/** Creates the pipeline or its instanced variant. */
+static void create_pipeline(_vlk_obj_pipeline_t* pipeline, boolean instanced, VkPipeline* out__handle);
+
+/** Destroys the instance buffers. */
+static void destroy_instance_buffers(_vlk_obj_pipeline_t* pipeline);
 
 /** Destroys the pipeline layout. */
 static void destroy_layout(_vlk_obj_pipeline_t* pipeline);
@@ -52,18 +55,70 @@ void _vlk_obj_pipeline__construct
 	pipeline->render_pass = render_pass;
 
 	create_layout(pipeline);
-	create_pipeline(pipeline);
+	create_pipeline(pipeline, FALSE, &pipeline->handle);
+	create_pipeline(pipeline, TRUE, &pipeline->instanced_handle);
+
+	/* Instance buffers are created and grown as needed at render time */
 }
 
 void _vlk_obj_pipeline__destruct(_vlk_obj_pipeline_t* pipeline)
 {
+	destroy_instance_buffers(pipeline);
 	destroy_pipeline(pipeline);
 	destroy_layout(pipeline);
 }
 
-void _vlk_obj_pipeline__bind(_vlk_obj_pipeline_t* pipeline, VkCommandBuffer cmd)
+void _vlk_obj_pipeline__bind(_vlk_obj_pipeline_t* pipeline, _vlk_cmd_state_t* state)
+{
+	_vlk_cmd_state__bind_pipeline(state, pipeline->handle);
+}
+
+void _vlk_obj_pipeline__bind_instanced
+	(
+	_vlk_obj_pipeline_t*			pipeline,
+	_vlk_cmd_state_t*				state,
+	_vlk_frame_t*					frame
+	)
+{
+	_vlk_cmd_state__bind_pipeline(state, pipeline->instanced_handle);
+	_vlk_cmd_state__bind_vertex_buffer(state, 1, pipeline->instance_buffers[frame->image_idx].handle, 0);
+}
+
+kk_mat4_t* _vlk_obj_pipeline__map_instances
+	(
+	_vlk_obj_pipeline_t*			pipeline,
+	_vlk_frame_t*					frame,
+	uint32_t						count
+	)
+{
+	_vlk_buffer_t* buffer = &pipeline->instance_buffers[frame->image_idx];
+	VkDeviceSize* size = &pipeline->instance_buffer_sizes[frame->image_idx];
+	VkDeviceSize needed = max(count, 1) * sizeof(kk_mat4_t);
+	kk_mat4_t* data = NULL;
+
+	/* Grow geometrically so a slowly growing scene does not recreate the buffer every frame */
+	if (*size < needed)
+	{
+		if (*size)
+		{
+			_vlk_buffer__destruct(buffer);
+		}
+
+		*size = max(needed, 2 * *size);
+		_vlk_buffer__construct(buffer, pipeline->dev, *size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	}
+
+	if (vmaMapMemory(pipeline->dev->allocator, buffer->allocation, (void**)&data) != VK_SUCCESS)
+	{
+		kk_log__fatal("Failed to map OBJ instance buffer.");
+	}
+
+	return data;
+}
+
+void _vlk_obj_pipeline__unmap_instances(_vlk_obj_pipeline_t* pipeline, _vlk_frame_t* frame)
 {
-	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
+	vmaUnmapMemory(pipeline->dev->allocator, pipeline->instance_buffers[frame->image_idx].allocation);
 }
 
 /*=========================================================
@@ -121,9 +176,9 @@ void create_layout(_vlk_obj_pipeline_t * pipeline)
 	}
 }
 
-static void create_pipeline(_vlk_obj_pipeline_t* pipeline)
+static void create_pipeline(_vlk_obj_pipeline_t* pipeline, boolean instanced, VkPipeline* out__handle)
 {
-	VkShaderModule vert_shader = _vlk_device__create_shader(pipeline->dev, "bin/shaders/obj.vert.spv");
+	VkShaderModule vert_shader = _vlk_device__create_shader(pipeline->dev, instanced ? "bin/shaders/obj_instanced.vert.spv" : "bin/shaders/obj.vert.spv");
 	VkShaderModule frag_shader = _vlk_device__create_shader(pipeline->dev, "bin/shaders/obj.frag.spv");
 
 	/*
@@ -188,14 +243,36 @@ static void create_pipeline(_vlk_obj_pipeline_t* pipeline)
 	material_idx_attr.location = 3;
 	material_idx_attr.offset = offsetof(_vlk_static_mesh_vertex_t, material_idx);
 
-	VkVertexInputBindingDescription binding_descriptions[] = { vertex_binding };
-	VkVertexInputAttributeDescription attribute_descriptions[] = { pos_attr, normal_attr, tex_coord_attr, material_idx_attr };
+	/* Binding for instances. The instanced variant reads the model matrix from here instead of push constants. */
+	VkVertexInputBindingDescription instance_binding;
+	clear_struct(&instance_binding);
+	instance_binding.binding = 1;
+	instance_binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+	instance_binding.stride = sizeof(kk_mat4_t);
+
+	/* Model matrix attribute, one location per column */
+	VkVertexInputAttributeDescription model_matrix_attrs[4];
+	for (uint32_t i = 0; i < cnt_of_array(model_matrix_attrs); ++i)
+	{
+		clear_struct(&model_matrix_attrs[i]);
+		model_matrix_attrs[i].binding = 1;
+		model_matrix_attrs[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		model_matrix_attrs[i].location = 4 + i;
+		model_matrix_attrs[i].offset = i * sizeof(kk_vec4_t);
+	}
+
+	VkVertexInputBindingDescription binding_descriptions[] = { vertex_binding, instance_binding };
+	VkVertexInputAttributeDescription attribute_descriptions[] =
+	{
+		pos_attr, normal_attr, tex_coord_attr, material_idx_attr,
+		model_matrix_attrs[0], model_matrix_attrs[1], model_matrix_attrs[2], model_matrix_attrs[3]
+	};
 
 	VkPipelineVertexInputStateCreateInfo vertex_input_info;
 	clear_struct(&vertex_input_info);
 	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertex_input_info.vertexBindingDescriptionCount = cnt_of_array(binding_descriptions);
-	vertex_input_info.vertexAttributeDescriptionCount = cnt_of_array(attribute_descriptions);
+	vertex_input_info.vertexBindingDescriptionCount = instanced ? 2 : 1;
+	vertex_input_info.vertexAttributeDescriptionCount = instanced ? 8 : 4;
 	vertex_input_info.pVertexBindingDescriptions = binding_descriptions;
 	vertex_input_info.pVertexAttributeDescriptions = attribute_descriptions;
 
@@ -346,7 +423,7 @@ static void create_pipeline(_vlk_obj_pipeline_t* pipeline)
 	pipeline_info.basePipelineHandle = VK_NULL_HANDLE; // Optional
 	pipeline_info.basePipelineIndex = -1; // Optional
 
-	if (vkCreateGraphicsPipelines(pipeline->dev->handle, VK_NULL_HANDLE, 1, &pipeline_info, NULL, &pipeline->handle) != VK_SUCCESS)
+	if (vkCreateGraphicsPipelines(pipeline->dev->handle, VK_NULL_HANDLE, 1, &pipeline_info, NULL, out__handle) != VK_SUCCESS)
 	{
 		kk_log__fatal("Failed to create pipeline.");
 	}
@@ -358,6 +435,18 @@ static void create_pipeline(_vlk_obj_pipeline_t* pipeline)
 	_vlk_device__destroy_shader(pipeline->dev, frag_shader);
 }
 
+static void destroy_instance_buffers(_vlk_obj_pipeline_t* pipeline)
+{
+	for (uint32_t i = 0; i < NUM_FRAMES; ++i)
+	{
+		if (pipeline->instance_buffer_sizes[i])
+		{
+			_vlk_buffer__destruct(&pipeline->instance_buffers[i]);
+			pipeline->instance_buffer_sizes[i] = 0;
+		}
+	}
+}
+
 void destroy_layout(_vlk_obj_pipeline_t* pipeline)
 {
 	vkDestroyPipelineLayout(pipeline->dev->handle, pipeline->layout, NULL);
@@ -365,5 +454,6 @@ void destroy_layout(_vlk_obj_pipeline_t* pipeline)
 
 static void destroy_pipeline(_vlk_obj_pipeline_t* pipeline)
 {
+	vkDestroyPipeline(pipeline->dev->handle, pipeline->instanced_handle, NULL);
 	vkDestroyPipeline(pipeline->dev->handle, pipeline->handle, NULL);
 }
\ No newline at end of file
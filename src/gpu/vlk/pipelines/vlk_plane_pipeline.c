@@ -65,9 +65,9 @@ void _vlk_plane_pipeline__destruct(_vlk_plane_pipeline_t* pipeline)
 /**
 _vlk_plane_pipeline__bind
 */
-void _vlk_plane_pipeline__bind(_vlk_plane_pipeline_t* pipeline, VkCommandBuffer cmd)
+void _vlk_plane_pipeline__bind(_vlk_plane_pipeline_t* pipeline, _vlk_cmd_state_t* state)
 {
-	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
+	_vlk_cmd_state__bind_pipeline(state, pipeline->handle);
 }
 
 /*=========================================================
@@ -17,6 +17,7 @@ INCLUDES
 #include "gpu/vlk/vlk.h"
 #include "gpu/vlk/vlk_material.h"
 #include "gpu/vlk/vlk_prv.h"
+#include "gpu/vlk/models/vlk_static_mesh.h"
 #include "gpu/vlk/models/vlk_static_model.h"
 #include "gpu/vlk/models/vlk_static_model.h"
 #include "platform/glfw/glfw.h"
@@ -31,6 +32,7 @@ VARIABLES
 DECLARATIONS
 =========================================================*/
 
+static boolean has_same_instances(gpu_render_draw_t* a, uint32_t a_count, gpu_render_draw_t* b, uint32_t b_count);
 static void vlk__construct(gpu_t* gpu);
 static void vlk__destruct(gpu_t* gpu);
 static void vlk__wait_idle(gpu_t* gpu);
@@ -42,6 +44,7 @@ static void vlk_plane__destruct(gpu_plane_t* plane, gpu_t* gpu);
 static void vlk_plane__render(gpu_plane_t* plane, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_material_t* material);
 static void vlk_plane__update_verts(gpu_plane_t* plane, gpu_t* gpu, kk_vec3_t verts[4]);
 static void vlk_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, ecs_transform_t* transform);
+static void vlk_static_model__render_batch(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count);
 static void vlk_texture__construct(gpu_texture_t* texture, gpu_t* gpu, void* img, int width, int height);
 static void vlk_texture__destruct(gpu_texture_t* texture, gpu_t* gpu);
 
@@ -89,6 +92,7 @@ void vlk__init_gpu_intf
 	intf->static_model__construct = vlk_static_model__construct;
 	intf->static_model__destruct = vlk_static_model__destruct;
 	intf->static_model__render = vlk_static_model__render;
+	intf->static_model__render_batch = vlk_static_model__render_batch;
 	intf->texture__construct = vlk_texture__construct;
 	intf->texture__destruct = vlk_texture__destruct;
 	intf->window__begin_frame = vlk_window__begin_frame;
@@ -172,12 +176,12 @@ static void vlk_anim_model__render(gpu_anim_model_t* model, gpu_t* gpu, gpu_fram
 	//_vlk_frame_t* frame = &vlk_window->swapchain.frame;
 
 	///* Bind pipeline */
-	//_vlk_md5_pipeline__bind(&vlk->md5_pipeline, frame->cmd_buf);
+	//_vlk_md5_pipeline__bind(&vlk->md5_pipeline, &frame->state);
 
 	//// TODO : Modelview, push constants, etc.
 
 	///* Render the model */
-	//_vlk_anim_model__render((_vlk_anim_model_t*)model->data, frame->cmd_buf, transform);
+	//_vlk_anim_model__render((_vlk_anim_model_t*)model->data, &frame->state, transform);
 }
 
 static void vlk_plane__construct(gpu_plane_t* plane, gpu_t* gpu)
@@ -206,10 +210,10 @@ static void vlk_plane__render(gpu_plane_t* plane, gpu_t* gpu, gpu_window_t* wind
 	_vlk_window_t* vlk_window = _vlk_window__from_base(window);
 
 	/* Bind the plane pipeline */
-	_vlk_plane_pipeline__bind(&vlk_window->plane_pipeline, vlk_frame->cmd_buf);
+	_vlk_plane_pipeline__bind(&vlk_window->plane_pipeline, &vlk_frame->state);
 
 	/* Bind per-view descriptor set */
-	_vlk_per_view_set__bind(&vlk_window->per_view_set, vlk_frame->cmd_buf, vlk_frame, vlk_window->plane_pipeline.layout);
+	_vlk_per_view_set__bind(&vlk_window->per_view_set, &vlk_frame->state, vlk_frame, vlk_window->plane_pipeline.layout);
 
 	/* Bind material descriptor set */
 	//_vlk_material_t* mat = (_vlk_material_t*)material->data;
@@ -225,7 +229,7 @@ static void vlk_plane__render(gpu_plane_t* plane, gpu_t* gpu, gpu_window_t* wind
 	vkCmdPushConstants(vlk_frame->cmd_buf, vlk_window->plane_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, pcVertSize, &pc.vertex);
 
 	/* Draw the plane */
-	_vlk_plane__render((_vlk_plane_t*)plane->data, vlk_frame->cmd_buf);
+	_vlk_plane__render((_vlk_plane_t*)plane->data, &vlk_frame->state);
 }
 
 static void vlk_plane__update_verts(gpu_plane_t* plane, gpu_t* gpu, kk_vec3_t verts[4])
@@ -241,11 +245,9 @@ static void vlk_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gpu_
 	_vlk_window_t* vlk_window = _vlk_window__from_base(window);
 	_vlk_static_model_t* vlk_model = (_vlk_static_model_t*)model->data;
 
-	/* Bind pipeline */
-	_vlk_obj_pipeline__bind(&vlk_window->obj_pipeline, vlk_frame->cmd_buf);
-
-	/* Bind per-view descriptor set */
-	_vlk_per_view_set__bind(&vlk_window->per_view_set, vlk_frame->cmd_buf, vlk_frame, vlk_window->obj_pipeline.layout);
+	/* Bind pipeline and per-view descriptor set, skipped if the previous model bound them */
+	_vlk_obj_pipeline__bind(&vlk_window->obj_pipeline, &vlk_frame->state);
+	_vlk_per_view_set__bind(&vlk_window->per_view_set, &vlk_frame->state, vlk_frame, vlk_window->obj_pipeline.layout);
 
 	/* Bind material descriptor set */
 	_vlk_material_set__bind(&vlk_model->material_set, vlk_frame, vlk_window->obj_pipeline.layout);
@@ -254,21 +256,83 @@ static void vlk_static_model__render(gpu_static_model_t* model, gpu_t* gpu, gpu_
 	_vlk_obj_push_constant_t pc;
 	clear_struct(&pc);
 
-	glm_mat4_identity(&pc.vertex.model_matrix);
-	glm_translate(&pc.vertex.model_matrix, &transform->pos);
-	glm_scale(&pc.vertex.model_matrix, &transform->scale);
-
-	kk_vec3_t axis;
-	float angle = glm_quat_angle(&transform->rot);
-	glm_quat_axis(&transform->rot, &axis);
-	glm_rotate(&pc.vertex.model_matrix, angle, &axis);
+	pc.vertex.model_matrix = transform->world_matrix;
 
 	uint32_t pcVertSize = sizeof(_vlk_obj_push_constant_vertex_t);
 
-	vkCmdPushConstants(vlk_frame->cmd_buf, vlk_window->plane_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, pcVertSize, &pc.vertex);
+	vkCmdPushConstants(vlk_frame->cmd_buf, vlk_window->obj_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, pcVertSize, &pc.vertex);
 
 	/* Render the model */
-	_vlk_static_model__render(vlk_model, vlk_frame->cmd_buf);
+	_vlk_static_model__render(vlk_model, &vlk_frame->state);
+}
+
+static void vlk_static_model__render_batch(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count)
+{
+	_vlk_frame_t* vlk_frame = _vlk_frame__from_base(frame);
+	_vlk_window_t* vlk_window = _vlk_window__from_base(window);
+	_vlk_obj_pipeline_t* pipeline = &vlk_window->obj_pipeline;
+	_vlk_static_model_t* vlk_model;
+	kk_mat4_t* instances;
+	uint32_t num_instances = 0;
+	uint32_t first_instance = 0;
+	uint32_t prev_start = 0;
+	uint32_t prev_count = 0;
+	uint32_t start;
+	uint32_t end;
+	uint32_t i;
+
+	/* Each draw needs at most one instance */
+	instances = _vlk_obj_pipeline__map_instances(pipeline, vlk_frame, count);
+
+	/* Static models are the only pipeline so far, so it and the per-view set are bound once */
+	_vlk_obj_pipeline__bind_instanced(pipeline, &vlk_frame->state, vlk_frame);
+	_vlk_per_view_set__bind(&vlk_window->per_view_set, &vlk_frame->state, vlk_frame, pipeline->layout);
+
+	/* Draws are sorted by model and then mesh, so each run with the same model and mesh is one instanced draw */
+	for (start = 0; start < count; start = end)
+	{
+		for (end = start + 1; end < count && draws[end].model == draws[start].model && draws[end].mesh == draws[start].mesh; ++end);
+
+		/* Every mesh of a model is queued for the same instances in the same order, so usually only the first mesh writes matrices */
+		if (!has_same_instances(&draws[prev_start], prev_count, &draws[start], end - start))
+		{
+			first_instance = num_instances;
+			for (i = start; i < end; ++i)
+			{
+				instances[num_instances++] = *draws[i].world_matrix;
+			}
+		}
+
+		prev_start = start;
+		prev_count = end - start;
+
+		vlk_model = (_vlk_static_model_t*)draws[start].model->data;
+		_vlk_material_set__bind(&vlk_model->material_set, vlk_frame, pipeline->layout);
+		_vlk_static_model__bind_buffers(vlk_model, &vlk_frame->state);
+		_vlk_static_mesh__render_instances(&vlk_model->meshes.data[draws[start].mesh], &vlk_frame->state, end - start, first_instance);
+	}
+
+	_vlk_obj_pipeline__unmap_instances(pipeline, vlk_frame);
+}
+
+static boolean has_same_instances(gpu_render_draw_t* a, uint32_t a_count, gpu_render_draw_t* b, uint32_t b_count)
+{
+	uint32_t i;
+
+	if (a_count != b_count)
+	{
+		return FALSE;
+	}
+
+	for (i = 0; i < a_count; ++i)
+	{
+		if (a[i].world_matrix != b[i].world_matrix)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
 }
 
 //void vlk_static_model__render_picker_buffer(gpu_static_model_t* model, gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, vec3_t id_color)
@@ -29,15 +29,6 @@ static void update_direct
 	VkDeviceSize			data_size
 	);
 
-/** Updates a GPU memory buffer using a stagning buffer */
-static void update_via_staging_buffer
-	(
-	_vlk_buffer_t*			buffer,
-	void*					data,
-	VkDeviceSize			offset,
-	VkDeviceSize			data_size
-	);
-
 /*=========================================================
 CONSTRUCTORS
 =========================================================*/
@@ -68,6 +59,12 @@ _vlk_buffer__destroy
 */
 void _vlk_buffer__destruct(_vlk_buffer_t* buffer)
 {
+	if (buffer->memory_usage == VMA_MEMORY_USAGE_GPU_ONLY)
+	{
+		/* A pending upload may still write to the buffer */
+		_vlk_upload__flush(&buffer->dev->upload);
+	}
+
 	vmaDestroyBuffer(buffer->dev->allocator, buffer->handle, buffer->allocation);
 }
 
@@ -96,7 +93,7 @@ void _vlk_buffer__update(_vlk_buffer_t* buffer, void* data, VkDeviceSize offset,
 	switch (buffer->memory_usage)
 	{
 	case VMA_MEMORY_USAGE_GPU_ONLY:
-		update_via_staging_buffer(buffer, data, offset, size);
+		_vlk_upload__buffer(&buffer->dev->upload, buffer->handle, offset, data, size);
 		break;
 
 	default:
@@ -116,6 +113,7 @@ static void create_buffer(_vlk_buffer_t* buffer)
 		buffer->buffer_usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 	}
 
+	uint32_t queue_families[2];
 	VkBufferCreateInfo info;
 	clear_struct(&info);
 	info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -123,6 +121,13 @@ static void create_buffer(_vlk_buffer_t* buffer)
 	info.usage = buffer->buffer_usage;
 	info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+	if (buffer->memory_usage == VMA_MEMORY_USAGE_GPU_ONLY)
+	{
+		/* Written on the transfer queue, read on the graphics queue */
+		info.sharingMode = _vlk_device__get_upload_sharing(buffer->dev, &info.queueFamilyIndexCount, queue_families);
+		info.pQueueFamilyIndices = queue_families;
+	}
+
 	VmaAllocationCreateInfo alloc_info;
 	clear_struct(&alloc_info);
 	alloc_info.usage = buffer->memory_usage;
@@ -155,51 +160,4 @@ static void update_direct
 	buf = (char*)buf + offset;
 	memcpy(buf, data, data_size);
 	vmaUnmapMemory(buffer->dev->allocator, buffer->allocation);
-}
-
-/**
-update_via_staging_buffer
-*/
-static void update_via_staging_buffer
-	(
-	_vlk_buffer_t*			buffer,
-	void*					data, 
-	VkDeviceSize			offset, 
-	VkDeviceSize			data_size
-	)
-{
-	/*
-	Create staging buffer
-	*/
-	_vlk_buffer_t staging_buffer;
-	_vlk_buffer__construct(
-		&staging_buffer, 
-		buffer->dev, 
-		data_size, 
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VMA_MEMORY_USAGE_CPU_ONLY);
-
-	/*
-	Load data to staging buffer
-	*/
-	_vlk_buffer__update(&staging_buffer, data, 0, data_size);
-
-	/*
-	Copy staging -> GPU
-	*/
-	VkCommandBuffer cmd_buf = _vlk_device__begin_one_time_cmd_buf(buffer->dev);
-
-	VkBufferCopy copy_region;
-	clear_struct(&copy_region);
-	copy_region.size = data_size;
-	copy_region.dstOffset = offset;
-	copy_region.srcOffset = 0;
-	vkCmdCopyBuffer(cmd_buf, staging_buffer.handle, buffer->handle, 1, &copy_region);
-
-	_vlk_device__end_one_time_cmd_buf(buffer->dev, cmd_buf);
-
-	/*
-	Free staging buffer
-	*/
-	_vlk_buffer__destruct(&staging_buffer);
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*=========================================================
+The command state tracks what is currently bound on a
+command buffer so binds that would not change anything can
+be skipped. Every bind on a tracked command buffer must go
+through the tracker, otherwise its view of the command
+buffer goes stale. Code that binds directly must call
+_vlk_cmd_state__invalidate afterwards.
+
+Descriptor sets are tracked along with the pipeline layout
+they were bound with. Binding with a different layout
+forgets the tracked sets, since Vulkan only keeps sets bound
+across compatible layouts.
+=========================================================*/
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "gpu/vlk/vlk.h"
+#include "gpu/vlk/vlk_prv.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+/**
+_vlk_cmd_state__reset
+*/
+void _vlk_cmd_state__reset(_vlk_cmd_state_t* state, VkCommandBuffer cmd)
+{
+	clear_struct(state);
+	state->cmd = cmd;
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+_vlk_cmd_state__bind_descriptor_set
+*/
+void _vlk_cmd_state__bind_descriptor_set
+	(
+	_vlk_cmd_state_t*				state,
+	VkPipelineLayout				layout,
+	uint32_t						set_num,
+	VkDescriptorSet					set
+	)
+{
+	if (layout != state->layout)
+	{
+		memset(state->sets, 0, sizeof(state->sets));
+		state->layout = layout;
+	}
+	else if (state->sets[set_num] == set)
+	{
+		state->num_binds_skipped++;
+		return;
+	}
+
+	vkCmdBindDescriptorSets(state->cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set_num, 1, &set, 0, NULL);
+	state->sets[set_num] = set;
+	state->num_binds_issued++;
+}
+
+/**
+_vlk_cmd_state__bind_index_buffer
+*/
+void _vlk_cmd_state__bind_index_buffer
+	(
+	_vlk_cmd_state_t*				state,
+	VkBuffer						buffer,
+	VkDeviceSize					offset,
+	VkIndexType						type
+	)
+{
+	if (buffer == state->index_buffer
+		&& offset == state->index_offset
+		&& type == state->index_type)
+	{
+		state->num_binds_skipped++;
+		return;
+	}
+
+	vkCmdBindIndexBuffer(state->cmd, buffer, offset, type);
+	state->index_buffer = buffer;
+	state->index_offset = offset;
+	state->index_type = type;
+	state->num_binds_issued++;
+}
+
+/**
+_vlk_cmd_state__bind_pipeline
+*/
+void _vlk_cmd_state__bind_pipeline(_vlk_cmd_state_t* state, VkPipeline pipeline)
+{
+	if (pipeline == state->pipeline)
+	{
+		state->num_binds_skipped++;
+		return;
+	}
+
+	vkCmdBindPipeline(state->cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	state->pipeline = pipeline;
+	state->num_binds_issued++;
+}
+
+/**
+_vlk_cmd_state__bind_vertex_buffer
+*/
+void _vlk_cmd_state__bind_vertex_buffer
+	(
+	_vlk_cmd_state_t*				state,
+	uint32_t						binding,
+	VkBuffer						buffer,
+	VkDeviceSize					offset
+	)
+{
+	if (buffer == state->vertex_buffers[binding]
+		&& offset == state->vertex_offsets[binding])
+	{
+		state->num_binds_skipped++;
+		return;
+	}
+
+	vkCmdBindVertexBuffers(state->cmd, binding, 1, &buffer, &offset);
+	state->vertex_buffers[binding] = buffer;
+	state->vertex_offsets[binding] = offset;
+	state->num_binds_issued++;
+}
+
+/**
+_vlk_cmd_state__invalidate
+*/
+void _vlk_cmd_state__invalidate(_vlk_cmd_state_t* state)
+{
+	VkCommandBuffer cmd = state->cmd;
+	uint32_t num_binds_issued = state->num_binds_issued;
+	uint32_t num_binds_skipped = state->num_binds_skipped;
+
+	_vlk_cmd_state__reset(state, cmd);
+	state->num_binds_issued = num_binds_issued;
+	state->num_binds_skipped = num_binds_skipped;
+}
\ No newline at end of file
@@ -10,8 +10,6 @@ INCLUDES
 #include "gpu/vlk/vlk_prv.h"
 #include "utl/utl_array.h"
 
-#include "autogen/vlk_device.static.h"
-
 /*=========================================================
 VARIABLES
 =========================================================*/
@@ -84,15 +82,17 @@ void _vlk_device__construct
 	dev->gpu = gpu;
 	dev->gfx_family_idx = -1;
 	dev->present_family_idx = -1;
+	dev->transfer_family_idx = -1;
 	utl_array_init(&dev->used_queue_families);
 
 	create_logical_device(dev, req_dev_ext, req_inst_layers);
 	create_command_pool(dev);
 	create_allocator(dev);
+	_vlk_upload__construct(&dev->upload, dev);
+	_vlk_geometry__construct(&dev->geometry, dev);
 	create_texture_sampler(dev);
 	create_layouts(dev);
 	create_render_pass(dev);
-	create_picker_render_pass(dev);
 }
 
 void _vlk_device__destruct
@@ -100,10 +100,11 @@ void _vlk_device__destruct
 	_vlk_dev_t*						dev
 	)
 {
-	destroy_picker_render_pass(dev);
 	destroy_render_pass(dev);
 	destroy_layouts(dev);
 	destroy_texture_sampler(dev);
+	_vlk_geometry__destruct(&dev->geometry);
+	_vlk_upload__destruct(&dev->upload);
 	destroy_allocator(dev);
 	destroy_command_pool(dev);
 	destroy_logical_device(dev);
@@ -267,6 +268,23 @@ void _vlk_device__end_one_time_cmd_buf(_vlk_dev_t* dev, VkCommandBuffer cmd_buf)
 	vkFreeCommandBuffers(dev->handle, dev->command_pool, 1, &cmd_buf);
 }
 
+/**
+_vlk_device__get_upload_sharing
+*/
+VkSharingMode _vlk_device__get_upload_sharing(_vlk_dev_t* dev, uint32_t* out__family_count, uint32_t* out__families)
+{
+	if (dev->transfer_family_idx == dev->gfx_family_idx)
+	{
+		*out__family_count = 0;
+		return VK_SHARING_MODE_EXCLUSIVE;
+	}
+
+	out__families[0] = (uint32_t)dev->gfx_family_idx;
+	out__families[1] = (uint32_t)dev->transfer_family_idx;
+	*out__family_count = 2;
+	return VK_SHARING_MODE_CONCURRENT;
+}
+
 /**
 _vlk_device__transition_image_layout
 */
@@ -474,6 +492,13 @@ static void create_logical_device
 
 	dev->present_family_idx = gpu->queue_family_indices.present_families.data[0];
 
+	/* Uploads use a dedicated transfer family if there is one, otherwise the graphics family */
+	dev->transfer_family_idx = dev->gfx_family_idx;
+	if (gpu->queue_family_indices.transfer_families.count > 0)
+	{
+		dev->transfer_family_idx = gpu->queue_family_indices.transfer_families.data[0];
+	}
+
 	/* Create list of used queue families */
 	utl_array_push(&dev->used_queue_families, dev->gfx_family_idx);
 	
@@ -483,6 +508,11 @@ static void create_logical_device
 		utl_array_push(&dev->used_queue_families, (uint32_t)dev->present_family_idx);
 	}
 
+	if (dev->transfer_family_idx != dev->gfx_family_idx)
+	{
+		utl_array_push(&dev->used_queue_families, (uint32_t)dev->transfer_family_idx);
+	}
+
 	float queuePriority = 1.0f;
 
 	/* create multiple queues if needed based on QF properties */
@@ -537,6 +567,7 @@ static void create_logical_device
 	*/
 	vkGetDeviceQueue(dev->handle, dev->gfx_family_idx, 0, &dev->gfx_queue);
 	vkGetDeviceQueue(dev->handle, dev->present_family_idx, 0, &dev->present_queue);
+	vkGetDeviceQueue(dev->handle, dev->transfer_family_idx, 0, &dev->transfer_queue);
 
 	/*
 	Cleanup
@@ -544,81 +575,6 @@ static void create_logical_device
 	utl_array_destroy(&queues);
 }
 
-//## static
-static void create_picker_render_pass(_vlk_dev_t* dev)
-{
-	/*
-	Attachment setup
-	*/
-
-	/* Primary color attachment */
-	VkAttachmentDescription color_attach;
-	clear_struct(&color_attach);
-	color_attach.format = dev->gpu->optimal_surface_format.format;
-	color_attach.samples = VK_SAMPLE_COUNT_1_BIT;
-	color_attach.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	color_attach.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	color_attach.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	color_attach.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	color_attach.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	color_attach.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference color_attach_ref;
-	clear_struct(&color_attach_ref);
-	color_attach_ref.attachment = 0;
-	color_attach_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkAttachmentDescription attachments[] =
-	{
-		color_attach,
-	};
-
-	/*
-	Subpass setup
-	*/
-
-	/* Primary subpass */
-	VkSubpassDescription subpass;
-	clear_struct(&subpass);
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &color_attach_ref;
-
-	VkSubpassDescription subpasses[] = { subpass };
-
-	/*
-	Subpass dependencies
-	*/
-	VkSubpassDependency dependency;
-	clear_struct(&dependency);
-	dependency.srcSubpass = VK_SUBPASS_EXTERNAL; // implicit subpass before the render pass
-	dependency.dstSubpass = 0; // 0 is index of our first subpass
-	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependency.srcAccessMask = 0;
-	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-	VkSubpassDependency dependencies[] = { dependency };
-
-	/*
-	Renderpass setup
-	*/
-	VkRenderPassCreateInfo render_pass_info;
-	clear_struct(&render_pass_info);
-	render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	render_pass_info.attachmentCount = cnt_of_array(attachments);
-	render_pass_info.pAttachments = attachments;
-	render_pass_info.subpassCount = cnt_of_array(subpasses);
-	render_pass_info.pSubpasses = &subpasses;
-	render_pass_info.dependencyCount = cnt_of_array(dependencies);
-	render_pass_info.pDependencies = &dependencies;
-
-	if (vkCreateRenderPass(dev->handle, &render_pass_info, NULL, &dev->picker_render_pass) != VK_SUCCESS)
-	{
-		kk_log__fatal("Failed to create render pass.");
-	}
-}
-
 static void create_render_pass(_vlk_dev_t* dev)
 {
 	/*
@@ -796,12 +752,6 @@ static void destroy_logical_device
 	vkDestroyDevice(dev->handle, NULL);
 }
 
-//## static
-static void destroy_picker_render_pass(_vlk_dev_t* dev)
-{
-	vkDestroyRenderPass(dev->handle, dev->picker_render_pass, NULL);
-}
-
 static void destroy_render_pass(_vlk_dev_t* dev)
 {
 	vkDestroyRenderPass(dev->handle, dev->render_pass, NULL);
@@ -0,0 +1,260 @@
+/*=========================================================
+Static mesh geometry lives in a few large device-local
+arenas instead of a buffer per model. Each model's vertices
+and indices are suballocated from the same arena, so every
+model in an arena draws with the same vertex and index
+bindings and only its draw offsets differ.
+
+Vertex offsets are aligned to the vertex stride and index
+offsets to the index size, which lets the arena buffer be
+bound at offset 0 and the placement be expressed with
+vertexOffset and firstIndex.
+=========================================================*/
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "gpu/gpu_suballoc.h"
+#include "gpu/vlk/vlk.h"
+#include "gpu/vlk/vlk_prv.h"
+#include "thirdparty/vma/vma.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+/** Creates an arena of at least the given size. */
+static _vlk_geometry_arena_t* create_arena(_vlk_geometry_t* geo, VkDeviceSize min_size);
+
+/** Tries to place vertices and indices in one arena. */
+static boolean try_alloc
+	(
+	_vlk_geometry_arena_t*			arena,
+	VkDeviceSize					vertex_size,
+	VkDeviceSize					vertex_stride,
+	VkDeviceSize					index_size,
+	VkDeviceSize					index_stride,
+	_vlk_geometry_alloc_t*			out__alloc
+	);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+/**
+_vlk_geometry__construct
+*/
+void _vlk_geometry__construct(_vlk_geometry_t* geo, _vlk_dev_t* dev)
+{
+	clear_struct(geo);
+	geo->dev = dev;
+	utl_array_init(&geo->arenas);
+}
+
+/**
+_vlk_geometry__destruct
+*/
+void _vlk_geometry__destruct(_vlk_geometry_t* geo)
+{
+	for (uint32_t i = 0; i < geo->arenas.count; ++i)
+	{
+		_vlk_geometry_arena_t* arena = &geo->arenas.data[i];
+		if (arena->suballoc.num_allocs > 0)
+		{
+			kk_log__error("Geometry arena destroyed with live allocations.");
+		}
+
+		_vlk_buffer__destruct(&arena->buffer);
+		gpu_suballoc__destruct(&arena->suballoc);
+	}
+
+	utl_array_destroy(&geo->arenas);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+_vlk_geometry__alloc
+*/
+void _vlk_geometry__alloc
+	(
+	_vlk_geometry_t*				geo,
+	VkDeviceSize					vertex_size,
+	VkDeviceSize					vertex_stride,
+	VkDeviceSize					index_size,
+	VkDeviceSize					index_stride,
+	_vlk_geometry_alloc_t*			out__alloc
+	)
+{
+	_vlk_geometry_arena_t* arena;
+	uint32_t i;
+
+	clear_struct(out__alloc);
+
+	for (i = 0; i < geo->arenas.count; ++i)
+	{
+		if (try_alloc(&geo->arenas.data[i], vertex_size, vertex_stride, index_size, index_stride, out__alloc))
+		{
+			out__alloc->arena_idx = i;
+			return;
+		}
+	}
+
+	/* No arena has room, so add one big enough even with worst case alignment padding */
+	arena = create_arena(geo, vertex_size + vertex_stride + index_size + index_stride);
+	if (!try_alloc(arena, vertex_size, vertex_stride, index_size, index_stride, out__alloc))
+	{
+		kk_log__fatal("Failed to allocate static geometry.");
+	}
+
+	out__alloc->arena_idx = geo->arenas.count - 1;
+}
+
+/**
+_vlk_geometry__free
+*/
+void _vlk_geometry__free(_vlk_geometry_t* geo, _vlk_geometry_alloc_t* alloc)
+{
+	_vlk_geometry_arena_t* arena = &geo->arenas.data[alloc->arena_idx];
+
+	/* Empty ranges were never allocated */
+	if (alloc->index_size > 0)
+	{
+		gpu_suballoc__free(&arena->suballoc, alloc->index_offset, alloc->index_size);
+	}
+
+	if (alloc->vertex_size > 0)
+	{
+		gpu_suballoc__free(&arena->suballoc, alloc->vertex_offset, alloc->vertex_size);
+	}
+
+	clear_struct(alloc);
+}
+
+/**
+_vlk_geometry__get_stats
+*/
+void _vlk_geometry__get_stats
+	(
+	_vlk_geometry_t*				geo,
+	uint64_t*						out__used,
+	uint64_t*						out__reserved,
+	float*							out__fragmentation
+	)
+{
+	uint64_t largest_free = 0;
+	uint64_t free_total = 0;
+	uint32_t i;
+
+	*out__used = 0;
+	*out__reserved = 0;
+	*out__fragmentation = 0.0f;
+
+	for (i = 0; i < geo->arenas.count; ++i)
+	{
+		gpu_suballoc_t* suballoc = &geo->arenas.data[i].suballoc;
+		*out__used += suballoc->used;
+		*out__reserved += suballoc->size;
+		free_total += suballoc->size - suballoc->used;
+		largest_free = max(largest_free, gpu_suballoc__get_largest_free(suballoc));
+	}
+
+	/* Same measure as a single suballocator, over the free space of every arena */
+	if (free_total > 0)
+	{
+		*out__fragmentation = 1.0f - (float)largest_free / (float)free_total;
+	}
+}
+
+/**
+_vlk_geometry__update
+*/
+void _vlk_geometry__update
+	(
+	_vlk_geometry_t*				geo,
+	_vlk_geometry_alloc_t*			alloc,
+	void*							vertices,
+	void*							indices
+	)
+{
+	_vlk_geometry_arena_t* arena = &geo->arenas.data[alloc->arena_idx];
+
+	/* Buffer copies must not be empty */
+	if (alloc->vertex_size > 0)
+	{
+		_vlk_buffer__update(&arena->buffer, vertices, alloc->vertex_offset, alloc->vertex_size);
+	}
+
+	if (alloc->index_size > 0)
+	{
+		_vlk_buffer__update(&arena->buffer, indices, alloc->index_offset, alloc->index_size);
+	}
+}
+
+/**
+create_arena
+*/
+static _vlk_geometry_arena_t* create_arena(_vlk_geometry_t* geo, VkDeviceSize min_size)
+{
+	_vlk_geometry_arena_t arena;
+	VkDeviceSize size = max(min_size, GEOMETRY_ARENA_SIZE);
+
+	kk_log__dbg_fmt("Creating geometry arena: size(%llu)", (unsigned long long)size);
+
+	clear_struct(&arena);
+	_vlk_buffer__construct(&arena.buffer, geo->dev, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	gpu_suballoc__construct(&arena.suballoc, size);
+
+	utl_array_push(&geo->arenas, arena);
+	return &geo->arenas.data[geo->arenas.count - 1];
+}
+
+/**
+try_alloc
+*/
+static boolean try_alloc
+	(
+	_vlk_geometry_arena_t*			arena,
+	VkDeviceSize					vertex_size,
+	VkDeviceSize					vertex_stride,
+	VkDeviceSize					index_size,
+	VkDeviceSize					index_stride,
+	_vlk_geometry_alloc_t*			out__alloc
+	)
+{
+	uint64_t vertex_offset = 0;
+	uint64_t index_offset = 0;
+
+	/* The suballocator rejects empty ranges, so a model without vertices or indices takes no space for them */
+	if (vertex_size > 0 && !gpu_suballoc__alloc(&arena->suballoc, vertex_size, vertex_stride, &vertex_offset))
+	{
+		return FALSE;
+	}
+
+	if (index_size > 0 && !gpu_suballoc__alloc(&arena->suballoc, index_size, index_stride, &index_offset))
+	{
+		if (vertex_size > 0)
+		{
+			gpu_suballoc__free(&arena->suballoc, vertex_offset, vertex_size);
+		}
+
+		return FALSE;
+	}
+
+	out__alloc->buffer = arena->buffer.handle;
+	out__alloc->vertex_offset = vertex_offset;
+	out__alloc->vertex_size = vertex_size;
+	out__alloc->index_offset = index_offset;
+	out__alloc->index_size = index_size;
+	return TRUE;
+}
\ No newline at end of file
@@ -167,6 +167,13 @@ void _vlk_gpu__init
 		{
 			utl_array_push(&gpu->queue_family_indices.graphics_families, i);
 		}
+
+		/* check for dedicated transfer support (usually a DMA engine) */
+		if ((family.queueFlags & VK_QUEUE_TRANSFER_BIT)
+			&& !(family.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+		{
+			utl_array_push(&gpu->queue_family_indices.transfer_families, i);
+		}
 	}
 
 	/*-----------------------------------------------------
@@ -190,6 +197,7 @@ void _vlk_gpu__term(_vlk_gpu_t* gpu)
 
 	utl_array_destroy(&gpu->queue_family_indices.graphics_families);
 	utl_array_destroy(&gpu->queue_family_indices.present_families);
+	utl_array_destroy(&gpu->queue_family_indices.transfer_families);
 }
 
 /*=========================================================
@@ -49,15 +49,12 @@ FUNCTIONS
 void _vlk_plane__render
 	(
 	_vlk_plane_t*				plane,
-	VkCommandBuffer				cmd
+	_vlk_cmd_state_t*			state
 	)
 {
-	VkBuffer vertBufs[] = { plane->vertex_buffer.handle };
-	VkDeviceSize vertBufOffsets[] = { 0 };
-
-	vkCmdBindVertexBuffers(cmd, 0, 1, vertBufs, vertBufOffsets);
-	vkCmdBindIndexBuffer(cmd, plane->index_buffer.handle, 0, VK_INDEX_TYPE_UINT16);
-	vkCmdDrawIndexed(cmd, 6, 1, 0, 0, 0);
+	_vlk_cmd_state__bind_vertex_buffer(state, 0, plane->vertex_buffer.handle, 0);
+	_vlk_cmd_state__bind_index_buffer(state, plane->index_buffer.handle, 0, VK_INDEX_TYPE_UINT16);
+	vkCmdDrawIndexed(state->cmd, 6, 1, 0, 0, 0);
 }
 
 void _vlk_plane__update_verts(_vlk_plane_t* plane, const kk_vec3_t verts[4])
@@ -24,6 +24,7 @@ INCLUDES
 #include "gpu/gpu_material.h"
 #include "gpu/gpu_texture.h"
 #include "gpu/gpu_static_model.h"
+#include "gpu/gpu_suballoc.h"
 #include "gpu/vlk/vlk.h"
 #include "platform/glfw/glfw.h"
 #include "thirdparty/cimgui/imgui_jetz.h"
@@ -45,6 +46,36 @@ The max number of materials per model.
 */
 #define MAX_NUM_MATERIALS_PER_SET	10
 
+/*
+The max number of descriptor sets tracked per command buffer.
+*/
+#define MAX_NUM_TRACKED_SETS	4
+
+/*
+The max number of vertex buffer bindings tracked per command buffer.
+*/
+#define MAX_NUM_TRACKED_VERTEX_BUFFERS	2
+
+/*
+The size of each geometry arena. Larger meshes get an arena of their own size.
+*/
+#define GEOMETRY_ARENA_SIZE	(32 * 1024 * 1024)
+
+/*
+The size of the upload staging ring. Uploads larger than half of it get a staging buffer of their own.
+*/
+#define UPLOAD_STAGING_SIZE	(16 * 1024 * 1024)
+
+/*
+The number of upload batches that can be recorded or in flight at once.
+*/
+#define NUM_UPLOAD_BATCHES	4
+
+/*
+Alignment of data in the upload staging ring. Covers the texel size of any format.
+*/
+#define UPLOAD_ALIGNMENT	16
+
 /*=========================================================
 TYPES
 =========================================================*/
@@ -104,6 +135,109 @@ typedef struct
 
 } _vlk_buffer_array_t;
 
+/**
+A device-local buffer that static mesh vertices and indices are suballocated from.
+*/
+typedef struct
+{
+	_vlk_buffer_t					buffer;			/* vertex and index data */
+	gpu_suballoc_t					suballoc;		/* free space of the buffer */
+
+} _vlk_geometry_arena_t;
+
+utl_array_declare_type(_vlk_geometry_arena_t);
+
+/**
+Where one model's vertices and indices were placed. Both are in the same arena
+so the model binds a single buffer.
+*/
+typedef struct
+{
+	uint32_t						arena_idx;
+	VkBuffer						buffer;			/* the arena's buffer */
+	VkDeviceSize					vertex_offset;	/* byte offset, a multiple of the vertex stride */
+	VkDeviceSize					vertex_size;
+	VkDeviceSize					index_offset;	/* byte offset, a multiple of the index size */
+	VkDeviceSize					index_size;
+
+} _vlk_geometry_alloc_t;
+
+/**
+The static geometry arenas. Arenas are created as needed and never released
+until the device is destroyed.
+*/
+typedef struct
+{
+	_vlk_dev_t*								dev;
+	utl_array_t(_vlk_geometry_arena_t)		arenas;
+
+} _vlk_geometry_t;
+
+/*-------------------------------------
+Uploads
+-------------------------------------*/
+
+/**
+Called once an upload batch has finished on the GPU.
+*/
+typedef void (*_vlk_upload_callback_t)(void* user_data);
+
+typedef struct
+{
+	_vlk_upload_callback_t			func;
+	void*							user_data;
+
+} _vlk_upload_callback_info_t;
+
+utl_array_declare_type(_vlk_upload_callback_info_t);
+
+/**
+Copies recorded into one command buffer and submitted together.
+*/
+typedef struct
+{
+	VkCommandBuffer					cmd;
+	VkFence							fence;			/* signaled when the batch finishes */
+	boolean							is_recording;
+	boolean							is_in_flight;
+	uint64_t						submit_idx;		/* order the batch was submitted in */
+	VkDeviceSize					staged_size;	/* staging ring bytes used, including bytes skipped at the wrap */
+	utl_array_t(_vlk_buffer_t)		temp_buffers;	/* staging for uploads too large for the ring */
+	utl_array_t(_vlk_upload_callback_info_t)
+									callbacks;
+
+} _vlk_upload_batch_t;
+
+/**
+Batches uploads to device-local memory. Data is copied into a persistently
+mapped staging ring right away and the copies are recorded into the current
+batch, which is submitted with a fence when the ring needs space or when the
+uploads are flushed.
+*/
+typedef struct
+{
+	_vlk_dev_t*						dev;
+
+	/*
+	Create/destroy
+	*/
+	VkCommandPool					command_pool;	/* on the transfer queue family */
+	_vlk_buffer_t					staging;		/* the staging ring */
+	uint8_t*						staging_data;	/* staging ring, mapped for the life of the batcher */
+	_vlk_upload_batch_t				batches[NUM_UPLOAD_BATCHES];
+
+	/*
+	Other
+	*/
+	VkDeviceSize					head;			/* next free byte of the ring */
+	VkDeviceSize					used;			/* ring bytes not yet released by a finished batch */
+	int32_t							current;		/* batch being recorded, -1 if none */
+	uint64_t						next_submit_idx;
+	uint32_t						num_submits;	/* Stat. Batches submitted. */
+	uint64_t						bytes_uploaded;	/* Stat. Bytes copied through the batcher. */
+
+} _vlk_upload_t;
+
 /*-------------------------------------
 Descriptor sets and layouts
 -------------------------------------*/
@@ -252,7 +386,10 @@ typedef struct
 	Create/destroy
 	*/
 	VkPipeline						handle;
+	VkPipeline						instanced_handle;					/* variant that reads the model matrix per instance from binding 1 */
 	VkPipelineLayout				layout;
+	_vlk_buffer_t					instance_buffers[NUM_FRAMES];		/* model matrices for instanced draws, created as needed */
+	VkDeviceSize					instance_buffer_sizes[NUM_FRAMES];	/* 0 until the frame's instance buffer is created */
 
 	/*
 	Other
@@ -327,25 +464,6 @@ typedef struct
 } _vlk_plane_push_constant_t;
 
 
-typedef struct
-{
-	kk_mat4_t			model_matrix;	/* 16 * 4 = 64 bytes */
-
-} _vlk_picker_push_constant_vertex_t;
-
-typedef struct
-{
-	kk_vec4_t			id_color;	/* The id value to use as the color to render this item on the picker buffer. */
-
-} _vlk_picker_push_constant_frag_t;
-
-typedef struct
-{
-	_vlk_picker_push_constant_vertex_t	vertex;
-	_vlk_picker_push_constant_frag_t	frag;
-
-} _vlk_picker_push_constant_t;
-
 /*-------------------------------------
 Models
 -------------------------------------*/
@@ -479,6 +597,7 @@ typedef struct
 {
 	utl_array_t(uint32_t)		graphics_families;
 	utl_array_t(uint32_t)		present_families;
+	utl_array_t(uint32_t)		transfer_families;		/* families with transfer but no graphics or compute */
 
 } _vlk_gpu_qfi_t;
 
@@ -512,6 +631,26 @@ struct _vlk_gpu_s
 	VkPhysicalDeviceFeatures		supported_features;			/* Features supported by this device */
 };
 
+/**
+Tracks the state bound on a command buffer so redundant binds can be skipped.
+*/
+typedef struct
+{
+	VkCommandBuffer					cmd;							/* the tracked command buffer */
+	VkPipeline						pipeline;						/* currently bound pipeline */
+	VkPipelineLayout				layout;							/* layout the tracked descriptor sets were bound with */
+	VkDescriptorSet					sets[MAX_NUM_TRACKED_SETS];		/* currently bound descriptor sets */
+	VkBuffer						vertex_buffers[MAX_NUM_TRACKED_VERTEX_BUFFERS];	/* vertex buffer bound to each binding */
+	VkDeviceSize					vertex_offsets[MAX_NUM_TRACKED_VERTEX_BUFFERS];
+	VkBuffer						index_buffer;
+	VkDeviceSize					index_offset;
+	VkIndexType						index_type;
+
+	uint32_t						num_binds_issued;				/* Stat. Binds recorded since the last reset. */
+	uint32_t						num_binds_skipped;				/* Stat. Binds skipped since the last reset. */
+
+} _vlk_cmd_state_t;
+
 /**
 Frame information
 */
@@ -520,7 +659,7 @@ typedef struct
 	gpu_frame_t*					base;
 
 	VkCommandBuffer					cmd_buf;		/* command buffer */
-	VkCommandBuffer					picker_cmd_buf;
+	_vlk_cmd_state_t				state;			/* bind state of cmd_buf */
 	uint32_t						frame_idx;
 	uint32_t						image_idx;
 	double							delta_time;
@@ -552,11 +691,13 @@ struct _vlk_dev_s
 	utl_array_t(uint32_t)			used_queue_families;	/* Unique set of queue family indices used by this device */
 
 	VkRenderPass					render_pass;
-	VkRenderPass					picker_render_pass;
 
 	_vlk_descriptor_layout_t		material_layout;
 	_vlk_descriptor_layout_t		per_view_layout;
 
+	_vlk_geometry_t					geometry;				/* Static mesh vertex and index arenas */
+	_vlk_upload_t					upload;					/* Batches copies to device-local memory */
+
 	/*
 	Queues and families
 	*/
@@ -564,6 +705,8 @@ struct _vlk_dev_s
 	VkQueue							gfx_queue;
 	int								present_family_idx;
 	VkQueue							present_queue;
+	int								transfer_family_idx;	/* A transfer-only family if the GPU has one, otherwise the graphics family */
+	VkQueue							transfer_queue;
 };
 
 /**
@@ -590,12 +733,6 @@ typedef struct
 	VkImage							images[NUM_FRAMES];		/* swapchain images */
 	VkImageView						image_views[NUM_FRAMES];/* swapchain image views */
 
-	VkCommandBuffer					picker_cmd_bufs[NUM_FRAMES];	/* implicitly destroy by command pools */
-	VkFramebuffer					picker_frame_bufs[NUM_FRAMES];	/* picker render pass framebuffers */
-	VkImage							picker_images[NUM_FRAMES];
-	VmaAllocation					picker_image_allocations[NUM_FRAMES];
-	VkImageView						picker_image_views[NUM_FRAMES];
-
 	VkFence							in_flight_fences[NUM_FRAMES];
 	VkSemaphore						image_avail_semaphores[NUM_FRAMES];
 	VkSemaphore						render_finished_semaphores[NUM_FRAMES];
@@ -629,7 +766,6 @@ typedef struct
 	_vlk_md5_pipeline_t				md5_pipeline;
 	_vlk_obj_pipeline_t				obj_pipeline;
 	_vlk_plane_pipeline_t			plane_pipeline;
-	_vlk_pipeline_t					picker_pipeline;
 
 } _vlk_window_t;
 
@@ -711,7 +847,7 @@ Renders an animated mesh. The appropriate pipeline must already be bound.
 void _vlk_anim_mesh__render
 	(
 	_vlk_anim_mesh_t*			mesh,			/* The mesh to render. */
-	VkCommandBuffer				cmd,			/* The command buffer. */
+	_vlk_cmd_state_t*			state,			/* The command buffer state. */
 	const ecs_transform_t*		transform
 	);
 
@@ -740,7 +876,7 @@ Renders an animated model. The appropriate pipeline must already be bound.
 void _vlk_anim_model__render
 	(
 	_vlk_anim_model_t*			model,
-	VkCommandBuffer				cmd,
+	_vlk_cmd_state_t*			state,
 	ecs_transform_t*			transform
 	);
 
@@ -802,6 +938,58 @@ Updates data for an element in the buffer.
 */
 void _vlk_buffer_array__update(_vlk_buffer_array_t* buffer, void* data, uint32_t index);
 
+/*-------------------------------------
+vlk_cmd_state.c
+-------------------------------------*/
+
+/**
+Starts tracking a command buffer that has just begun recording.
+*/
+void _vlk_cmd_state__reset(_vlk_cmd_state_t* state, VkCommandBuffer cmd);
+
+/**
+Binds a graphics descriptor set unless it is already bound with the same layout.
+*/
+void _vlk_cmd_state__bind_descriptor_set
+	(
+	_vlk_cmd_state_t*				state,
+	VkPipelineLayout				layout,
+	uint32_t						set_num,
+	VkDescriptorSet					set
+	);
+
+/**
+Binds an index buffer unless it is already bound.
+*/
+void _vlk_cmd_state__bind_index_buffer
+	(
+	_vlk_cmd_state_t*				state,
+	VkBuffer						buffer,
+	VkDeviceSize					offset,
+	VkIndexType						type
+	);
+
+/**
+Binds a graphics pipeline unless it is already bound.
+*/
+void _vlk_cmd_state__bind_pipeline(_vlk_cmd_state_t* state, VkPipeline pipeline);
+
+/**
+Binds a vertex buffer to a binding unless it is already bound there.
+*/
+void _vlk_cmd_state__bind_vertex_buffer
+	(
+	_vlk_cmd_state_t*				state,
+	uint32_t						binding,
+	VkBuffer						buffer,
+	VkDeviceSize					offset
+	);
+
+/**
+Forgets the tracked state, keeping the stats. Call after binding outside the tracker.
+*/
+void _vlk_cmd_state__invalidate(_vlk_cmd_state_t* state);
+
 /*-------------------------------------
 vlk_dbg.c
 -------------------------------------*/
@@ -872,6 +1060,16 @@ Ends recording of one-time command buffer and submits it to the queue.
 */
 void _vlk_device__end_one_time_cmd_buf(_vlk_dev_t* dev, VkCommandBuffer cmd_buf);
 
+/**
+Gets the sharing mode for resources written by uploads. When uploads use a
+dedicated transfer family the resource is shared with the graphics family, so
+no queue ownership transfers are needed.
+
+@param out__family_count Receives the number of queue families to share with.
+@param out__families Receives up to two queue family indices.
+*/
+VkSharingMode _vlk_device__get_upload_sharing(_vlk_dev_t* dev, uint32_t* out__family_count, uint32_t* out__families);
+
 /**
 _vlk_device__transition_image_layout
 */
@@ -890,6 +1088,61 @@ vlk_frame.c
 
 _vlk_frame_t* _vlk_frame__from_base(gpu_frame_t* frame);
 
+/*-------------------------------------
+vlk_geometry.c
+-------------------------------------*/
+
+/**
+Initializes the geometry arenas. None are created until something is allocated.
+*/
+void _vlk_geometry__construct(_vlk_geometry_t* geo, _vlk_dev_t* dev);
+
+/**
+Destroys the geometry arenas. Every allocation must have been freed.
+*/
+void _vlk_geometry__destruct(_vlk_geometry_t* geo);
+
+/**
+Allocates room for a model's vertices and indices in one arena, creating an arena if none has room.
+A zero vertex or index size takes no space and is skipped by update and free.
+*/
+void _vlk_geometry__alloc
+	(
+	_vlk_geometry_t*				geo,
+	VkDeviceSize					vertex_size,
+	VkDeviceSize					vertex_stride,
+	VkDeviceSize					index_size,
+	VkDeviceSize					index_stride,
+	_vlk_geometry_alloc_t*			out__alloc
+	);
+
+/**
+Frees an allocation made by _vlk_geometry__alloc.
+*/
+void _vlk_geometry__free(_vlk_geometry_t* geo, _vlk_geometry_alloc_t* alloc);
+
+/**
+Gets bytes used and reserved across the arenas, and the fragmentation of the free space from 0 to 1.
+*/
+void _vlk_geometry__get_stats
+	(
+	_vlk_geometry_t*				geo,
+	uint64_t*						out__used,
+	uint64_t*						out__reserved,
+	float*							out__fragmentation
+	);
+
+/**
+Uploads vertex and index data to an allocation.
+*/
+void _vlk_geometry__update
+	(
+	_vlk_geometry_t*				geo,
+	_vlk_geometry_alloc_t*			alloc,
+	void*							vertices,
+	void*							indices
+	);
+
 /*-------------------------------------
 vlk_gpu.c
 -------------------------------------*/
@@ -961,7 +1214,7 @@ void _vlk_imgui_pipeline__construct
 
 void _vlk_imgui_pipeline__destruct(_vlk_imgui_pipeline_t* pipeline);
 
-void _vlk_imgui_pipeline__bind(_vlk_imgui_pipeline_t* pipeline, VkCommandBuffer cmd);
+void _vlk_imgui_pipeline__bind(_vlk_imgui_pipeline_t* pipeline, _vlk_cmd_state_t* state);
 
 void _vlk_imgui_pipeline__render(_vlk_imgui_pipeline_t* pipeline, _vlk_frame_t* frame, ImDrawData* draw_data);
 
@@ -1037,7 +1290,7 @@ void _vlk_md5_pipeline__destruct(_vlk_md5_pipeline_t* pipeline);
 /**
 Binds the MD5 model pipeline.
 */
-void _vlk_md5_pipeline__bind(_vlk_md5_pipeline_t* pipeline, VkCommandBuffer cmd);
+void _vlk_md5_pipeline__bind(_vlk_md5_pipeline_t* pipeline, _vlk_cmd_state_t* state);
 
 /*-------------------------------------
 vlk_obj_pipeline.c
@@ -1062,7 +1315,34 @@ void _vlk_obj_pipeline__destruct(_vlk_obj_pipeline_t* pipeline);
 /**
 Binds the OBJ model pipeline.
 */
-void _vlk_obj_pipeline__bind(_vlk_obj_pipeline_t* pipeline, VkCommandBuffer cmd);
+void _vlk_obj_pipeline__bind(_vlk_obj_pipeline_t* pipeline, _vlk_cmd_state_t* state);
+
+/**
+Binds the instanced OBJ model pipeline and the frame's instance buffer.
+*/
+void _vlk_obj_pipeline__bind_instanced
+	(
+	_vlk_obj_pipeline_t*			pipeline,
+	_vlk_cmd_state_t*				state,
+	_vlk_frame_t*					frame
+	);
+
+/**
+Maps the frame's instance buffer for writing, growing it to hold at least
+count model matrices. Instance i is drawn with firstInstance = i. The buffer
+is rewritten from the start, so it is mapped at most once per frame.
+*/
+kk_mat4_t* _vlk_obj_pipeline__map_instances
+	(
+	_vlk_obj_pipeline_t*			pipeline,
+	_vlk_frame_t*					frame,
+	uint32_t						count
+	);
+
+/**
+Unmaps the frame's instance buffer. Must be called before the frame is submitted.
+*/
+void _vlk_obj_pipeline__unmap_instances(_vlk_obj_pipeline_t* pipeline, _vlk_frame_t* frame);
 
 /*-------------------------------------
 vlk_per_view_layout.c
@@ -1106,7 +1386,7 @@ Binds the descriptor set for the specified frame.
 void _vlk_per_view_set__bind
 	(
 	_vlk_descriptor_set_t*			set,
-	VkCommandBuffer					cmd_buf,
+	_vlk_cmd_state_t*				state,
 	_vlk_frame_t*					frame,
 	VkPipelineLayout				pipelineLayout
 	);
@@ -1118,8 +1398,7 @@ void _vlk_per_view_set__update
 	(
 	_vlk_descriptor_set_t*			set,
 	_vlk_frame_t*					frame,
-	kk_camera_t*					camera,
-	VkExtent2D						extent
+	kk_camera_t*					camera
 	);
 
 /*-------------------------------------
@@ -1146,7 +1425,7 @@ Renders a plane.
 void _vlk_plane__render
 	(
 	_vlk_plane_t*				plane,
-	VkCommandBuffer				cmd
+	_vlk_cmd_state_t*			state
 	);
 
 /**
@@ -1154,22 +1433,6 @@ Updates the vertices for the plane.
 */
 void _vlk_plane__update_verts(_vlk_plane_t* plane, const kk_vec3_t verts[4]);
 
-/*-------------------------------------
-vlk_picker_pipeline.c
--------------------------------------*/
-
-void _vlk_picker_pipeline__construct
-	(
-	_vlk_pipeline_t*				pipeline,
-	_vlk_dev_t*						device,
-	VkRenderPass					render_pass,
-	VkExtent2D						extent
-	);
-
-void _vlk_picker_pipeline__destruct(_vlk_pipeline_t* pipeline);
-
-void _vlk_picker_pipeline__bind(_vlk_pipeline_t* pipeline, VkCommandBuffer cmd);
-
 /*-------------------------------------
 vlk_plane_pipeline.c
 -------------------------------------*/
@@ -1193,7 +1456,7 @@ void _vlk_plane_pipeline__destruct(_vlk_plane_pipeline_t* pipeline);
 /**
 Binds the pipeline for use.
 */
-void _vlk_plane_pipeline__bind(_vlk_plane_pipeline_t* pipeline, VkCommandBuffer cmd);
+void _vlk_plane_pipeline__bind(_vlk_plane_pipeline_t* pipeline, _vlk_cmd_state_t* state);
 
 /*-------------------------------------
 vlk_setup.c
@@ -1295,6 +1558,60 @@ void _vlk_texture__destruct(_vlk_texture_t* tex);
 
 _vlk_texture_t* _vlk_texture__from_base(gpu_texture_t* base);
 
+/*-------------------------------------
+vlk_upload.c
+-------------------------------------*/
+
+/**
+Creates the upload batcher.
+*/
+void _vlk_upload__construct(_vlk_upload_t* up, _vlk_dev_t* dev);
+
+/**
+Finishes any pending uploads and destroys the upload batcher.
+*/
+void _vlk_upload__destruct(_vlk_upload_t* up);
+
+/**
+Copies data into a buffer. The data is staged before returning, so it can be freed right away.
+*/
+void _vlk_upload__buffer
+	(
+	_vlk_upload_t*					up,
+	VkBuffer						dst,
+	VkDeviceSize					dst_offset,
+	const void*						data,
+	VkDeviceSize					size
+	);
+
+/**
+Copies data into all of a 2D color image and leaves it ready to sample. The data is staged before returning.
+*/
+void _vlk_upload__image
+	(
+	_vlk_upload_t*					up,
+	VkImage							image,
+	uint32_t						width,
+	uint32_t						height,
+	const void*						data,
+	VkDeviceSize					size
+	);
+
+/**
+Submits pending uploads and waits for every batch to finish, then calls their callbacks.
+*/
+void _vlk_upload__flush(_vlk_upload_t* up);
+
+/**
+Calls a function once every upload recorded so far has finished.
+*/
+void _vlk_upload__on_complete(_vlk_upload_t* up, _vlk_upload_callback_t func, void* user_data);
+
+/**
+Submits the batch being recorded without waiting for it.
+*/
+void _vlk_upload__submit(_vlk_upload_t* up);
+
 /*-------------------------------------
 vlk_window.c
 -------------------------------------*/
@@ -77,7 +77,6 @@ void _vlk_swapchain__begin_frame(_vlk_swapchain_t* swap, _vlk_t* vlk, _vlk_frame
 
 	/* Start render passes */
 	begin_primary_render_pass(swap, frame);
-	begin_picker_render_pass(swap, frame);
 
 	/* Calc frame timing */
 	double curTime = glfwGetTime();
@@ -102,22 +101,11 @@ void _vlk_swapchain__end_frame(_vlk_swapchain_t* swap, _vlk_frame_t* frame)
 		kk_log__fatal("Failed to record command buffer.");
 	}
 
-	/* End the picker buffer render pass */
-	vkCmdEndRenderPass(swap->picker_cmd_bufs[img_idx]);
-
-	result = vkEndCommandBuffer(swap->picker_cmd_bufs[img_idx]);
-	if (result != VK_SUCCESS)
-	{
-		kk_log__fatal("Failed to record command buffer.");
-	}
-
 	VkCommandBuffer cmd_buffers[] =
 	{
 		swap->cmd_bufs[img_idx],
-		swap->picker_cmd_bufs[img_idx],
 	};
 
-
 	VkSubmitInfo submit_info;
 	clear_struct(&submit_info);
 	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -201,48 +189,6 @@ void _vlk_swapchain__recreate(_vlk_swapchain_t* swap, int width, int height)
 STATIC FUNCTIONS
 =========================================================*/
 
-//## static
-static void begin_picker_render_pass(_vlk_swapchain_t* swap, _vlk_frame_t* frame)
-{
-	/*
-	Begin picker buffer render pass command buffer
-	*/
-	frame->picker_cmd_buf = swap->picker_cmd_bufs[frame->image_idx];
-
-	VkCommandBufferBeginInfo begin_info;
-	clear_struct(&begin_info);
-	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	begin_info.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-	begin_info.pInheritanceInfo = NULL; // Optional
-
-	if (vkBeginCommandBuffer(frame->picker_cmd_buf, &begin_info) != VK_SUCCESS)
-	{
-		kk_log__fatal("Failed to begin recording command buffer.");
-	}
-
-	VkRenderPassBeginInfo render_pass_info;
-	clear_struct(&render_pass_info);
-	render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	render_pass_info.renderPass = swap->dev->picker_render_pass;
-	render_pass_info.framebuffer = swap->picker_frame_bufs[frame->image_idx];
-	render_pass_info.renderArea.offset.x = 0;
-	render_pass_info.renderArea.offset.y = 0;
-	render_pass_info.renderArea.extent = swap->extent;
-
-	/* Initialize picker buffer to 0xFFFFFFFF. This is the invalid entity id. */
-	VkClearValue clear_values[1];
-	memset(&clear_values, 0, sizeof(clear_values));
-	clear_values[0].color.float32[0] = 1.0f;
-	clear_values[0].color.float32[1] = 1.0f;
-	clear_values[0].color.float32[2] = 1.0f;
-	clear_values[0].color.float32[3] = 1.0f;
-
-	render_pass_info.clearValueCount = cnt_of_array(clear_values);
-	render_pass_info.pClearValues = clear_values;
-
-	vkCmdBeginRenderPass(frame->picker_cmd_buf, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
-}
-
 //## static
 static void begin_primary_render_pass(_vlk_swapchain_t* swap, _vlk_frame_t* frame)
 {
@@ -262,6 +208,8 @@ static void begin_primary_render_pass(_vlk_swapchain_t* swap, _vlk_frame_t* fram
 		kk_log__fatal("Failed to begin recording command buffer.");
 	}
 
+	_vlk_cmd_state__reset(&frame->state, frame->cmd_buf);
+
 	VkRenderPassBeginInfo render_pass_info;
 	clear_struct(&render_pass_info);
 	render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -320,7 +268,6 @@ static void create_all(_vlk_swapchain_t* swap, VkExtent2D extent)
 	create_swapchain(swap, extent);
 	create_image_views(swap);
 	create_depth_buffer(swap);
-	create_picker_buffers(swap);
 	create_framebuffers(swap);
 
 	/*
@@ -349,23 +296,6 @@ static void create_command_buffers(_vlk_swapchain_t* swap)
 	{
 		kk_log__fatal("Failed to allocate command buffers.");
 	}
-
-	/*
-	Create command buffers for picker buffer render pass
-	*/
-	memset(swap->picker_cmd_bufs, 0, sizeof(swap->picker_cmd_bufs));
-
-	//VkCommandBufferAllocateInfo alloc_info;
-	clear_struct(&alloc_info);
-	alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	alloc_info.commandPool = swap->dev->command_pool;
-	alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	alloc_info.commandBufferCount = cnt_of_array(swap->picker_cmd_bufs);
-
-	if (vkAllocateCommandBuffers(swap->dev->handle, &alloc_info, swap->picker_cmd_bufs) != VK_SUCCESS)
-	{
-		kk_log__fatal("Failed to allocate command buffers.");
-	}
 }
 
 //## static
@@ -508,95 +438,6 @@ static void create_image_views(_vlk_swapchain_t* swap)
 	}
 }
 
-//## static
-/**
-Creates images and image views for the picker buffers. Objects are rendered
-to the a picker buffer using a unique color. The buffer can then be sampled at a certain
-pixel to determine what object is drawn at that pixel. It allows "picking" objects on the screen.
-*/
-static void create_picker_buffers(_vlk_swapchain_t* swap)
-{
-	for (int i = 0; i < cnt_of_array(swap->picker_images); ++i)
-	{
-		/*
-		Create image
-		*/
-		VkImageCreateInfo image_info;
-		clear_struct(&image_info);
-		image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-		image_info.imageType = VK_IMAGE_TYPE_2D;
-		image_info.extent.width = swap->extent.width;
-		image_info.extent.height = swap->extent.height;
-		image_info.extent.depth = 1;
-		image_info.mipLevels = 1;
-		image_info.arrayLayers = 1;
-
-		image_info.format = VK_FORMAT_B8G8R8A8_UNORM;
-		image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-		image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		image_info.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-		image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		image_info.samples = VK_SAMPLE_COUNT_1_BIT;
-		image_info.flags = 0;
-
-		VmaAllocationCreateInfo alloc_info;
-		clear_struct(&alloc_info);
-		alloc_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-		alloc_info.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-
-		VkResult result = vmaCreateImage(swap->dev->allocator, &image_info, &alloc_info, &swap->picker_images[i], &swap->picker_image_allocations[i], NULL);
-		if (result != VK_SUCCESS) 
-		{
-			kk_log__fatal("Failed to create picker buffer image.");
-		}
-		
-		_vlk_device__transition_image_layout(swap->dev, swap->picker_images[i], image_info.format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-		/*
-		Create image view
-		*/
-		VkImageViewCreateInfo view_info;
-		clear_struct(&view_info);
-		view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		view_info.image = swap->picker_images[i];
-		view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		view_info.format = image_info.format;
-		view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		view_info.subresourceRange.baseMipLevel = 0;
-		view_info.subresourceRange.levelCount = 1;
-		view_info.subresourceRange.baseArrayLayer = 0;
-		view_info.subresourceRange.layerCount = 1;
-
-		if (vkCreateImageView(swap->dev->handle, &view_info, NULL, &swap->picker_image_views[i]) != VK_SUCCESS)
-		{
-			kk_log__fatal("Failed to create picker buffer image view.");
-		}
-
-		/*
-		Create frame buffers
-		*/
-		VkImageView attachments[] =
-		{
-			swap->picker_image_views[i],
-		};
-
-		VkFramebufferCreateInfo framebuf_info;
-		clear_struct(&framebuf_info);
-		framebuf_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebuf_info.renderPass = swap->dev->picker_render_pass;
-		framebuf_info.attachmentCount = cnt_of_array(attachments);
-		framebuf_info.pAttachments = attachments;
-		framebuf_info.width = swap->extent.width;
-		framebuf_info.height = swap->extent.height;
-		framebuf_info.layers = 1;
-
-		if (vkCreateFramebuffer(swap->dev->handle, &framebuf_info, NULL, &swap->picker_frame_bufs[i]) != VK_SUCCESS)
-		{
-			kk_log__fatal("Failed to create framebuffer.");
-		}
-	}
-}
-
 //## static
 /**
 create_semaphores
@@ -722,7 +563,6 @@ static void destroy_all(_vlk_swapchain_t* swap)
 	destroy_command_buffers(swap);
 
 	destroy_framebuffers(swap);
-	destroy_picker_buffers(swap);
 	destroy_depth_buffer(swap);
 	destroy_image_views(swap);
 	destroy_swapchain(swap);
@@ -782,22 +622,6 @@ static void destroy_image_views(_vlk_swapchain_t* swap)
 	}
 }
 
-//## static
-/**
-Destroys the picker buffer images and image views.
-*/
-static void destroy_picker_buffers(_vlk_swapchain_t* swap)
-{
-	uint32_t i;
-
-	for (i = 0; i < cnt_of_array(swap->picker_images); i++)
-	{
-		vkDestroyFramebuffer(swap->dev->handle, swap->picker_frame_bufs[i], NULL);
-		vkDestroyImageView(swap->dev->handle, swap->picker_image_views[i], NULL);
-		vmaDestroyImage(swap->dev->allocator, swap->picker_images[i], swap->picker_image_allocations[i]);
-	}
-}
-
 //## static
 /**
 destroy_semaphores
@@ -831,7 +655,6 @@ static void resize(_vlk_swapchain_t* swap, VkExtent2D extent)
 
 	/* destroy things that need recreated */
 	destroy_framebuffers(swap);
-	destroy_picker_buffers(swap);
 	destroy_depth_buffer(swap);
 	destroy_image_views(swap);
 	destroy_swapchain(swap);
@@ -840,6 +663,5 @@ static void resize(_vlk_swapchain_t* swap, VkExtent2D extent)
 	create_swapchain(swap, extent);
 	create_image_views(swap);
 	create_depth_buffer(swap);
-	create_picker_buffers(swap);
 	create_framebuffers(swap);
 }
\ No newline at end of file
@@ -53,6 +53,9 @@ void _vlk_texture__construct
 
 void _vlk_texture__destruct(_vlk_texture_t* tex)
 {
+	/* A pending upload may still write to the image */
+	_vlk_upload__flush(&tex->dev->upload);
+
 	destroy_image_view(tex);
 	destroy_image(tex);
 }
@@ -68,22 +71,10 @@ _vlk_texture_t* _vlk_texture__from_base(gpu_texture_t* base)
 
 static void create_image(_vlk_texture_t* tex, const _vlk_texture_create_info_t* create_info)
 {
-	/*
-	Create staging buffer with texture data
-	*/
-	_vlk_buffer_t staging_buffer;
-	_vlk_buffer__construct(
-		&staging_buffer,
-		tex->dev,
-		create_info->size,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VMA_MEMORY_USAGE_CPU_ONLY);
-
-	_vlk_buffer__update(&staging_buffer, create_info->data, 0, create_info->size);
-
 	/*
 	Create the image
 	*/
+	uint32_t queue_families[2];
 	VkImageCreateInfo image_info;
 	clear_struct(&image_info);
 	image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -101,7 +92,8 @@ static void create_image(_vlk_texture_t* tex, const _vlk_texture_create_info_t*
 	image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
 	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	image_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-	image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_info.sharingMode = _vlk_device__get_upload_sharing(tex->dev, &image_info.queueFamilyIndexCount, queue_families);
+	image_info.pQueueFamilyIndices = queue_families;
 	image_info.samples = VK_SAMPLE_COUNT_1_BIT;
 	image_info.flags = 0;
 
@@ -117,16 +109,10 @@ static void create_image(_vlk_texture_t* tex, const _vlk_texture_create_info_t*
 	}
 
 	/*
-	Copy texture from staging buffer to GPU
-	*/
-	_vlk_device__transition_image_layout(tex->dev, tex->image, tex->format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	_vlk_device__copy_buffer_to_img_now(tex->dev, staging_buffer.handle, tex->image, create_info->width, create_info->height);
-	_vlk_device__transition_image_layout(tex->dev, tex->image, tex->format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	/*
-	Cleanup staging buffer
+	Copy texture to GPU. The copy is batched with other uploads and
+	completes before the next frame renders.
 	*/
-	_vlk_buffer__destruct(&staging_buffer);
+	_vlk_upload__image(&tex->dev->upload, tex->image, create_info->width, create_info->height, create_info->data, create_info->size);
 }
 
 void create_image_view(_vlk_texture_t* tex)
@@ -0,0 +1,513 @@
+/*=========================================================
+Uploads to device-local memory are batched instead of each
+getting its own command buffer and queue wait. Data is
+copied into a staging ring as soon as it is given, so
+callers can free it, and the copy is recorded into the
+current batch. A batch is submitted with a fence when the
+ring runs out of room or when uploads are flushed, and its
+ring space is released once the fence signals.
+
+Batches go to a transfer-only queue when the GPU has one.
+Resources written by uploads are created with concurrent
+sharing between the graphics and transfer families in that
+case, so no ownership transfers are needed. Rendering waits
+for uploads on the host: the window flushes them at the
+start of each frame.
+=========================================================*/
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_log.h"
+#include "gpu/vlk/vlk.h"
+#include "gpu/vlk/vlk_prv.h"
+#include "thirdparty/vma/vma.h"
+#include "utl/utl_array.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+DECLARATIONS
+=========================================================*/
+
+/** Gets the batch being recorded, starting one if needed. */
+static _vlk_upload_batch_t* begin_batch(_vlk_upload_t* up);
+
+/** Waits for a submitted batch, releases its staging and calls its callbacks. */
+static void complete_batch(_vlk_upload_t* up, _vlk_upload_batch_t* batch);
+
+/** Takes space from the staging ring. Returns FALSE if the ring does not have it right now. */
+static boolean ring_alloc(_vlk_upload_t* up, VkDeviceSize size, VkDeviceSize* out__offset, VkDeviceSize* out__consumed);
+
+/** Copies data to staging and returns the staging buffer and offset to copy from. */
+static VkBuffer stage(_vlk_upload_t* up, const void* data, VkDeviceSize size, VkDeviceSize* out__offset);
+
+/** Frees ring space by submitting the current batch or waiting for the oldest one. */
+static void wait_for_space(_vlk_upload_t* up);
+
+/*=========================================================
+CONSTRUCTORS
+=========================================================*/
+
+/**
+_vlk_upload__construct
+*/
+void _vlk_upload__construct(_vlk_upload_t* up, _vlk_dev_t* dev)
+{
+	clear_struct(up);
+	up->dev = dev;
+	up->current = -1;
+
+	/* Command pool on the transfer family */
+	VkCommandPoolCreateInfo pool_info;
+	clear_struct(&pool_info);
+	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pool_info.queueFamilyIndex = dev->transfer_family_idx;
+	pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+	if (vkCreateCommandPool(dev->handle, &pool_info, NULL, &up->command_pool) != VK_SUCCESS)
+	{
+		kk_log__fatal("Failed to create upload command pool.");
+	}
+
+	/* A command buffer and fence per batch */
+	VkCommandBuffer cmds[NUM_UPLOAD_BATCHES];
+
+	VkCommandBufferAllocateInfo alloc_info;
+	clear_struct(&alloc_info);
+	alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	alloc_info.commandPool = up->command_pool;
+	alloc_info.commandBufferCount = NUM_UPLOAD_BATCHES;
+
+	if (vkAllocateCommandBuffers(dev->handle, &alloc_info, cmds) != VK_SUCCESS)
+	{
+		kk_log__fatal("Failed to allocate upload command buffers.");
+	}
+
+	VkFenceCreateInfo fence_info;
+	clear_struct(&fence_info);
+	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	for (uint32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+	{
+		_vlk_upload_batch_t* batch = &up->batches[i];
+		batch->cmd = cmds[i];
+		utl_array_init(&batch->temp_buffers);
+		utl_array_init(&batch->callbacks);
+
+		if (vkCreateFence(dev->handle, &fence_info, NULL, &batch->fence) != VK_SUCCESS)
+		{
+			kk_log__fatal("Failed to create upload fence.");
+		}
+	}
+
+	/* Staging ring, mapped for the life of the batcher */
+	_vlk_buffer__construct(&up->staging, dev, UPLOAD_STAGING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+	if (vmaMapMemory(dev->allocator, up->staging.allocation, (void**)&up->staging_data) != VK_SUCCESS)
+	{
+		kk_log__fatal("Unable to map upload staging memory.");
+	}
+}
+
+/**
+_vlk_upload__destruct
+*/
+void _vlk_upload__destruct(_vlk_upload_t* up)
+{
+	_vlk_upload__flush(up);
+
+	vmaUnmapMemory(up->dev->allocator, up->staging.allocation);
+	_vlk_buffer__destruct(&up->staging);
+
+	for (uint32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+	{
+		vkDestroyFence(up->dev->handle, up->batches[i].fence, NULL);
+		utl_array_destroy(&up->batches[i].temp_buffers);
+		utl_array_destroy(&up->batches[i].callbacks);
+	}
+
+	/* Frees the command buffers too */
+	vkDestroyCommandPool(up->dev->handle, up->command_pool, NULL);
+}
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+_vlk_upload__buffer
+*/
+void _vlk_upload__buffer
+	(
+	_vlk_upload_t*					up,
+	VkBuffer						dst,
+	VkDeviceSize					dst_offset,
+	const void*						data,
+	VkDeviceSize					size
+	)
+{
+	VkDeviceSize src_offset;
+	VkBuffer src = stage(up, data, size, &src_offset);
+
+	VkBufferCopy region;
+	clear_struct(&region);
+	region.srcOffset = src_offset;
+	region.dstOffset = dst_offset;
+	region.size = size;
+
+	vkCmdCopyBuffer(begin_batch(up)->cmd, src, dst, 1, &region);
+}
+
+/**
+_vlk_upload__image
+*/
+void _vlk_upload__image
+	(
+	_vlk_upload_t*					up,
+	VkImage							image,
+	uint32_t						width,
+	uint32_t						height,
+	const void*						data,
+	VkDeviceSize					size
+	)
+{
+	VkDeviceSize src_offset;
+	VkBuffer src = stage(up, data, size, &src_offset);
+	VkCommandBuffer cmd = begin_batch(up)->cmd;
+
+	VkImageMemoryBarrier barrier;
+	clear_struct(&barrier);
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+
+	/* Undefined -> transfer destination */
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+	VkBufferImageCopy region;
+	clear_struct(&region);
+	region.bufferOffset = src_offset;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = width;
+	region.imageExtent.height = height;
+	region.imageExtent.depth = 1;
+	vkCmdCopyBufferToImage(cmd, src, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	/*
+	Transfer destination -> shader read. A transfer queue cannot name the fragment shader stage,
+	but the host waits for the batch before the image is used, so the layout change is all that is needed.
+	*/
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+}
+
+/**
+_vlk_upload__flush
+*/
+void _vlk_upload__flush(_vlk_upload_t* up)
+{
+	_vlk_upload_batch_t* oldest;
+
+	_vlk_upload__submit(up);
+
+	/* Complete in submission order so the ring is released front to back */
+	for (;;)
+	{
+		oldest = NULL;
+		for (uint32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+		{
+			_vlk_upload_batch_t* batch = &up->batches[i];
+			if (batch->is_in_flight && (!oldest || batch->submit_idx < oldest->submit_idx))
+			{
+				oldest = batch;
+			}
+		}
+
+		if (!oldest)
+		{
+			break;
+		}
+
+		complete_batch(up, oldest);
+	}
+}
+
+/**
+_vlk_upload__on_complete
+*/
+void _vlk_upload__on_complete(_vlk_upload_t* up, _vlk_upload_callback_t func, void* user_data)
+{
+	_vlk_upload_batch_t* target = NULL;
+	_vlk_upload_callback_info_t callback;
+
+	callback.func = func;
+	callback.user_data = user_data;
+
+	/* The batch being recorded finishes after everything else, otherwise the newest one in flight does */
+	if (up->current >= 0)
+	{
+		target = &up->batches[up->current];
+	}
+	else
+	{
+		for (uint32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+		{
+			_vlk_upload_batch_t* batch = &up->batches[i];
+			if (batch->is_in_flight && (!target || batch->submit_idx > target->submit_idx))
+			{
+				target = batch;
+			}
+		}
+	}
+
+	if (!target)
+	{
+		/* Nothing pending */
+		func(user_data);
+		return;
+	}
+
+	utl_array_push(&target->callbacks, callback);
+}
+
+/**
+_vlk_upload__submit
+*/
+void _vlk_upload__submit(_vlk_upload_t* up)
+{
+	if (up->current < 0)
+	{
+		return;
+	}
+
+	_vlk_upload_batch_t* batch = &up->batches[up->current];
+
+	vkEndCommandBuffer(batch->cmd);
+
+	VkSubmitInfo submit_info;
+	clear_struct(&submit_info);
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &batch->cmd;
+
+	if (vkQueueSubmit(up->dev->transfer_queue, 1, &submit_info, batch->fence) != VK_SUCCESS)
+	{
+		kk_log__fatal("Failed to submit uploads.");
+	}
+
+	batch->is_recording = FALSE;
+	batch->is_in_flight = TRUE;
+	batch->submit_idx = up->next_submit_idx++;
+	up->current = -1;
+	up->num_submits++;
+}
+
+/**
+begin_batch
+*/
+static _vlk_upload_batch_t* begin_batch(_vlk_upload_t* up)
+{
+	_vlk_upload_batch_t* batch = NULL;
+	_vlk_upload_batch_t* oldest = NULL;
+
+	if (up->current >= 0)
+	{
+		return &up->batches[up->current];
+	}
+
+	/* Find an idle batch, or wait for the oldest to finish */
+	for (int32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+	{
+		_vlk_upload_batch_t* b = &up->batches[i];
+		if (!b->is_in_flight)
+		{
+			batch = b;
+			up->current = i;
+			break;
+		}
+
+		if (!oldest || b->submit_idx < oldest->submit_idx)
+		{
+			oldest = b;
+		}
+	}
+
+	if (!batch)
+	{
+		complete_batch(up, oldest);
+		batch = oldest;
+		up->current = (int32_t)(oldest - up->batches);
+	}
+
+	VkCommandBufferBeginInfo begin_info;
+	clear_struct(&begin_info);
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	vkResetCommandBuffer(batch->cmd, 0);
+	vkBeginCommandBuffer(batch->cmd, &begin_info);
+	batch->is_recording = TRUE;
+
+	return batch;
+}
+
+/**
+complete_batch
+*/
+static void complete_batch(_vlk_upload_t* up, _vlk_upload_batch_t* batch)
+{
+	vkWaitForFences(up->dev->handle, 1, &batch->fence, VK_TRUE, UINT64_MAX);
+	vkResetFences(up->dev->handle, 1, &batch->fence);
+	batch->is_in_flight = FALSE;
+
+	/* Batches complete in submission order, so this releases the back of the ring */
+	up->used -= batch->staged_size;
+	batch->staged_size = 0;
+
+	for (uint32_t i = 0; i < batch->temp_buffers.count; ++i)
+	{
+		_vlk_buffer__destruct(&batch->temp_buffers.data[i]);
+	}
+
+	batch->temp_buffers.count = 0;
+
+	for (uint32_t i = 0; i < batch->callbacks.count; ++i)
+	{
+		batch->callbacks.data[i].func(batch->callbacks.data[i].user_data);
+	}
+
+	batch->callbacks.count = 0;
+}
+
+/**
+ring_alloc
+*/
+static boolean ring_alloc(_vlk_upload_t* up, VkDeviceSize size, VkDeviceSize* out__offset, VkDeviceSize* out__consumed)
+{
+	VkDeviceSize tail;
+	VkDeviceSize offset;
+	VkDeviceSize skipped = 0;
+
+	if (up->used == UPLOAD_STAGING_SIZE)
+	{
+		return FALSE;
+	}
+
+	/* Start over at the front once everything is released */
+	if (up->used == 0)
+	{
+		up->head = 0;
+	}
+
+	tail = (up->head + UPLOAD_STAGING_SIZE - up->used) % UPLOAD_STAGING_SIZE;
+
+	if (up->head >= tail)
+	{
+		/* Free space runs from head to the end, then from the start to tail */
+		if (up->head + size <= UPLOAD_STAGING_SIZE)
+		{
+			offset = up->head;
+		}
+		else if (size <= tail)
+		{
+			offset = 0;
+			skipped = UPLOAD_STAGING_SIZE - up->head;
+		}
+		else
+		{
+			return FALSE;
+		}
+	}
+	else if (up->head + size <= tail)
+	{
+		offset = up->head;
+	}
+	else
+	{
+		return FALSE;
+	}
+
+	up->head = (offset + size) % UPLOAD_STAGING_SIZE;
+	up->used += skipped + size;
+	*out__offset = offset;
+	*out__consumed = skipped + size;
+	return TRUE;
+}
+
+/**
+stage
+*/
+static VkBuffer stage(_vlk_upload_t* up, const void* data, VkDeviceSize size, VkDeviceSize* out__offset)
+{
+	VkDeviceSize aligned = (size + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+	VkDeviceSize consumed;
+	_vlk_buffer_t temp;
+
+	up->bytes_uploaded += size;
+
+	/* Large uploads would hog the ring, so they get their own staging buffer */
+	if (aligned > UPLOAD_STAGING_SIZE / 2)
+	{
+		_vlk_buffer__construct(&temp, up->dev, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+		_vlk_buffer__update(&temp, (void*)data, 0, size);
+		utl_array_push(&begin_batch(up)->temp_buffers, temp);
+
+		*out__offset = 0;
+		return temp.handle;
+	}
+
+	while (!ring_alloc(up, aligned, out__offset, &consumed))
+	{
+		wait_for_space(up);
+	}
+
+	memcpy(up->staging_data + *out__offset, data, size);
+	begin_batch(up)->staged_size += consumed;
+
+	return up->staging.handle;
+}
+
+/**
+wait_for_space
+*/
+static void wait_for_space(_vlk_upload_t* up)
+{
+	_vlk_upload_batch_t* oldest = NULL;
+
+	/* The current batch may hold the space, so it has to go out before anything can be waited on */
+	_vlk_upload__submit(up);
+
+	for (uint32_t i = 0; i < NUM_UPLOAD_BATCHES; ++i)
+	{
+		_vlk_upload_batch_t* batch = &up->batches[i];
+		if (batch->is_in_flight && (!oldest || batch->submit_idx < oldest->submit_idx))
+		{
+			oldest = batch;
+		}
+	}
+
+	if (oldest)
+	{
+		complete_batch(up, oldest);
+	}
+}
\ No newline at end of file
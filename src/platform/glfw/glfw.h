@@ -55,6 +55,8 @@ FUNCTIONS
 
 float glfw__get_delta_time(platform_t* platform);
 
+double glfw__get_time(platform_t* platform);
+
 boolean glfw__load_file(const char* filename, boolean binary, long* out__size, void** out__buffer);
 
 void glfw__log_to_stdout(kk_log_t* log, const char* msg);
@@ -8,6 +8,7 @@ INCLUDES
 #include "common.h"
 #include "app/app.h"
 #include "app/game/jetz.h"
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
 #include "gpu/vlk/vlk.h"
@@ -25,6 +26,7 @@ VARIABLES
 
 app_t*						g_app;
 gpu_t*						g_gpu;
+kk_job_system_t*			g_jobs;
 kk_log_t*					g_log;
 platform_t*					g_platform;
 
@@ -32,6 +34,7 @@ static app_t				s_app;
 static app_intf_t			s_app_intf;
 static gpu_t				s_gpu;
 static gpu_intf_t			s_gpu_intf;
+static kk_job_system_t		s_jobs;
 static kk_log_t				s_log;
 static platform_t			s_platform;
 
@@ -87,6 +90,9 @@ static void shutdown()
 	/* Shutdown GPU */
 	gpu__destruct(&s_gpu);
 
+	/* Shutdown job system */
+	kk_job__destruct(g_jobs);
+
 	/* Shutdown logging */
 	kk_log__destruct(g_log);
 }
@@ -107,10 +113,15 @@ static void startup()
 	kk_log__register_target(g_log, glfw__log_to_stdout);
 	kk_log__dbg("Logging initialized.");
 
+	/* Setup the job system, one thread per core */
+	g_jobs = &s_jobs;
+	kk_job__construct(g_jobs, 0);
+
 	/* Setup the platform */
 	g_platform = &s_platform;
 	clear_struct(g_platform);
 	g_platform->get_delta_time = &glfw__get_delta_time;
+	g_platform->get_time = &glfw__get_time;
 	g_platform->load_file = &glfw__load_file;
 	g_platform->window__construct = glfw_window__construct;
 	g_platform->window__destruct = glfw_window__destruct;
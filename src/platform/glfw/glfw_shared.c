@@ -30,6 +30,11 @@ float glfw__get_delta_time(platform_t* platform)
 	return delta;
 }
 
+double glfw__get_time(platform_t* platform)
+{
+	return glfwGetTime();
+}
+
 boolean glfw__load_file(const char* filename, boolean binary, long *out__size, void** out__buffer)
 {
 	FILE* f;
@@ -31,6 +31,7 @@ TYPES
 Platform callback functions
 -------------------------------------*/
 typedef float (*platform_get_delta_time_func)(platform_t* platform);
+typedef double (*platform_get_time_func)(platform_t* platform);
 
 typedef boolean (*platform_load_file_func)(const char* filename, boolean binary, long* out__size, void** out__buffer);
 typedef FILE* (*platform_open_file_func)(const char* filename, long* out__size);
@@ -48,6 +49,7 @@ struct platform_s
 
 
 	platform_get_delta_time_func	get_delta_time;	/* gets delta time between the last frame and this frame */
+	platform_get_time_func			get_time;		/* gets a high resolution time in seconds, used for profiling */
 
 	/*
 	Allocates a temporary buffer and loads the specified file into the buffer.
@@ -17,6 +17,7 @@ INCLUDES
 #include "common.h"
 #include "app/app.h"
 #include "app/game/jetz.h"
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
 #include "gpu/gpu.h"
 #include "gpu/pspgu/pspgu.h"
@@ -50,6 +51,7 @@ VARIABLES
 
 app_t*						g_app;
 gpu_t*						g_gpu;
+kk_job_system_t*			g_jobs;
 kk_log_t*					g_log;
 platform_t*					g_platform;
 
@@ -57,6 +59,7 @@ static app_t				s_app;
 static app_intf_t			s_app_intf;
 static gpu_t				s_gpu;
 static gpu_intf_t			s_gpu_intf;
+static kk_job_system_t		s_jobs;
 static kk_log_t				s_log;
 static platform_t			s_platform;
 static psp_platform_t		s_platform_psp;
@@ -235,6 +238,17 @@ static float platform_get_delta_time(platform_t* platform)
 	return (float)(time_span);
 }
 
+//## static
+/** Platform callback to get the current time in seconds. */
+static double platform_get_time(platform_t* platform)
+{
+	uint64_t tick;
+	int tick_res = sceRtcGetTickResolution();
+
+	sceRtcGetCurrentTick(&tick);
+	return (double)tick / (double)max(tick_res, 1);
+}
+
 //## static
 /** Loads a file. */
 static boolean platform_load_file(const char* filename, boolean binary, long* out__size, void** out__buffer)
@@ -296,6 +310,9 @@ static void shutdown()
 	/* Shutdown GPU */
 	gpu__destruct(&s_gpu);
 
+	/* Shutdown job system */
+	kk_job__destruct(g_jobs);
+
 	/* Shutdown logging */
 	kk_log__destruct(g_log);
 }
@@ -322,6 +339,13 @@ static void startup()
 		kk_log__dbg("Logging initialized.");
 	}
 
+	/*
+	Setup job system. Jobs run inline on the PSP.
+	*/
+	kk_log__dbg("Initializing job system.");
+	g_jobs = &s_jobs;
+	kk_job__construct(g_jobs, 1);
+
 	/*
 	Setup platform 
 	*/
@@ -331,6 +355,7 @@ static void startup()
 	g_platform = &s_platform;
 	g_platform->context = (void*)&s_platform_psp;
 	g_platform->get_delta_time = &platform_get_delta_time;
+	g_platform->get_time = &platform_get_time;
 	g_platform->load_file = &platform_load_file;
 	g_platform->window__construct = &psp_window__construct;
 	g_platform->window__destruct = &psp_window__destruct;
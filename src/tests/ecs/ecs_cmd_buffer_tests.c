@@ -0,0 +1,186 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+
+#include "common.h"
+#include "global.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_cmd_buffer.h"
+#include "engine/kk_job.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	ecs_t*					ecs;
+	entity_id_t				first;
+
+} spawn_data_t;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void spawn_range(void* data, uint32_t start, uint32_t end)
+{
+	spawn_data_t* d = (spawn_data_t*)data;
+	ecs_cmd_buffer_t* buf = ecs__get_cmd_buffer(d->ecs);
+	ecs_physics_t* physics;
+	uint32_t i;
+
+	for (i = start; i < end; ++i)
+	{
+		entity_id_t ent = ecs_cmd_buffer__spawn(buf);
+		physics = (ecs_physics_t*)ecs_cmd_buffer__add(buf, ent, ECS_COMPONENT_TYPE_PHYSICS);
+		physics->mass = (float)i;
+
+		/* Every other existing entity loses its transform */
+		if (i % 2 == 0)
+		{
+			ecs_cmd_buffer__remove(buf, d->first + i, ECS_COMPONENT_TYPE_TRANSFORM);
+		}
+	}
+}
+
+static void test_spawn()
+{
+	ecs_t ecs;
+	ecs_cmd_buffer_t buf;
+	ecs_transform_t* transform;
+	ecs_physics_t* physics;
+	entity_id_t a, b;
+
+	ecs__construct(&ecs);
+	ecs_cmd_buffer__construct(&buf);
+
+	a = ecs_cmd_buffer__spawn(&buf);
+	b = ecs_cmd_buffer__spawn(&buf);
+	assert(a & ECS_CMD_PENDING_BIT);
+	assert(a != b);
+
+	transform = (ecs_transform_t*)ecs_cmd_buffer__add(&buf, a, ECS_COMPONENT_TYPE_TRANSFORM);
+	assert(transform->rot.w == 1.0f && transform->scale.y == 1.0f);
+	transform->pos.x = 5.0f;
+
+	/* Child refers to a parent that does not exist yet */
+	transform = (ecs_transform_t*)ecs_cmd_buffer__add(&buf, b, ECS_COMPONENT_TYPE_TRANSFORM);
+	transform->parent = a;
+
+	physics = (ecs_physics_t*)ecs_cmd_buffer__add(&buf, b, ECS_COMPONENT_TYPE_PHYSICS);
+	physics->mass = 2.0f;
+
+	/* Nothing changes until applied */
+	assert(ecs.next_free_id == 0);
+	assert(!ecs_cmd_buffer__is_empty(&buf));
+
+	ecs_cmd_buffer__apply(&buf, 1, &ecs);
+	assert(ecs_cmd_buffer__is_empty(&buf));
+	assert(ecs.next_free_id == 2);
+
+	assert(ecs__get_signature(&ecs, 0) == ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM));
+	assert(ecs_transform__get(&ecs, 0)->pos.x == 5.0f);
+	assert(ecs_transform__get(&ecs, 0)->parent == ECS_INVALID_ID);
+
+	assert(ecs_transform__get(&ecs, 1)->parent == 0);
+	assert(ecs_physics__get(&ecs, 1)->mass == 2.0f);
+	assert(ecs_physics__get(&ecs, 1)->base.entity == 1);
+
+	ecs_cmd_buffer__destruct(&buf);
+	ecs__destruct(&ecs);
+}
+
+static void test_remove_and_destroy()
+{
+	ecs_t ecs;
+	ecs_cmd_buffer_t buf;
+	entity_id_t a, b;
+
+	ecs__construct(&ecs);
+	ecs_cmd_buffer__construct(&buf);
+
+	a = ecs__alloc_entity(&ecs);
+	b = ecs__alloc_entity(&ecs);
+	ecs_transform__add(&ecs, a);
+	ecs_physics__add(&ecs, a);
+	ecs_transform__add(&ecs, b);
+
+	/* Commands for one component type keep their recorded order */
+	ecs_cmd_buffer__remove(&buf, a, ECS_COMPONENT_TYPE_PHYSICS);
+	ecs_cmd_buffer__add(&buf, a, ECS_COMPONENT_TYPE_PHYSICS);
+	ecs_cmd_buffer__add(&buf, b, ECS_COMPONENT_TYPE_PLAYER);
+	ecs_cmd_buffer__remove(&buf, b, ECS_COMPONENT_TYPE_PLAYER);
+	ecs_cmd_buffer__remove(&buf, a, ECS_COMPONENT_TYPE_TRANSFORM);
+
+	/* Destroys run after everything else */
+	ecs_cmd_buffer__destroy(&buf, b);
+	ecs_cmd_buffer__add(&buf, b, ECS_COMPONENT_TYPE_STATIC_MODEL);
+
+	ecs_cmd_buffer__apply(&buf, 1, &ecs);
+
+	assert(ecs__get_signature(&ecs, a) == ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS));
+	assert(ecs__get_signature(&ecs, b) == 0);
+	assert(ecs.next_free_id == 1);
+
+	ecs_cmd_buffer__destruct(&buf);
+	ecs__destruct(&ecs);
+}
+
+static void test_threads()
+{
+	const uint32_t count = 5000;
+	ecs_t ecs;
+	ecs_query_t* query;
+	spawn_data_t data;
+	float mass_sum = 0.0f;
+	uint32_t i;
+
+	ecs__construct(&ecs);
+
+	for (i = 0; i < count; ++i)
+	{
+		ecs_transform__add(&ecs, ecs__alloc_entity(&ecs));
+	}
+
+	data.ecs = &ecs;
+	data.first = 0;
+
+	/* Each worker records into its own buffer */
+	kk_job__parallel_for(g_jobs, count, 64, spawn_range, &data);
+	assert(ecs.next_free_id == count);
+
+	ecs__apply_commands(&ecs);
+
+	assert(ecs.next_free_id == count * 2);
+	assert(ecs.transform_comp.count == count / 2);
+	assert(ecs.physics_comp.count == count);
+
+	query = ecs__query(&ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS), 0);
+	assert(query->matches.count == count);
+
+	for (i = count; i < count * 2; ++i)
+	{
+		assert(ecs_physics__get(&ecs, i));
+		mass_sum += ecs_physics__get(&ecs, i)->mass;
+	}
+
+	assert(mass_sum == (float)(count * (count - 1) / 2));
+
+	for (i = 0; i < cnt_of_array(ecs.cmd_buffers); ++i)
+	{
+		assert(ecs_cmd_buffer__is_empty(&ecs.cmd_buffers[i]));
+	}
+
+	ecs__destruct(&ecs);
+}
+
+void ecs_cmd_buffer_tests()
+{
+	RUN_TEST_CASE(test_remove_and_destroy);
+	RUN_TEST_CASE(test_spawn);
+	RUN_TEST_CASE(test_threads);
+}
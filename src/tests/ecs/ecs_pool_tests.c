@@ -0,0 +1,88 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+
+#include "common.h"
+#include "ecs/ecs_pool.h"
+#include "tests/tests.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_construct()
+{
+	ecs_pool_t pool;
+	ecs_pool__construct(&pool, sizeof(uint32_t), 0);
+
+	assert(pool.num_chunks == 0);
+	assert(ecs_pool__get_capacity(&pool) == 0);
+	assert(ecs_pool__get_memory_usage(&pool) == 0);
+
+	ecs_pool__destruct(&pool);
+}
+
+static void test_reserve()
+{
+	ecs_pool_t pool;
+	ecs_pool__construct(&pool, sizeof(uint32_t), 0xFF);
+
+	ecs_pool__reserve(&pool, 1);
+	assert(pool.num_chunks == 1);
+	assert(ecs_pool__get_capacity(&pool) == ECS_POOL_CHUNK_SIZE);
+
+	/* New chunks are filled */
+	assert(*(uint32_t*)ecs_pool__get(&pool, 0) == 0xFFFFFFFF);
+	assert(*(uint32_t*)ecs_pool__get(&pool, ECS_POOL_CHUNK_SIZE - 1) == 0xFFFFFFFF);
+
+	/* Reserving less than the capacity does nothing */
+	ecs_pool__reserve(&pool, ECS_POOL_CHUNK_SIZE);
+	assert(pool.num_chunks == 1);
+
+	ecs_pool__reserve(&pool, ECS_POOL_CHUNK_SIZE + 1);
+	assert(pool.num_chunks == 2);
+
+	ecs_pool__destruct(&pool);
+}
+
+static void test_stable()
+{
+	ecs_pool_t pool;
+	uint32_t* first;
+	uint32_t i;
+
+	ecs_pool__construct(&pool, sizeof(uint32_t), 0);
+	ecs_pool__reserve(&pool, 1);
+
+	first = (uint32_t*)ecs_pool__get(&pool, 0);
+	*first = 42;
+
+	/* Grow past the initial chunk table size */
+	ecs_pool__reserve(&pool, ECS_POOL_CHUNK_SIZE * 20);
+	assert(pool.num_chunks == 20);
+
+	for (i = 1; i < ECS_POOL_CHUNK_SIZE * 20; ++i)
+	{
+		*(uint32_t*)ecs_pool__get(&pool, i) = i;
+	}
+
+	/* Existing elements do not move */
+	assert(ecs_pool__get(&pool, 0) == first);
+	assert(*first == 42);
+	assert(*(uint32_t*)ecs_pool__get(&pool, ECS_POOL_CHUNK_SIZE * 20 - 1) == ECS_POOL_CHUNK_SIZE * 20 - 1);
+
+	ecs_pool__destruct(&pool);
+}
+
+void ecs_pool_tests()
+{
+	RUN_TEST_CASE(test_construct);
+	RUN_TEST_CASE(test_reserve);
+	RUN_TEST_CASE(test_stable);
+}
@@ -0,0 +1,89 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/ecs_query.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+static const ecs_component_mask_t PHYSICS = ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS);
+static const ecs_component_mask_t PLAYER = ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PLAYER);
+static const ecs_component_mask_t TRANSFORM = ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM);
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_is_match()
+{
+	ecs_query_t query;
+	ecs_query__construct(&query, PHYSICS | TRANSFORM, PLAYER);
+
+	assert(ecs_query__is_match(&query, PHYSICS | TRANSFORM));
+	assert(!ecs_query__is_match(&query, PHYSICS));
+	assert(!ecs_query__is_match(&query, TRANSFORM));
+	assert(!ecs_query__is_match(&query, PHYSICS | TRANSFORM | PLAYER));
+	assert(!ecs_query__is_match(&query, 0));
+
+	ecs_query__destruct(&query);
+}
+
+static void test_update()
+{
+	ecs_query_t query;
+	ecs_query__construct(&query, PHYSICS | TRANSFORM, 0);
+
+	/* Entity gains components one at a time */
+	ecs_query__update(&query, 3, TRANSFORM);
+	assert(ecs_query__get_count(&query) == 0);
+
+	ecs_query__update(&query, 3, PHYSICS | TRANSFORM);
+	assert(ecs_query__get_count(&query) == 1);
+	assert(ecs_query__get_entity(&query, 0) == 3);
+
+	/* Updating with the same signature does not duplicate the match */
+	ecs_query__update(&query, 3, PHYSICS | TRANSFORM | PLAYER);
+	assert(ecs_query__get_count(&query) == 1);
+
+	ecs_query__update(&query, 5, PHYSICS | TRANSFORM);
+	assert(ecs_query__get_count(&query) == 2);
+
+	/* Losing a required component removes the match */
+	ecs_query__update(&query, 3, TRANSFORM);
+	assert(ecs_query__get_count(&query) == 1);
+	assert(ecs_query__get_entity(&query, 0) == 5);
+
+	ecs_query__destruct(&query);
+}
+
+static void test_get_single()
+{
+	ecs_query_t query;
+	ecs_query__construct(&query, PLAYER, 0);
+
+	assert(ecs_query__get_single(&query) == ECS_INVALID_ID);
+
+	ecs_query__update(&query, 0, PLAYER | TRANSFORM);
+	assert(ecs_query__get_single(&query) == 0);
+
+	ecs_query__destruct(&query);
+}
+
+void ecs_query_tests()
+{
+	RUN_TEST_CASE(test_is_match);
+	RUN_TEST_CASE(test_update);
+	RUN_TEST_CASE(test_get_single);
+}
@@ -0,0 +1,194 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+
+#include "common.h"
+#include "global.h"
+#include "ecs/ecs_scheduler.h"
+#include "platform/platform.h"
+#include "tests/tests.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define PHYSICS_BIT		ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS)
+#define TRANSFORM_BIT	ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_TRANSFORM)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	ecs_scheduler_t*		sched;
+	volatile int			done[ECS_SCHEDULER_MAX_SYSTEMS];
+
+} run_data_t;
+
+typedef struct
+{
+	run_data_t*				data;
+	uint32_t				index;
+
+} system_context_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+static double s_fake_time;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static double fake_get_time(platform_t* platform)
+{
+	/* Each call advances the clock by 1 ms */
+	s_fake_time += 0.001;
+	return s_fake_time;
+}
+
+static void empty_system(ecs_t* ecs, void* context)
+{
+}
+
+static void check_system(ecs_t* ecs, void* context)
+{
+	system_context_t* ctx = (system_context_t*)context;
+	uint32_t depends_on = ctx->data->sched->systems[ctx->index].depends_on;
+	uint32_t i;
+
+	/* Everything this system depends on has already finished */
+	for (i = 0; i < ECS_SCHEDULER_MAX_SYSTEMS; ++i)
+	{
+		if (depends_on & (1u << i))
+		{
+			assert(ctx->data->done[i]);
+		}
+	}
+
+	assert(!ctx->data->done[ctx->index]);
+	ctx->data->done[ctx->index] = 1;
+}
+
+static void test_stages()
+{
+	ecs_scheduler_t sched;
+	uint32_t a, b, c, d, e, f;
+
+	ecs_scheduler__construct(&sched);
+
+	a = ecs_scheduler__add(&sched, "a", empty_system, NULL, PHYSICS_BIT, 0, 0);
+	b = ecs_scheduler__add(&sched, "b", empty_system, NULL, PHYSICS_BIT, 0, 0);
+	c = ecs_scheduler__add(&sched, "c", empty_system, NULL, 0, PHYSICS_BIT, 0);
+	d = ecs_scheduler__add(&sched, "d", empty_system, NULL, 0, TRANSFORM_BIT, 0);
+	e = ecs_scheduler__add(&sched, "e", empty_system, NULL, PHYSICS_BIT | TRANSFORM_BIT, 0, 0);
+	f = ecs_scheduler__add(&sched, "f", empty_system, NULL, 0, 0, 0);
+
+	ecs_scheduler__add_dependency(&sched, f, d);
+
+	/* Only earlier systems can be depended on */
+	ecs_scheduler__add_dependency(&sched, d, f);
+	assert(sched.systems[d].after == 0);
+
+	ecs_scheduler__run(&sched, NULL);
+
+	/* Readers share a stage, a writer waits for them */
+	assert(sched.systems[a].stage == 0);
+	assert(sched.systems[b].stage == 0);
+	assert(sched.systems[c].stage == 1);
+	assert(sched.systems[c].depends_on == ((1u << a) | (1u << b)));
+
+	/* No shared components */
+	assert(sched.systems[d].stage == 0);
+
+	/* Waits for both writers */
+	assert(sched.systems[e].stage == 2);
+	assert(sched.systems[e].depends_on == ((1u << c) | (1u << d)));
+
+	/* Explicit dependency only */
+	assert(sched.systems[f].stage == 1);
+	assert(sched.systems[f].depends_on == (1u << d));
+
+	assert(sched.num_stages == 3);
+	assert(sched.num_runs == 1);
+
+	ecs_scheduler__dump(&sched);
+	ecs_scheduler__destruct(&sched);
+}
+
+static void test_run_order()
+{
+	const ecs_component_mask_t reads[] = { PHYSICS_BIT, PHYSICS_BIT, 0, TRANSFORM_BIT, 0, PHYSICS_BIT | TRANSFORM_BIT, 0, TRANSFORM_BIT };
+	const ecs_component_mask_t writes[] = { 0, 0, PHYSICS_BIT, 0, TRANSFORM_BIT, 0, 0, PHYSICS_BIT };
+	ecs_scheduler_t sched;
+	system_context_t ctx[cnt_of_array(reads)];
+	run_data_t data;
+	uint32_t i;
+	int run;
+
+	ecs_scheduler__construct(&sched);
+	clear_struct(&data);
+	data.sched = &sched;
+
+	for (i = 0; i < cnt_of_array(reads); ++i)
+	{
+		ctx[i].data = &data;
+		ctx[i].index = i;
+		ecs_scheduler__add(&sched, "check", check_system, &ctx[i], reads[i], writes[i], (i == 3) ? ECS_SYSTEM_FLAG_MAIN_THREAD : 0);
+	}
+
+	ecs_scheduler__add_dependency(&sched, 6, 1);
+
+	/* The first run is serial, later runs use the job system */
+	for (run = 0; run < 50; ++run)
+	{
+		memset((void*)data.done, 0, sizeof(data.done));
+		ecs_scheduler__run(&sched, NULL);
+
+		for (i = 0; i < cnt_of_array(reads); ++i)
+		{
+			assert(data.done[i]);
+		}
+	}
+
+	ecs_scheduler__destruct(&sched);
+}
+
+static void test_timing()
+{
+	platform_t platform;
+	platform_t* prev_platform = g_platform;
+	ecs_scheduler_t sched;
+	uint32_t idx;
+
+	clear_struct(&platform);
+	platform.get_time = fake_get_time;
+	g_platform = &platform;
+	s_fake_time = 0.0;
+
+	ecs_scheduler__construct(&sched);
+	idx = ecs_scheduler__add(&sched, "timed", empty_system, NULL, 0, 0, 0);
+
+	/* Clock reads: frame start, system start, system end, frame end */
+	ecs_scheduler__run(&sched, NULL);
+	assert(fabsf(sched.systems[idx].start_ms - 1.0f) < 0.01f);
+	assert(fabsf(sched.systems[idx].time_ms - 1.0f) < 0.01f);
+	assert(fabsf(sched.systems[idx].avg_ms - 1.0f) < 0.01f);
+	assert(fabsf(sched.frame_ms - 3.0f) < 0.01f);
+
+	ecs_scheduler__destruct(&sched);
+	g_platform = prev_platform;
+}
+
+void ecs_scheduler_tests()
+{
+	RUN_TEST_CASE(test_run_order);
+	RUN_TEST_CASE(test_stages);
+	RUN_TEST_CASE(test_timing);
+}
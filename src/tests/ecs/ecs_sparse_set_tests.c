@@ -0,0 +1,157 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/ecs_component.h"
+#include "ecs/ecs_sparse_set.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	ecs_component_t		base;
+	int					value;
+
+} test_comp_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_construct()
+{
+	ecs_sparse_set_t set;
+	ecs_sparse_set__construct(&set, sizeof(test_comp_t));
+
+	assert(set.count == 0);
+	assert(set.elem_size == sizeof(test_comp_t));
+	assert(!ecs_sparse_set__has(&set, 0));
+	assert(!ecs_sparse_set__has(&set, 9));
+
+	ecs_sparse_set__destruct(&set);
+}
+
+static void test_add()
+{
+	ecs_sparse_set_t set;
+	ecs_sparse_set__construct(&set, sizeof(test_comp_t));
+
+	test_comp_t* comp = (test_comp_t*)ecs_sparse_set__add(&set, 5);
+	assert(comp != NULL);
+	assert(comp->base.entity == 5);
+	assert(comp->value == 0);
+	assert(set.count == 1);
+	assert(ecs_sparse_set__has(&set, 5));
+	assert(ecs_sparse_set__get(&set, 5) == comp);
+
+	/* Adding again reuses the slot */
+	comp->value = 3;
+	assert(ecs_sparse_set__add(&set, 5) == comp);
+	assert(comp->value == 0);
+	assert(set.count == 1);
+
+	/* Invalid entity id */
+	assert(ecs_sparse_set__add(&set, ECS_INVALID_ID) == NULL);
+	assert(set.count == 1);
+
+	ecs_sparse_set__destruct(&set);
+}
+
+static void test_get_at()
+{
+	ecs_sparse_set_t set;
+	ecs_sparse_set__construct(&set, sizeof(test_comp_t));
+
+	/* Dense slots are assigned in the order components are added */
+	ecs_sparse_set__add(&set, 8);
+	ecs_sparse_set__add(&set, 2);
+	ecs_sparse_set__add(&set, 4);
+
+	assert(((test_comp_t*)ecs_sparse_set__get_at(&set, 0))->base.entity == 8);
+	assert(((test_comp_t*)ecs_sparse_set__get_at(&set, 1))->base.entity == 2);
+	assert(((test_comp_t*)ecs_sparse_set__get_at(&set, 2))->base.entity == 4);
+
+	ecs_sparse_set__destruct(&set);
+}
+
+static void test_remove()
+{
+	ecs_sparse_set_t set;
+	ecs_sparse_set__construct(&set, sizeof(test_comp_t));
+
+	((test_comp_t*)ecs_sparse_set__add(&set, 1))->value = 10;
+	((test_comp_t*)ecs_sparse_set__add(&set, 3))->value = 30;
+	((test_comp_t*)ecs_sparse_set__add(&set, 7))->value = 70;
+
+	/* Remove from the middle, last component fills the hole */
+	ecs_sparse_set__remove(&set, 1);
+	assert(set.count == 2);
+	assert(!ecs_sparse_set__has(&set, 1));
+	assert(ecs_sparse_set__get(&set, 1) == NULL);
+	assert(((test_comp_t*)ecs_sparse_set__get_at(&set, 0))->base.entity == 7);
+	assert(((test_comp_t*)ecs_sparse_set__get(&set, 7))->value == 70);
+	assert(((test_comp_t*)ecs_sparse_set__get(&set, 3))->value == 30);
+
+	/* Remove the last component */
+	ecs_sparse_set__remove(&set, 3);
+	assert(set.count == 1);
+	assert(((test_comp_t*)ecs_sparse_set__get(&set, 7))->value == 70);
+
+	/* Removing a missing component does nothing */
+	ecs_sparse_set__remove(&set, 3);
+	assert(set.count == 1);
+
+	ecs_sparse_set__destruct(&set);
+}
+
+static void test_grow()
+{
+	ecs_sparse_set_t set;
+	test_comp_t* first;
+	uint32_t i;
+
+	ecs_sparse_set__construct(&set, sizeof(test_comp_t));
+
+	first = (test_comp_t*)ecs_sparse_set__add(&set, 0);
+	first->value = 1;
+
+	/* Fill several chunks with sparse entity ids */
+	for (i = 1; i < ECS_POOL_CHUNK_SIZE * 3; ++i)
+	{
+		((test_comp_t*)ecs_sparse_set__add(&set, i * 7))->value = (int)i;
+	}
+
+	assert(set.count == ECS_POOL_CHUNK_SIZE * 3);
+	assert(set.dense.num_chunks == 3);
+
+	/* Growing does not move existing components */
+	assert(ecs_sparse_set__get(&set, 0) == first);
+	assert(first->value == 1);
+	assert(((test_comp_t*)ecs_sparse_set__get(&set, 700))->value == 100);
+	assert(!ecs_sparse_set__has(&set, 701));
+	assert(!ecs_sparse_set__has(&set, 100000));
+
+	assert(ecs_sparse_set__get_memory_usage(&set) >= 3 * ECS_POOL_CHUNK_SIZE * sizeof(test_comp_t));
+
+	ecs_sparse_set__destruct(&set);
+}
+
+void ecs_sparse_set_tests()
+{
+	RUN_TEST_CASE(test_construct);
+	RUN_TEST_CASE(test_add);
+	RUN_TEST_CASE(test_get_at);
+	RUN_TEST_CASE(test_grow);
+	RUN_TEST_CASE(test_remove);
+}
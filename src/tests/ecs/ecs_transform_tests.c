@@ -0,0 +1,346 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_math.h"
+#include "tests/tests.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_update_matrix()
+{
+	ecs_transform_t transform;
+	kk_mat4_t expected;
+	kk_vec3_t axis;
+	float* a;
+	float* b;
+	int i;
+
+	clear_struct(&transform);
+	transform.pos.x = 1.0f;
+	transform.pos.y = -2.0f;
+	transform.pos.z = 3.0f;
+	transform.scale.x = 2.0f;
+	transform.scale.y = 0.5f;
+	transform.scale.z = 4.0f;
+
+	/* 90 degrees about an arbitrary axis */
+	axis.x = 1.0f;
+	axis.y = 2.0f;
+	axis.z = 3.0f;
+	glm_vec3_normalize((float*)&axis);
+	glm_quatv((float*)&transform.rot, kk_math_rad(90.0f), (float*)&axis);
+
+	transform.dirty = TRUE;
+	ecs_transform__update_matrix(&transform, NULL, 1.0f);
+	assert(!transform.dirty);
+
+	/* Same as building the matrix step by step */
+	glm_mat4_identity((vec4*)&expected);
+	glm_translate((vec4*)&expected, (float*)&transform.pos);
+	glm_scale((vec4*)&expected, (float*)&transform.scale);
+	glm_rotate((vec4*)&expected, kk_math_rad(90.0f), (float*)&axis);
+
+	a = (float*)&transform.world_matrix;
+	b = (float*)&expected;
+	for (i = 0; i < 16; ++i)
+	{
+		assert(fabsf(a[i] - b[i]) < 1e-5f);
+	}
+}
+
+static void test_hierarchy()
+{
+	ecs_t ecs;
+	ecs_transform_t* root;
+	ecs_transform_t* child;
+	ecs_transform_t* grandchild;
+	ecs_transform_t* other;
+
+	ecs__construct(&ecs);
+
+	/* Create the child before the parent so the order has to be sorted */
+	entity_id_t grandchild_ent = ecs__alloc_entity(&ecs);
+	entity_id_t child_ent = ecs__alloc_entity(&ecs);
+	entity_id_t root_ent = ecs__alloc_entity(&ecs);
+	entity_id_t other_ent = ecs__alloc_entity(&ecs);
+
+	grandchild = ecs_transform__add(&ecs, grandchild_ent);
+	child = ecs_transform__add(&ecs, child_ent);
+	root = ecs_transform__add(&ecs, root_ent);
+	other = ecs_transform__add(&ecs, other_ent);
+
+	grandchild->rot.w = child->rot.w = root->rot.w = other->rot.w = 1.0f;
+	grandchild->scale.x = grandchild->scale.y = grandchild->scale.z = 1.0f;
+	child->scale.x = child->scale.y = child->scale.z = 1.0f;
+	root->scale.x = root->scale.y = root->scale.z = 2.0f;
+	other->scale.x = other->scale.y = other->scale.z = 1.0f;
+
+	root->pos.x = 10.0f;
+	child->pos.x = 1.0f;
+	grandchild->pos.y = 1.0f;
+
+	assert(ecs_transform__set_parent(&ecs, child_ent, root_ent));
+	assert(ecs_transform__set_parent(&ecs, grandchild_ent, child_ent));
+
+	/* Cycles are rejected */
+	assert(!ecs_transform__set_parent(&ecs, root_ent, grandchild_ent));
+
+	transform_system__run(&ecs, 1.0f);
+
+	/* Parents are ordered before children */
+	assert(root->order_idx < child->order_idx);
+	assert(child->order_idx < grandchild->order_idx);
+	assert(grandchild->depth == 2);
+
+	/* Each subtree is a contiguous range */
+	assert(child->order_idx == root->order_idx + 1);
+	assert(ecs.transform_subtree_end.data[root->order_idx] == root->order_idx + 3);
+	assert(ecs.transform_subtree_end.data[grandchild->order_idx] == grandchild->order_idx + 1);
+
+	/* Child positions are scaled and offset by the root */
+	assert(child->world_matrix.w.x == 12.0f);
+	assert(grandchild->world_matrix.w.x == 12.0f);
+	assert(grandchild->world_matrix.w.y == 2.0f);
+
+	/* Moving the root updates the subtree only */
+	other->update_pass = 0;
+	root->pos.x = 20.0f;
+	ecs_transform__set_dirty(&ecs, root);
+	transform_system__run(&ecs, 1.0f);
+
+	assert(grandchild->world_matrix.w.x == 22.0f);
+	assert(grandchild->update_pass == ecs.transform_pass);
+	assert(other->update_pass == 0);
+
+	/* A dirty leaf does not touch its ancestors */
+	grandchild->pos.z = 1.0f;
+	ecs_transform__set_dirty(&ecs, grandchild);
+	transform_system__run(&ecs, 1.0f);
+
+	assert(grandchild->world_matrix.w.z == 2.0f);
+	assert(grandchild->update_pass == ecs.transform_pass);
+	assert(child->update_pass == ecs.transform_pass - 1);
+
+	/* Dirtiness can be pushed down before the pass, for systems that run first */
+	root->pos.x = 30.0f;
+	ecs_transform__set_dirty(&ecs, root);
+	transform_system__propagate_dirty(&ecs);
+	assert(child->dirty && grandchild->dirty);
+	assert(!other->dirty);
+	transform_system__run(&ecs, 1.0f);
+	assert(!child->dirty && !grandchild->dirty);
+	assert(grandchild->world_matrix.w.x == 32.0f);
+
+	/* Removing a parent detaches only its direct children */
+	ecs_transform__remove(&ecs, root_ent);
+	child = ecs_transform__get(&ecs, child_ent);
+	grandchild = ecs_transform__get(&ecs, grandchild_ent);
+	assert(child->parent == ECS_INVALID_ID);
+	assert(grandchild->parent == child_ent);
+	transform_system__run(&ecs, 1.0f);
+	assert(grandchild->world_matrix.w.x == 1.0f);
+
+	ecs_transform__remove(&ecs, child_ent);
+	grandchild = ecs_transform__get(&ecs, grandchild_ent);
+	assert(grandchild->parent == ECS_INVALID_ID);
+	transform_system__run(&ecs, 1.0f);
+	assert(grandchild->world_matrix.w.y == 1.0f);
+
+	ecs__destruct(&ecs);
+}
+
+static void test_remove_many()
+{
+	ecs_t ecs;
+	ecs_transform_t* transform;
+	entity_id_t ents[4];
+	int i;
+
+	ecs__construct(&ecs);
+
+	/* A chain ents[0] <- ents[1] <- ents[2] <- ents[3] */
+	for (i = 0; i < 4; ++i)
+	{
+		ents[i] = ecs__alloc_entity(&ecs);
+		transform = ecs_transform__add(&ecs, ents[i]);
+		transform->rot.w = 1.0f;
+		transform->scale.x = transform->scale.y = transform->scale.z = 1.0f;
+		if (i > 0)
+		{
+			assert(ecs_transform__set_parent(&ecs, ents[i], ents[i - 1]));
+		}
+	}
+
+	transform_system__run(&ecs, 1.0f);
+
+	/* Removals in a row keep finding children through the old ranges */
+	ecs_transform__remove(&ecs, ents[0]);
+	ecs_transform__remove(&ecs, ents[2]);
+	assert(ecs.transform_ranges_valid);
+
+	assert(ecs_transform__get(&ecs, ents[1])->parent == ECS_INVALID_ID);
+	assert(ecs_transform__get(&ecs, ents[3])->parent == ECS_INVALID_ID);
+
+	transform_system__run(&ecs, 1.0f);
+	assert(ecs.transform_order.count == 2);
+
+	/* Adding invalidates the ranges until the next pass */
+	ecs_transform__add(&ecs, ecs__alloc_entity(&ecs));
+	assert(!ecs.transform_ranges_valid);
+
+	ecs__destruct(&ecs);
+}
+
+static void test_interpolation()
+{
+	ecs_transform_t transform;
+
+	clear_struct(&transform);
+	transform.scale.x = transform.scale.y = transform.scale.z = 1.0f;
+	transform.rot.w = 1.0f;
+	transform.prev_rot.w = 1.0f;
+	transform.pos.x = 4.0f;
+	transform.prev_pos.x = 2.0f;
+
+	/* Previous pose is ignored unless interpolated */
+	ecs_transform__update_matrix(&transform, NULL, 0.5f);
+	assert(transform.world_matrix.w.x == 4.0f);
+
+	transform.interpolated = TRUE;
+	ecs_transform__update_matrix(&transform, NULL, 0.5f);
+	assert(transform.world_matrix.w.x == 3.0f);
+
+	ecs_transform__update_matrix(&transform, NULL, 0.0f);
+	assert(transform.world_matrix.w.x == 2.0f);
+
+	/* Half way through a quarter turn about y */
+	glm_quatv((float*)&transform.rot, kk_math_rad(90.0f), (float[3]){ 0.0f, 1.0f, 0.0f });
+	ecs_transform__update_matrix(&transform, NULL, 0.5f);
+	assert(fabsf(transform.world_matrix.x.x - cosf(kk_math_rad(45.0f))) < 1e-5f);
+}
+
+static void assert_near_box(kk_aabb_t* a, kk_aabb_t* b)
+{
+	float* x = (float*)a;
+	float* y = (float*)b;
+	int i;
+
+	for (i = 0; i < 6; ++i)
+	{
+		assert(fabsf(x[i] - y[i]) < 1e-4f);
+	}
+}
+
+static void test_world_bounds()
+{
+	ecs_t ecs;
+	ecs_transform_t* parent;
+	ecs_transform_t* child;
+	kk_aabb_t box;
+	kk_aabb_t world;
+	kk_aabb_t expected;
+	kk_sphere_t sphere;
+	kk_sphere_t world_sphere;
+	kk_mat4_t m;
+	kk_vec3_t axis;
+
+	ecs__construct(&ecs);
+
+	entity_id_t parent_ent = ecs__alloc_entity(&ecs);
+	entity_id_t child_ent = ecs__alloc_entity(&ecs);
+	parent = ecs_transform__add(&ecs, parent_ent);
+	child = ecs_transform__add(&ecs, child_ent);
+
+	box.min.x = -1.0f; box.max.x = 3.0f;
+	box.min.y = 0.0f; box.max.y = 2.0f;
+	box.min.z = -0.5f; box.max.z = 0.5f;
+	sphere.center.x = 1.0f;
+	sphere.center.y = 1.0f;
+	sphere.center.z = 0.0f;
+	sphere.radius = 2.5f;
+
+	axis.x = 1.0f;
+	axis.y = 2.0f;
+	axis.z = 3.0f;
+	glm_vec3_normalize((float*)&axis);
+	glm_quatv((float*)&child->rot, kk_math_rad(30.0f), (float*)&axis);
+	child->pos.x = 1.0f;
+	child->pos.y = -2.0f;
+	child->pos.z = 3.0f;
+	child->scale.x = 2.0f;
+	child->scale.y = 0.5f;
+	child->scale.z = 4.0f;
+
+	parent->pos.y = 5.0f;
+	parent->scale.x = parent->scale.y = parent->scale.z = 3.0f;
+	glm_quatv((float*)&parent->rot, kk_math_rad(90.0f), (float[3]){ 0.0f, 1.0f, 0.0f });
+
+	/* Matches transforming the box by the full matrix */
+	transform_system__run(&ecs, 1.0f);
+	ecs_transform__get_world_bounds(&ecs, child, 1.0f, &box, &sphere, &world, &world_sphere);
+	kk_math_aabb_transform(&box, &child->world_matrix, &expected);
+	assert_near_box(&world, &expected);
+
+	ecs_transform__get_local_matrix(child, 1.0f, &m);
+	kk_math_mat4_mulv3(&m, &sphere.center, 1.0f, &axis);
+	assert(fabsf(world_sphere.center.x - axis.x) < 1e-4f);
+	assert(fabsf(world_sphere.center.y - axis.y) < 1e-4f);
+	assert(fabsf(world_sphere.center.z - axis.z) < 1e-4f);
+	assert(fabsf(world_sphere.radius - 10.0f) < 1e-4f);
+
+	/* Parent space is applied on top, which may only loosen the box */
+	assert(ecs_transform__set_parent(&ecs, child_ent, parent_ent));
+	transform_system__run(&ecs, 1.0f);
+	ecs_transform__get_world_bounds(&ecs, child, 1.0f, &box, &sphere, &world, &world_sphere);
+	kk_math_aabb_transform(&box, &child->world_matrix, &expected);
+	assert(world.min.x <= expected.min.x + 1e-4f && world.max.x >= expected.max.x - 1e-4f);
+	assert(world.min.y <= expected.min.y + 1e-4f && world.max.y >= expected.max.y - 1e-4f);
+	assert(world.min.z <= expected.min.z + 1e-4f && world.max.z >= expected.max.z - 1e-4f);
+	kk_math_mat4_mulv3(&child->world_matrix, &sphere.center, 1.0f, &axis);
+	assert(fabsf(world_sphere.center.x - axis.x) < 1e-4f);
+	assert(fabsf(world_sphere.center.y - axis.y) < 1e-4f);
+	assert(fabsf(world_sphere.center.z - axis.z) < 1e-4f);
+	assert(fabsf(world_sphere.radius - 30.0f) < 1e-3f);
+
+	/* Moving the parent is seen before the transform pass runs */
+	parent->pos.y = 8.0f;
+	ecs_transform__set_dirty(&ecs, parent);
+	ecs_transform__get_world_bounds(&ecs, child, 1.0f, &box, &sphere, &world, &world_sphere);
+	transform_system__run(&ecs, 1.0f);
+	kk_math_mat4_mulv3(&child->world_matrix, &sphere.center, 1.0f, &axis);
+	assert(fabsf(world_sphere.center.y - axis.y) < 1e-4f);
+
+	/* So is the world matrix */
+	parent->pos.y = 9.0f;
+	ecs_transform__set_dirty(&ecs, parent);
+	ecs_transform__get_world_matrix(&ecs, child, &m);
+	transform_system__run(&ecs, 1.0f);
+	assert(fabsf(m.w.x - child->world_matrix.w.x) < 1e-4f);
+	assert(fabsf(m.w.y - child->world_matrix.w.y) < 1e-4f);
+	assert(fabsf(m.w.z - child->world_matrix.w.z) < 1e-4f);
+
+	ecs__destruct(&ecs);
+}
+
+void ecs_transform_tests()
+{
+	RUN_TEST_CASE(test_update_matrix);
+	RUN_TEST_CASE(test_hierarchy);
+	RUN_TEST_CASE(test_remove_many);
+	RUN_TEST_CASE(test_interpolation);
+	RUN_TEST_CASE(test_world_bounds);
+}
@@ -0,0 +1,370 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "common.h"
+#include "engine/kk_broadphase.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	uint32_t*				hits;
+
+} query_data_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void make_box(kk_aabb_t* box, float x, float y, float z, float half)
+{
+	box->min.x = x - half;
+	box->min.y = y - half;
+	box->min.z = z - half;
+	box->max.x = x + half;
+	box->max.y = y + half;
+	box->max.z = z + half;
+}
+
+static boolean count_hit(void* data, uint32_t proxy)
+{
+	query_data_t* d = (query_data_t*)data;
+	d->hits[proxy]++;
+	return TRUE;
+}
+
+static float count_ray_hit(void* data, uint32_t proxy, kk_ray_t* ray)
+{
+	count_hit(data, proxy);
+	return ray->max_t;
+}
+
+static float stop_ray(void* data, uint32_t proxy, kk_ray_t* ray)
+{
+	count_hit(data, proxy);
+	return -1.0f;
+}
+
+/**
+Checks the tree's structure and that the pairs match a brute force test of
+every proxy's fat box.
+*/
+static void validate(kk_broadphase_t* bp, uint32_t* proxies, boolean* alive, boolean* is_static, uint32_t count)
+{
+	kk_broadphase_node_t* nodes = bp->nodes.data;
+	uint32_t num_pairs = 0;
+	uint32_t num_leaves = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < bp->nodes.count; ++i)
+	{
+		kk_broadphase_node_t* node = &nodes[i];
+
+		if (node->height <= 0)
+		{
+			num_leaves += (node->height == 0);
+			continue;
+		}
+
+		/* Children point back and are enclosed */
+		assert(nodes[node->child1].parent == i);
+		assert(nodes[node->child2].parent == i);
+		assert(kk_math_aabb_contains(&node->box, &nodes[node->child1].box));
+		assert(kk_math_aabb_contains(&node->box, &nodes[node->child2].box));
+		assert(node->height == 1 + max(nodes[node->child1].height, nodes[node->child2].height));
+
+		/* Balanced */
+		assert(abs(nodes[node->child1].height - nodes[node->child2].height) <= 1);
+	}
+
+	assert(num_leaves == bp->num_proxies);
+
+	for (i = 0; i < count; ++i)
+	{
+		for (j = i + 1; j < count; ++j)
+		{
+			if (!alive[i] || !alive[j] || (is_static[i] && is_static[j]))
+			{
+				continue;
+			}
+
+			if (kk_math_aabb_overlaps(&nodes[proxies[i]].box, &nodes[proxies[j]].box))
+			{
+				/* User data is the index, so pairs are sorted the same way */
+				assert(num_pairs < bp->pairs.count);
+				assert(bp->pairs.data[num_pairs].a == i);
+				assert(bp->pairs.data[num_pairs].b == j);
+				num_pairs++;
+			}
+		}
+	}
+
+	assert(num_pairs == bp->pairs.count);
+}
+
+static void test_tree()
+{
+	const uint32_t count = 600;
+	kk_broadphase_t bp;
+	kk_aabb_t box;
+	uint32_t proxies[600];
+	boolean alive[600];
+	boolean is_static[600];
+	uint32_t i;
+	int frame;
+
+	srand(7);
+	kk_broadphase__construct(&bp);
+
+	for (i = 0; i < count; ++i)
+	{
+		make_box(&box, rand_range(-20.0f, 20.0f), rand_range(-20.0f, 20.0f), rand_range(-20.0f, 20.0f), rand_range(0.1f, 1.5f));
+		is_static[i] = (i % 3 != 0);
+		alive[i] = TRUE;
+		proxies[i] = kk_broadphase__add(&bp, &box, i, is_static[i]);
+		assert(kk_broadphase__get_user_data(&bp, proxies[i]) == i);
+		assert(kk_broadphase__is_static(&bp, proxies[i]) == is_static[i]);
+	}
+
+	kk_broadphase__update_pairs(&bp);
+	validate(&bp, proxies, alive, is_static, count);
+	assert(bp.pairs.count > 0);
+
+	/* Log2 of 600 is about 9 */
+	assert(kk_broadphase__get_height(&bp) < 20);
+
+	for (frame = 0; frame < 20; ++frame)
+	{
+		/* Move the dynamic proxies, some only slightly */
+		for (i = 0; i < count; i += 3)
+		{
+			float step = (frame % 2) ? 0.01f : rand_range(-2.0f, 2.0f);
+
+			if (!alive[i])
+			{
+				continue;
+			}
+
+			box = bp.nodes.data[proxies[i]].box;
+			box.min.x += KK_BROADPHASE_MARGIN + step;
+			box.max.x += -KK_BROADPHASE_MARGIN + step;
+			box.min.y += KK_BROADPHASE_MARGIN;
+			box.max.y -= KK_BROADPHASE_MARGIN;
+			box.min.z += KK_BROADPHASE_MARGIN;
+			box.max.z -= KK_BROADPHASE_MARGIN;
+			kk_broadphase__move(&bp, proxies[i], &box);
+		}
+
+		/* Remove and re-add a few */
+		i = (uint32_t)rand() % count;
+		if (alive[i])
+		{
+			kk_broadphase__remove(&bp, proxies[i]);
+			alive[i] = FALSE;
+		}
+		else
+		{
+			make_box(&box, 0.0f, 0.0f, 0.0f, 1.0f);
+			proxies[i] = kk_broadphase__add(&bp, &box, i, is_static[i]);
+			alive[i] = TRUE;
+		}
+
+		/* Switch one between static and dynamic */
+		i = (uint32_t)rand() % count;
+		if (alive[i])
+		{
+			is_static[i] = !is_static[i];
+			kk_broadphase__set_static(&bp, proxies[i], is_static[i]);
+			assert(kk_broadphase__is_static(&bp, proxies[i]) == is_static[i]);
+		}
+
+		kk_broadphase__update_pairs(&bp);
+		validate(&bp, proxies, alive, is_static, count);
+	}
+
+	kk_broadphase__destruct(&bp);
+}
+
+static void test_query()
+{
+	kk_broadphase_t bp;
+	kk_aabb_t box;
+	query_data_t data;
+	uint32_t hits[8] = { 0 };
+	uint32_t a, b, c;
+
+	kk_broadphase__construct(&bp);
+
+	make_box(&box, 0.0f, 0.0f, 0.0f, 1.0f);
+	a = kk_broadphase__add(&bp, &box, 10, TRUE);
+	make_box(&box, 5.0f, 0.0f, 0.0f, 1.0f);
+	b = kk_broadphase__add(&bp, &box, 11, TRUE);
+	make_box(&box, 0.0f, 1.5f, 0.0f, 1.0f);
+	c = kk_broadphase__add(&bp, &box, 12, FALSE);
+
+	data.hits = hits;
+	make_box(&box, 0.0f, -1.0f, 0.0f, 0.2f);
+	kk_broadphase__query(&bp, &box, count_hit, &data);
+	assert(hits[a] == 1 && hits[b] == 0 && hits[c] == 0);
+
+	/* Only the dynamic proxy makes pairs */
+	kk_broadphase__update_pairs(&bp);
+	assert(bp.pairs.count == 1);
+	assert(bp.pairs.data[0].a == 10 && bp.pairs.data[0].b == 12);
+
+	/* Small moves stay inside the fat box */
+	make_box(&box, 0.0f, 1.55f, 0.0f, 1.0f);
+	assert(!kk_broadphase__move(&bp, c, &box));
+	make_box(&box, 5.0f, 1.5f, 0.0f, 1.0f);
+	assert(kk_broadphase__move(&bp, c, &box));
+
+	kk_broadphase__update_pairs(&bp);
+	assert(bp.pairs.count == 1);
+	assert(bp.pairs.data[0].a == 11 && bp.pairs.data[0].b == 12);
+
+	kk_broadphase__destruct(&bp);
+}
+
+static void test_raycast()
+{
+	kk_broadphase_t bp;
+	kk_aabb_t box;
+	kk_ray_t ray;
+	query_data_t data;
+	uint32_t hits[8] = { 0 };
+	uint32_t proxies[3];
+	uint32_t i;
+
+	kk_broadphase__construct(&bp);
+
+	for (i = 0; i < 3; ++i)
+	{
+		make_box(&box, 5.0f * (float)i, 0.0f, 0.0f, 1.0f);
+		proxies[i] = kk_broadphase__add(&bp, &box, i, TRUE);
+	}
+
+	data.hits = hits;
+	ray.origin.x = -5.0f;
+	ray.origin.y = 0.5f;
+	ray.origin.z = 0.0f;
+	ray.dir.x = 1.0f;
+	ray.dir.y = 0.0f;
+	ray.dir.z = 0.0f;
+	ray.max_t = 100.0f;
+	kk_broadphase__raycast(&bp, &ray, count_ray_hit, &data);
+
+	for (i = 0; i < 3; ++i)
+	{
+		assert(hits[proxies[i]] == 1);
+		hits[proxies[i]] = 0;
+	}
+
+	/* Too short to reach past the first box */
+	ray.max_t = 8.0f;
+	kk_broadphase__raycast(&bp, &ray, count_ray_hit, &data);
+	assert(hits[proxies[0]] == 1 && hits[proxies[1]] == 0 && hits[proxies[2]] == 0);
+	hits[proxies[0]] = 0;
+
+	/* Stopped after the first proxy */
+	ray.max_t = 100.0f;
+	kk_broadphase__raycast(&bp, &ray, stop_ray, &data);
+	assert(hits[proxies[0]] + hits[proxies[1]] + hits[proxies[2]] == 1);
+	hits[proxies[0]] = hits[proxies[1]] = hits[proxies[2]] = 0;
+
+	/* Passes above them */
+	ray.origin.y = 2.0f;
+	kk_broadphase__raycast(&bp, &ray, count_ray_hit, &data);
+	assert(hits[proxies[0]] + hits[proxies[1]] + hits[proxies[2]] == 0);
+
+	kk_broadphase__destruct(&bp);
+}
+
+static void test_benchmark()
+{
+	const uint32_t num_static = 5000;
+	const uint32_t num_dynamic = 500;
+	const uint32_t frames = 100;
+	kk_broadphase_t bp;
+	kk_aabb_t box;
+	uint32_t* proxies;
+	float* pos;
+	double start, build_ms, move_ms = 0.0, pairs_ms = 0.0;
+	uint32_t total_pairs = 0;
+	uint32_t i, frame;
+
+	srand(11);
+	kk_broadphase__construct(&bp);
+	proxies = (uint32_t*)malloc(sizeof(uint32_t) * num_dynamic);
+	pos = (float*)malloc(sizeof(float) * 3 * num_dynamic);
+
+	/* Static colliders scattered over a 200 x 200 area, like world props */
+	start = get_time_ms();
+	for (i = 0; i < num_static; ++i)
+	{
+		make_box(&box, rand_range(-100.0f, 100.0f), rand_range(0.0f, 4.0f), rand_range(-100.0f, 100.0f), rand_range(0.5f, 2.0f));
+		kk_broadphase__add(&bp, &box, i, TRUE);
+	}
+	build_ms = get_time_ms() - start;
+
+	for (i = 0; i < num_dynamic; ++i)
+	{
+		pos[i * 3 + 0] = rand_range(-100.0f, 100.0f);
+		pos[i * 3 + 1] = rand_range(0.0f, 4.0f);
+		pos[i * 3 + 2] = rand_range(-100.0f, 100.0f);
+		make_box(&box, pos[i * 3 + 0], pos[i * 3 + 1], pos[i * 3 + 2], 0.5f);
+		proxies[i] = kk_broadphase__add(&bp, &box, num_static + i, FALSE);
+	}
+
+	for (frame = 0; frame < frames; ++frame)
+	{
+		/* Each body moves a little every frame */
+		start = get_time_ms();
+		for (i = 0; i < num_dynamic; ++i)
+		{
+			pos[i * 3 + 0] += 0.05f;
+			make_box(&box, pos[i * 3 + 0], pos[i * 3 + 1], pos[i * 3 + 2], 0.5f);
+			kk_broadphase__move(&bp, proxies[i], &box);
+		}
+		move_ms += get_time_ms() - start;
+
+		start = get_time_ms();
+		kk_broadphase__update_pairs(&bp);
+		pairs_ms += get_time_ms() - start;
+
+		total_pairs += bp.pairs.count;
+	}
+
+	printf("\t\t%u static, %u dynamic, height %d: build %.2f ms, move %.3f ms/frame, pairs %.3f ms/frame, %u pairs/frame, %.0f pairs/ms, %u reinserts\n",
+		num_static,
+		num_dynamic,
+		kk_broadphase__get_height(&bp),
+		build_ms,
+		move_ms / frames,
+		pairs_ms / frames,
+		total_pairs / frames,
+		(double)total_pairs / max(pairs_ms, 0.001),
+		bp.num_reinserts);
+
+	free(pos);
+	free(proxies);
+	kk_broadphase__destruct(&bp);
+}
+
+void kk_broadphase_tests()
+{
+	RUN_TEST_CASE(test_query);
+	RUN_TEST_CASE(test_raycast);
+	RUN_TEST_CASE(test_tree);
+	RUN_TEST_CASE(test_benchmark);
+}
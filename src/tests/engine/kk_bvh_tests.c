@@ -0,0 +1,552 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "engine/kk_bvh.h"
+#include "engine/kk_math.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_static_model.h"
+#include "tests/tests.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define NUM_TRIANGLES	(500)
+#define NUM_RAYS		(1000)
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+static const uint32_t s_cube_indices[36] =
+{
+	0, 2, 1,	1, 2, 3,	/* -z */
+	4, 5, 6,	5, 7, 6,	/* +z */
+	0, 1, 4,	1, 5, 4,	/* -y */
+	2, 6, 3,	3, 6, 7,	/* +y */
+	0, 4, 2,	2, 4, 6,	/* -x */
+	1, 3, 5,	3, 7, 5,	/* +x */
+};
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void make_identity(kk_mat4_t* m)
+{
+	clear_struct(m);
+	m->x.x = m->y.y = m->z.z = m->w.w = 1.0f;
+}
+
+/**
+Makes a random soup of small triangles in a 20 unit cube.
+*/
+static void make_soup(float* positions, uint32_t* indices)
+{
+	uint32_t i;
+	float cx, cy, cz;
+
+	for (i = 0; i < NUM_TRIANGLES * 3; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			cx = rand_range(-10.0f, 10.0f);
+			cy = rand_range(-10.0f, 10.0f);
+			cz = rand_range(-10.0f, 10.0f);
+		}
+
+		positions[i * 3 + 0] = cx + rand_range(-1.0f, 1.0f);
+		positions[i * 3 + 1] = cy + rand_range(-1.0f, 1.0f);
+		positions[i * 3 + 2] = cz + rand_range(-1.0f, 1.0f);
+		indices[i] = i;
+	}
+}
+
+/**
+Builds a tree over one triangle, which is a single leaf. Used as the brute
+force reference.
+*/
+static void make_single(kk_bvh_t* bvh, float* positions, uint32_t tri)
+{
+	uint32_t indices[3] = { tri * 3 + 0, tri * 3 + 1, tri * 3 + 2 };
+	kk_bvh__construct(bvh, positions, indices, 1);
+	assert(bvh->nodes.count == 1 && bvh->nodes.data[0].count == 1);
+}
+
+/**
+Makes a model with a unit cube mesh scaled by half extents.
+*/
+static void make_cube_model(gpu_static_model_t* model, float hx, float hy, float hz)
+{
+	float positions[8 * 3];
+	int i;
+
+	clear_struct(model);
+
+	for (i = 0; i < 8; ++i)
+	{
+		positions[i * 3 + 0] = (i & 1) ? hx : -hx;
+		positions[i * 3 + 1] = (i & 2) ? hy : -hy;
+		positions[i * 3 + 2] = (i & 4) ? hz : -hz;
+	}
+
+	kk_bvh__construct(&model->bvh, positions, s_cube_indices, 12);
+	kk_shape__construct_from_points(&model->shape, positions, 8);
+
+	model->bounds.min.x = -hx; model->bounds.max.x = hx;
+	model->bounds.min.y = -hy; model->bounds.max.y = hy;
+	model->bounds.min.z = -hz; model->bounds.max.z = hz;
+}
+
+static entity_id_t make_entity(ecs_t* ecs, gpu_static_model_t* model, float x, float y, float z, float scale)
+{
+	entity_id_t ent = ecs__alloc_entity(ecs);
+	ecs_transform_t* transform = ecs_transform__add(ecs, ent);
+
+	transform->pos.x = x;
+	transform->pos.y = y;
+	transform->pos.z = z;
+	transform->rot.w = 1.0f;
+	transform->scale.x = transform->scale.y = transform->scale.z = scale;
+
+	ecs_static_model__add(ecs, ent)->model = model;
+	return ent;
+}
+
+static void test_raycast()
+{
+	float* positions = (float*)malloc(sizeof(float) * 9 * NUM_TRIANGLES);
+	uint32_t* indices = (uint32_t*)malloc(sizeof(uint32_t) * 3 * NUM_TRIANGLES);
+	kk_bvh_t* singles = (kk_bvh_t*)malloc(sizeof(kk_bvh_t) * NUM_TRIANGLES);
+	kk_bvh_t bvh;
+	kk_bvh_hit_t hit;
+	kk_bvh_hit_t single_hit;
+	kk_ray_t ray;
+	boolean expected;
+	float best_t;
+	uint32_t i;
+	uint32_t j;
+
+	srand(3);
+	make_soup(positions, indices);
+	kk_bvh__construct(&bvh, positions, indices, NUM_TRIANGLES);
+	assert(bvh.triangles.count == NUM_TRIANGLES);
+
+	for (i = 0; i < NUM_TRIANGLES; ++i)
+	{
+		make_single(&singles[i], positions, i);
+	}
+
+	/* Every leaf is small and the tree covers every triangle once */
+	for (i = 0; i < bvh.nodes.count; ++i)
+	{
+		assert(bvh.nodes.data[i].count <= KK_BVH_LEAF_SIZE);
+	}
+
+	for (i = 0; i < NUM_RAYS; ++i)
+	{
+		ray.origin.x = rand_range(-15.0f, 15.0f);
+		ray.origin.y = rand_range(-15.0f, 15.0f);
+		ray.origin.z = rand_range(-15.0f, 15.0f);
+		ray.dir.x = rand_range(-1.0f, 1.0f);
+		ray.dir.y = rand_range(-1.0f, 1.0f);
+		ray.dir.z = rand_range(-1.0f, 1.0f);
+		kk_math_vec3_normalize(&ray.dir);
+		ray.max_t = rand_range(5.0f, 40.0f);
+
+		/* Closest hit over every triangle */
+		expected = FALSE;
+		best_t = ray.max_t;
+		for (j = 0; j < NUM_TRIANGLES; ++j)
+		{
+			if (kk_bvh__raycast(&singles[j], &ray, &single_hit) && single_hit.t <= best_t)
+			{
+				expected = TRUE;
+				best_t = single_hit.t;
+			}
+		}
+
+		assert(kk_bvh__raycast(&bvh, &ray, &hit) == expected);
+		if (expected)
+		{
+			assert(fabsf(hit.t - best_t) < 1e-4f);
+			assert(fabsf(kk_math_vec3_norm(&hit.normal) - 1.0f) < 1e-4f);
+			assert(kk_math_vec3_dot(&hit.normal, &ray.dir) <= 0.0f);
+		}
+	}
+
+	for (i = 0; i < NUM_TRIANGLES; ++i)
+	{
+		kk_bvh__destruct(&singles[i]);
+	}
+
+	kk_bvh__destruct(&bvh);
+	free(singles);
+	free(indices);
+	free(positions);
+}
+
+static void test_overlap()
+{
+	float* positions = (float*)malloc(sizeof(float) * 9 * NUM_TRIANGLES);
+	uint32_t* indices = (uint32_t*)malloc(sizeof(uint32_t) * 3 * NUM_TRIANGLES);
+	kk_bvh_t* singles = (kk_bvh_t*)malloc(sizeof(kk_bvh_t) * NUM_TRIANGLES);
+	kk_bvh_t bvh;
+	kk_mat4_t m;
+	kk_aabb_t box;
+	kk_vec3_t center;
+	float radius;
+	boolean expected;
+	uint32_t i;
+	uint32_t j;
+
+	srand(5);
+	make_soup(positions, indices);
+	kk_bvh__construct(&bvh, positions, indices, NUM_TRIANGLES);
+
+	for (i = 0; i < NUM_TRIANGLES; ++i)
+	{
+		make_single(&singles[i], positions, i);
+	}
+
+	/* Placed somewhere else, rotated 90 degrees about y and scaled */
+	clear_struct(&m);
+	m.x.z = -2.0f;
+	m.y.y = 2.0f;
+	m.z.x = 2.0f;
+	m.w.x = 5.0f;
+	m.w.y = -3.0f;
+	m.w.w = 1.0f;
+
+	for (i = 0; i < NUM_RAYS; ++i)
+	{
+		center.x = rand_range(-20.0f, 25.0f);
+		center.y = rand_range(-25.0f, 20.0f);
+		center.z = rand_range(-20.0f, 20.0f);
+		radius = rand_range(0.1f, 2.0f);
+
+		expected = FALSE;
+		for (j = 0; j < NUM_TRIANGLES && !expected; ++j)
+		{
+			expected = kk_bvh__overlap_sphere(&singles[j], &m, &center, radius);
+		}
+
+		assert(kk_bvh__overlap_sphere(&bvh, &m, &center, radius) == expected);
+
+		box.min.x = center.x - radius;
+		box.min.y = center.y - 0.5f * radius;
+		box.min.z = center.z - 2.0f * radius;
+		box.max.x = center.x + radius;
+		box.max.y = center.y + 0.5f * radius;
+		box.max.z = center.z + 2.0f * radius;
+
+		expected = FALSE;
+		for (j = 0; j < NUM_TRIANGLES && !expected; ++j)
+		{
+			expected = kk_bvh__overlap_aabb(&singles[j], &m, &box);
+		}
+
+		assert(kk_bvh__overlap_aabb(&bvh, &m, &box) == expected);
+	}
+
+	for (i = 0; i < NUM_TRIANGLES; ++i)
+	{
+		kk_bvh__destruct(&singles[i]);
+	}
+
+	kk_bvh__destruct(&bvh);
+	free(singles);
+	free(indices);
+	free(positions);
+}
+
+static void test_primitives()
+{
+	float positions[3 * 3] =
+	{
+		0.0f, 0.0f, 0.0f,
+		2.0f, 0.0f, 0.0f,
+		0.0f, 2.0f, 0.0f,
+	};
+	uint32_t indices[3] = { 0, 1, 2 };
+	kk_bvh_t bvh;
+	kk_bvh_hit_t hit;
+	kk_mat4_t m;
+	kk_aabb_t box;
+	kk_vec3_t center;
+	kk_ray_t ray;
+
+	make_identity(&m);
+	kk_bvh__construct(&bvh, positions, indices, 1);
+
+	/* Hit from behind, the normal faces the ray */
+	ray.origin.x = 0.5f;
+	ray.origin.y = 0.5f;
+	ray.origin.z = -3.0f;
+	ray.dir.x = 0.0f;
+	ray.dir.y = 0.0f;
+	ray.dir.z = 1.0f;
+	ray.max_t = 10.0f;
+	assert(kk_bvh__raycast(&bvh, &ray, &hit));
+	assert(fabsf(hit.t - 3.0f) < 1e-5f);
+	assert(hit.normal.z == -1.0f);
+
+	/* Too short */
+	ray.max_t = 2.9f;
+	assert(!kk_bvh__raycast(&bvh, &ray, &hit));
+
+	/* Past the hypotenuse */
+	ray.origin.x = 1.2f;
+	ray.origin.y = 1.2f;
+	ray.max_t = 10.0f;
+	assert(!kk_bvh__raycast(&bvh, &ray, &hit));
+
+	/* Sphere near the hypotenuse, closest to the edge rather than the face */
+	center.x = 1.5f;
+	center.y = 1.5f;
+	center.z = 0.0f;
+	assert(!kk_bvh__overlap_sphere(&bvh, &m, &center, 0.7f));
+	assert(kk_bvh__overlap_sphere(&bvh, &m, &center, 0.75f));
+
+	/* Box inside the triangle's bounds but past the hypotenuse, only the edge axes separate it */
+	box.min.x = 1.3f;
+	box.min.y = 1.3f;
+	box.min.z = -0.1f;
+	box.max.x = 1.9f;
+	box.max.y = 1.9f;
+	box.max.z = 0.1f;
+	assert(!kk_bvh__overlap_aabb(&bvh, &m, &box));
+
+	box.min.x = 0.9f;
+	box.min.y = 0.9f;
+	assert(kk_bvh__overlap_aabb(&bvh, &m, &box));
+
+	/* Box beside the plane */
+	box.min.x = 0.1f;
+	box.min.y = 0.1f;
+	box.min.z = 0.05f;
+	box.max.x = 0.5f;
+	box.max.y = 0.5f;
+	box.max.z = 0.5f;
+	assert(!kk_bvh__overlap_aabb(&bvh, &m, &box));
+
+	kk_bvh__destruct(&bvh);
+
+	/* No triangles */
+	kk_bvh__construct(&bvh, positions, indices, 0);
+	assert(!kk_bvh__raycast(&bvh, &ray, &hit));
+	assert(!kk_bvh__overlap_sphere(&bvh, &m, &center, 100.0f));
+	kk_bvh__destruct(&bvh);
+}
+
+static void test_world_queries()
+{
+	ecs_t ecs;
+	collision_system_t cs;
+	gpu_static_model_t cube;
+	gpu_static_model_t wall;
+	collision_system_hit_t hit;
+	collision_system_hit_t hits[64];
+	utl_array_t(uint32_t) found;
+	kk_ray_t rays[64];
+	entity_id_t near_cube;
+	entity_id_t far_cube;
+	entity_id_t big_cube;
+	entity_id_t wall_ent;
+	kk_vec3_t center;
+	kk_aabb_t box;
+	uint32_t i;
+
+	ecs__construct(&ecs);
+	collision_system__construct(&cs);
+	utl_array_init(&found);
+	make_cube_model(&cube, 0.5f, 0.5f, 0.5f);
+	make_cube_model(&wall, 0.1f, 5.0f, 5.0f);
+
+	near_cube = make_entity(&ecs, &cube, 3.0f, 0.0f, 0.0f, 1.0f);
+	far_cube = make_entity(&ecs, &cube, 6.0f, 0.0f, 0.0f, 1.0f);
+	big_cube = make_entity(&ecs, &cube, 0.0f, 10.0f, 0.0f, 4.0f);
+	wall_ent = make_entity(&ecs, &wall, -5.0f, 0.0f, 0.0f, 1.0f);
+	collision_system__run(&cs, &ecs);
+
+	/* The nearest cube along +x */
+	rays[0].origin.x = 0.0f;
+	rays[0].origin.y = 0.2f;
+	rays[0].origin.z = 0.0f;
+	rays[0].dir.x = 1.0f;
+	rays[0].dir.y = 0.0f;
+	rays[0].dir.z = 0.0f;
+	rays[0].max_t = 100.0f;
+	assert(collision_system__raycast(&cs, &ecs, &rays[0], &hit));
+	assert(hit.entity == near_cube);
+	assert(fabsf(hit.t - 2.5f) < 1e-4f);
+	assert(fabsf(hit.point.x - 2.5f) < 1e-4f && fabsf(hit.point.y - 0.2f) < 1e-4f);
+	assert(fabsf(hit.normal.x + 1.0f) < 1e-4f);
+
+	/* Scaled cube from below, the normal is still a unit vector */
+	rays[1].origin.x = 1.5f;
+	rays[1].origin.y = 0.0f;
+	rays[1].origin.z = 0.0f;
+	rays[1].dir.x = 0.0f;
+	rays[1].dir.y = 1.0f;
+	rays[1].dir.z = 0.0f;
+	rays[1].max_t = 100.0f;
+	assert(collision_system__raycast(&cs, &ecs, &rays[1], &hit));
+	assert(hit.entity == big_cube);
+	assert(fabsf(hit.t - 8.0f) < 1e-4f);
+	assert(fabsf(hit.normal.y + 1.0f) < 1e-4f);
+
+	/* Misses, and too short to reach */
+	rays[2] = rays[0];
+	rays[2].origin.z = 3.0f;
+	assert(!collision_system__raycast(&cs, &ecs, &rays[2], &hit));
+	assert(hit.entity == ECS_INVALID_ID);
+
+	rays[3] = rays[0];
+	rays[3].max_t = 2.0f;
+	assert(!collision_system__raycast(&cs, &ecs, &rays[3], &hit));
+
+	/* Moving the near cube out of the way is seen after the next update */
+	ecs_transform__get(&ecs, near_cube)->pos.z = 5.0f;
+	ecs_transform__set_dirty(&ecs, ecs_transform__get(&ecs, near_cube));
+	collision_system__run(&cs, &ecs);
+	assert(collision_system__raycast(&cs, &ecs, &rays[0], &hit));
+	assert(hit.entity == far_cube);
+
+	/* Batches match single rays */
+	for (i = 4; i < 64; ++i)
+	{
+		rays[i].origin.x = rand_range(-2.0f, 2.0f);
+		rays[i].origin.y = rand_range(-2.0f, 2.0f);
+		rays[i].origin.z = rand_range(-2.0f, 2.0f);
+		rays[i].dir.x = rand_range(-1.0f, 1.0f);
+		rays[i].dir.y = rand_range(-1.0f, 1.0f);
+		rays[i].dir.z = rand_range(-1.0f, 1.0f);
+		kk_math_vec3_normalize(&rays[i].dir);
+		rays[i].max_t = 50.0f;
+	}
+
+	collision_system__raycast_batch(&cs, &ecs, rays, 64, hits);
+	for (i = 0; i < 64; ++i)
+	{
+		collision_system__raycast(&cs, &ecs, &rays[i], &hit);
+		assert(hits[i].entity == hit.entity);
+		assert(hits[i].entity == ECS_INVALID_ID || hits[i].t == hit.t);
+	}
+
+	/* Overlaps test the triangles, not just the bounds */
+	center.x = -5.0f;
+	center.y = 4.0f;
+	center.z = 0.0f;
+	collision_system__overlap_sphere(&cs, &ecs, &center, 0.5f, &found);
+	assert(found.count == 1 && found.data[0] == wall_ent);
+
+	center.x = 6.6f;
+	center.y = 0.6f;
+	center.z = 0.6f;
+	collision_system__overlap_sphere(&cs, &ecs, &center, 0.15f, &found);
+	assert(found.count == 0);
+	collision_system__overlap_sphere(&cs, &ecs, &center, 0.2f, &found);
+	assert(found.count == 1 && found.data[0] == far_cube);
+
+	box.min.x = -5.0f;
+	box.min.y = -1.0f;
+	box.min.z = -1.0f;
+	box.max.x = 6.0f;
+	box.max.y = 1.0f;
+	box.max.z = 1.0f;
+	collision_system__overlap_aabb(&cs, &ecs, &box, &found);
+	assert(found.count == 2);
+	assert((found.data[0] == wall_ent && found.data[1] == far_cube) || (found.data[0] == far_cube && found.data[1] == wall_ent));
+
+	utl_array_destroy(&found);
+	kk_shape__destruct(&wall.shape);
+	kk_bvh__destruct(&wall.bvh);
+	kk_shape__destruct(&cube.shape);
+	kk_bvh__destruct(&cube.bvh);
+	collision_system__destruct(&cs);
+	ecs__destruct(&ecs);
+}
+
+static void test_benchmark()
+{
+	const uint32_t num_triangles = 50000;
+	const uint32_t num_rays = 10000;
+	float* positions = (float*)malloc(sizeof(float) * 9 * num_triangles);
+	uint32_t* indices = (uint32_t*)malloc(sizeof(uint32_t) * 3 * num_triangles);
+	kk_bvh_t bvh;
+	kk_bvh_hit_t hit;
+	kk_ray_t ray;
+	uint32_t num_hits = 0;
+	double build_ms;
+	double ray_ms;
+	double start;
+	uint32_t i;
+
+	/* Terrain-like grid of triangles with some height noise */
+	srand(7);
+	for (i = 0; i < num_triangles * 3; ++i)
+	{
+		uint32_t cell = i / 3;
+		float x = (float)(cell % 250) * 0.4f;
+		float z = (float)(cell / 250) * 0.4f;
+
+		positions[i * 3 + 0] = x + ((i % 3 == 1) ? 0.4f : 0.0f);
+		positions[i * 3 + 1] = rand_range(0.0f, 0.3f);
+		positions[i * 3 + 2] = z + ((i % 3 == 2) ? 0.4f : 0.0f);
+		indices[i] = i;
+	}
+
+	start = get_time_ms();
+	kk_bvh__construct(&bvh, positions, indices, num_triangles);
+	build_ms = get_time_ms() - start;
+
+	start = get_time_ms();
+	for (i = 0; i < num_rays; ++i)
+	{
+		ray.origin.x = rand_range(0.0f, 100.0f);
+		ray.origin.y = 10.0f;
+		ray.origin.z = rand_range(0.0f, 80.0f);
+		ray.dir.x = rand_range(-0.5f, 0.5f);
+		ray.dir.y = -1.0f;
+		ray.dir.z = rand_range(-0.5f, 0.5f);
+		kk_math_vec3_normalize(&ray.dir);
+		ray.max_t = 100.0f;
+
+		num_hits += kk_bvh__raycast(&bvh, &ray, &hit);
+	}
+	ray_ms = get_time_ms() - start;
+
+	printf("\t\t%u triangles, %u nodes: build %.2f ms, %u rays in %.2f ms, %.0f rays/ms, %u hits\n",
+		num_triangles,
+		bvh.nodes.count,
+		build_ms,
+		num_rays,
+		ray_ms,
+		(double)num_rays / max(ray_ms, 0.001),
+		num_hits);
+
+	kk_bvh__destruct(&bvh);
+	free(indices);
+	free(positions);
+}
+
+void kk_bvh_tests()
+{
+	RUN_TEST_CASE(test_primitives);
+	RUN_TEST_CASE(test_raycast);
+	RUN_TEST_CASE(test_overlap);
+	RUN_TEST_CASE(test_world_queries);
+	RUN_TEST_CASE(test_benchmark);
+}
@@ -0,0 +1,128 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "common.h"
+#include "engine/kk_camera.h"
+#include "engine/kk_frustum.h"
+#include "engine/kk_math.h"
+#include "tests/tests.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_cache()
+{
+	kk_camera_t cam;
+	kk_mat4_t view;
+	kk_mat4_t proj;
+	kk_mat4_t view_proj;
+	kk_vec3_t look_at;
+	float* a;
+	float* b;
+	int i;
+
+	kk_camera__construct(&cam);
+	kk_camera__set_aspect(&cam, 2.0f);
+	kk_camera__update(&cam);
+	assert(!cam.dirty);
+
+	/* Same matrices as building them directly */
+	kk_math_vec3_add(&cam.pos, &cam.dir, &look_at);
+	kk_math_lookat(&cam.pos, &look_at, &cam.up, &view);
+	kk_math_perspective(kk_math_rad(KK_CAMERA_FOV_Y), 2.0f, KK_CAMERA_NEAR, KK_CAMERA_FAR, &proj);
+	kk_math_mat4_mul(&proj, &view, &view_proj);
+
+	a = (float*)&cam.view_proj;
+	b = (float*)&view_proj;
+	for (i = 0; i < 16; ++i)
+	{
+		assert(fabsf(a[i] - b[i]) < 1e-5f);
+	}
+
+	/* Nothing is rebuilt until the camera changes */
+	kk_camera__set_aspect(&cam, 2.0f);
+	assert(!cam.dirty);
+
+	memcpy(&view, &cam.view, sizeof(view));
+	kk_camera__move(&cam, 1.0f);
+	assert(cam.dirty);
+	kk_camera__update(&cam);
+	assert(memcmp(&view, &cam.view, sizeof(view)) != 0);
+
+	/* Setting the pose directly rebuilds too */
+	memcpy(&view, &cam.view, sizeof(view));
+	look_at.x = 1.0f;
+	look_at.y = 0.0f;
+	look_at.z = 0.0f;
+	kk_camera__set_pose(&cam, &cam.pos, &look_at, &cam.up);
+	assert(cam.dirty);
+	kk_camera__update(&cam);
+	assert(memcmp(&view, &cam.view, sizeof(view)) != 0);
+
+	kk_camera__destruct(&cam);
+}
+
+static void test_frustum()
+{
+	kk_camera_t cam;
+	kk_sphere_t sphere;
+
+	kk_camera__construct(&cam);
+	kk_camera__update(&cam);
+
+	/* In front of the camera */
+	sphere.center.x = cam.pos.x + cam.dir.x * 10.0f;
+	sphere.center.y = cam.pos.y + cam.dir.y * 10.0f;
+	sphere.center.z = cam.pos.z + cam.dir.z * 10.0f;
+	sphere.radius = 1.0f;
+	assert(kk_frustum__test_sphere(&cam.frustum, &sphere));
+
+	/* Turned away */
+	kk_camera__rot_y(&cam, 180.0f);
+	kk_camera__update(&cam);
+	assert(!kk_frustum__test_sphere(&cam.frustum, &sphere));
+
+	kk_camera__destruct(&cam);
+}
+
+static void test_ray()
+{
+	kk_camera_t cam;
+	kk_ray_t ray;
+	kk_vec3_t end;
+
+	kk_camera__construct(&cam);
+	kk_camera__set_aspect(&cam, 2.0f);
+	kk_camera__update(&cam);
+
+	/* Through the center the ray follows the view direction to the far plane */
+	kk_camera__get_ray(&cam, 100.0f, 50.0f, 200.0f, 100.0f, &ray);
+	assert(fabsf(kk_math_vec3_dot(&ray.dir, &cam.dir) - 1.0f) < 1e-5f);
+	assert(fabsf(ray.max_t - KK_CAMERA_FAR) < 1e-2f);
+
+	/* Through a corner the ray is longer but still ends on the far plane */
+	kk_camera__get_ray(&cam, 0.0f, 0.0f, 200.0f, 100.0f, &ray);
+	assert(ray.max_t > KK_CAMERA_FAR);
+
+	kk_math_vec3_scale(&ray.dir, ray.max_t, &end);
+	assert(fabsf(kk_math_vec3_dot(&end, &cam.dir) - KK_CAMERA_FAR) < 1e-2f);
+
+	kk_camera__destruct(&cam);
+}
+
+void kk_camera_tests()
+{
+	RUN_TEST_CASE(test_cache);
+	RUN_TEST_CASE(test_frustum);
+	RUN_TEST_CASE(test_ray);
+}
@@ -0,0 +1,171 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "ecs/systems/physics_system.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_contacts.h"
+#include "engine/kk_islands.h"
+#include "engine/kk_physics_bodies.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_static_model.h"
+#include "tests/tests.h"
+#include "tests/engine/physics_test_util.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_resting_box()
+{
+	physics_test_world_t w;
+	entity_id_t box;
+	ecs_transform_t* transform;
+	ecs_physics_t* phys;
+	int i;
+
+	physics_test__world_construct(&w, 10.0f);
+	box = physics_test__make_entity(&w, &w.box_model, 0.0f, 1.0f, 0.0f, TRUE);
+	phys = ecs_physics__get(&w.ecs, box);
+
+	for (i = 0; i < 180 && !phys->sleeping; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	/* Settled on the ground rather than falling through */
+	transform = ecs_transform__get(&w.ecs, box);
+	assert(phys->sleeping);
+	assert(fabsf(transform->pos.y - 0.5f) < 0.02f);
+	assert(fabsf(transform->rot.w) > 0.999f);
+
+	physics_test__world_destruct(&w);
+}
+
+static void test_warm_start()
+{
+	physics_test_world_t w;
+	kk_contacts_t* contacts = &w.collision.contacts;
+	kk_contact_manifold_t* manifold;
+	uint32_t slot;
+	uint32_t base;
+	float total;
+	int i;
+	uint32_t p;
+
+	physics_test__world_construct(&w, 10.0f);
+	physics_test__make_entity(&w, &w.box_model, 0.0f, 0.499f, 0.0f, TRUE);
+
+	for (i = 0; i < 5; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	assert(contacts->manifolds.count == 1);
+	slot = contacts->manifolds.data[0].slot;
+
+	/* Stop before it sleeps, which drops the manifold */
+	for (i = 0; i < KK_ISLANDS_SLEEP_TICKS - 10; ++i)
+	{
+		physics_test__world_tick(&w);
+
+		/* Same manifold keeps its slot and carries the impulses over */
+		manifold = &contacts->manifolds.data[0];
+		assert(contacts->manifolds.count == 1);
+		assert(manifold->slot == slot);
+		assert(manifold->num_points > 0 && manifold->num_points <= KK_CONTACTS_MAX_POINTS);
+
+		base = slot * KK_CONTACTS_MAX_POINTS;
+		total = 0.0f;
+		for (p = 0; p < manifold->num_points; ++p)
+		{
+			assert(contacts->normal_impulse[base + p] >= 0.0f);
+			total += contacts->normal_impulse[base + p];
+		}
+
+		/* The accumulated impulse holds the box up against one tick of gravity */
+		assert(fabsf(total - PHYSICS_TEST_GRAVITY * PHYSICS_TEST_TICK_TIME) < 0.25f * PHYSICS_TEST_GRAVITY * PHYSICS_TEST_TICK_TIME);
+	}
+
+	physics_test__world_destruct(&w);
+}
+
+static void test_separate()
+{
+	physics_test_world_t w;
+	entity_id_t box;
+	ecs_physics_t* phys;
+	int i;
+
+	physics_test__world_construct(&w, 10.0f);
+	box = physics_test__make_entity(&w, &w.box_model, 0.0f, 0.5f, 0.0f, TRUE);
+
+	for (i = 0; i < 10; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	assert(w.collision.contacts.manifolds.count == 1);
+
+	/* Launch it upward, the manifold is dropped once the pair separates */
+	phys = ecs_physics__get(&w.ecs, box);
+	phys->momentum.y = 10.0f;
+
+	for (i = 0; i < 10; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	assert(w.collision.contacts.manifolds.count == 0);
+	assert(ecs_transform__get(&w.ecs, box)->pos.y > 1.5f);
+
+	physics_test__world_destruct(&w);
+}
+
+static void test_stack()
+{
+	physics_test_world_t w;
+	entity_id_t boxes[3];
+	int i;
+
+	physics_test__world_construct(&w, 10.0f);
+	for (i = 0; i < 3; ++i)
+	{
+		boxes[i] = physics_test__make_entity(&w, &w.box_model, 0.0f, 0.5f + 1.05f * (float)i, 0.0f, TRUE);
+	}
+
+	for (i = 0; i < 300; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	for (i = 0; i < 3; ++i)
+	{
+		ecs_transform_t* transform = ecs_transform__get(&w.ecs, boxes[i]);
+		assert(fabsf(transform->pos.y - (0.5f + (float)i)) < 0.05f);
+		assert(fabsf(transform->pos.x) < 0.05f && fabsf(transform->pos.z) < 0.05f);
+	}
+
+	physics_test__world_destruct(&w);
+}
+
+void kk_contacts_tests()
+{
+	RUN_TEST_CASE(test_resting_box);
+	RUN_TEST_CASE(test_warm_start);
+	RUN_TEST_CASE(test_separate);
+	RUN_TEST_CASE(test_stack);
+}
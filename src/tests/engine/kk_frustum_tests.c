@@ -0,0 +1,146 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "engine/kk_frustum.h"
+#include "engine/kk_math.h"
+#include "tests/tests.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define NUM_SPHERES		(1003)	/* Not a multiple of the SIMD width, so the scalar tail runs. */
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Frustum of a camera at the origin looking down -z.
+*/
+static void make_frustum(kk_frustum_t* f)
+{
+	kk_mat4_t view;
+	kk_mat4_t proj;
+	kk_mat4_t view_proj;
+	kk_vec3_t eye = { 0.0f, 0.0f, 0.0f };
+	kk_vec3_t center = { 0.0f, 0.0f, -1.0f };
+	kk_vec3_t up = { 0.0f, 1.0f, 0.0f };
+
+	kk_math_lookat(&eye, &center, &up, &view);
+	kk_math_perspective(kk_math_rad(90.0f), 1.0f, 1.0f, 100.0f, &proj);
+	kk_math_mat4_mul(&proj, &view, &view_proj);
+	kk_frustum__from_matrix(f, &view_proj);
+}
+
+static boolean is_visible(kk_frustum_t* f, float x, float y, float z, float r)
+{
+	kk_sphere_t sphere;
+
+	sphere.center.x = x;
+	sphere.center.y = y;
+	sphere.center.z = z;
+	sphere.radius = r;
+	return kk_frustum__test_sphere(f, &sphere);
+}
+
+static void test_sphere()
+{
+	kk_frustum_t f;
+
+	make_frustum(&f);
+
+	/* Planes face inwards */
+	assert(f.planes[KK_FRUSTUM_PLANE_NEAR].z < 0.0f);
+	assert(f.planes[KK_FRUSTUM_PLANE_FAR].z > 0.0f);
+	assert(f.planes[KK_FRUSTUM_PLANE_LEFT].x > 0.0f);
+	assert(f.planes[KK_FRUSTUM_PLANE_TOP].y < 0.0f);
+
+	assert(is_visible(&f, 0.0f, 0.0f, -10.0f, 0.5f));
+
+	/* Behind, too close and too far */
+	assert(!is_visible(&f, 0.0f, 0.0f, 10.0f, 0.5f));
+	assert(!is_visible(&f, 0.0f, 0.0f, -0.2f, 0.5f));
+	assert(!is_visible(&f, 0.0f, 0.0f, -101.0f, 0.5f));
+	assert(is_visible(&f, 0.0f, 0.0f, -100.2f, 0.5f));
+
+	/* 90 degree field of view, so the side planes are at |x| = -z */
+	assert(!is_visible(&f, -12.0f, 0.0f, -10.0f, 1.0f));
+	assert(is_visible(&f, -10.5f, 0.0f, -10.0f, 1.0f));
+	assert(!is_visible(&f, 0.0f, 12.0f, -10.0f, 1.0f));
+	assert(is_visible(&f, 0.0f, 10.5f, -10.0f, 1.0f));
+}
+
+static void test_cull_spheres()
+{
+	float* data = (float*)malloc(sizeof(float) * 4 * NUM_SPHERES);
+	uint32_t* visible = (uint32_t*)malloc(sizeof(uint32_t) * NUM_SPHERES);
+	float* sphere[4];
+	kk_frustum_t f;
+	uint32_t num_visible;
+	uint32_t expected = 0;
+	uint32_t i;
+	double start_ms;
+	double elapsed_ms;
+	int pass;
+
+	assert(data && visible);
+	for (i = 0; i < 4; ++i)
+	{
+		sphere[i] = data + i * NUM_SPHERES;
+	}
+
+	srand(11);
+	for (i = 0; i < NUM_SPHERES; ++i)
+	{
+		sphere[0][i] = rand_range(-120.0f, 120.0f);
+		sphere[1][i] = rand_range(-120.0f, 120.0f);
+		sphere[2][i] = rand_range(-120.0f, 120.0f);
+		sphere[3][i] = rand_range(0.0f, 5.0f);
+	}
+
+	make_frustum(&f);
+	num_visible = kk_frustum__cull_spheres(&f, sphere[0], sphere[1], sphere[2], sphere[3], NUM_SPHERES, visible);
+
+	/* Same spheres, in order, as testing them one at a time */
+	for (i = 0; i < NUM_SPHERES; ++i)
+	{
+		if (is_visible(&f, sphere[0][i], sphere[1][i], sphere[2][i], sphere[3][i]))
+		{
+			assert(expected < num_visible && visible[expected] == i);
+			expected++;
+		}
+	}
+
+	assert(expected == num_visible);
+	assert(num_visible > 0 && num_visible < NUM_SPHERES);
+
+	/* Timing */
+	start_ms = get_time_ms();
+	for (pass = 0; pass < 1000; ++pass)
+	{
+		num_visible = kk_frustum__cull_spheres(&f, sphere[0], sphere[1], sphere[2], sphere[3], NUM_SPHERES, visible);
+	}
+
+	elapsed_ms = get_time_ms() - start_ms;
+	printf("\t\t%d spheres, %u visible: %.3f ms per cull (width %d)\n", NUM_SPHERES, num_visible, elapsed_ms / 1000.0, KK_FRUSTUM_WIDTH);
+
+	free(visible);
+	free(data);
+}
+
+void kk_frustum_tests()
+{
+	RUN_TEST_CASE(test_sphere);
+	RUN_TEST_CASE(test_cull_spheres);
+}
@@ -0,0 +1,190 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "ecs/systems/physics_system.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_broadphase.h"
+#include "engine/kk_islands.h"
+#include "engine/kk_physics_bodies.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_static_model.h"
+#include "tests/tests.h"
+#include "tests/engine/physics_test_util.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define MAX_TICKS	(300)
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static entity_id_t make_box(physics_test_world_t* w, float x, float y, float z)
+{
+	return physics_test__make_entity(w, &w->box_model, x, y, z, TRUE);
+}
+
+/**
+Ticks until every body is asleep.
+*/
+static void world_settle(physics_test_world_t* w, uint32_t num_bodies)
+{
+	int i;
+
+	for (i = 0; i < MAX_TICKS && w->collision.islands.num_sleeping < num_bodies; ++i)
+	{
+		physics_test__world_tick(w);
+	}
+
+	assert(w->collision.islands.num_sleeping == num_bodies);
+}
+
+static boolean is_sleeping(physics_test_world_t* w, entity_id_t ent)
+{
+	return ecs_physics__get(&w->ecs, ent)->sleeping;
+}
+
+static void test_sleep()
+{
+	physics_test_world_t w;
+	entity_id_t box;
+	ecs_physics_t* phys;
+	ecs_transform_t* transform;
+	kk_vec3_t pos;
+
+	physics_test__world_construct(&w, 20.0f);
+	box = make_box(&w, 0.0f, 0.6f, 0.0f);
+	world_settle(&w, 1);
+
+	/* Asleep bodies are left out of the simulation */
+	phys = ecs_physics__get(&w.ecs, box);
+	transform = ecs_transform__get(&w.ecs, box);
+	assert(phys->momentum.x == 0.0f && phys->momentum.y == 0.0f && phys->momentum.z == 0.0f);
+	assert(!transform->interpolated);
+	assert(kk_broadphase__is_static(&w.collision.broadphase, w.collision.proxies.data[box]));
+
+	pos = transform->pos;
+	physics_test__world_tick(&w);
+	physics_test__world_tick(&w);
+	assert(w.bodies.count == 0);
+	assert(w.collision.contacts.manifolds.count == 0);
+	assert(is_sleeping(&w, box));
+	assert(memcmp(&pos, &transform->pos, sizeof(pos)) == 0);
+
+	physics_test__world_destruct(&w);
+}
+
+static void test_wake_on_write()
+{
+	physics_test_world_t w;
+	entity_id_t box;
+	ecs_transform_t* transform;
+	int i;
+
+	physics_test__world_construct(&w, 20.0f);
+	box = make_box(&w, 0.0f, 0.5f, 0.0f);
+	world_settle(&w, 1);
+
+	/* Motion written by a game system */
+	ecs_physics__get(&w.ecs, box)->momentum.x = 1.0f;
+	physics_test__world_tick(&w);
+	assert(!is_sleeping(&w, box));
+	assert(w.bodies.count == 1);
+	assert(!kk_broadphase__is_static(&w.collision.broadphase, w.collision.proxies.data[box]));
+
+	world_settle(&w, 1);
+
+	/* Moved directly */
+	transform = ecs_transform__get(&w.ecs, box);
+	transform->pos.y = 2.0f;
+	ecs_transform__set_dirty(&w.ecs, transform);
+	physics_test__world_tick(&w);
+	assert(!is_sleeping(&w, box));
+
+	for (i = 0; i < 5; ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	assert(transform->pos.y < 2.0f);
+
+	world_settle(&w, 1);
+
+	/* Woken explicitly */
+	ecs_physics__wake(&w.ecs, box);
+	assert(!is_sleeping(&w, box));
+	physics_test__world_tick(&w);
+	assert(w.bodies.count == 1);
+
+	physics_test__world_destruct(&w);
+}
+
+static void test_islands()
+{
+	physics_test_world_t w;
+	entity_id_t stack_a[3];
+	entity_id_t stack_b[3];
+	entity_id_t ent;
+	int i;
+
+	physics_test__world_construct(&w, 20.0f);
+	for (i = 0; i < 3; ++i)
+	{
+		stack_a[i] = make_box(&w, -5.0f, 0.5f + 1.02f * (float)i, 0.0f);
+		stack_b[i] = make_box(&w, 5.0f, 0.5f + 1.02f * (float)i, 0.0f);
+	}
+
+	world_settle(&w, 6);
+	physics_test__world_tick(&w);
+	assert(w.collision.islands.num_islands == 2);
+
+	/* Pushing the top of one stack wakes all of it, and only it */
+	ecs_physics__get(&w.ecs, stack_a[2])->momentum.x = 0.5f;
+	physics_test__world_tick(&w);
+
+	for (i = 0; i < 3; ++i)
+	{
+		assert(!is_sleeping(&w, stack_a[i]));
+		assert(is_sleeping(&w, stack_b[i]));
+	}
+
+	assert(w.bodies.count == 3);
+	world_settle(&w, 6);
+
+	/* A box dropped onto the other stack wakes it once they touch */
+	ent = make_box(&w, 5.0f, 4.0f, 0.0f);
+	for (i = 0; i < MAX_TICKS && is_sleeping(&w, stack_b[0]); ++i)
+	{
+		physics_test__world_tick(&w);
+	}
+
+	assert(!is_sleeping(&w, stack_b[0]));
+	assert(ecs_transform__get(&w.ecs, ent)->pos.y > 3.0f);
+	assert(is_sleeping(&w, stack_a[0]));
+
+	physics_test__world_destruct(&w);
+}
+
+void kk_islands_tests()
+{
+	RUN_TEST_CASE(test_sleep);
+	RUN_TEST_CASE(test_wake_on_write);
+	RUN_TEST_CASE(test_islands);
+}
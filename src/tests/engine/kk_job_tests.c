@@ -0,0 +1,272 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "common.h"
+#include "engine/kk_job.h"
+#include "engine/kk_physics_bodies.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	kk_physics_bodies_t*	bodies;
+	float					delta_time;
+
+} integrate_data_t;
+
+typedef struct
+{
+	kk_job_system_t*		sys;
+	uint32_t				hits[32 * 64];
+
+} nested_data_t;
+
+typedef struct
+{
+	volatile int			first_done;
+	volatile int			second_saw_first;
+
+} order_data_t;
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void count_range(void* data, uint32_t start, uint32_t end)
+{
+	uint32_t* hits = (uint32_t*)data;
+	uint32_t i;
+
+	for (i = start; i < end; ++i)
+	{
+		hits[i]++;
+	}
+}
+
+static void integrate_range(void* data, uint32_t start, uint32_t end)
+{
+	integrate_data_t* d = (integrate_data_t*)data;
+	kk_physics_bodies__integrate_range(d->bodies, start, end, d->delta_time);
+}
+
+static void order_first(void* data, uint32_t start, uint32_t end)
+{
+	order_data_t* d = (order_data_t*)data;
+	volatile uint32_t spin;
+
+	/* Give the second job a chance to run early if dependencies are broken */
+	for (spin = 0; spin < 1000000; ++spin);
+
+	d->first_done = 1;
+}
+
+static void order_second(void* data, uint32_t start, uint32_t end)
+{
+	order_data_t* d = (order_data_t*)data;
+	d->second_saw_first = d->first_done;
+}
+
+static void nested_range(void* data, uint32_t start, uint32_t end)
+{
+	nested_data_t* d = (nested_data_t*)data;
+	uint32_t i;
+
+	/* Each outer index runs an inner parallel_for over its own 64 slots */
+	for (i = start; i < end; ++i)
+	{
+		kk_job__parallel_for(d->sys, 64, 8, count_range, d->hits + i * 64);
+	}
+}
+
+static void test_parallel_for()
+{
+	const uint32_t count = 100000;
+	kk_job_system_t sys;
+	uint32_t* hits;
+	uint32_t i;
+
+	kk_job__construct(&sys, 4);
+	assert(sys.num_threads >= 1);
+
+	hits = (uint32_t*)calloc(count, sizeof(uint32_t));
+
+	/* Every index is visited exactly once for a range of grain sizes */
+	kk_job__parallel_for(&sys, count, 0, count_range, hits);
+	kk_job__parallel_for(&sys, count, 1, count_range, hits);
+	kk_job__parallel_for(&sys, count, 777, count_range, hits);
+	kk_job__parallel_for(&sys, count, count * 2, count_range, hits);
+	kk_job__parallel_for(&sys, 0, 0, count_range, hits);
+
+	for (i = 0; i < count; ++i)
+	{
+		assert(hits[i] == 4);
+	}
+
+	free(hits);
+	kk_job__destruct(&sys);
+}
+
+static void test_nested()
+{
+	kk_job_system_t sys;
+	nested_data_t* data;
+	uint32_t i;
+
+	kk_job__construct(&sys, 4);
+
+	data = (nested_data_t*)calloc(1, sizeof(nested_data_t));
+	data->sys = &sys;
+
+	kk_job__parallel_for(&sys, 32, 1, nested_range, data);
+
+	for (i = 0; i < cnt_of_array(data->hits); ++i)
+	{
+		assert(data->hits[i] == 1);
+	}
+
+	free(data);
+	kk_job__destruct(&sys);
+}
+
+static void test_run_after()
+{
+	kk_job_system_t sys;
+	kk_job_counter_t first_counter;
+	kk_job_counter_t second_counter;
+	order_data_t data;
+	kk_job_t job;
+	int i;
+
+	kk_job__construct(&sys, 4);
+
+	for (i = 0; i < 20; ++i)
+	{
+		clear_struct(&first_counter);
+		clear_struct(&second_counter);
+		clear_struct(&data);
+
+		job.data = &data;
+		job.start = 0;
+		job.end = 0;
+
+		job.func = order_first;
+		job.counter = &first_counter;
+		kk_job__run(&sys, &job);
+
+		job.func = order_second;
+		job.counter = &second_counter;
+		kk_job__run_after(&sys, &job, &first_counter);
+
+		/* Waiting on the second job also covers the first */
+		kk_job__wait(&sys, &second_counter);
+		assert(data.first_done);
+		assert(data.second_saw_first);
+		assert(first_counter.value == 0);
+	}
+
+	kk_job__destruct(&sys);
+}
+
+static void test_single_thread()
+{
+	kk_job_system_t sys;
+	kk_job_counter_t counter;
+	uint32_t hits[16] = { 0 };
+	kk_job_t job;
+
+	kk_job__construct(&sys, 1);
+	assert(sys.num_threads == 1);
+
+	/* Jobs run inline when there are no other threads */
+	clear_struct(&counter);
+	job.func = count_range;
+	job.data = hits;
+	job.start = 2;
+	job.end = 5;
+	job.counter = &counter;
+	kk_job__run(&sys, &job);
+
+	assert(counter.value == 0);
+	assert(hits[1] == 0 && hits[2] == 1 && hits[4] == 1 && hits[5] == 0);
+
+	kk_job__parallel_for(&sys, 16, 4, count_range, hits);
+	assert(hits[0] == 1 && hits[2] == 2 && hits[15] == 1);
+
+	kk_job__destruct(&sys);
+}
+
+static void test_benchmark()
+{
+	const uint32_t count = 100000;
+	const uint32_t iterations = 200;
+	const uint32_t thread_counts[] = { 1, 2, 4, 8 };
+	kk_physics_bodies_t bodies;
+	integrate_data_t data;
+	double base_ms = 0.0;
+	uint32_t c, i;
+
+	kk_physics_bodies__construct(&bodies);
+	kk_physics_bodies__reserve(&bodies, count);
+	bodies.count = count;
+
+	for (i = 0; i < count; ++i)
+	{
+		bodies.inverse_mass[i] = 1.0f;
+		bodies.inverse_inertia[i] = 1.0f;
+		bodies.momentum[0][i] = (float)(i % 7);
+		bodies.angular_momentum[1][i] = 0.5f;
+		bodies.rot[3][i] = 1.0f;
+	}
+
+	data.bodies = &bodies;
+	data.delta_time = 1.0f / 60.0f;
+
+	for (c = 0; c < cnt_of_array(thread_counts); ++c)
+	{
+		kk_job_system_t sys;
+		double start, ms;
+
+		kk_job__construct(&sys, thread_counts[c]);
+
+		start = get_time_ms();
+		for (i = 0; i < iterations; ++i)
+		{
+			kk_job__parallel_for(&sys, count, 1024, integrate_range, &data);
+		}
+		ms = get_time_ms() - start;
+
+		if (c == 0)
+		{
+			base_ms = ms;
+		}
+
+		printf("\t\t%u threads: %.0f bodies/ms, %.2fx\n",
+			sys.num_threads,
+			(double)count * iterations / max(ms, 0.001),
+			base_ms / max(ms, 0.001));
+
+		kk_job__destruct(&sys);
+	}
+
+	kk_physics_bodies__destruct(&bodies);
+}
+
+void kk_job_tests()
+{
+	RUN_TEST_CASE(test_nested);
+	RUN_TEST_CASE(test_parallel_for);
+	RUN_TEST_CASE(test_run_after);
+	RUN_TEST_CASE(test_single_thread);
+	RUN_TEST_CASE(test_benchmark);
+}
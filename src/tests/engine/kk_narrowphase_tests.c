@@ -0,0 +1,285 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "engine/kk_math.h"
+#include "engine/kk_narrowphase.h"
+#include "engine/kk_shape.h"
+#include "tests/tests.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void make_matrix(kk_mat4_t* m, float x, float y, float z, float angle_z)
+{
+	clear_struct(m);
+	m->x.x = cosf(angle_z);
+	m->x.y = sinf(angle_z);
+	m->y.x = -sinf(angle_z);
+	m->y.y = cosf(angle_z);
+	m->z.z = 1.0f;
+	m->w.x = x;
+	m->w.y = y;
+	m->w.z = z;
+	m->w.w = 1.0f;
+}
+
+static void make_box(kk_shape_t* shape, float half)
+{
+	kk_vec3_t center;
+	kk_vec3_t extents;
+
+	clear_struct(&center);
+	extents.x = extents.y = extents.z = half;
+	kk_shape__construct_box(shape, &center, &extents);
+}
+
+static void make_sphere(kk_shape_t* shape, float radius)
+{
+	kk_vec3_t center;
+
+	clear_struct(&center);
+	kk_shape__construct_sphere(shape, &center, radius);
+}
+
+/**
+Checks that the contact points are consistent with the normal and depth.
+*/
+static void check_contact(kk_narrowphase_contact_t* c)
+{
+	kk_vec3_t d;
+
+	assert(fabsf(kk_math_vec3_norm(&c->normal) - 1.0f) < 1e-4f);
+
+	kk_math_vec3_sub(&c->point_a, &c->point_b, &d);
+	assert(fabsf(kk_math_vec3_dot(&d, &c->normal) - c->depth) < 1e-3f);
+}
+
+static void test_shape_from_points()
+{
+	float box_points[8 * 3];
+	float sphere_points[64 * 3];
+	float hull_points[7 * 3] =
+	{
+		0.0f, 0.0f, 0.0f,
+		1.0f, 0.0f, 0.0f,
+		0.0f, 2.0f, 0.0f,
+		0.0f, 0.0f, 3.0f,
+		1.0f, 0.0f, 0.0f,		/* Duplicate */
+		0.2f, 0.2f, 0.2f,		/* Interior */
+		0.0f, 2.0f, 0.0f,		/* Duplicate */
+	};
+	float* big;
+	kk_shape_t shape;
+	kk_vec3_t dir;
+	kk_vec3_t p;
+	int i;
+
+	/* Corners of a box */
+	for (i = 0; i < 8; ++i)
+	{
+		box_points[i * 3 + 0] = (i & 1) ? 1.0f : -1.0f;
+		box_points[i * 3 + 1] = (i & 2) ? 3.0f : 1.0f;
+		box_points[i * 3 + 2] = (i & 4) ? 0.5f : -0.5f;
+	}
+
+	kk_shape__construct_from_points(&shape, box_points, 8);
+	assert(shape.type == KK_SHAPE_TYPE_BOX);
+	assert(shape.center.y == 2.0f);
+	assert(shape.half_extents.x == 1.0f && shape.half_extents.y == 1.0f && shape.half_extents.z == 0.5f);
+	kk_shape__destruct(&shape);
+
+	/* Points on a sphere */
+	for (i = 0; i < 64; ++i)
+	{
+		float theta = (float)(i % 8) / 8.0f * 2.0f * KK_PIf;
+		float phi = ((float)(i / 8) + 0.5f) / 8.0f * KK_PIf;
+
+		sphere_points[i * 3 + 0] = 5.0f + 2.0f * sinf(phi) * cosf(theta);
+		sphere_points[i * 3 + 1] = 2.0f * cosf(phi);
+		sphere_points[i * 3 + 2] = 2.0f * sinf(phi) * sinf(theta);
+	}
+
+	kk_shape__construct_from_points(&shape, sphere_points, 64);
+	assert(shape.type == KK_SHAPE_TYPE_SPHERE);
+	assert(fabsf(shape.radius - 2.0f) < 0.1f);
+	assert(fabsf(shape.center.x - 5.0f) < 0.1f);
+	kk_shape__destruct(&shape);
+
+	/* Anything else is a hull of the unique points */
+	kk_shape__construct_from_points(&shape, hull_points, 7);
+	assert(shape.type == KK_SHAPE_TYPE_HULL);
+	assert(shape.num_vertices == 5);
+
+	dir.x = 0.0f;
+	dir.y = 0.0f;
+	dir.z = 1.0f;
+	kk_shape__support(&shape, &dir, &p);
+	assert(p.z == 3.0f);
+	kk_shape__destruct(&shape);
+
+	/* Too many points for a hull */
+	big = (float*)malloc(sizeof(float) * 3 * (KK_SHAPE_MAX_HULL_VERTICES + 1));
+	for (i = 0; i < KK_SHAPE_MAX_HULL_VERTICES + 1; ++i)
+	{
+		big[i * 3 + 0] = (float)i;
+		big[i * 3 + 1] = (float)(i * i % 7);
+		big[i * 3 + 2] = (float)(i % 3);
+	}
+
+	kk_shape__construct_from_points(&shape, big, KK_SHAPE_MAX_HULL_VERTICES + 1);
+	assert(shape.type == KK_SHAPE_TYPE_BOX);
+	assert(!shape.vertices);
+	kk_shape__destruct(&shape);
+	free(big);
+}
+
+static void test_spheres()
+{
+	kk_narrowphase_contact_t c;
+	kk_shape_t a;
+	kk_shape_t b;
+	kk_mat4_t ma;
+	kk_mat4_t mb;
+
+	make_sphere(&a, 1.0f);
+	make_sphere(&b, 1.0f);
+	make_matrix(&ma, 0.0f, 0.0f, 0.0f, 0.0f);
+
+	make_matrix(&mb, 1.5f, 0.0f, 0.0f, 0.0f);
+	assert(kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+	check_contact(&c);
+	assert(fabsf(c.depth - 0.5f) < 1e-5f);
+	assert(fabsf(c.normal.x - 1.0f) < 1e-5f);
+
+	make_matrix(&mb, 2.5f, 0.0f, 0.0f, 0.0f);
+	assert(!kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+}
+
+static void test_box_sphere()
+{
+	kk_narrowphase_contact_t c;
+	kk_shape_t box;
+	kk_shape_t sphere;
+	kk_mat4_t mbox;
+	kk_mat4_t msphere;
+
+	make_box(&box, 1.0f);
+	make_sphere(&sphere, 0.5f);
+	make_matrix(&mbox, 0.0f, 0.0f, 0.0f, 0.0f);
+
+	/* Touching a face */
+	make_matrix(&msphere, 1.3f, 0.2f, 0.0f, 0.0f);
+	assert(kk_narrowphase__collide(&box, &mbox, &sphere, &msphere, &c));
+	check_contact(&c);
+	assert(fabsf(c.depth - 0.2f) < 1e-5f);
+	assert(fabsf(c.normal.x - 1.0f) < 1e-5f);
+
+	/* Reversed order flips the normal */
+	assert(kk_narrowphase__collide(&sphere, &msphere, &box, &mbox, &c));
+	check_contact(&c);
+	assert(fabsf(c.normal.x + 1.0f) < 1e-5f);
+
+	/* Center inside the box pushes out the nearest face */
+	make_matrix(&msphere, 0.0f, -0.8f, 0.0f, 0.0f);
+	assert(kk_narrowphase__collide(&box, &mbox, &sphere, &msphere, &c));
+	check_contact(&c);
+	assert(fabsf(c.normal.y + 1.0f) < 1e-5f);
+	assert(fabsf(c.depth - 0.7f) < 1e-5f);
+
+	/* Near a corner but not touching */
+	make_matrix(&msphere, 1.4f, 1.4f, 0.0f, 0.0f);
+	assert(!kk_narrowphase__collide(&box, &mbox, &sphere, &msphere, &c));
+}
+
+static void test_boxes()
+{
+	kk_narrowphase_contact_t c;
+	kk_shape_t a;
+	kk_shape_t b;
+	kk_mat4_t ma;
+	kk_mat4_t mb;
+
+	make_box(&a, 1.0f);
+	make_box(&b, 1.0f);
+	make_matrix(&ma, 0.0f, 0.0f, 0.0f, 0.0f);
+
+	/* Face overlap, shallowest along x */
+	make_matrix(&mb, 1.8f, 0.5f, 0.3f, 0.0f);
+	assert(kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+	check_contact(&c);
+	assert(fabsf(c.depth - 0.2f) < 1e-3f);
+	assert(c.normal.x > 0.999f);
+
+	/* Rotated 45 degrees, a corner pokes into the top face */
+	make_matrix(&mb, 0.0f, 2.3f, 0.0f, 0.25f * KK_PIf);
+	assert(kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+	check_contact(&c);
+	assert(fabsf(c.depth - (sqrtf(2.0f) - 1.3f)) < 1e-3f);
+	assert(c.normal.y > 0.999f);
+
+	/* Separated */
+	make_matrix(&mb, 2.1f, 0.0f, 0.0f, 0.0f);
+	assert(!kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+	make_matrix(&mb, 0.0f, 2.5f, 0.0f, 0.25f * KK_PIf);
+	assert(!kk_narrowphase__collide(&a, &ma, &b, &mb, &c));
+}
+
+static void test_hull()
+{
+	float points[4 * 3] =
+	{
+		0.0f, 0.0f, 0.0f,
+		1.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 1.0f,
+	};
+	kk_narrowphase_contact_t c;
+	kk_shape_t hull;
+	kk_shape_t box;
+	kk_shape_t sphere;
+	kk_mat4_t mhull;
+	kk_mat4_t mbox;
+
+	kk_shape__construct_from_points(&hull, points, 4);
+	assert(hull.type == KK_SHAPE_TYPE_HULL);
+	make_box(&box, 1.0f);
+	make_sphere(&sphere, 1.0f);
+
+	/* Tetrahedron corner dipping into the top of the box */
+	make_matrix(&mbox, 0.0f, 0.0f, 0.0f, 0.0f);
+	make_matrix(&mhull, 0.2f, 0.9f, 0.2f, 0.0f);
+	assert(kk_narrowphase__collide(&hull, &mhull, &box, &mbox, &c));
+	check_contact(&c);
+	assert(fabsf(c.depth - 0.1f) < 1e-3f);
+	assert(c.normal.y < -0.999f);
+
+	/* Hull against sphere goes through the generic path */
+	assert(kk_narrowphase__collide(&hull, &mhull, &sphere, &mbox, &c));
+	check_contact(&c);
+	assert(c.depth > 0.0f);
+
+	make_matrix(&mhull, 0.2f, 1.1f, 0.2f, 0.0f);
+	assert(!kk_narrowphase__collide(&hull, &mhull, &box, &mbox, &c));
+
+	kk_shape__destruct(&hull);
+}
+
+void kk_narrowphase_tests()
+{
+	RUN_TEST_CASE(test_shape_from_points);
+	RUN_TEST_CASE(test_spheres);
+	RUN_TEST_CASE(test_box_sphere);
+	RUN_TEST_CASE(test_boxes);
+	RUN_TEST_CASE(test_hull);
+}
@@ -0,0 +1,221 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "common.h"
+#include "engine/kk_physics_bodies.h"
+#include "tests/tests.h"
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void fill_bodies(kk_physics_bodies_t* bodies, uint32_t count, unsigned seed)
+{
+	uint32_t i;
+	int a;
+
+	srand(seed);
+	kk_physics_bodies__reserve(bodies, count);
+	bodies->count = count;
+
+	for (i = 0; i < count; ++i)
+	{
+		for (a = 0; a < 3; ++a)
+		{
+			bodies->pos[a][i] = rand_range(-1.0f, 1.0f) * 10.0f;
+			bodies->momentum[a][i] = rand_range(-1.0f, 1.0f);
+			bodies->velocity[a][i] = rand_range(-1.0f, 1.0f);
+			bodies->angular_momentum[a][i] = rand_range(-1.0f, 1.0f);
+			bodies->angular_velocity[a][i] = rand_range(-1.0f, 1.0f);
+		}
+
+		for (a = 0; a < 4; ++a)
+		{
+			bodies->rot[a][i] = rand_range(-1.0f, 1.0f);
+			bodies->spin[a][i] = rand_range(-1.0f, 1.0f) * 0.1f;
+		}
+
+		bodies->inverse_mass[i] = 0.5f + rand_range(-1.0f, 1.0f) * 0.25f;
+		bodies->inverse_inertia[i] = 0.5f + rand_range(-1.0f, 1.0f) * 0.25f;
+	}
+}
+
+static void assert_near(float* a, float* b, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; ++i)
+	{
+		assert(fabsf(a[i] - b[i]) < 1e-4f);
+	}
+}
+
+static void test_reserve()
+{
+	kk_physics_bodies_t bodies;
+	kk_physics_bodies__construct(&bodies);
+
+	kk_physics_bodies__reserve(&bodies, 5);
+	assert(bodies.capacity >= 5);
+	assert(bodies.capacity % KK_PHYSICS_BODIES_WIDTH == 0);
+
+	kk_physics_bodies__destruct(&bodies);
+}
+
+static void test_integrate()
+{
+	kk_physics_bodies_t bodies;
+	kk_physics_bodies__construct(&bodies);
+	kk_physics_bodies__reserve(&bodies, 1);
+	bodies.count = 1;
+
+	/* Moving body with identity orientation and no rotation */
+	bodies.pos[0][0] = 1.0f;
+	bodies.velocity[0][0] = 2.0f;
+	bodies.momentum[1][0] = 4.0f;
+	bodies.inverse_mass[0] = 0.5f;
+	bodies.rot[3][0] = 1.0f;
+
+	kk_physics_bodies__integrate(&bodies, 0.5f);
+
+	assert(bodies.pos[0][0] == 2.0f);
+	assert(bodies.velocity[0][0] == 0.0f);
+	assert(bodies.velocity[1][0] == 2.0f);
+	assert(bodies.rot[3][0] == 1.0f);
+	assert(bodies.spin[3][0] == 0.0f);
+
+	/* Zero orientation is reset to identity */
+	bodies.rot[3][0] = 0.0f;
+	kk_physics_bodies__integrate(&bodies, 0.5f);
+	assert(bodies.rot[3][0] == 1.0f);
+
+	kk_physics_bodies__destruct(&bodies);
+}
+
+static void test_save_previous()
+{
+	const uint32_t count = 37;
+	kk_physics_bodies_t bodies;
+	float pos[37];
+	float rot[37];
+
+	kk_physics_bodies__construct(&bodies);
+	fill_bodies(&bodies, count, 3);
+
+	memcpy(pos, bodies.pos[1], sizeof(pos));
+	memcpy(rot, bodies.rot[2], sizeof(rot));
+
+	/* Saved in two ranges, then stepped */
+	kk_physics_bodies__save_previous_range(&bodies, 0, 20);
+	kk_physics_bodies__save_previous_range(&bodies, 20, count);
+	kk_physics_bodies__integrate(&bodies, 0.5f);
+
+	assert_near(bodies.prev_pos[1], pos, count);
+	assert_near(bodies.prev_rot[2], rot, count);
+	assert(memcmp(bodies.pos[1], pos, sizeof(pos)) != 0);
+
+	kk_physics_bodies__destruct(&bodies);
+}
+
+static void test_simd_matches_scalar()
+{
+	kk_physics_bodies_t simd;
+	kk_physics_bodies_t scalar;
+	const uint32_t count = 37;		/* Not a multiple of the SIMD width */
+	int a;
+
+	kk_physics_bodies__construct(&simd);
+	kk_physics_bodies__construct(&scalar);
+	fill_bodies(&simd, count, 1234);
+	fill_bodies(&scalar, count, 1234);
+
+	/* Zero orientation in a SIMD lane */
+	for (a = 0; a < 4; ++a)
+	{
+		simd.rot[a][2] = scalar.rot[a][2] = 0.0f;
+		simd.spin[a][2] = scalar.spin[a][2] = 0.0f;
+	}
+
+	kk_physics_bodies__integrate(&simd, 1.0f / 60.0f);
+	kk_physics_bodies__integrate_scalar(&scalar, 1.0f / 60.0f);
+
+	for (a = 0; a < 3; ++a)
+	{
+		assert_near(simd.pos[a], scalar.pos[a], count);
+		assert_near(simd.velocity[a], scalar.velocity[a], count);
+		assert_near(simd.angular_velocity[a], scalar.angular_velocity[a], count);
+	}
+
+	for (a = 0; a < 4; ++a)
+	{
+		assert_near(simd.rot[a], scalar.rot[a], count);
+		assert_near(simd.spin[a], scalar.spin[a], count);
+	}
+
+	assert(simd.rot[3][2] == 1.0f);
+
+	kk_physics_bodies__destruct(&simd);
+	kk_physics_bodies__destruct(&scalar);
+}
+
+static void test_benchmark()
+{
+	const uint32_t counts[] = { 1000, 10000, 100000 };
+	const uint32_t total_bodies = 10000000;		/* Bodies integrated per measurement */
+	kk_physics_bodies_t bodies;
+	int c;
+
+	kk_physics_bodies__construct(&bodies);
+
+	for (c = 0; c < 3; ++c)
+	{
+		uint32_t iterations = total_bodies / counts[c];
+		clock_t start;
+		double simd_ms, scalar_ms;
+		uint32_t i;
+
+		fill_bodies(&bodies, counts[c], 1);
+
+		start = clock();
+		for (i = 0; i < iterations; ++i)
+		{
+			kk_physics_bodies__integrate(&bodies, 1.0f / 60.0f);
+		}
+		simd_ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+		start = clock();
+		for (i = 0; i < iterations; ++i)
+		{
+			kk_physics_bodies__integrate_scalar(&bodies, 1.0f / 60.0f);
+		}
+		scalar_ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+		printf("\t\t%6u bodies: simd (width %d) %.0f bodies/ms, scalar %.0f bodies/ms\n",
+			counts[c],
+			KK_PHYSICS_BODIES_WIDTH,
+			total_bodies / max(simd_ms, 0.001),
+			total_bodies / max(scalar_ms, 0.001));
+	}
+
+	kk_physics_bodies__destruct(&bodies);
+}
+
+void kk_physics_bodies_tests()
+{
+	RUN_TEST_CASE(test_reserve);
+	RUN_TEST_CASE(test_integrate);
+	RUN_TEST_CASE(test_save_previous);
+	RUN_TEST_CASE(test_simd_matches_scalar);
+	RUN_TEST_CASE(test_benchmark);
+}
@@ -0,0 +1,104 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/components/ecs_physics.h"
+#include "ecs/components/ecs_static_model.h"
+#include "ecs/components/ecs_transform.h"
+#include "ecs/systems/collision_system.h"
+#include "ecs/systems/physics_system.h"
+#include "ecs/systems/transform_system.h"
+#include "engine/kk_physics_bodies.h"
+#include "engine/kk_shape.h"
+#include "gpu/gpu_static_model.h"
+#include "tests/engine/physics_test_util.h"
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+void physics_test__make_model(gpu_static_model_t* model, float hx, float hy, float hz)
+{
+	kk_vec3_t center;
+	kk_vec3_t half;
+
+	clear_struct(model);
+	clear_struct(&center);
+	half.x = hx;
+	half.y = hy;
+	half.z = hz;
+	kk_shape__construct_box(&model->shape, &center, &half);
+
+	model->bounds.min.x = -hx; model->bounds.max.x = hx;
+	model->bounds.min.y = -hy; model->bounds.max.y = hy;
+	model->bounds.min.z = -hz; model->bounds.max.z = hz;
+}
+
+entity_id_t physics_test__make_entity(physics_test_world_t* w, gpu_static_model_t* model, float x, float y, float z, boolean dynamic)
+{
+	entity_id_t ent = ecs__alloc_entity(&w->ecs);
+	ecs_transform_t* transform = ecs_transform__add(&w->ecs, ent);
+	ecs_physics_t* phys;
+
+	transform->pos.x = x;
+	transform->pos.y = y;
+	transform->pos.z = z;
+	transform->rot.w = 1.0f;
+	transform->scale.x = transform->scale.y = transform->scale.z = 1.0f;
+
+	ecs_static_model__add(&w->ecs, ent)->model = model;
+
+	if (dynamic)
+	{
+		phys = ecs_physics__add(&w->ecs, ent);
+		phys->mass = 1.0f;
+		phys->inverse_mass = 1.0f;
+		phys->inertia = 1.0f;
+		phys->inverse_inertia = 1.0f;
+	}
+
+	return ent;
+}
+
+void physics_test__world_construct(physics_test_world_t* w, float ground_half_size)
+{
+	clear_struct(w);
+	ecs__construct(&w->ecs);
+	collision_system__construct(&w->collision);
+	kk_physics_bodies__construct(&w->bodies);
+
+	physics_test__make_model(&w->ground_model, ground_half_size, 0.5f, ground_half_size);
+	physics_test__make_model(&w->box_model, 0.5f, 0.5f, 0.5f);
+	physics_test__make_entity(w, &w->ground_model, 0.0f, -0.5f, 0.0f, FALSE);
+}
+
+void physics_test__world_destruct(physics_test_world_t* w)
+{
+	kk_shape__destruct(&w->box_model.shape);
+	kk_shape__destruct(&w->ground_model.shape);
+	kk_physics_bodies__destruct(&w->bodies);
+	collision_system__destruct(&w->collision);
+	ecs__destruct(&w->ecs);
+}
+
+void physics_test__world_tick(physics_test_world_t* w)
+{
+	ecs_query_t* query = ecs__query(&w->ecs, ECS_COMPONENT_BIT(ECS_COMPONENT_TYPE_PHYSICS), 0);
+	ecs_physics_t* phys;
+	uint32_t i;
+
+	for (i = 0; i < ecs_query__get_count(query); ++i)
+	{
+		phys = ecs_physics__get(&w->ecs, ecs_query__get_entity(query, i));
+		if (!phys->sleeping)
+		{
+			phys->momentum.y -= phys->mass * PHYSICS_TEST_GRAVITY * PHYSICS_TEST_TICK_TIME;
+		}
+	}
+
+	physics_system__run(&w->ecs, &w->bodies, &w->collision, PHYSICS_TEST_TICK_TIME, 1);
+	collision_system__run(&w->collision, &w->ecs);
+	transform_system__run(&w->ecs, 1.0f);
+}
\ No newline at end of file
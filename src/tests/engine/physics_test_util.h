@@ -0,0 +1,71 @@
+#ifndef PHYSICS_TEST_UTIL_H
+#define PHYSICS_TEST_UTIL_H
+
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include "common.h"
+#include "ecs/ecs.h"
+#include "ecs/systems/collision_system.h"
+#include "engine/kk_physics_bodies.h"
+#include "gpu/gpu_static_model.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define PHYSICS_TEST_TICK_TIME	(1.0f / 60.0f)
+#define PHYSICS_TEST_GRAVITY	(9.8f)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+/**
+A small physics world for tests: an ECS, the collision and body state the
+game keeps next to it, and box models for the ground and for bodies.
+*/
+typedef struct
+{
+	ecs_t					ecs;
+	collision_system_t		collision;
+	kk_physics_bodies_t		bodies;
+	gpu_static_model_t		ground_model;
+	gpu_static_model_t		box_model;
+
+} physics_test_world_t;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Sets up a model with a box collision shape and matching bounds. Destroy the
+shape with kk_shape__destruct.
+*/
+void physics_test__make_model(gpu_static_model_t* model, float hx, float hy, float hz);
+
+/**
+Adds an entity with a unit scale transform and a model. Dynamic entities
+also get a unit mass physics component.
+*/
+entity_id_t physics_test__make_entity(physics_test_world_t* w, gpu_static_model_t* model, float x, float y, float z, boolean dynamic);
+
+/**
+Constructs the world with a static ground whose top is at y = 0 and a
+1 x 1 x 1 box model for bodies.
+
+@param ground_half_size Half the width and depth of the ground.
+*/
+void physics_test__world_construct(physics_test_world_t* w, float ground_half_size);
+
+void physics_test__world_destruct(physics_test_world_t* w);
+
+/**
+Runs one tick in the same order as the game, with gravity applied to every
+awake body first.
+*/
+void physics_test__world_tick(physics_test_world_t* w);
+
+#endif /* PHYSICS_TEST_UTIL_H */
\ No newline at end of file
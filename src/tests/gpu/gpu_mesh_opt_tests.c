@@ -0,0 +1,186 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "common.h"
+#include "gpu/gpu_mesh_opt.h"
+#include "gpu/gpu_vertex_weld.h"
+#include "tests/tests.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define GRID_SIZE		(16)
+#define GRID_TRIS		(GRID_SIZE * GRID_SIZE * 2)
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	float		tex[2];
+	float		pos[3];
+
+} vertex_t;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+/**
+Gets a key for a triangle from its corners' grid cells, rotated so it starts
+at the smallest cell. Winding is kept.
+*/
+static uint32_t get_tri_key(const gpu_vertex_weld_t* w, uint32_t tri)
+{
+	uint32_t c[3];
+	uint32_t first = 0;
+	uint32_t k;
+
+	for (k = 0; k < 3; ++k)
+	{
+		const vertex_t* v = (const vertex_t*)(w->vertices + (size_t)w->indices[tri * 3 + k] * sizeof(vertex_t));
+		c[k] = (uint32_t)v->pos[1] * (GRID_SIZE + 1) + (uint32_t)v->pos[0];
+		if (c[k] < c[first])
+		{
+			first = k;
+		}
+	}
+
+	return (c[first] * 1024 + c[(first + 1) % 3]) * 1024 + c[(first + 2) % 3];
+}
+
+static int compare_keys(const void* a, const void* b)
+{
+	uint32_t ka = *(const uint32_t*)a;
+	uint32_t kb = *(const uint32_t*)b;
+
+	return (ka > kb) - (ka < kb);
+}
+
+static void test_count_misses()
+{
+	uint32_t reuse[] = { 0, 1, 2, 0, 1, 2 };
+	uint32_t evict[] = { 0, 1, 2, 3, 4, 5, 0, 2 };
+
+	assert(gpu_mesh_opt__count_misses(reuse, 6, 3, 3) == 3);
+
+	/* 0 and 2 have been pushed out of a 3 entry FIFO */
+	assert(gpu_mesh_opt__count_misses(evict, 8, 6, 3) == 8);
+	assert(gpu_mesh_opt__count_misses(evict, 8, 6, 6) == 6);
+}
+
+static void test_optimize()
+{
+	gpu_vertex_weld_t w;
+	gpu_mesh_opt_stats_t stats;
+	vertex_t corners[GRID_TRIS * 3];
+	vertex_t tmp[3];
+	uint32_t keys_before[GRID_TRIS];
+	uint32_t keys_after[GRID_TRIS];
+	uint32_t seed = 12345;
+	uint32_t x;
+	uint32_t y;
+	uint32_t i;
+	uint32_t j;
+
+	/* Two triangles per grid cell */
+	memset(corners, 0, sizeof(corners));
+	for (y = 0; y < GRID_SIZE; ++y)
+	{
+		for (x = 0; x < GRID_SIZE; ++x)
+		{
+			vertex_t* c = &corners[(y * GRID_SIZE + x) * 6];
+			c[0].pos[0] = (float)x;			c[0].pos[1] = (float)y;
+			c[1].pos[0] = (float)(x + 1);	c[1].pos[1] = (float)y;
+			c[2].pos[0] = (float)(x + 1);	c[2].pos[1] = (float)(y + 1);
+			c[3] = c[0];
+			c[4] = c[2];
+			c[5].pos[0] = (float)x;			c[5].pos[1] = (float)(y + 1);
+		}
+	}
+
+	/* Shuffle the triangles so the input order has no locality */
+	for (i = GRID_TRIS - 1; i > 0; --i)
+	{
+		seed = seed * 1103515245 + 12345;
+		j = (seed >> 8) % (i + 1);
+		memcpy(tmp, &corners[i * 3], sizeof(tmp));
+		memcpy(&corners[i * 3], &corners[j * 3], sizeof(tmp));
+		memcpy(&corners[j * 3], tmp, sizeof(tmp));
+	}
+
+	gpu_vertex_weld__construct(&w, sizeof(vertex_t), GRID_TRIS * 3);
+	for (i = 0; i < GRID_TRIS * 3; ++i)
+	{
+		gpu_vertex_weld__add(&w, &corners[i]);
+	}
+
+	assert(w.num_vertices == (GRID_SIZE + 1) * (GRID_SIZE + 1));
+
+	for (i = 0; i < GRID_TRIS; ++i)
+	{
+		keys_before[i] = get_tri_key(&w, i);
+	}
+
+	clear_struct(&stats);
+	gpu_mesh_opt__optimize(&w, offsetof(vertex_t, pos), &stats);
+
+	/* The cache order gets well under one miss per triangle */
+	assert(stats.num_triangles == GRID_TRIS);
+	assert(stats.misses_before > 2 * GRID_TRIS);
+	assert(stats.misses_after < GRID_TRIS);
+	assert(gpu_mesh_opt__get_acmr(&stats, TRUE) < gpu_mesh_opt__get_acmr(&stats, FALSE));
+	assert(gpu_mesh_opt__count_misses(w.indices, w.num_indices, w.num_vertices, GPU_MESH_OPT_ACMR_CACHE_SIZE) == stats.misses_after);
+
+	/* Same triangles with the same winding */
+	for (i = 0; i < GRID_TRIS; ++i)
+	{
+		keys_after[i] = get_tri_key(&w, i);
+	}
+
+	qsort(keys_before, GRID_TRIS, sizeof(uint32_t), compare_keys);
+	qsort(keys_after, GRID_TRIS, sizeof(uint32_t), compare_keys);
+	assert(memcmp(keys_before, keys_after, sizeof(keys_before)) == 0);
+
+	/* Vertices are in first use order */
+	for (i = 0, j = 0; i < w.num_indices; ++i)
+	{
+		assert(w.indices[i] <= j);
+		if (w.indices[i] == j)
+		{
+			j++;
+		}
+	}
+
+	assert(j == w.num_vertices);
+
+	gpu_vertex_weld__destruct(&w);
+}
+
+static void test_vertex_fetch()
+{
+	uint32_t vertices[] = { 10, 11, 12, 13, 14 };
+	uint32_t indices[] = { 2, 0, 3, 3, 0, 1 };
+	uint32_t expected_vertices[] = { 12, 10, 13, 11, 14 };
+	uint32_t expected_indices[] = { 0, 1, 2, 2, 1, 3 };
+
+	/* Vertex 4 is never used and goes last */
+	gpu_mesh_opt__optimize_vertex_fetch((uint8_t*)vertices, sizeof(uint32_t), indices, 6, 5);
+
+	assert(memcmp(vertices, expected_vertices, sizeof(vertices)) == 0);
+	assert(memcmp(indices, expected_indices, sizeof(indices)) == 0);
+}
+
+void gpu_mesh_opt_tests()
+{
+	RUN_TEST_CASE(test_count_misses);
+	RUN_TEST_CASE(test_optimize);
+	RUN_TEST_CASE(test_vertex_fetch);
+}
@@ -0,0 +1,167 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "gpu/gpu.h"
+#include "gpu/gpu_render_queue.h"
+#include "tests/tests.h"
+
+/*=========================================================
+CONSTANTS
+=========================================================*/
+
+#define NUM_DRAWS		(10000)
+
+/*=========================================================
+VARIABLES
+=========================================================*/
+
+static uint32_t s_batch_calls;
+static uint32_t s_batch_count;
+static uint64_t s_batch_last_key;
+static boolean s_batch_sorted;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static int compare_keys(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static void render_batch(gpu_t* gpu, gpu_window_t* window, gpu_frame_t* frame, gpu_render_draw_t* draws, uint32_t count)
+{
+	uint32_t i;
+
+	s_batch_calls++;
+	s_batch_count = count;
+	s_batch_sorted = TRUE;
+	s_batch_last_key = 0;
+
+	for (i = 0; i < count; ++i)
+	{
+		s_batch_sorted &= (draws[i].key >= s_batch_last_key);
+		s_batch_last_key = draws[i].key;
+	}
+}
+
+static void test_make_key()
+{
+	/* State outranks depth, so draws group before they sort by distance */
+	assert(gpu_render_queue__make_key(0, 1, 0, 1.0f) < gpu_render_queue__make_key(0, 2, 0, 0.0f));
+	assert(gpu_render_queue__make_key(0, 1, 0, 1.0f) < gpu_render_queue__make_key(0, 1, 1, 0.0f));
+	assert(gpu_render_queue__make_key(0, 1, 1, 0.25f) < gpu_render_queue__make_key(0, 1, 1, 0.5f));
+
+	/* Depth is clamped */
+	assert(gpu_render_queue__make_key(0, 1, 1, -5.0f) == gpu_render_queue__make_key(0, 1, 1, 0.0f));
+	assert(gpu_render_queue__make_key(0, 1, 1, 5.0f) == gpu_render_queue__make_key(0, 1, 1, 1.0f));
+	assert(gpu_render_queue__make_key(0, 1, 1, 1.0f) < gpu_render_queue__make_key(0, 1, 2, 0.0f));
+}
+
+static void test_sort()
+{
+	gpu_render_queue_t q;
+	gpu_render_draw_t draw;
+	uint64_t* expected = (uint64_t*)malloc(sizeof(uint64_t) * NUM_DRAWS);
+	uint32_t i;
+	double start_ms;
+
+	assert(expected);
+	gpu_render_queue__construct(&q);
+	clear_struct(&draw);
+
+	/* Empty */
+	gpu_render_queue__sort(&q);
+	assert(q.sorted.count == 0);
+
+	srand(5);
+	for (i = 0; i < NUM_DRAWS; ++i)
+	{
+		draw.key = gpu_render_queue__make_key(0, (uint32_t)rand() % 50, (uint32_t)rand() % 4, rand_range(0.0f, 1.0f));
+		draw.mesh = i;
+		expected[i] = draw.key;
+		gpu_render_queue__push(&q, &draw);
+	}
+
+	start_ms = get_time_ms();
+	gpu_render_queue__sort(&q);
+	printf("\t\t%d draws sorted in %.3f ms\n", NUM_DRAWS, get_time_ms() - start_ms);
+
+	qsort(expected, NUM_DRAWS, sizeof(uint64_t), compare_keys);
+
+	assert(q.sorted.count == NUM_DRAWS);
+	for (i = 0; i < NUM_DRAWS; ++i)
+	{
+		assert(q.sorted.data[i].key == expected[i]);
+		assert(q.draws.data[q.sorted.data[i].mesh].key == expected[i]);
+	}
+
+	/* Equal keys keep the order they were pushed in */
+	gpu_render_queue__clear(&q);
+	for (i = 0; i < 100; ++i)
+	{
+		draw.key = (uint64_t)(i % 3) << 40;
+		draw.mesh = i;
+		gpu_render_queue__push(&q, &draw);
+	}
+
+	gpu_render_queue__sort(&q);
+	for (i = 1; i < 100; ++i)
+	{
+		assert(q.sorted.data[i - 1].key < q.sorted.data[i].key || q.sorted.data[i - 1].mesh < q.sorted.data[i].mesh);
+	}
+
+	gpu_render_queue__destruct(&q);
+	free(expected);
+}
+
+static void test_submit()
+{
+	gpu_render_queue_t q;
+	gpu_render_draw_t draw;
+	gpu_intf_t intf;
+	gpu_t gpu;
+	uint32_t i;
+
+	clear_struct(&intf);
+	clear_struct(&gpu);
+	intf.static_model__render_batch = render_batch;
+	gpu.intf = &intf;
+
+	gpu_render_queue__construct(&q);
+	clear_struct(&draw);
+
+	/* Nothing queued, nothing recorded */
+	s_batch_calls = 0;
+	gpu_render_queue__submit(&q, &gpu, NULL, NULL);
+	assert(s_batch_calls == 0);
+
+	/* One call with every draw in key order */
+	for (i = 0; i < 64; ++i)
+	{
+		draw.key = gpu_render_queue__make_key(0, 63 - i, 0, 0.5f);
+		gpu_render_queue__push(&q, &draw);
+	}
+
+	gpu_render_queue__submit(&q, &gpu, NULL, NULL);
+	assert(s_batch_calls == 1);
+	assert(s_batch_count == 64);
+	assert(s_batch_sorted);
+
+	gpu_render_queue__destruct(&q);
+}
+
+void gpu_render_queue_tests()
+{
+	RUN_TEST_CASE(test_make_key);
+	RUN_TEST_CASE(test_sort);
+	RUN_TEST_CASE(test_submit);
+}
@@ -0,0 +1,95 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+
+#include "common.h"
+#include "gpu/gpu_suballoc.h"
+#include "tests/tests.h"
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static void test_alloc_free()
+{
+	gpu_suballoc_t a;
+	uint64_t offsets[4];
+	uint64_t offset;
+	uint32_t i;
+
+	gpu_suballoc__construct(&a, 1000);
+
+	for (i = 0; i < 4; ++i)
+	{
+		assert(gpu_suballoc__alloc(&a, 200, 1, &offsets[i]));
+		assert(offsets[i] == i * 200);
+	}
+
+	assert(a.used == 800);
+	assert(a.num_allocs == 4);
+
+	/* Only 200 bytes are left */
+	assert(!gpu_suballoc__alloc(&a, 300, 1, &offset));
+
+	/* Freeing two ranges apart leaves two holes */
+	gpu_suballoc__free(&a, offsets[0], 200);
+	gpu_suballoc__free(&a, offsets[2], 200);
+	assert(a.free_blocks.count == 3);
+	assert(gpu_suballoc__get_largest_free(&a) == 200);
+	assert(gpu_suballoc__get_fragmentation(&a) > 0.6f);
+
+	/* Freeing between them merges all three into one */
+	gpu_suballoc__free(&a, offsets[1], 200);
+	assert(a.free_blocks.count == 2);
+	assert(a.free_blocks.data[0].offset == 0);
+	assert(a.free_blocks.data[0].size == 600);
+
+	gpu_suballoc__free(&a, offsets[3], 200);
+	assert(a.free_blocks.count == 1);
+	assert(a.free_blocks.data[0].size == 1000);
+	assert(a.used == 0);
+	assert(a.num_allocs == 0);
+	assert(gpu_suballoc__get_fragmentation(&a) == 0.0f);
+
+	gpu_suballoc__destruct(&a);
+}
+
+static void test_alignment()
+{
+	gpu_suballoc_t a;
+	uint64_t first;
+	uint64_t second;
+	uint64_t third;
+
+	gpu_suballoc__construct(&a, 1000);
+
+	assert(gpu_suballoc__alloc(&a, 10, 1, &first));
+	assert(first == 0);
+
+	/* Alignments need not be powers of two, and the padding stays free */
+	assert(gpu_suballoc__alloc(&a, 72, 36, &second));
+	assert(second == 36);
+	assert(a.free_blocks.count == 2);
+	assert(a.free_blocks.data[0].offset == 10);
+	assert(a.free_blocks.data[0].size == 26);
+
+	/* A small allocation fits in the padding */
+	assert(gpu_suballoc__alloc(&a, 20, 4, &third));
+	assert(third == 12);
+
+	gpu_suballoc__free(&a, first, 10);
+	gpu_suballoc__free(&a, third, 20);
+	gpu_suballoc__free(&a, second, 72);
+	assert(a.free_blocks.count == 1);
+	assert(a.free_blocks.data[0].size == 1000);
+
+	gpu_suballoc__destruct(&a);
+}
+
+void gpu_suballoc_tests()
+{
+	RUN_TEST_CASE(test_alloc_free);
+	RUN_TEST_CASE(test_alignment);
+}
@@ -0,0 +1,127 @@
+/*=========================================================
+INCLUDES
+=========================================================*/
+
+#include <assert.h>
+#include <string.h>
+
+#include "common.h"
+#include "gpu/gpu_vertex_weld.h"
+#include "tests/tests.h"
+
+/*=========================================================
+TYPES
+=========================================================*/
+
+typedef struct
+{
+	float		pos[3];
+	float		tex[2];
+	int32_t		material_idx;
+
+} vertex_t;
+
+/*=========================================================
+FUNCTIONS
+=========================================================*/
+
+static vertex_t make_vertex(float x, float y, float u, int32_t material_idx)
+{
+	vertex_t v;
+
+	clear_struct(&v);
+	v.pos[0] = x;
+	v.pos[1] = y;
+	v.tex[0] = u;
+	v.material_idx = material_idx;
+
+	return v;
+}
+
+static void test_weld()
+{
+	gpu_vertex_weld_t w;
+	vertex_t quad[6];
+	vertex_t v;
+	uint16_t indices16[7];
+	uint32_t i;
+
+	/* Two triangles of a quad share two corners */
+	quad[0] = make_vertex(0.0f, 0.0f, 0.0f, 0);
+	quad[1] = make_vertex(1.0f, 0.0f, 1.0f, 0);
+	quad[2] = make_vertex(1.0f, 1.0f, 1.0f, 0);
+	quad[3] = quad[0];
+	quad[4] = quad[2];
+	quad[5] = make_vertex(0.0f, 1.0f, 0.0f, 0);
+
+	gpu_vertex_weld__construct(&w, sizeof(vertex_t), 7);
+	for (i = 0; i < 6; ++i)
+	{
+		gpu_vertex_weld__add(&w, &quad[i]);
+	}
+
+	assert(w.num_vertices == 4);
+	assert(w.num_indices == 6);
+	assert(w.indices[3] == w.indices[0]);
+	assert(w.indices[4] == w.indices[2]);
+	assert(w.indices[5] == 3);
+	assert(memcmp(w.vertices + 3 * sizeof(vertex_t), &quad[5], sizeof(vertex_t)) == 0);
+
+	/* Any differing attribute keeps corners apart */
+	v = quad[0];
+	v.material_idx = 1;
+	assert(gpu_vertex_weld__add(&w, &v) == 4);
+	assert(w.num_vertices == 5);
+
+	assert(gpu_vertex_weld__get_index_size(&w) == sizeof(uint16_t));
+	gpu_vertex_weld__copy_indices(&w, indices16);
+	for (i = 0; i < w.num_indices; ++i)
+	{
+		assert(indices16[i] == w.indices[i]);
+	}
+
+	gpu_vertex_weld__destruct(&w);
+}
+
+static void test_index_size()
+{
+	gpu_vertex_weld_t w;
+	vertex_t v;
+	uint32_t* indices32;
+	uint32_t n = GPU_VERTEX_WELD_MAX_16BIT_VERTICES + 1;
+	uint32_t i;
+
+	gpu_vertex_weld__construct(&w, sizeof(vertex_t), n + 1);
+
+	/* The largest mesh that fits 16-bit indices */
+	for (i = 0; i < n - 1; ++i)
+	{
+		v = make_vertex((float)i, 0.0f, 0.0f, 0);
+		gpu_vertex_weld__add(&w, &v);
+	}
+
+	assert(w.num_vertices == GPU_VERTEX_WELD_MAX_16BIT_VERTICES);
+	assert(gpu_vertex_weld__get_index_size(&w) == sizeof(uint16_t));
+
+	/* One more vertex needs 32-bit indices */
+	v = make_vertex((float)i, 0.0f, 0.0f, 0);
+	gpu_vertex_weld__add(&w, &v);
+	v = make_vertex(0.0f, 0.0f, 0.0f, 0);
+	gpu_vertex_weld__add(&w, &v);
+	assert(w.num_vertices == n);
+	assert(gpu_vertex_weld__get_index_size(&w) == sizeof(uint32_t));
+
+	indices32 = malloc(sizeof(uint32_t) * w.num_indices);
+	gpu_vertex_weld__copy_indices(&w, indices32);
+	assert(indices32[n - 1] == n - 1);
+	assert(indices32[n] == 0);
+
+	free(indices32);
+	gpu_vertex_weld__destruct(&w);
+}
+
+void gpu_vertex_weld_tests()
+{
+	RUN_TEST_CASE(test_weld);
+	RUN_TEST_CASE(test_index_size);
+}
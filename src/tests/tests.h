@@ -6,6 +6,10 @@ INCLUDES
 =========================================================*/
 
 #include <assert.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common.h"
 
 /*=========================================================
 TYPES
@@ -25,4 +29,22 @@ FUNCTIONS
 	printf("\t%s\n", #func); \
 	##func##()
 
+/**
+Gets a wall clock time in milliseconds, for timing benchmarks.
+*/
+KK_INLINE double get_time_ms()
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/**
+Gets a random float in [lo, hi] from rand().
+*/
+KK_INLINE float rand_range(float lo, float hi)
+{
+	return lo + ((float)rand() / (float)RAND_MAX) * (hi - lo);
+}
+
 #endif /* TESTS_H */
\ No newline at end of file
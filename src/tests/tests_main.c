@@ -4,7 +4,9 @@ INCLUDES
 
 #include <stdio.h>
 
+#include "engine/kk_job.h"
 #include "engine/kk_log.h"
+#include "platform/platform_.h"
 #include "tests/tests.h"
 
 /*=========================================================
@@ -15,14 +17,37 @@ TYPES
 VARIABLES
 =========================================================*/
 
+kk_job_system_t* g_jobs;
 kk_log_t* g_log;
+platform_t* g_platform;
+
+static kk_job_system_t s_jobs;
 static kk_log_t s_log;
 
 /*=========================================================
 FUNCTIONS
 =========================================================*/
 
+void ecs_cmd_buffer_tests();
+void ecs_pool_tests();
+void ecs_query_tests();
+void ecs_scheduler_tests();
+void ecs_sparse_set_tests();
+void ecs_transform_tests();
 void ed_undo_tests();
+void gpu_mesh_opt_tests();
+void gpu_render_queue_tests();
+void gpu_suballoc_tests();
+void gpu_vertex_weld_tests();
+void kk_broadphase_tests();
+void kk_bvh_tests();
+void kk_camera_tests();
+void kk_contacts_tests();
+void kk_frustum_tests();
+void kk_islands_tests();
+void kk_job_tests();
+void kk_narrowphase_tests();
+void kk_physics_bodies_tests();
 void lua_script_tests();
 void utl_array_tests();
 void utl_ringbuf_tests();
@@ -32,11 +57,35 @@ void main()
 	g_log = &s_log;
 	kk_log__construct(g_log);
 
+	g_jobs = &s_jobs;
+	kk_job__construct(g_jobs, 0);
+
+	RUN_TEST(ecs_cmd_buffer_tests);
+	RUN_TEST(ecs_pool_tests);
+	RUN_TEST(ecs_query_tests);
+	RUN_TEST(ecs_scheduler_tests);
+	RUN_TEST(ecs_sparse_set_tests);
+	RUN_TEST(ecs_transform_tests);
 	RUN_TEST(ed_undo_tests);
+	RUN_TEST(gpu_mesh_opt_tests);
+	RUN_TEST(gpu_render_queue_tests);
+	RUN_TEST(gpu_suballoc_tests);
+	RUN_TEST(gpu_vertex_weld_tests);
+	RUN_TEST(kk_broadphase_tests);
+	RUN_TEST(kk_bvh_tests);
+	RUN_TEST(kk_camera_tests);
+	RUN_TEST(kk_contacts_tests);
+	RUN_TEST(kk_frustum_tests);
+	RUN_TEST(kk_islands_tests);
+	RUN_TEST(kk_job_tests);
+	RUN_TEST(kk_narrowphase_tests);
+	RUN_TEST(kk_physics_bodies_tests);
 	RUN_TEST(lua_script_tests);
 	RUN_TEST(utl_array_tests);
 	RUN_TEST(utl_ringbuf_tests);
 
+	kk_job__destruct(g_jobs);
+
 	printf("Press enter to continue...\n");
 	int not_used = getchar();
 }
\ No newline at end of file
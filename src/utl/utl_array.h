@@ -159,6 +159,7 @@ Declare common types.
 utl_array_declare_ptr_type(char);
 utl_array_declare_type(char);
 utl_array_declare_type(int);
+utl_array_declare_type(uint64_t);
 utl_array_declare_type(uint32_t);
 utl_array_declare_type(uint16_t);
 utl_array_declare_type(uint8_t);
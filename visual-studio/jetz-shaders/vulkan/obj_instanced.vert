@@ -10,22 +10,26 @@ layout(set = 0, binding = 0) uniform PerViewUBO {
 	vec3 cameraPos;
 } viewUbo;
 
-/*---------------------------------------------------------
-Push constants
----------------------------------------------------------*/
-layout(std430, push_constant) uniform PushConstants
-{
-	mat4			model_matrix;
-} constants;
-
 /*---------------------------------------------------------
 Inputs
 ---------------------------------------------------------*/
 layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_tex_coord;
+layout(location = 3) in int in_material_idx;
+
+/* Per-instance model matrix, one column per location (4-7) */
+layout(location = 4) in mat4 in_model_matrix;
 
 /*---------------------------------------------------------
 Outputs
 ---------------------------------------------------------*/
+layout(location = 0) out vec2 frag_tex_coord;
+layout(location = 1) flat out int frag_material_idx;	// Use "flat" since we don't want to interpolate
+//layout(location = 1) out vec3 fragNormal;
+//layout(location = 2) out vec3 lightDirNorm;
+//layout(location = 3) out vec3 eyeDirNorm;
+
 out gl_PerVertex {
     vec4 gl_Position;
 };
@@ -35,7 +39,10 @@ Functions
 ---------------------------------------------------------*/
 void main() 
 {
+	frag_tex_coord = in_tex_coord;
+	frag_material_idx = in_material_idx;
+
 	vec4 pos = vec4(in_position, 1.0); 
-	vec4 worldPos = constants.model_matrix * pos;
+	vec4 worldPos = in_model_matrix * pos;
     gl_Position = viewUbo.proj * viewUbo.view * worldPos;
 }
\ No newline at end of file